@@ -200,4 +200,8 @@ void autograderMain() {
 
     //stylecheck::setStyleCheckMergedWithUnitTests(true);
     //autograder::styleCheckAddFile("mainfunc.cpp");
+
+    // to time the parallel runner, run with --gtest_filter=WorkerBenchmarkTests.*
+    //autograder::setGraphicalUI(false);
+    //autograder::setTestWorkerCount(4);
 }
@@ -0,0 +1,107 @@
+/*
+ * Test file for verifying the Stanford C++ lib audio functionality.
+ * Notes and sounds are rendered to WAV files, so no audio device is needed.
+ */
+
+#include "testcases.h"
+#include "assertions.h"
+#include "audio.h"
+#include "filelib.h"
+#include "gtest-marty.h"
+#include "note.h"
+#include "sound.h"
+#include "vector.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <string>
+
+TEST_CATEGORY(AudioTests, "audio tests");
+
+// renders a short melody with a rest to the given file
+static void renderMelody(const std::string& filename) {
+    Vector<Note> melody {
+        Note("0.25 C 4 NATURAL false"), Note("0.25 E 4 NATURAL false"),
+        Note("0.25 R false"), Note("0.5 G 4 NATURAL false")
+    };
+    audio::startRendering();
+    for (const Note& note : melody) {
+        note.play();
+    }
+    audio::finishRendering(filename);
+}
+
+TIMED_TEST(AudioTests, noteFrequencyTest, TEST_TIMEOUT_DEFAULT) {
+    assertDoubleNear("A 4 is 440 Hz", 440, Note(1, Note::A, 4).getFrequency(), 1e-9);
+    assertDoubleNear("middle C", 261.626, Note(1, Note::C, 4).getFrequency(), 0.001);
+    assertDoubleNear("C# 4 == D flat 4", Note(1, Note::D, 4, Note::FLAT).getFrequency(),
+                     Note(1, Note::C, 4, Note::SHARP).getFrequency(), 1e-9);
+}
+
+TIMED_TEST(AudioTests, renderMelodyTest, TEST_TIMEOUT_DEFAULT) {
+    // notes follow one another without waiting for each to finish playing
+    std::string filename = getTempDirectory() + "/audio-melody.wav";
+    auto start = std::chrono::steady_clock::now();
+    renderMelody(filename);
+    double millis = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    assertTrue("rendering does not wait for the notes", millis < 1000);
+
+    std::shared_ptr<const audio::Samples> rendered = audio::readWavFile(filename);
+    deleteFile(filename);
+    assertEqualsInt("melody length", (int) (1.25 * audio::SAMPLE_RATE) * 2, (int) rendered->size());
+    double notePeak = 0;
+    for (int i = 0; i < (int) (0.5 * audio::SAMPLE_RATE) * 2; i++) {
+        notePeak = std::max(notePeak, (double) std::fabs((*rendered)[i]));
+    }
+    double restPeak = 0;
+    for (int i = (int) (0.5 * audio::SAMPLE_RATE) * 2; i < (int) (0.75 * audio::SAMPLE_RATE) * 2; i++) {
+        restPeak = std::max(restPeak, (double) std::fabs((*rendered)[i]));
+    }
+    assertTrue("notes are not silent", notePeak > 0.1);
+    assertEqualsDouble("rest is silent", 0.0, restPeak);
+}
+
+TIMED_TEST(AudioTests, soundPlayedTwiceTest, TEST_TIMEOUT_DEFAULT) {
+    // a sound read from a file mixes with itself when played twice
+    std::string melodyFile = getTempDirectory() + "/audio-melody.wav";
+    std::string twiceFile = getTempDirectory() + "/audio-twice.wav";
+    renderMelody(melodyFile);
+    std::shared_ptr<const audio::Samples> rendered = audio::readWavFile(melodyFile);
+    Sound sound(melodyFile);
+    audio::startRendering();
+    sound.play();
+    sound.play();
+    audio::finishRendering(twiceFile);
+    std::shared_ptr<const audio::Samples> twice = audio::readWavFile(twiceFile);
+    deleteFile(melodyFile);
+    deleteFile(twiceFile);
+
+    assertEqualsInt("length", (int) rendered->size(), (int) twice->size());
+    double maxError = 0;
+    for (int i = 0; i < (int) twice->size(); i++) {
+        maxError = std::max(maxError, (double) std::fabs((*twice)[i] - 2 * (*rendered)[i]));
+    }
+    assertTrue("sound played twice is twice as loud", maxError < 2.0 / 32768);
+}
+
+TIMED_TEST(AudioTests, wavFileTest, TEST_TIMEOUT_DEFAULT) {
+    std::string filename = getTempDirectory() + "/audio-tone.wav";
+    std::shared_ptr<const audio::Samples> tone = audio::synthesizeTone(440, 0.1);
+    audio::writeWavFile(filename, *tone);
+    std::shared_ptr<const audio::Samples> read = audio::readWavFile(filename);
+    assertEqualsInt("length", (int) tone->size(), (int) read->size());
+    double maxError = 0;
+    for (int i = 0; i < (int) read->size(); i++) {
+        maxError = std::max(maxError, (double) std::fabs((*read)[i] - (*tone)[i]));
+    }
+    // rounding to 16 bits, and writing full scale as 32767 but reading it as
+    // 32768, each lose up to about one step
+    assertTrue("16-bit round trip", maxError < 2.0 / 32768);
+
+    writeEntireFile(filename, "not a WAV file");
+    assertThrows("reading a file that is not a WAV file", audio::readWavFile(filename);, ErrorException);
+    deleteFile(filename);
+    assertThrows("reading a missing file", audio::readWavFile(filename);, ErrorException);
+    assertThrows("finishing without starting", audio::finishRendering(filename);, ErrorException);
+}
@@ -0,0 +1,204 @@
+/*
+ * Test file for verifying the Stanford C++ lib bitstream functionality.
+ * The "untracked" streams wrap a plain stringbuf or filebuf, so they take
+ * the path that checks the stream position on every bit; both paths must
+ * write and read the same bits.
+ */
+
+#include "testcases.h"
+#include "assertions.h"
+#include "bitstream.h"
+#include "filelib.h"
+#include "gtest-marty.h"
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+TEST_CATEGORY(BitstreamTests, "bitstream tests");
+
+class UntrackedOstringbitstream : public obitstream {
+public:
+    UntrackedOstringbitstream() {
+        init(&sb);
+    }
+
+    std::string str() const {
+        return sb.str();
+    }
+
+private:
+    std::stringbuf sb;
+};
+
+class UntrackedIstringbitstream : public ibitstream {
+public:
+    UntrackedIstringbitstream(const std::string& s) : sb(s) {
+        init(&sb);
+    }
+
+private:
+    std::stringbuf sb;
+};
+
+class UntrackedOfbitstream : public obitstream {
+public:
+    UntrackedOfbitstream(const std::string& filename) {
+        init(&fb);
+        fb.open(filename, std::ios::out | std::ios::binary);
+    }
+
+    void close() {
+        fb.close();
+    }
+
+private:
+    std::filebuf fb;
+};
+
+class UntrackedIfbitstream : public ibitstream {
+public:
+    UntrackedIfbitstream(const std::string& filename) {
+        init(&fb);
+        fb.open(filename, std::ios::in | std::ios::binary);
+    }
+
+private:
+    std::filebuf fb;
+};
+
+struct Code {
+    unsigned int bits;
+    int length;
+};
+
+// codes of 1-20 bits; about 'bytes' bytes of them in all
+static std::vector<Code> randomCodes(int bytes) {
+    std::mt19937 rng(20181019);
+    std::vector<Code> codes;
+    long totalBits = 0;
+    while (totalBits < 8L * bytes) {
+        Code code;
+        code.length = 1 + rng() % 20;
+        code.bits = rng() & ((1u << code.length) - 1);
+        codes.push_back(code);
+        totalBits += code.length;
+    }
+    return codes;
+}
+
+static void writeBitByBit(obitstream& out, const std::vector<Code>& codes) {
+    for (const Code& code : codes) {
+        for (int i = 0; i < code.length; i++) {
+            out.writeBit((code.bits >> i) & 1);
+        }
+    }
+}
+
+// returns the index of the first code read back wrong, or -1 if all match
+static int readBitByBit(ibitstream& in, const std::vector<Code>& codes) {
+    for (int c = 0; c < (int) codes.size(); c++) {
+        unsigned int bits = 0;
+        for (int i = 0; i < codes[c].length; i++) {
+            bits |= (unsigned int) in.readBit() << i;
+        }
+        if (bits != codes[c].bits) {
+            return c;
+        }
+    }
+    return -1;
+}
+
+static void writeCodes(obitstream& out, const std::vector<Code>& codes) {
+    for (const Code& code : codes) {
+        out.writeBits(code.bits, code.length);
+    }
+}
+
+// returns the index of the first code read back wrong, or -1 if all match
+static int readCodes(ibitstream& in, const std::vector<Code>& codes) {
+    for (int c = 0; c < (int) codes.size(); c++) {
+        if ((unsigned int) in.readBits(codes[c].length) != codes[c].bits) {
+            return c;
+        }
+    }
+    return -1;
+}
+
+TIMED_TEST(BitstreamTests, bitOrderTest, TEST_TIMEOUT_DEFAULT) {
+    // bits fill each byte from its least significant bit
+    ostringbitstream out;
+    out.writeBit(1);
+    out.writeBit(0);
+    out.writeBit(1);
+    out.writeBits(0x1f, 5);
+    out.writeBits(0x3, 3);
+    assertEqualsString("bytes", std::string("\xfd\x03", 2), out.str());
+
+    istringbitstream in(out.str());
+    int first = in.readBit();
+    long long rest = in.readBits(10);
+    long long pastEnd = in.readBits(10);
+    assertEqualsInt("first bit", 1, first);
+    assertEqualsInt("next 10 bits", 0x1fe, (int) rest);
+    assertEqualsInt("reading past the end", EOF, (int) pastEnd);
+}
+
+TIMED_TEST(BitstreamTests, fileStreamTest, TEST_TIMEOUT_DEFAULT) {
+    std::vector<Code> codes = randomCodes(20000);
+    ostringbitstream expectedOut;
+    writeCodes(expectedOut, codes);
+    std::string bytes = expectedOut.str();
+
+    std::string fileName = getTempDirectory() + "/bitstream-test.dat";
+    UntrackedOfbitstream untrackedOut(fileName);
+    writeBitByBit(untrackedOut, codes);
+    untrackedOut.close();
+    assertTrue("untracked file writeBit output", readEntireFile(fileName) == bytes);
+    UntrackedIfbitstream untrackedIn(fileName);
+    int untrackedResult = readBitByBit(untrackedIn, codes);
+    assertEqualsInt("untracked file readBit, first wrong code", -1, untrackedResult);
+
+    ofbitstream bitOut(fileName);
+    writeBitByBit(bitOut, codes);
+    bitOut.close();
+    assertTrue("file writeBit output", readEntireFile(fileName) == bytes);
+    ifbitstream bitIn(fileName);
+    int bitResult = readBitByBit(bitIn, codes);
+    bitIn.close();
+    assertEqualsInt("file readBit, first wrong code", -1, bitResult);
+
+    ofbitstream codeOut(fileName);
+    writeCodes(codeOut, codes);
+    codeOut.close();
+    assertTrue("file writeBits output", readEntireFile(fileName) == bytes);
+    ifbitstream codeIn(fileName);
+    int codeResult = readCodes(codeIn, codes);
+    codeIn.close();
+    assertEqualsInt("file readBits, first wrong code", -1, codeResult);
+    deleteFile(fileName);
+}
+
+TIMED_TEST(BitstreamTests, stringStreamTest, TEST_TIMEOUT_DEFAULT) {
+    std::vector<Code> codes = randomCodes(100000);
+    UntrackedOstringbitstream untrackedOut;
+    ostringbitstream bitOut;
+    ostringbitstream codeOut;
+    writeBitByBit(untrackedOut, codes);
+    writeBitByBit(bitOut, codes);
+    writeCodes(codeOut, codes);
+    std::string bytes = untrackedOut.str();
+    assertTrue("writeBit output agrees with the untracked stream", bitOut.str() == bytes);
+    assertTrue("writeBits output agrees with writeBit", codeOut.str() == bytes);
+
+    UntrackedIstringbitstream untrackedIn(bytes);
+    istringbitstream bitIn(bytes);
+    istringbitstream codeIn(bytes);
+    int untrackedResult = readBitByBit(untrackedIn, codes);
+    int bitResult = readBitByBit(bitIn, codes);
+    int codeResult = readCodes(codeIn, codes);
+    assertEqualsInt("untracked readBit, first wrong code", -1, untrackedResult);
+    assertEqualsInt("readBit, first wrong code", -1, bitResult);
+    assertEqualsInt("readBits, first wrong code", -1, codeResult);
+}
@@ -1,5 +1,7 @@
 /*
  * Common helper functions used by collection tests.
+ * @version 2018/10/19
+ * - added Counted, for checking how often a collection allocates storage
  * @version 2016/10/22
  * - initial version
  */
@@ -7,6 +9,7 @@
 #ifndef _collection_test_common_h
 #define _collection_test_common_h
 
+#include <cstddef>
 #include <initializer_list>
 #include <iostream>
 #include <sstream>
@@ -62,4 +65,32 @@ void assertMap(std::string message, std::initializer_list<std::pair<K, V> > expe
     assertEquals(message + ": size of collection", (int) expected.size(), map.size());
 }
 
+/*
+ * An element type that counts how many arrays of it are allocated,
+ * which is how Vector, Stack, and Queue allocate their storage.
+ */
+struct Counted {
+    int value;
+
+    Counted(int value = 0) : value(value) {}
+
+    bool operator ==(const Counted& other) const {
+        return value == other.value;
+    }
+
+    static void* operator new[](std::size_t size) {
+        arrayAllocations()++;
+        return ::operator new[](size);
+    }
+
+    static void operator delete[](void* p) {
+        ::operator delete[](p);
+    }
+
+    static int& arrayAllocations() {
+        static int count = 0;
+        return count;
+    }
+};
+
 #endif // _collection_test_common_h
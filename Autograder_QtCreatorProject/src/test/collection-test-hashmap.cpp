@@ -18,6 +18,28 @@
 
 TEST_CATEGORY(HashMapTests, "HashMap tests");
 
+TIMED_TEST(HashMapTests, capacityTest_HashMap, TEST_TIMEOUT_DEFAULT) {
+    const int N = 200000;
+    HashMap<int, int> map;
+    map.reserve(N);
+    int buckets = map.bucketCount();
+    for (int i = 0; i < N; i++) {
+        map.put(i, i * 2);
+    }
+    assertEqualsInt("buckets after reserved puts", buckets, map.bucketCount());
+    assertEqualsInt("size after reserved puts", N, map.size());
+    map.put(-1, 0);
+    for (int i = 0; i < N; i++) {
+        assertEqualsInt("get after reserved puts", i * 2, map.get(i));
+    }
+    for (int i = 0; i < N; i++) {
+        map.remove(i);
+    }
+    map.shrinkToFit();
+    assertTrue("buckets after shrinkToFit", map.bucketCount() < 10);
+    assertEqualsInt("get after shrinkToFit", 0, map.get(-1));
+}
+
 TIMED_TEST(HashMapTests, forEachTest_HashMap, TEST_TIMEOUT_DEFAULT) {
     HashMap<std::string, int> hmap;
     hmap["a"] = 1;
@@ -160,6 +182,26 @@ TIMED_TEST(HashMapTests, iteratorVersionTest_HashMap, TEST_TIMEOUT_DEFAULT) {
 }
 #endif // SPL_THROW_ON_INVALID_ITERATOR
 
+TIMED_TEST(HashMapTests, loadFactorTest_HashMap, TEST_TIMEOUT_DEFAULT) {
+    const int N = 200000;
+    HashMap<int, int> map;
+    map.setMaxLoadFactor(4.0);
+    map.reserve(N);
+    assertEqualsDouble("max load factor", 4.0, map.getMaxLoadFactor());
+    assertTrue("load factor sizes table", map.bucketCount() <= N / 4 + 1);
+    int buckets = map.bucketCount();
+    for (int i = 0; i < N; i++) {
+        map[i] = i;
+    }
+    assertEqualsInt("buckets after dense puts", buckets, map.bucketCount());
+    map.setMaxLoadFactor(1.0);
+    assertTrue("lower load factor rehashes", map.bucketCount() >= N);
+    assertEqualsInt("get after rehash", N - 1, map[N - 1]);
+    HashMap<int, int> copy = map;
+    assertEqualsDouble("copy keeps load factor", 1.0, copy.getMaxLoadFactor());
+    assertTrue("copy equals original", copy == map);
+}
+
 TIMED_TEST(HashMapTests, randomKeyTest_HashMap, TEST_TIMEOUT_DEFAULT) {
     Map<std::string, int> counts;
     int RUNS = 200;
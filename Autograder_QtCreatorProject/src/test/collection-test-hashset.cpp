@@ -18,6 +18,18 @@
 
 TEST_CATEGORY(HashSetTests, "HashSet tests");
 
+TIMED_TEST(HashSetTests, capacityTest_HashSet, TEST_TIMEOUT_DEFAULT) {
+    const int N = 200000;
+    HashSet<std::string> set;
+    set.reserve(N);
+    int buckets = set.bucketCount();
+    for (int i = 0; i < N; i++) {
+        set.add(std::to_string(i));
+    }
+    assertEqualsInt("buckets after reserved adds", buckets, set.bucketCount());
+    assertEqualsInt("size after reserved adds", N, set.size());
+}
+
 TIMED_TEST(HashSetTests, forEachTest_HashSet, TEST_TIMEOUT_DEFAULT) {
     HashSet<int> hset {40, 20, 10, 30};
     Set<int> expected {10, 20, 30, 40};
@@ -17,6 +17,20 @@
 
 TEST_CATEGORY(LinkedHashMapTests, "LinkedHashMap tests");
 
+TIMED_TEST(LinkedHashMapTests, capacityTest_LinkedHashMap, TEST_TIMEOUT_DEFAULT) {
+    const int N = 200000;
+    LinkedHashMap<std::string, int> map;
+    map.reserve(N);
+    int buckets = map.bucketCount();
+    for (int i = 0; i < N; i++) {
+        map.put(std::to_string(i), i);
+    }
+    assertEqualsInt("buckets after reserved puts", buckets, map.bucketCount());
+    Vector<std::string> keys = map.keys();
+    assertEqualsInt("keys after reserved puts", N, keys.size());
+    assertEqualsString("last key", std::to_string(N - 1), keys[N - 1]);
+}
+
 TIMED_TEST(LinkedHashMapTests, compareTest_LinkedHashMap, TEST_TIMEOUT_DEFAULT) {
     // TODO
 }
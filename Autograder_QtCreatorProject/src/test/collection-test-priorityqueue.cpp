@@ -17,6 +17,24 @@
 
 TEST_CATEGORY(PriorityQueueTests, "PriorityQueue tests");
 
+TIMED_TEST(PriorityQueueTests, capacityTest_PriorityQueue, TEST_TIMEOUT_DEFAULT) {
+    const int N = 100000;
+    PriorityQueue<int> pq;
+    pq.reserve(N);
+    assertEqualsInt("capacity after reserve", N, pq.capacity());
+    for (int i = 0; i < N; i++) {
+        pq.enqueue(i, (i * 7919) % N);
+    }
+    assertEqualsInt("capacity after reserved enqueues", N, pq.capacity());
+    for (int i = 0; i < N - 5; i++) {
+        pq.dequeue();
+    }
+    pq.shrinkToFit();
+    assertEqualsInt("capacity after shrinkToFit", 5, pq.capacity());
+    assertEqualsInt("size after shrinkToFit", 5, pq.size());
+    assertEqualsDouble("peekPriority after shrinkToFit", N - 5, pq.peekPriority());
+}
+
 TIMED_TEST(PriorityQueueTests, forEachTest_PriorityQueue, TEST_TIMEOUT_DEFAULT) {
     PriorityQueue<std::string> pq;
     pq.add("a", 4);
@@ -16,6 +16,58 @@
 
 TEST_CATEGORY(QueueTests, "Queue tests");
 
+TIMED_TEST(QueueTests, capacityTest_Queue, TEST_TIMEOUT_DEFAULT) {
+    const int N = 100000;
+    Queue<Counted> queue;
+    // move the head along so that the elements wrap around the ring buffer
+    for (int i = 0; i < 7; i++) {
+        queue.enqueue(-1);
+        queue.dequeue();
+    }
+    queue.enqueue(0);
+    queue.enqueue(1);
+    queue.enqueue(2);
+    Counted::arrayAllocations() = 0;
+    queue.reserve(N);
+    assertTrue("capacity after reserve", queue.capacity() >= N);
+    assertEqualsInt("allocations after reserve", 1, Counted::arrayAllocations());
+    for (int i = 3; i < N; i++) {
+        queue.enqueue(i);
+    }
+    assertEqualsInt("allocations after reserved enqueues", 1, Counted::arrayAllocations());
+
+    for (int i = 0; i < N - 10; i++) {
+        queue.dequeue();
+    }
+    queue.shrinkToFit();
+    assertEqualsInt("capacity after shrinkToFit", 10, queue.capacity());
+    assertEqualsInt("size after shrinkToFit", 10, queue.size());
+    for (int i = N - 10; i < N; i++) {
+        int value = queue.dequeue().value;
+        assertEqualsInt("dequeue after shrinkToFit", i, value);
+    }
+    assertTrue("empty at end", queue.isEmpty());
+}
+
+TIMED_TEST(QueueTests, growWrappedTest_Queue, TEST_TIMEOUT_DEFAULT) {
+    // growing while wrapped around keeps the elements in order
+    Queue<int> queue;
+    for (int i = 0; i < 6; i++) {
+        queue.enqueue(i);
+    }
+    for (int i = 0; i < 4; i++) {
+        queue.dequeue();
+    }
+    for (int i = 6; i < 40; i++) {
+        queue.enqueue(i);
+    }
+    assertEqualsInt("size after growing", 36, queue.size());
+    for (int i = 4; i < 40; i++) {
+        int value = queue.dequeue();
+        assertEqualsInt("dequeue after growing", i, value);
+    }
+}
+
 TIMED_TEST(QueueTests, compareTest_Queue, TEST_TIMEOUT_DEFAULT) {
     Queue<int> q1;
     q1.add(1);
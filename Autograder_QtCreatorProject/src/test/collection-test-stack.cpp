@@ -17,6 +17,22 @@
 
 TEST_CATEGORY(StackTests, "Stack tests");
 
+TIMED_TEST(StackTests, capacityTest_Stack, TEST_TIMEOUT_DEFAULT) {
+    const int N = 100000;
+    Stack<Counted> stack;
+    Counted::arrayAllocations() = 0;
+    stack.reserve(N);
+    for (int i = 0; i < N; i++) {
+        stack.push(i);
+    }
+    assertEqualsInt("capacity after reserved pushes", N, stack.capacity());
+    assertEqualsInt("allocations after reserved pushes", 1, Counted::arrayAllocations());
+    stack.pop();
+    stack.shrinkToFit();
+    assertEqualsInt("capacity after shrinkToFit", N - 1, stack.capacity());
+    assertEqualsInt("peek after shrinkToFit", N - 2, stack.peek().value);
+}
+
 TIMED_TEST(StackTests, compareTest_Stack, TEST_TIMEOUT_DEFAULT) {
     Stack<int> s1;
     s1.add(1);
@@ -17,6 +17,38 @@
 
 TEST_CATEGORY(VectorTests, "Vector tests");
 
+TIMED_TEST(VectorTests, capacityTest_Vector, TEST_TIMEOUT_DEFAULT) {
+    const int N = 100000;
+    Counted::arrayAllocations() = 0;
+    Vector<Counted> v;
+    v.reserve(N);
+    assertEqualsInt("capacity after reserve", N, v.capacity());
+    assertEqualsInt("allocations after reserve", 1, Counted::arrayAllocations());
+    for (int i = 0; i < N; i++) {
+        v.add(i);
+    }
+    assertEqualsInt("capacity after reserved adds", N, v.capacity());
+    assertEqualsInt("allocations after reserved adds", 1, Counted::arrayAllocations());
+    v.add(N);
+    assertTrue("capacity grows past reserve", v.capacity() > N);
+    assertEqualsInt("allocations after growing", 2, Counted::arrayAllocations());
+
+    for (int i = 0; i < N / 2; i++) {
+        v.removeBack();
+    }
+    v.shrinkToFit();
+    assertEqualsInt("size after shrinkToFit", N / 2 + 1, v.size());
+    assertEqualsInt("capacity after shrinkToFit", v.size(), v.capacity());
+    assertEqualsInt("front after shrinkToFit", 0, v[0].value);
+    assertEqualsInt("back after shrinkToFit", N / 2, v.back().value);
+    v.reserve(10);
+    assertEqualsInt("reserve never shrinks", N / 2 + 1, v.capacity());
+    v.clear();
+    v.shrinkToFit();
+    assertEqualsInt("capacity after clear and shrinkToFit", 0, v.capacity());
+    assertTrue("empty after clear", v.isEmpty());
+}
+
 TIMED_TEST(VectorTests, compareTest_Vector, TEST_TIMEOUT_DEFAULT) {
     Vector<int> v1 {1, 2, 4, 5};
     Vector<int> v2 {1, 3, 1, 4, 8};
@@ -0,0 +1,55 @@
+/*
+ * Test file for verifying the Stanford C++ lib diff functionality.
+ */
+
+#include "testcases.h"
+#include "assertions.h"
+#include "diff.h"
+#include "gtest-marty.h"
+#include <string>
+
+TEST_CATEGORY(DiffTests, "diff tests");
+
+TIMED_TEST(DiffTests, noDiffsTest, TEST_TIMEOUT_DEFAULT) {
+    assertEqualsString("same text", diff::NO_DIFFS_MESSAGE, diff::diff("a\nb\nc", "a\nb\nc", 0));
+    assertEqualsString("trailing whitespace", diff::NO_DIFFS_MESSAGE, diff::diff("a\nb\n", "a\nb  \n\n", 0));
+    assertTrue("diffPass same text", diff::diffPass("a\nb\nc", "a\nb\nc", 0));
+}
+
+TIMED_TEST(DiffTests, changedLineTest, TEST_TIMEOUT_DEFAULT) {
+    std::string diffs = diff::diff("a\nb\nc", "a\nx\nc", 0);
+    assertEqualsString("changed line", "Line 2 does not match\nEXPECTED < b\nSTUDENT  > x", diffs);
+    assertFalse("diffPass changed line", diff::diffPass("a\nb\nc", "a\nx\nc", 0));
+}
+
+TIMED_TEST(DiffTests, deletedLineTest, TEST_TIMEOUT_DEFAULT) {
+    std::string diffs = diff::diff("a\nb\nc", "a\nc", 0);
+    assertEqualsString("deleted line", "Line 2 deleted near student line 1\nEXPECTED < b", diffs);
+    assertFalse("diffPass deleted line", diff::diffPass("a\nb\nc", "a\nc", 0));
+}
+
+TIMED_TEST(DiffTests, trailingAddedLinesTest, TEST_TIMEOUT_DEFAULT) {
+    // extra lines past the end of the expected output are only reported
+    // under IGNORE_TRAILING
+    assertEqualsString("added lines", diff::NO_DIFFS_MESSAGE, diff::diff("a\nb", "a\nb\nc", 0));
+    assertTrue("diffPass added lines", diff::diffPass("a\nb", "a\nb\nc", 0));
+    assertFalse("added lines reported", diff::isDiffMatch(diff::diff("a\nb", "a\nb\nc", diff::IGNORE_TRAILING)));
+    assertFalse("diffPass added lines reported", diff::diffPass("a\nb", "a\nb\nc", diff::IGNORE_TRAILING));
+}
+
+TIMED_TEST(DiffTests, trailingChangedLinesTest, TEST_TIMEOUT_DEFAULT) {
+    // a final change that replaces the last expected line with several
+    // student lines must show all of them
+    std::string diffs = diff::diff("a\nb", "a\nc\nd", 0);
+    assertEqualsString("changed last line", "Line 2 changed to student line 2-3\nEXPECTED < b\nSTUDENT  > c\nSTUDENT  > d", diffs);
+    assertFalse("diffPass changed last line", diff::diffPass("a\nb", "a\nc\nd", 0));
+}
+
+TIMED_TEST(DiffTests, ignoreFlagsTest, TEST_TIMEOUT_DEFAULT) {
+    assertTrue("IGNORE_CASE", diff::diffPass("Hello\nWorld", "hello\nWORLD", diff::IGNORE_CASE));
+    assertTrue("IGNORE_NUMBERS", diff::diffPass("x = 3\ny = 42", "x = 7\ny = 1", diff::IGNORE_NUMBERS));
+    assertTrue("IGNORE_PUNCTUATION", diff::diffPass("Hi, there!", "Hi there", diff::IGNORE_PUNCTUATION));
+    assertTrue("IGNORE_LINEORDER", diff::diffPass("a\nb\nc", "c\na\nb", diff::IGNORE_LINEORDER));
+    assertTrue("IGNORE_LEADING", diff::diffPass("a\nb", "x\ny\na\nb", diff::IGNORE_LEADING));
+    assertFalse("no IGNORE_CASE", diff::diffPass("Hello", "hello", 0));
+}
@@ -0,0 +1,185 @@
+/*
+ * Test file for verifying the Stanford C++ lib canonicalhuffman functionality.
+ */
+
+#include "testcases.h"
+#include "assertions.h"
+#include "bitstream.h"
+#include "canonicalhuffman.h"
+#include "gtest-marty.h"
+#include <cmath>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST_CATEGORY(HuffmanTests, "huffman tests");
+
+// about 'bytes' bytes of words, chosen with a skewed distribution like English
+static std::string sampleText(int bytes) {
+    static const std::vector<std::string> words {
+        "the", "of", "and", "to", "a", "in", "is", "that", "for", "it", "as",
+        "with", "was", "on", "be", "by", "this", "are", "from", "or", "Huffman",
+        "code", "tree", "bits", "compression", "frequency", "symbol", "node,",
+        "file.", "stream", "encode", "decode", "table", "length", "priority"
+    };
+    std::mt19937 rng(20181019);
+    std::geometric_distribution<int> choose(0.15);
+    std::string text;
+    while ((int) text.length() < bytes) {
+        text += words[choose(rng) % words.size()];
+        text += rng() % 12 == 0 ? '\n' : ' ';
+    }
+    return text;
+}
+
+// compresses the text and decompresses the result
+static std::string roundTrip(const std::string& text) {
+    std::istringstream input(text);
+    ostringbitstream compressed;
+    CanonicalHuffmanCode::compress(input, compressed);
+    istringbitstream compressedInput(compressed.str());
+    std::ostringstream output;
+    CanonicalHuffmanCode::decompress(compressedInput, output);
+    return output.str();
+}
+
+static CanonicalHuffmanCode codeFor(const std::string& text) {
+    std::istringstream input(text);
+    return CanonicalHuffmanCode(CanonicalHuffmanCode::countFrequencies(input));
+}
+
+TIMED_TEST(HuffmanTests, codeStringsTest, TEST_TIMEOUT_DEFAULT) {
+    // writing each symbol's code string bit by bit gives the same bits as
+    // encode, and the codes are prefix-free and use up the whole code space
+    std::string text = sampleText(50000);
+    CanonicalHuffmanCode code = codeFor(text);
+    std::istringstream input(text);
+    ostringbitstream encoded;
+    code.encode(input, encoded);
+
+    ostringbitstream bitByBit;
+    std::vector<std::string> codes;
+    double kraftSum = 0;
+    for (int symbol = 0; symbol < CanonicalHuffmanCode::SYMBOL_COUNT; symbol++) {
+        std::string bits = code.getCode(symbol);
+        assertEqualsInt("code length of " + std::to_string(symbol), code.getCodeLength(symbol), (int) bits.length());
+        if (!bits.empty()) {
+            codes.push_back(bits);
+            kraftSum += std::ldexp(1.0, -(int) bits.length());
+        }
+    }
+    for (char ch : text) {
+        for (char bit : code.getCode((unsigned char) ch)) {
+            bitByBit.writeBit(bit - '0');
+        }
+    }
+    for (char bit : code.getCode(PSEUDO_EOF)) {
+        bitByBit.writeBit(bit - '0');
+    }
+    assertTrue("code strings write the same bits as encode", bitByBit.str() == encoded.str());
+    assertEqualsInt("symbols with codes", code.size(), (int) codes.size());
+    assertEqualsDouble("Kraft sum", 1.0, kraftSum);
+    for (const std::string& a : codes) {
+        for (const std::string& b : codes) {
+            if (&a != &b && b.compare(0, a.length(), a) == 0) {
+                assertFail("code " + a + " is a prefix of code " + b);
+            }
+        }
+    }
+}
+
+TIMED_TEST(HuffmanTests, compressRoundTripTest, TEST_TIMEOUT_DEFAULT) {
+    std::string text = sampleText(200000);
+    assertTrue("sample text", roundTrip(text) == text);
+    assertEqualsString("empty text", "", roundTrip(""));
+    assertEqualsString("one symbol", "aaaaaaaa", roundTrip("aaaaaaaa"));
+    std::string allBytes;
+    for (int i = 0; i < 256; i++) {
+        allBytes += (char) i;
+    }
+    assertTrue("every byte value", roundTrip(allBytes + allBytes) == allBytes + allBytes);
+}
+
+TIMED_TEST(HuffmanTests, encodeDecodeTest, TEST_TIMEOUT_DEFAULT) {
+    std::string text = sampleText(200000);
+    CanonicalHuffmanCode code = codeFor(text);
+    std::istringstream input(text);
+    ostringbitstream encoded;
+    code.encode(input, encoded);
+    istringbitstream encodedInput(encoded.str());
+    std::ostringstream decoded;
+    code.decode(encodedInput, decoded);
+    assertTrue("encode and decode round trip", decoded.str() == text);
+    assertTrue("compressed", encoded.str().length() < text.length());
+
+    std::istringstream missing("text with a byte that has no code: \x01");
+    ostringbitstream ignored;
+    assertThrows("encoding a byte with no code", code.encode(missing, ignored);, ErrorException);
+}
+
+TIMED_TEST(HuffmanTests, headerTest, TEST_TIMEOUT_DEFAULT) {
+    CanonicalHuffmanCode code = codeFor(sampleText(20000));
+    ostringbitstream output;
+    code.writeHeader(output);
+    assertEqualsInt("header size", 2 + 3 * code.size(), (int) output.str().length());
+    istringbitstream input(output.str());
+    CanonicalHuffmanCode code2 = CanonicalHuffmanCode::readHeader(input);
+    assertEqualsString("code lengths", code.getCodeLengths().toString(), code2.getCodeLengths().toString());
+    assertEqualsString("codes", code.toString(), code2.toString());
+}
+
+TIMED_TEST(HuffmanTests, readSymbolTest, TEST_TIMEOUT_DEFAULT) {
+    // symbols can be read and written at any bit position
+    CanonicalHuffmanCode code = codeFor("abracadabra");
+    ostringbitstream output;
+    output.writeBit(1);
+    std::string symbols = "cabbad";
+    for (char ch : symbols) {
+        code.writeSymbol(output, ch);
+    }
+    code.writeSymbol(output, PSEUDO_EOF);
+    istringbitstream input(output.str());
+    int leadingBit = input.readBit();
+    assertEqualsInt("leading bit", 1, leadingBit);
+    std::string read;
+    while (true) {
+        int symbol = code.readSymbol(input);
+        if (symbol == PSEUDO_EOF || symbol == EOF) {
+            break;
+        }
+        read += (char) symbol;
+    }
+    assertEqualsString("symbols read back", symbols, read);
+    assertThrows("writing a symbol with no code", code.writeSymbol(output, 'z');, ErrorException);
+}
+
+TIMED_TEST(HuffmanTests, threadsTest, TEST_TIMEOUT_DEFAULT) {
+    // one code, which has not decoded anything yet, shared by several threads
+    std::string text = sampleText(200000);
+    CanonicalHuffmanCode code = codeFor(text);
+    std::istringstream input(text);
+    ostringbitstream encoded;
+    code.encode(input, encoded);
+    std::string bits = encoded.str();
+
+    CanonicalHuffmanCode sharedCode = CanonicalHuffmanCode::fromCodeLengths(code.getCodeLengths());
+    const int threadCount = 4;
+    std::vector<std::string> results(threadCount);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < threadCount; i++) {
+        threads.push_back(std::thread([&, i]() {
+            istringbitstream threadInput(bits);
+            std::ostringstream threadOutput;
+            sharedCode.decode(threadInput, threadOutput);
+            results[i] = threadOutput.str();
+        }));
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
+    for (int i = 0; i < threadCount; i++) {
+        assertTrue("thread " + std::to_string(i) + " decoded the text", results[i] == text);
+    }
+}
@@ -0,0 +1,131 @@
+/*
+ * Test file for verifying the Stanford C++ lib random functionality.
+ * The statistical tests use a fixed seed and bounds several standard
+ * deviations wide, so they pass every time unless the generator is broken.
+ */
+
+#include "testcases.h"
+#include "assertions.h"
+#include "gtest-marty.h"
+#include "random.h"
+#include "vector.h"
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <thread>
+
+TEST_CATEGORY(RandomTests, "random tests");
+
+// returns the chi-square statistic of the counts of randomInteger(0, buckets - 1)
+static double chiSquare(int buckets, int samples) {
+    Vector<int> counts(buckets);
+    for (int i = 0; i < samples; i++) {
+        counts[randomInteger(0, buckets - 1)]++;
+    }
+    double expected = samples * 1.0 / buckets;
+    double result = 0;
+    for (int count : counts) {
+        result += (count - expected) * (count - expected) / expected;
+    }
+    return result;
+}
+
+TIMED_TEST(RandomTests, bitFrequencyTest, TEST_TIMEOUT_DEFAULT) {
+    // each bit of next() should be 1 half of the time
+    setRandomSeed(42);
+    const int N = 200000;
+    RandomEngine& engine = getRandomEngine();
+    int bitCounts[64] = {0};
+    for (int i = 0; i < N; i++) {
+        uint64_t bits = engine.next();
+        for (int b = 0; b < 64; b++) {
+            bitCounts[b] += (bits >> b) & 1;
+        }
+    }
+    for (int b = 0; b < 64; b++) {
+        assertDoubleNear("frequency of bit " + std::to_string(b), 0.5, bitCounts[b] * 1.0 / N, 0.01);
+    }
+}
+
+TIMED_TEST(RandomTests, chiSquareTest, TEST_TIMEOUT_DEFAULT) {
+    // a chi-square statistic far from the number of buckets - 1 means that
+    // some values come up too often or not often enough
+    setRandomSeed(42);
+    assertTrue("randomInteger(0, 9)", chiSquare(10, 1000000) < 9 + 6 * std::sqrt(2.0 * 9));
+    assertTrue("randomInteger(0, 999)", chiSquare(1000, 1000000) < 999 + 6 * std::sqrt(2.0 * 999));
+}
+
+TIMED_TEST(RandomTests, feedTest, TEST_TIMEOUT_DEFAULT) {
+    // fed values come before random ones, for autograders
+    autograder::randomFeedInteger(7);
+    autograder::randomFeedReal(0.25);
+    int fedInteger = randomInteger(1, 10);
+    double fedReal = randomReal(0, 1);
+    assertEqualsInt("fed integer", 7, fedInteger);
+    assertEqualsDouble("fed real", 0.25, fedReal);
+    int value = randomInteger(1, 1000);
+    assertTrue("random after feeding", value >= 1 && value <= 1000);
+}
+
+TIMED_TEST(RandomTests, largeRangeTest, TEST_TIMEOUT_DEFAULT) {
+    // 3 * 2^29 values: the old double scaling method favored some of these
+    // by a factor of 2, so half of the values in the low bucket came up
+    // twice as often; all buckets should be about 1/3 now
+    setRandomSeed(42);
+    const int N = 300000;
+    int counts[3] = {0, 0, 0};
+    for (int i = 0; i < N; i++) {
+        counts[randomInteger(0, 3 * (1 << 29) - 1) / (1 << 29)]++;
+    }
+    for (int i = 0; i < 3; i++) {
+        assertDoubleNear("third " + std::to_string(i), 1.0 / 3, counts[i] * 1.0 / N, 0.01);
+    }
+}
+
+TIMED_TEST(RandomTests, rangeTest, TEST_TIMEOUT_DEFAULT) {
+    for (int i = 0; i < 10000; i++) {
+        int value = randomInteger(-3, 3);
+        assertTrue("randomInteger(-3, 3)", value >= -3 && value <= 3);
+        value = randomInteger(INT_MIN, INT_MAX);
+        assertTrue("randomInteger(INT_MIN, INT_MAX)", value >= INT_MIN && value <= INT_MAX);
+        double real = randomReal(2, 5);
+        assertTrue("randomReal(2, 5)", real >= 2 && real < 5);
+    }
+    assertEqualsInt("randomInteger(4, 4)", 4, randomInteger(4, 4));
+}
+
+TIMED_TEST(RandomTests, realMeanCorrelationTest, TEST_TIMEOUT_DEFAULT) {
+    // correlation between consecutive reals should be near 0, mean near 0.5
+    setRandomSeed(42);
+    const int N = 300000;
+    double sum = 0;
+    double sumProducts = 0;
+    double prev = randomReal(0, 1);
+    for (int i = 0; i < N; i++) {
+        double d = randomReal(0, 1);
+        sum += d;
+        sumProducts += (d - 0.5) * (prev - 0.5);
+        prev = d;
+    }
+    assertDoubleNear("randomReal mean", 0.5, sum / N, 0.005);
+    assertDoubleNear("serial correlation", 0.0, sumProducts / N * 12, 0.02);
+}
+
+TIMED_TEST(RandomTests, seedTest, TEST_TIMEOUT_DEFAULT) {
+    setRandomSeed(42);
+    Vector<int> first(10);
+    randomFill(first, 1, 100);
+    setRandomSeed(42);
+    Vector<int> second;
+    for (int i = 0; i < 10; i++) {
+        second.add(randomInteger(1, 100));
+    }
+    assertEqualsString("same seed, same numbers", first.toString(), second.toString());
+
+    // another thread gets its own sequence
+    setRandomSeed(42);
+    Vector<int> other(10);
+    std::thread thread([&other]() { randomFill(other, 1, 100); });
+    thread.join();
+    assertNotEqualsString("other thread", first.toString(), other.toString());
+}
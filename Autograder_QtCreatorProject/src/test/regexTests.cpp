@@ -0,0 +1,156 @@
+/*
+ * Test file for verifying the Stanford C++ lib regexpr functionality.
+ * The linear-time matcher must find the same matches as std::regex.
+ */
+
+#include "testcases.h"
+#include "assertions.h"
+#include "gtest-marty.h"
+#include "regexpr.h"
+#include "strlib.h"
+#include "vector.h"
+#include <random>
+#include <regex>
+#include <string>
+
+TEST_CATEGORY(RegexTests, "regex tests");
+
+// returns what the chosen matcher finds for the regexp in s, as a string
+// such as "true 2 {1, 3}" holding regexMatch, regexMatchCount, and the lines
+static std::string matchSummary(const std::string& s, const std::string& regexp, bool linear) {
+    setRegexLinearMatchingEnabled(linear);
+    Vector<int> lines;
+    bool match = regexMatch(s, regexp);
+    int count = regexMatchCount(s, regexp);
+    regexMatchCountWithLines(s, regexp, lines);
+    setRegexLinearMatchingEnabled(true);
+    return boolToString(match) + " " + std::to_string(count) + " " + lines.toString();
+}
+
+// asserts that both matchers agree on s; returns false if they don't
+static bool assertSameMatches(const std::string& s, const std::string& regexp) {
+    std::string linear = matchSummary(s, regexp, true);
+    std::string standard = matchSummary(s, regexp, false);
+    if (linear != standard) {
+        assertEqualsString("/" + regexp + "/ in \"" + s + "\"", standard, linear);
+        return false;
+    }
+    return true;
+}
+
+static std::string randomPattern(std::mt19937& rng, int depth) {
+    static const Vector<std::string> atoms {
+        "a", "b", "\\n", ".", "[ab]", "[^a]", "\\s", "\\w", "^", "$", "(?:ab)", "x"
+    };
+    static const Vector<std::string> quantifiers {
+        "", "", "", "*", "+", "?", "*?", "+?", "??", "{2}", "{1,3}", "{0,2}?", "{2,}"
+    };
+    std::string pattern;
+    int pieces = 1 + rng() % 3;
+    for (int i = 0; i < pieces; i++) {
+        int kind = rng() % 10;
+        if (kind < 3 && depth < 2) {
+            // only ? on groups, since repeating a group that can match the
+            // empty string makes std::regex take exponential time
+            pattern += (kind < 2 ? "(" : "(?:") + randomPattern(rng, depth + 1)
+                    + (kind < 2 ? "|" + randomPattern(rng, depth + 1) : "")
+                    + ")" + (rng() % 2 ? "?" : "");
+        } else {
+            pattern += atoms[rng() % atoms.size()] + quantifiers[rng() % quantifiers.size()];
+        }
+    }
+    return pattern;
+}
+
+TIMED_TEST(RegexTests, backtrackingPatternTest, TEST_TIMEOUT_DEFAULT) {
+    // exponential for a backtracking matcher, immediate for the linear one
+    std::string text(30, 'a');
+    assertFalse("(a|aa)*b on 30 a's", regexMatch(text, "(a|aa)*b"));
+    assertTrue("(a|aa)*b on 30 a's and b", regexMatch(text + "b", "(a|aa)*b"));
+}
+
+TIMED_TEST(RegexTests, fixedAgreementTest, TEST_TIMEOUT_DEFAULT) {
+    const Vector<std::string> patterns {
+        "a", "ab|a", "a|ab", "a*", "a*?", "a+?b", "(a|b)*c", "a{2,3}", "a{2,3}?",
+        "a{0,2}b", "a{2,}", "^a", "a$", "^$", "^", "$", "a?", "(?:ab)+", "[^a]+",
+        "[a-c]+", "[-a]", "[a-]", "\\d+", "\\D", "\\w+", "\\W", "\\s+", "\\S+",
+        "[\\d.]+", "\\.", "\\x41", "\\u0042", "\\cJ", "\\t", "[\\n]", ".",
+        ".*", ".*;.*;.*;", "\\r?\\n[ \\t]*\\r?\\n", ".{5,}\\n", "(a|aa)*b",
+        "(\\/\\/.*)|(\\/\\*([^*]|([*][^\\/])\\r?\\n?)*\\*\\/)", "[!=]=[ \\t]*(true|false)",
+        "(?:int|double)[ \\t]*\\*", "x*|b", "(a*)*b", "(a|)+", "\\bint\\b", "(a)\\1",
+        "a(?=b)"
+    };
+    const Vector<std::string> texts {
+        "", "a", "aa", "aab", "ab\nab", "abcabc", "baaac", "aaaa\n\naaaa", "x = 1.5;\n",
+        "int* p; double *q;", "// note\nint x; /* block\n * comment */ y;",
+        "if (x == true) { y != false; }\n\n  \t\nAB\tA", "a;b;c;d;\n;;;\n",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaab", "\r\n\r\n", "abc\ndefghij\n"
+    };
+    for (const std::string& pattern : patterns) {
+        for (const std::string& text : texts) {
+            assertSameMatches(text, pattern);
+        }
+    }
+}
+
+TIMED_TEST(RegexTests, randomAgreementTest, TEST_TIMEOUT_DEFAULT) {
+    std::mt19937 rng(20181015);
+    const std::string alphabet = "aab \nx";
+    bool ok = true;
+    for (int i = 0; i < 3000 && ok; i++) {
+        std::string pattern = randomPattern(rng, 0);
+        try {
+            std::regex parsed(pattern);
+        } catch (const std::regex_error&) {
+            continue;   // such as a quantified ^, which std::regex rejects
+        }
+        for (int j = 0; j < 5 && ok; j++) {
+            std::string text;
+            int length = rng() % 20;
+            for (int k = 0; k < length; k++) {
+                text += alphabet[rng() % alphabet.size()];
+            }
+            ok = assertSameMatches(text, pattern);
+        }
+    }
+}
+
+TIMED_TEST(RegexTests, styleRuleAgreementTest, TEST_TIMEOUT_DEFAULT) {
+    // rules from stylecheck-mainfunc-cpp.xml, with (:SPACES:) and (:IDENT:)
+    // expanded as stylecheck.cpp does, over a student-like source file
+    const std::string spaces = "(?:[ \\t]{0,999})";
+    const std::string ident = "(?:[a-zA-Z_$][a-zA-Z0-9_$]{0,255})";
+    const Vector<std::string> patterns {
+        "Grid" + spaces + "<" + spaces + "(?:int|double|string)" + spaces + ">",
+        "num(?:Rows|Cols)" + spaces + "\\(" + spaces + "\\)" + spaces + "[+]" + spaces + "2",
+        "\\[[^\\]]+\\]" + spaces + "=" + spaces + "(?:true|false|0|1|'X'|'-')" + spaces + ";",
+        "(?:printf)|(?:scanf)",
+        ".{101,}\\n",
+        ".*;.*;.*;",
+        "\\r?\\n" + spaces + "\\r?\\n",
+        "\\n" + ident + "[^()\\n]*" + ident + spaces + "\\([^\\)]*\\)[ \\t\\n]{0,255}\\{",
+        "[!=]=" + spaces + "(true|false)",
+        "else" + spaces + "if",
+        "(\\/\\/.*)|(\\/\\*([^*]|([*][^\\/])\\r?\\n?)*\\*\\/)"
+    };
+    const std::string source =
+            "/*\n * Prints the cells of the grid.\n */\n"
+            "void printGrid(const Grid<int>& grid, int rows, int cols) {\n"
+            "    for (int r = 0; r < grid.numRows(); r++) {\n"
+            "        for (int c = 0; c < grid.numCols(); c++) {\n"
+            "            if (grid[r][c] == 1) {   // a living cell\n"
+            "                cout << \"X\";\n"
+            "            } else if (isAlive == true) {\n"
+            "                cout << \"-\";\n"
+            "            }\n"
+            "        }\n"
+            "        cout << endl;\n"
+            "    }\n"
+            "}\n\n"
+            "int main() {\n"
+            "    printf(\"%d\\n\", 42);   // " + std::string(120, 'x') + "\n"
+            "}\n";
+    for (const std::string& pattern : patterns) {
+        assertSameMatches(source, pattern);
+    }
+}
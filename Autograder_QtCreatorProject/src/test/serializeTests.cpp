@@ -0,0 +1,225 @@
+/*
+ * Test file for verifying the Stanford C++ lib serialize functionality.
+ */
+
+#include "testcases.h"
+#include "assertions.h"
+#include "basicgraph.h"
+#include "grid.h"
+#include "gtest-marty.h"
+#include "hashmap.h"
+#include "hashset.h"
+#include "lexicon.h"
+#include "map.h"
+#include "serialize.h"
+#include "set.h"
+#include "vector.h"
+#include <cstdio>
+#include <sstream>
+#include <streambuf>
+#include <string>
+
+TEST_CATEGORY(SerializeTests, "serialize tests");
+
+// writes the collection and reads it back into another one; returns true
+// if the read worked and used up all of the data
+template <typename FromType, typename ToType>
+static bool roundTrip(const FromType& from, ToType& to) {
+    std::stringstream stream;
+    serialize(stream, from);
+    deserialize(stream, to);
+    return !stream.fail() && stream.peek() == EOF;
+}
+
+/*
+ * A stream buffer over a string that cannot seek, like a pipe, so that
+ * deserialize cannot find out how much data is left.
+ */
+class UnseekableBuffer : public std::streambuf {
+public:
+    explicit UnseekableBuffer(std::string& data) {
+        setg(&data[0], &data[0], &data[0] + data.length());
+    }
+};
+
+// a header for the given kind of collection followed by sizes of 2^31 - 1
+static std::string oversized(char kind, int sizeCount) {
+    std::string data = std::string("SPLB\x01", 5) + kind;
+    for (int i = 0; i < sizeCount; i++) {
+        data += std::string("\xff\xff\xff\x7f", 4);
+    }
+    return data;
+}
+
+// deserializes the data from both a string stream and an unseekable stream;
+// returns true if both fail
+template <typename CollectionType>
+static bool failsBothWays(std::string data) {
+    CollectionType collection;
+    std::stringstream seekable(data);
+    bool seekableFailed = deserialize(seekable, collection).fail();
+    UnseekableBuffer buffer(data);
+    std::istream unseekable(&buffer);
+    return seekableFailed && deserialize(unseekable, collection).fail();
+}
+
+TIMED_TEST(SerializeTests, badInputTest, TEST_TIMEOUT_DEFAULT) {
+    Vector<int> ints {1, 2, 3};
+    Map<std::string, int> map;
+    std::stringstream wrongKind;
+    serialize(wrongKind, ints);
+    assertTrue("wrong kind of collection fails", deserialize(wrongKind, map).fail());
+
+    std::stringstream text("{1, 2, 3}");
+    assertTrue("text fails", deserialize(text, ints).fail());
+
+    Vector<std::string> strings {"", "a", "hello world", std::string(1000, 'x')};
+    std::stringstream whole;
+    serialize(whole, strings);
+    std::string data = whole.str();
+    std::stringstream truncated(data.substr(0, data.length() - 10));
+    Vector<std::string> strings2;
+    assertTrue("truncated data fails", deserialize(truncated, strings2).fail());
+}
+
+TIMED_TEST(SerializeTests, graphRoundTripTest, TEST_TIMEOUT_DEFAULT) {
+    BasicGraph graph;
+    graph.addNode("a");
+    graph.addNode("b");
+    graph.addNode("c");
+    graph.addEdge("a", "b", 2.5);
+    graph.addEdge("b", "c", 1);
+    graph.addEdge("c", "a", 7);
+    BasicGraph graph2;
+    assertTrue("BasicGraph round trip", roundTrip(graph, graph2));
+    assertEqualsInt("node count", 3, graph2.size());
+    assertEqualsInt("edge count", 3, graph2.getEdgeSet().size());
+    assertNotNull("edge a-b", graph2.getEdge("a", "b"));
+    assertEqualsDouble("edge a-b cost", 2.5, graph2.getEdge("a", "b")->cost);
+    assertNotNull("edge c-a", graph2.getEdge("c", "a"));
+    assertNull("no edge a-c", graph2.getEdge("a", "c"));
+}
+
+TIMED_TEST(SerializeTests, gridRoundTripTest, TEST_TIMEOUT_DEFAULT) {
+    Grid<double> grid(3, 4);
+    for (int r = 0; r < 3; r++) {
+        for (int c = 0; c < 4; c++) {
+            grid[r][c] = r + c / 10.0;
+        }
+    }
+    Grid<double> grid2;
+    assertTrue("Grid<double> round trip", roundTrip(grid, grid2));
+    assertEqualsString("Grid<double>", grid.toString(), grid2.toString());
+
+    Grid<std::string> empty;
+    Grid<std::string> empty2(2, 2);
+    assertTrue("empty Grid<string> round trip", roundTrip(empty, empty2));
+    assertTrue("empty Grid<string>", empty2.isEmpty());
+}
+
+TIMED_TEST(SerializeTests, mapRoundTripTest, TEST_TIMEOUT_DEFAULT) {
+    Map<std::string, int> map {{"a", 1}, {"b", 2}, {"c", 3}};
+    Map<std::string, int> map2;
+    assertTrue("Map round trip", roundTrip(map, map2));
+    assertEqualsString("Map", map.toString(), map2.toString());
+
+    HashMap<std::string, int> hashMap;
+    assertTrue("Map read as HashMap", roundTrip(map, hashMap));
+    assertEqualsInt("HashMap size", 3, hashMap.size());
+    assertEqualsInt("HashMap value", 2, hashMap["b"]);
+
+    HashMap<std::string, Vector<int>> nested {{"one", {1}}, {"none", {}}, {"three", {1, 2, 3}}};
+    HashMap<std::string, Vector<int>> nested2;
+    assertTrue("HashMap of Vectors round trip", roundTrip(nested, nested2));
+    assertTrue("HashMap of Vectors", nested2 == nested);
+}
+
+TIMED_TEST(SerializeTests, multipleCollectionsTest, TEST_TIMEOUT_DEFAULT) {
+    // several collections in one stream are read back in order
+    Vector<int> ints {3, -1, 4};
+    Map<std::string, int> map {{"a", 1}, {"b", 2}};
+    std::stringstream stream;
+    serialize(stream, ints);
+    serialize(stream, map);
+    Vector<int> first;
+    Map<std::string, int> second;
+    deserialize(stream, first);
+    deserialize(stream, second);
+    assertFalse("stream state", stream.fail());
+    assertEqualsString("first collection", ints.toString(), first.toString());
+    assertEqualsString("second collection", map.toString(), second.toString());
+}
+
+TIMED_TEST(SerializeTests, oversizedSizeTest, TEST_TIMEOUT_DEFAULT) {
+    // the size of each collection claims far more data than there is
+    assertTrue("oversized Vector", failsBothWays<Vector<int>>(oversized(1, 1)));
+    assertTrue("oversized string", failsBothWays<Vector<std::string>>(
+                   oversized(1, 0) + std::string("\x01\x00\x00\x00", 4) + std::string("\xff\xff\xff\x7f", 4)));
+    assertTrue("oversized Grid", failsBothWays<Grid<char>>(
+                   oversized(2, 0) + std::string("\xff\xff\x00\x00\xff\x7f\x00\x00", 8)));
+    assertTrue("Grid whose size overflows", failsBothWays<Grid<int>>(
+                   oversized(2, 0) + std::string("\x03\x00\x00\x00\x02\x00\x00\x7d", 8)));
+    assertTrue("oversized HashMap", (failsBothWays<HashMap<int, int>>(oversized(3, 1))));
+    assertTrue("oversized HashSet", failsBothWays<HashSet<std::string>>(oversized(4, 1)));
+}
+
+TIMED_TEST(SerializeTests, setRoundTripTest, TEST_TIMEOUT_DEFAULT) {
+    Set<std::string> set {"x", "y", "z"};
+    HashSet<std::string> hashSet;
+    assertTrue("Set read as HashSet", roundTrip(set, hashSet));
+    assertEqualsInt("HashSet size", 3, hashSet.size());
+    assertTrue("HashSet contains", hashSet.contains("y"));
+
+    Lexicon lex;
+    assertTrue("HashSet read as Lexicon", roundTrip(hashSet, lex));
+    assertEqualsInt("Lexicon size", 3, lex.size());
+    assertTrue("Lexicon contains", lex.contains("z"));
+}
+
+TIMED_TEST(SerializeTests, truncatedSizeTest, TEST_TIMEOUT_DEFAULT) {
+    // the data ends partway through a collection's size
+    assertTrue("truncated Vector size", failsBothWays<Vector<int>>(oversized(1, 1).substr(0, 8)));
+    assertTrue("truncated Grid size", failsBothWays<Grid<int>>(oversized(2, 2).substr(0, 10)));
+    assertTrue("header only", failsBothWays<Vector<int>>(oversized(1, 0)));
+}
+
+TIMED_TEST(SerializeTests, unseekableStreamTest, TEST_TIMEOUT_DEFAULT) {
+    // collections larger than what is reserved in advance still read back
+    // from a stream that cannot tell how much data it holds
+    Vector<int> ints;
+    for (int i = 0; i < 300000; i++) {
+        ints.add(i * 3);
+    }
+    Grid<std::string> grid(400, 300, "cell");
+    grid[399][299] = "last";
+    std::stringstream stream;
+    serialize(stream, ints);
+    serialize(stream, grid);
+    std::string data = stream.str();
+    UnseekableBuffer buffer(data);
+    std::istream unseekable(&buffer);
+    Vector<int> ints2;
+    Grid<std::string> grid2;
+    deserialize(unseekable, ints2);
+    deserialize(unseekable, grid2);
+    assertFalse("stream state", unseekable.fail());
+    assertTrue("Vector from unseekable stream", ints2 == ints);
+    assertTrue("Grid from unseekable stream", grid2 == grid);
+}
+
+TIMED_TEST(SerializeTests, vectorRoundTripTest, TEST_TIMEOUT_DEFAULT) {
+    Vector<int> ints {3, -1, 4, 1, -5, 9};
+    Vector<int> ints2 {7};
+    assertTrue("Vector<int> round trip", roundTrip(ints, ints2));
+    assertEqualsString("Vector<int>", ints.toString(), ints2.toString());
+
+    Vector<std::string> strings {"", "a", "hello world", std::string(100000, 'x')};
+    Vector<std::string> strings2;
+    assertTrue("Vector<string> round trip", roundTrip(strings, strings2));
+    assertTrue("Vector<string>", strings2 == strings);
+
+    Vector<bool> bools {true, false, true};
+    Vector<bool> bools2;
+    assertTrue("Vector<bool> round trip", roundTrip(bools, bools2));
+    assertEqualsString("Vector<bool>", bools.toString(), bools2.toString());
+}
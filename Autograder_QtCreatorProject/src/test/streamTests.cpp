@@ -0,0 +1,103 @@
+/*
+ * Test file for verifying the Stanford C++ lib functional stream functionality.
+ * Stream pipelines, sequential or parallel, must give the same results as
+ * the eager filter/map/reduce functions.
+ */
+
+#include "testcases.h"
+#include "assertions.h"
+#include "functional.h"
+#include "grid.h"
+#include "gtest-marty.h"
+#include "hashset.h"
+#include "vector.h"
+#include <string>
+
+TEST_CATEGORY(StreamTests, "stream tests");
+
+static bool isEven(int n) {
+    return n % 2 == 0;
+}
+
+static long long squared(int n) {
+    return (long long) n * n % 1000;
+}
+
+static long long add(long long a, long long b) {
+    return a + b;
+}
+
+// the integers from 0 up to but not including size
+static Vector<int> numbers(int size) {
+    Vector<int> v;
+    for (int i = 0; i < size; i++) {
+        v.add(i);
+    }
+    return v;
+}
+
+TIMED_TEST(StreamTests, collectTest, TEST_TIMEOUT_DEFAULT) {
+    HashSet<int> collected;
+    functional::range(0, 100).filter(isEven).collect(collected);
+    assertEqualsInt("collect size", 50, collected.size());
+    assertTrue("collect contains", collected.contains(98) && !collected.contains(99));
+}
+
+TIMED_TEST(StreamTests, gridTest, TEST_TIMEOUT_DEFAULT) {
+    Grid<int> grid(300, 400);
+    long long expected = 0;
+    for (int r = 0; r < grid.numRows(); r++) {
+        for (int c = 0; c < grid.numCols(); c++) {
+            grid[r][c] = r * c;
+            expected += r * c;
+        }
+    }
+    long long total = functional::stream(grid).parallel()
+            .reduce(0LL, [](long long a, long long b) { return a + b; });
+    assertTrue("parallel grid sum", total == expected);
+}
+
+TIMED_TEST(StreamTests, hashSetTest, TEST_TIMEOUT_DEFAULT) {
+    // streams over other collections run sequentially even if made parallel
+    HashSet<int> set {1, 2, 3, 4, 5};
+    assertEqualsInt("sum of evens", 6, functional::stream(set).parallel().filter(isEven).sum());
+}
+
+TIMED_TEST(StreamTests, mapTypeTest, TEST_TIMEOUT_DEFAULT) {
+    // lambdas that capture, and a map to a different type
+    Vector<int> v = numbers(100000);
+    int limit = 10;
+    Vector<std::string> strings = functional::stream(v)
+            .filter([limit](int n) { return n < limit; })
+            .map([](int n) { return std::to_string(n); })
+            .toVector();
+    assertEqualsInt("size", 10, strings.size());
+    assertEqualsString("last", "9", strings[9]);
+}
+
+TIMED_TEST(StreamTests, rangeTest, TEST_TIMEOUT_DEFAULT) {
+    assertTrue("sum of squares", functional::range(0, 10).map(squared).sum() == 285);
+    assertEqualsInt("empty range", 0, functional::range(10, 0).count());
+}
+
+TIMED_TEST(StreamTests, reduceTest, TEST_TIMEOUT_DEFAULT) {
+    Vector<int> v = numbers(100000);
+    Vector<long long> squares;
+    functional::map(functional::filter(v, isEven), squared, squares);
+    long long eager = functional::reduce(squares, add, 0LL);
+    long long lazy = functional::stream(v).filter(isEven).map(squared).reduce(0LL, add);
+    long long parallel = functional::stream(v).parallel(1000).filter(isEven).map(squared).reduce(0LL, add);
+    assertTrue("stream reduce", lazy == eager);
+    assertTrue("parallel stream reduce", parallel == eager);
+    assertEqualsInt("parallel count", 50000, functional::stream(v).parallel(1000).filter(isEven).count());
+}
+
+TIMED_TEST(StreamTests, toVectorTest, TEST_TIMEOUT_DEFAULT) {
+    Vector<int> v = numbers(100000);
+    Vector<long long> expected;
+    functional::map(functional::filter(v, isEven), squared, expected);
+    Vector<long long> lazy = functional::stream(v).filter(isEven).map(squared).toVector();
+    Vector<long long> parallel = functional::stream(v).filter(isEven).map(squared).parallel(777).toVector();
+    assertTrue("stream toVector", lazy == expected);
+    assertTrue("parallel stream toVector", parallel == expected);
+}
@@ -8,12 +8,35 @@
 #include "strlib.h"
 #include <iostream>
 #include <string>
+#include <vector>
 //using namespace std;
 
 #define TEST_TIMEOUT_DEFAULT 3000
 
 TEST_CATEGORY(StringTests, "string tests");
 
+// returns the pieces in a form like {"a", "", "b"} for comparing in tests
+template <typename PieceType>
+static std::string piecesToString(const std::vector<PieceType>& pieces) {
+    std::string result = "{";
+    for (size_t i = 0; i < pieces.size(); i++) {
+        if (i > 0) {
+            result += ", ";
+        }
+        result += "\"" + std::string(pieces[i].begin(), pieces[i].end()) + "\"";
+    }
+    return result + "}";
+}
+
+// the inputs given to each split test, and the pieces that each one splits into on ','
+static const std::vector<std::string> SPLIT_INPUTS {
+    "", ",", "a", "a,b", ",a,,b,", "one,two,,three", "no delimiters here"
+};
+static const std::vector<std::string> SPLIT_PIECES {
+    "{}", "{\"\"}", "{\"a\"}", "{\"a\", \"b\"}", "{\"\", \"a\", \"\", \"b\"}",
+    "{\"one\", \"two\", \"\", \"three\"}", "{\"no delimiters here\"}"
+};
+
 TIMED_TEST(StringTests, diffOutputFailTest, TEST_TIMEOUT_DEFAULT) {
     std::string exp = "Hi\nyo\nbye\nok\nthe end";
     std::string stu = "Hi\nOOPS\nbye\nDOH\nthe end";
@@ -29,3 +52,93 @@ TIMED_TEST(StringTests, stringToIntegerTest, TEST_TIMEOUT_DEFAULT) {
 TIMED_TEST(StringTests, stringToIntegerInvalidRadixTest, TEST_TIMEOUT_DEFAULT) {
     assertThrows("expect exception on converting stringToInteger with radix 0", stringToInteger("234", /* radix */ 0);, ErrorException);
 }
+
+TIMED_TEST(StringTests, htmlEncodeTest, TEST_TIMEOUT_DEFAULT) {
+    std::string html = "<a href=\"x&y\">1 < 2</a>";
+    std::string encoded = htmlEncode(html);
+    assertEqualsString("htmlEncode", "&lt;a href=&quot;x&amp;y&quot;&gt;1 &lt; 2&lt;/a&gt;", encoded);
+    assertEqualsString("htmlDecode", html, htmlDecode(encoded));
+    assertEqualsString("htmlEncode plain", "plain text", htmlEncode("plain text"));
+}
+
+TIMED_TEST(StringTests, stringJoinTest, TEST_TIMEOUT_DEFAULT) {
+    std::vector<std::string> pieces {"a", "", "bc", "def"};
+    assertEqualsString("string delimiter", "a----bc--def", stringJoin(pieces, "--"));
+    assertEqualsString("char delimiter", "a,,bc,def", stringJoin(pieces, ','));
+    assertEqualsString("empty delimiter", "abcdef", stringJoin(pieces, ""));
+    assertEqualsString("one piece", "a", stringJoin(std::vector<std::string> {"a"}, ", "));
+    assertEqualsString("no pieces", "", stringJoin(std::vector<std::string>(), ", "));
+}
+
+TIMED_TEST(StringTests, stringReplaceTest, TEST_TIMEOUT_DEFAULT) {
+    std::string text = "aXbXXc";
+    int count = stringReplaceInPlace(text, "X", "YYY");
+    assertEqualsInt("replace count", 3, count);
+    assertEqualsString("replace growing", "aYYYbYYYYYYc", text);
+    assertEqualsString("replace shrinking", "abc", stringReplace("aXYbXYc", "XY", ""));
+    assertEqualsString("replacement contains old", "aaaa", stringReplace("aa", "a", "aa"));
+    assertEqualsString("replace limit", "a-b,c", stringReplace("a,b,c", ",", "-", 1));
+}
+
+TIMED_TEST(StringTests, stringSplitTest, TEST_TIMEOUT_DEFAULT) {
+    for (size_t i = 0; i < SPLIT_INPUTS.size(); i++) {
+        assertEqualsString("split \"" + SPLIT_INPUTS[i] + "\" on string",
+                           SPLIT_PIECES[i], piecesToString(stringSplit(SPLIT_INPUTS[i], ",")));
+        assertEqualsString("split \"" + SPLIT_INPUTS[i] + "\" on char",
+                           SPLIT_PIECES[i], piecesToString(stringSplit(SPLIT_INPUTS[i], ',')));
+    }
+    assertEqualsString("multi-character delimiter", "{\"a\", \"b\", \"c\"}",
+                       piecesToString(stringSplit("a::b::c", "::")));
+}
+
+TIMED_TEST(StringTests, stringSplitterTest, TEST_TIMEOUT_DEFAULT) {
+    for (size_t i = 0; i < SPLIT_INPUTS.size(); i++) {
+        std::vector<StringView> pieces;
+        for (StringView piece : StringSplitter(SPLIT_INPUTS[i], ',')) {
+            pieces.push_back(piece);
+        }
+        assertEqualsString("split \"" + SPLIT_INPUTS[i] + "\"", SPLIT_PIECES[i], piecesToString(pieces));
+    }
+    StringSplitter splitter("a;b", ';');
+    std::string first = splitter.next().toString();
+    std::string second = splitter.next().toString();
+    assertEqualsString("first piece", "a", first);
+    assertEqualsString("second piece", "b", second);
+    assertFalse("no more pieces", splitter.hasNext());
+    assertThrows("next past the end", splitter.next();, ErrorException);
+}
+
+TIMED_TEST(StringTests, stringSplitViewTest, TEST_TIMEOUT_DEFAULT) {
+    for (size_t i = 0; i < SPLIT_INPUTS.size(); i++) {
+        assertEqualsString("split \"" + SPLIT_INPUTS[i] + "\" on char",
+                           SPLIT_PIECES[i], piecesToString(stringSplitView(SPLIT_INPUTS[i], ',')));
+        assertEqualsString("split \"" + SPLIT_INPUTS[i] + "\" on string",
+                           SPLIT_PIECES[i], piecesToString(stringSplitView(SPLIT_INPUTS[i], ",")));
+    }
+
+    // the views point into the original string rather than copying it
+    std::string text = "key=value";
+    std::vector<StringView> pieces = stringSplitView(text, '=');
+    assertTrue("view refers to original", pieces[1].data() == text.data() + 4);
+}
+
+TIMED_TEST(StringTests, stringViewTest, TEST_TIMEOUT_DEFAULT) {
+    std::string text = "hello world";
+    StringView view(text);
+    assertEqualsInt("length", 11, view.length());
+    assertEqualsString("substr", "world", view.substr(6).toString());
+    assertEqualsString("substr with length", "lo w", view.substr(3, 4).toString());
+    assertEqualsString("substr past the end", "", view.substr(20).toString());
+    assertTrue("== std::string", view.substr(0, 5) == StringView("hello"));
+    assertTrue("!=", view != StringView("hello"));
+    assertTrue("<", StringView("abc") < StringView("abd"));
+    assertTrue("prefix <", StringView("ab") < StringView("abc"));
+    assertTrue("empty", StringView().empty());
+}
+
+TIMED_TEST(StringTests, urlEncodeTest, TEST_TIMEOUT_DEFAULT) {
+    std::string url = "a b&c=d/e~f*g\xe9";
+    std::string encoded = urlEncode(url);
+    assertEqualsString("urlEncode", "a+b%26c%3Dd%2Fe~f*g%E9", encoded);
+    assertEqualsString("urlDecode", url, urlDecode(encoded));
+}
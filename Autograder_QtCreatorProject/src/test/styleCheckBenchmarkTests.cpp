@@ -0,0 +1,176 @@
+/*
+ * Test file for timing the autograder's style checker over many files.
+ * Writes STYLE_CHECK_BENCHMARK_FILE_COUNT small student-like source files
+ * to a temporary directory and checks them against typical style rules:
+ * by running each rule's regex on each file, as the style checker used to,
+ * and by scanning them with a StyleCheckRuleSet, each way with std::regex
+ * and with the linear-time matcher, and the latter on one thread per core.
+ * Prints the times and checks that every way finds the same matches.
+ */
+
+#include "testcases.h"
+#include "assertions.h"
+#include "filelib.h"
+#include "gtest-marty.h"
+#include "regexpr.h"
+#include "strlib.h"
+#include "stylecheck.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+
+TEST_CATEGORY(StyleCheckBenchmarkTests, "style checker benchmark");
+
+static const int STYLE_CHECK_BENCHMARK_FILE_COUNT = 10000;
+static const int STYLE_CHECK_BENCHMARK_TIMEOUT_MS = 120000;
+
+// rules like those in res/stylecheck-mainfunc-cpp.xml
+static const char* const STYLE_CHECK_BENCHMARK_XML =
+        "<stylecheck>\n"
+        "<pattern regex=\"Grid(:SPACES:)&lt;(:SPACES:)(?:int|double|string)(:SPACES:)&gt;\" />\n"
+        "<pattern regex=\"num(?:Rows|Cols)(:SPACES:)\\((:SPACES:)\\)(:SPACES:)[+](:SPACES:)2\" />\n"
+        "<pattern regex=\"\\[[^\\]]+\\](:SPACES:)=(:SPACES:)(?:true|false|0|1|'X'|'-')(:SPACES:);\" />\n"
+        "<pattern regex=\"(?:printf)|(?:scanf)\" />\n"
+        "<pattern regex=\".{101,}\\n\" />\n"
+        "<pattern regex=\".*;.*;.*;\" />\n"
+        "<pattern regex=\"\\r?\\n(:SPACES:)\\r?\\n\" />\n"
+        "<pattern regex=\"[!=]=(:SPACES:)(true|false)\" />\n"
+        "<pattern regex=\"else(:SPACES:)if\" />\n"
+        "<pattern regex=\"(\\/\\/.*)|(\\/\\*([^*]|([*][^\\/])\\r?\\n?)*\\*\\/)\" />\n"
+        "</stylecheck>\n";
+
+// a source file of about 600 bytes; i varies its names and style problems
+static std::string styleCheckBenchmarkSource(int i) {
+    std::string n = integerToString(i);
+    std::string source =
+            "/*\n * Prints the cells of grid " + n + ".\n */\n"
+            "void printGrid" + n + "(const Grid<int>& grid) {\n"
+            "    for (int r = 0; r < grid.numRows(); r++) {\n"
+            "        for (int c = 0; c < grid.numCols(); c++) {\n"
+            "            if (grid[r][c] == " + integerToString(i % 3) + ") {   // a living cell\n"
+            "                cout << \"X\";\n";
+    if (i % 2 == 0) {
+        source += "            } else if (isAlive == true) {\n";
+    } else {
+        source += "            } else {\n";
+    }
+    source +=
+            "                cout << \"-\";\n"
+            "            }\n"
+            "        }\n"
+            "        cout << endl;\n"
+            "    }\n"
+            "}\n";
+    if (i % 5 == 0) {
+        source += "\n\nint x" + n + " = 0; int y = 0; int z = 0;\n";
+    }
+    return source;
+}
+
+// the total number of matches, and a checksum of their line numbers
+struct StyleCheckBenchmarkTotals {
+    long matches;
+    long lines;
+
+    StyleCheckBenchmarkTotals() : matches(0), lines(0) {}
+
+    void add(int matchCount, const Vector<int>& matchLines) {
+        matches += matchCount;
+        for (int line : matchLines) {
+            lines += line;
+        }
+    }
+};
+
+static double styleCheckBenchmarkMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// checks each file by running each rule's regex on it, as styleCheck used to
+static double styleCheckBenchmarkPerRule(const stylecheck::StyleCheckRuleSet& ruleSet,
+                                         const Vector<std::string>& files,
+                                         StyleCheckBenchmarkTotals& totals) {
+    auto start = std::chrono::steady_clock::now();
+    for (const std::string& file : files) {
+        std::string text = readEntireFile(file);
+        for (int r = 0; r < ruleSet.size(); r++) {
+            Vector<int> lines;
+            regexMatchCountWithLines(text, ruleSet.getRule(r).regexText, lines);
+            totals.add(lines.size(), lines);
+        }
+    }
+    return styleCheckBenchmarkMs(start);
+}
+
+static double styleCheckBenchmarkRuleSet(const stylecheck::StyleCheckRuleSet& ruleSet,
+                                         const Vector<std::string>& files, int threadCount,
+                                         StyleCheckBenchmarkTotals& totals) {
+    auto start = std::chrono::steady_clock::now();
+    Vector<Vector<stylecheck::StyleCheckResult> > results = ruleSet.scanFiles(files, threadCount);
+    double ms = styleCheckBenchmarkMs(start);
+    for (const Vector<stylecheck::StyleCheckResult>& fileResults : results) {
+        for (const stylecheck::StyleCheckResult& result : fileResults) {
+            totals.add(result.matchCount, result.lines);
+        }
+    }
+    return ms;
+}
+
+TIMED_TEST(StyleCheckBenchmarkTests, manyFilesTest, STYLE_CHECK_BENCHMARK_TIMEOUT_MS) {
+    std::string dir = getTempDirectory() + "/stylecheck-benchmark";
+    if (!fileExists(dir)) {
+        createDirectory(dir);
+    }
+    std::string xmlFile = dir + "/stylecheck.xml";
+    writeEntireFile(xmlFile, STYLE_CHECK_BENCHMARK_XML);
+    Vector<std::string> files;
+    long bytes = 0;
+    for (int i = 0; i < STYLE_CHECK_BENCHMARK_FILE_COUNT; i++) {
+        std::string source = styleCheckBenchmarkSource(i);
+        files.add(dir + "/student" + integerToString(i) + ".cpp");
+        writeEntireFile(files[i], source);
+        bytes += (long) source.length();
+    }
+    stylecheck::StyleCheckRuleSet ruleSet(xmlFile);
+
+    StyleCheckBenchmarkTotals stdTotals;
+    StyleCheckBenchmarkTotals linearTotals;
+    StyleCheckBenchmarkTotals ruleSetStdTotals;
+    StyleCheckBenchmarkTotals serialTotals;
+    StyleCheckBenchmarkTotals parallelTotals;
+    setRegexLinearMatchingEnabled(false);
+    double stdMs = styleCheckBenchmarkPerRule(ruleSet, files, stdTotals);
+    double ruleSetStdMs = styleCheckBenchmarkRuleSet(ruleSet, files, 1, ruleSetStdTotals);
+    setRegexLinearMatchingEnabled(true);
+    double linearMs = styleCheckBenchmarkPerRule(ruleSet, files, linearTotals);
+    double serialMs = styleCheckBenchmarkRuleSet(ruleSet, files, 1, serialTotals);
+    double parallelMs = styleCheckBenchmarkRuleSet(ruleSet, files, 0, parallelTotals);
+
+    for (const std::string& file : files) {
+        deleteFile(file);
+    }
+    deleteFile(xmlFile);
+    deleteFile(dir);
+
+    std::cout << std::fixed << std::setprecision(1)
+              << ruleSet.size() << " rules over " << files.size() << " files ("
+              << bytes / 1000 << " KB):" << std::endl
+              << "  each rule on each file: " << stdMs << " ms std::regex, "
+              << linearMs << " ms linear" << std::endl
+              << "  StyleCheckRuleSet: " << ruleSetStdMs << " ms std::regex, "
+              << serialMs << " ms linear, " << parallelMs << " ms linear on "
+              << std::thread::hardware_concurrency() << " threads" << std::endl;
+
+    assertTrue("rule set loaded", ruleSet.isLoaded());
+    assertTrue("rules matched", stdTotals.matches > 0);
+    assertEqualsInt("linear match count", (int) stdTotals.matches, (int) linearTotals.matches);
+    assertEqualsInt("linear match lines", (int) stdTotals.lines, (int) linearTotals.lines);
+    assertEqualsInt("rule set std::regex match count", (int) stdTotals.matches, (int) ruleSetStdTotals.matches);
+    assertEqualsInt("rule set std::regex match lines", (int) stdTotals.lines, (int) ruleSetStdTotals.lines);
+    assertEqualsInt("rule set match count", (int) stdTotals.matches, (int) serialTotals.matches);
+    assertEqualsInt("rule set match lines", (int) stdTotals.lines, (int) serialTotals.lines);
+    assertEqualsInt("parallel match count", (int) stdTotals.matches, (int) parallelTotals.matches);
+    assertEqualsInt("parallel match lines", (int) stdTotals.lines, (int) parallelTotals.lines);
+}
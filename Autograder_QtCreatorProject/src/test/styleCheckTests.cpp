@@ -0,0 +1,85 @@
+/*
+ * Test file for verifying the Stanford C++ autograder style checker.
+ */
+
+#include "testcases.h"
+#include "assertions.h"
+#include "filelib.h"
+#include "gtest-marty.h"
+#include "strlib.h"
+#include "stylecheck.h"
+#include <regex>
+#include <string>
+
+TEST_CATEGORY(StyleCheckTests, "style check tests");
+
+/*
+ * Writes the given regexes to a temporary style check XML file and checks
+ * that the rule set built from it finds as many matches of each one in the
+ * given code as running its regex directly does, and that each rule's
+ * required literal is the expected one.
+ */
+static void styleCheckLiteralTestHelper(const Vector<std::string>& regexes,
+                                        const Vector<std::string>& literals,
+                                        const std::string& code) {
+    std::string xmlFile = getTempDirectory() + "/stylecheck-test-" + integerToString(regexes.size()) + ".xml";
+    std::string xml = "<stylecheck>\n";
+    for (const std::string& regex : regexes) {
+        xml += "<pattern regex=\"" + regex + "\" />\n";
+    }
+    xml += "</stylecheck>\n";
+    writeEntireFile(xmlFile, xml);
+    stylecheck::StyleCheckRuleSet ruleSet(xmlFile);
+    deleteFile(xmlFile);
+
+    assertTrue("rule set loaded", ruleSet.isLoaded());
+    assertEqualsInt("rule count", regexes.size(), ruleSet.size());
+    Vector<stylecheck::StyleCheckResult> results = ruleSet.scan(code);
+    for (int i = 0; i < regexes.size(); i++) {
+        std::regex regex(regexes[i]);
+        int expectedCount = (int) std::distance(
+                    std::sregex_iterator(code.begin(), code.end(), regex),
+                    std::sregex_iterator());
+        assertEqualsString("literal for " + regexes[i], literals[i], ruleSet.getRule(i).literal);
+        assertEqualsInt("match count for " + regexes[i], expectedCount, results[i].matchCount);
+    }
+}
+
+TIMED_TEST(StyleCheckTests, requiredLiteralPlainTest, TEST_TIMEOUT_DEFAULT) {
+    styleCheckLiteralTestHelper(
+        {"goto", "while \\(true\\)", "colou?r", "a+bcd"},
+        {"goto", "while (true)", "colo", "bcd"},
+        "while (true) { goto x; }\ncolor colour abcd aabcd");
+}
+
+TIMED_TEST(StyleCheckTests, requiredLiteralHexEscapeTest, TEST_TIMEOUT_DEFAULT) {
+    // \x41 is 'A'; its digits are not literal text
+    styleCheckLiteralTestHelper(
+        {"\\x41BC", "x\\x3d+y", "\\x41\\x42"},
+        {"BC", "x", ""},
+        "ABC x==y AB 41BC");
+}
+
+TIMED_TEST(StyleCheckTests, requiredLiteralUnicodeEscapeTest, TEST_TIMEOUT_DEFAULT) {
+    // a four-digit escape such as the one for 'A' is not literal text
+    styleCheckLiteralTestHelper(
+        {"\\u0041BC", "int\\u0020main"},
+        {"BC", "main"},
+        "ABC int main 0041BC");
+}
+
+TIMED_TEST(StyleCheckTests, requiredLiteralControlEscapeTest, TEST_TIMEOUT_DEFAULT) {
+    // \cJ is a newline; the J is not literal text
+    styleCheckLiteralTestHelper(
+        {"end\\cJJava", "\\cMx"},
+        {"Java", "x"},
+        "end\nJava endJJava Java\rx");
+}
+
+TIMED_TEST(StyleCheckTests, requiredLiteralBackreferenceTest, TEST_TIMEOUT_DEFAULT) {
+    // \1 and \12 repeat a group; their digits are not literal text
+    styleCheckLiteralTestHelper(
+        {"(ab)\\1cd", "(a)(b)(c)(d)(e)(f)(g)(h)(i)(j)(k)(l)\\12z"},
+        {"cd", "z"},
+        "ababcd ab1cd abcdefghijkllz");
+}
@@ -0,0 +1,68 @@
+/*
+ * Test file for verifying the Stanford C++ lib threadpool functionality.
+ */
+
+#include "testcases.h"
+#include "assertions.h"
+#include "gtest-marty.h"
+#include "threadpool.h"
+#include <atomic>
+#include <climits>
+#include <stdexcept>
+#include <vector>
+
+TEST_CATEGORY(ThreadPoolTests, "thread pool tests");
+
+TIMED_TEST(ThreadPoolTests, parallelForTest, TEST_TIMEOUT_DEFAULT) {
+    ThreadPool pool(4);
+    std::vector<int> calls(10000);
+    pool.parallelFor(0, (int) calls.size(), [&calls](int i) { calls[i]++; });
+    for (int i = 0; i < (int) calls.size(); i++) {
+        assertEqualsInt("calls for " + std::to_string(i), 1, calls[i]);
+    }
+
+    std::atomic<long long> sum(0);
+    pool.parallelFor(10, 20, [&sum](int i) { sum += i; }, 3);
+    assertEqualsInt("grain size that does not divide the range", 145, (int) sum);
+
+    std::atomic<int> count(0);
+    pool.parallelFor(5, 5, [&count](int) { count++; });
+    pool.parallelFor(5, 0, [&count](int) { count++; });
+    assertEqualsInt("empty ranges", 0, (int) count);
+}
+
+TIMED_TEST(ThreadPoolTests, parallelForLimitsTest, TEST_TIMEOUT_DEFAULT) {
+    // the last chunk ends at INT_MAX, so stepping past it would overflow
+    ThreadPool pool(4);
+    std::atomic<long long> sum(0);
+    std::atomic<int> count(0);
+    pool.parallelFor(INT_MAX - 1000, INT_MAX, [&sum, &count](int i) {
+        sum += i;
+        count++;
+    }, 300);
+    assertEqualsInt("calls up to INT_MAX", 1000, (int) count);
+    assertTrue("indexes up to INT_MAX", sum == 1000LL * (INT_MAX - 1000) + 999 * 1000 / 2);
+
+    count = 0;
+    pool.parallelFor(INT_MIN, INT_MIN + 1000, [&count](int) { count++; }, 300);
+    assertEqualsInt("calls from INT_MIN", 1000, (int) count);
+}
+
+TIMED_TEST(ThreadPoolTests, parallelForExceptionTest, TEST_TIMEOUT_DEFAULT) {
+    ThreadPool pool(4);
+    std::atomic<int> count(0);
+    bool thrown = false;
+    try {
+        pool.parallelFor(0, 100, [&count](int i) {
+            count++;
+            if (i == 50) {
+                throw std::runtime_error("body failed");
+            }
+        }, 10);
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    assertTrue("exception rethrown", thrown);
+    // every chunk but the one that threw ran all of its calls
+    assertEqualsInt("other calls finished", 91, (int) count);
+}
@@ -0,0 +1,64 @@
+/*
+ * Test file for timing the autograder's parallel test runner.
+ * Half of these tests wait, as tests of programs that sleep or wait for a
+ * process or a server do, and half keep the CPU busy, as tests of
+ * recursive backtracking code do.  Run them in the text UI with
+ * autograder::setTestWorkerCount (see autograderMain in mainfunc.cpp) and
+ * --gtest_filter=WorkerBenchmarkTests.*, and compare the wall-clock time in
+ * the runner's report line to that of a run with no workers.
+ */
+
+#include "testcases.h"
+#include "assertions.h"
+#include "gtest-marty.h"
+#include <chrono>
+#include <thread>
+
+TEST_CATEGORY(WorkerBenchmarkTests, "parallel test runner benchmark");
+
+static const int WORKER_BENCHMARK_TEST_MS = 200;
+
+static void workerBenchmarkWait() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(WORKER_BENCHMARK_TEST_MS));
+}
+
+// a fixed amount of CPU work, about 0.1 s on a typical machine
+static int workerBenchmarkFibonacci(int n) {
+    return n < 2 ? n : workerBenchmarkFibonacci(n - 1) + workerBenchmarkFibonacci(n - 2);
+}
+
+TIMED_TEST(WorkerBenchmarkTests, waitTest1, TEST_TIMEOUT_DEFAULT) {
+    workerBenchmarkWait();
+    assertTrue("waited", true);
+}
+
+TIMED_TEST(WorkerBenchmarkTests, waitTest2, TEST_TIMEOUT_DEFAULT) {
+    workerBenchmarkWait();
+    assertTrue("waited", true);
+}
+
+TIMED_TEST(WorkerBenchmarkTests, waitTest3, TEST_TIMEOUT_DEFAULT) {
+    workerBenchmarkWait();
+    assertTrue("waited", true);
+}
+
+TIMED_TEST(WorkerBenchmarkTests, waitTest4, TEST_TIMEOUT_DEFAULT) {
+    workerBenchmarkWait();
+    assertTrue("waited", true);
+}
+
+TIMED_TEST(WorkerBenchmarkTests, cpuTest1, TEST_TIMEOUT_DEFAULT) {
+    assertEqualsInt("fib(37)", 24157817, workerBenchmarkFibonacci(37));
+}
+
+TIMED_TEST(WorkerBenchmarkTests, cpuTest2, TEST_TIMEOUT_DEFAULT) {
+    assertEqualsInt("fib(37)", 24157817, workerBenchmarkFibonacci(37));
+}
+
+TIMED_TEST(WorkerBenchmarkTests, cpuTest3, TEST_TIMEOUT_DEFAULT) {
+    assertEqualsInt("fib(37)", 24157817, workerBenchmarkFibonacci(37));
+}
+
+TIMED_TEST(WorkerBenchmarkTests, cpuTest4, TEST_TIMEOUT_DEFAULT) {
+    assertEqualsInt("fib(37)", 24157817, workerBenchmarkFibonacci(37));
+}
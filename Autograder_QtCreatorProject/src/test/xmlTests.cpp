@@ -0,0 +1,107 @@
+/*
+ * Test file for verifying the Stanford C++ lib xmlutils functionality.
+ * Checks path queries on XmlDocument and the cache of documents kept by
+ * XmlDocument::open.
+ */
+
+#include "testcases.h"
+#include "assertions.h"
+#include "filelib.h"
+#include "gtest-marty.h"
+#include "xmlutils.h"
+#include <fstream>
+#include <memory>
+#include <string>
+
+TEST_CATEGORY(XmlTests, "xml tests");
+
+// writes a stylecheck-like file with a top-level pattern and the given
+// number of categories, each holding 'patterns' patterns and a note
+static std::string writeTestFile(int categories, int patterns) {
+    std::string filename = getTempDirectory() + "/xml-test.xml";
+    std::ofstream out(filename);
+    out << "<stylecheck omitonpass=\"true\">" << std::endl;
+    out << "    <pattern regex=\"top\" />" << std::endl;
+    for (int c = 0; c < categories; c++) {
+        out << "    <category name=\"c" << c << "\">" << std::endl;
+        for (int p = 0; p < patterns; p++) {
+            out << "        <pattern regex=\"p" << p << "/x\" type=\""
+                << (p % 2 ? "warn" : "fail") << "\" />" << std::endl;
+        }
+        out << "        <note>text</note>" << std::endl;
+        out << "    </category>" << std::endl;
+    }
+    out << "</stylecheck>" << std::endl;
+    return filename;
+}
+
+TIMED_TEST(XmlTests, cacheTest, TEST_TIMEOUT_DEFAULT) {
+    // documents come from the cache until the file changes
+    std::string filename = writeTestFile(3, 4);
+    std::shared_ptr<const xmlutils::XmlDocument> first = xmlutils::XmlDocument::open(filename);
+    assertNotNull("open", first.get());
+    std::shared_ptr<const xmlutils::XmlDocument> again = xmlutils::XmlDocument::open(filename);
+    assertTrue("cached", again == first);
+
+    writeTestFile(5, 4);
+    std::shared_ptr<const xmlutils::XmlDocument> second = xmlutils::XmlDocument::open(filename);
+    assertTrue("reloaded after change", second != first);
+    assertEqualsInt("new document", 5, second->query("stylecheck/category").size());
+    assertEqualsInt("old document still usable", 3, first->query("stylecheck/category").size());
+    assertTrue("openXmlDocument uses the cache",
+               xmlutils::openXmlDocument(filename, "stylecheck") == second->getRootNode());
+
+    xmlutils::XmlDocument::clearCache();
+    std::shared_ptr<const xmlutils::XmlDocument> third = xmlutils::XmlDocument::open(filename);
+    assertTrue("reloaded after clearCache", third != second);
+    assertEqualsInt("reloaded document", 5, third->query("stylecheck/category").size());
+    deleteFile(filename);
+}
+
+TIMED_TEST(XmlTests, openErrorTest, TEST_TIMEOUT_DEFAULT) {
+    std::string missing = getTempDirectory() + "/no-such-file.xml";
+    assertTrue("missing file", !xmlutils::XmlDocument::open(missing));
+    assertNull("missing file, openXmlDocument", xmlutils::openXmlDocument(missing));
+
+    std::string filename = getTempDirectory() + "/xml-bad.xml";
+    writeEntireFile(filename, "<stylecheck><pattern></stylecheck>");
+    assertThrows("malformed file", xmlutils::XmlDocument::open(filename);, ErrorException);
+    deleteFile(filename);
+}
+
+TIMED_TEST(XmlTests, queryTest, TEST_TIMEOUT_DEFAULT) {
+    std::string filename = writeTestFile(3, 4);
+    xmlutils::XmlDocument doc(filename);
+    deleteFile(filename);
+    rapidxml::xml_node<>* root = doc.getRootNode("stylecheck");
+    assertNotNull("root", root);
+    assertTrue("root without a name", doc.getRootNode() == root);
+    assertNull("root with another name", doc.getRootNode("other"));
+
+    assertEqualsInt("top-level pattern", 1, doc.query("stylecheck/pattern").size());
+    assertEqualsInt("nested patterns", 12, doc.query("stylecheck/category/pattern").size());
+    assertEqualsInt("wildcard", 15, doc.query("stylecheck/*/*").size());
+    assertEqualsInt("attribute test", 6, doc.query("stylecheck/category/pattern[@type='warn']").size());
+    assertEqualsInt("attribute exists", 3, doc.query("/stylecheck/*[@name]").size());
+    assertEqualsString("value with slash", "warn", xmlutils::getAttribute(
+            doc.query("stylecheck/category[@name=\"c2\"]/pattern[@regex='p3/x']").first(), "type"));
+    assertTrue("no match", doc.query("stylecheck/category/missing").isEmpty());
+    assertEqualsInt("relative query", 3, xmlutils::query(root, "category/note").size());
+    assertEqualsInt("getChildNodes wildcard", 4, (int) xmlutils::getChildNodes(root).size());
+}
+
+TIMED_TEST(XmlTests, queryIteratorTest, TEST_TIMEOUT_DEFAULT) {
+    // iterating visits the nodes in document order, and an iterator stays
+    // usable after its range is gone
+    std::string filename = writeTestFile(2, 3);
+    xmlutils::XmlDocument doc(filename);
+    deleteFile(filename);
+    std::string regexes;
+    for (rapidxml::xml_node<>* pattern : doc.query("stylecheck/category/pattern")) {
+        regexes += xmlutils::getAttribute(pattern, "regex") + " ";
+    }
+    assertEqualsString("document order", "p0/x p1/x p2/x p0/x p1/x p2/x ", regexes);
+
+    xmlutils::XmlNodeRange::iterator it = doc.query("stylecheck/category[@name='c1']/note").begin();
+    assertEqualsString("iterator outlives its range", "note", std::string((*it)->name()));
+}
@@ -15,6 +15,8 @@
  * The DAWG builder code is quite a bit more intricate, see Julie Zelenski
  * if you need it.
  * 
+ * @version 2018/10/03
+ * - plain-text word files are read in bulk rather than line by line
  * @version 2018/03/10
  * - added method front
  * @version 2017/11/14
@@ -46,6 +48,7 @@
 #include <string>
 #include "collections.h"
 #include "error.h"
+#include "filelib.h"
 #include "hashcode.h"
 #include "strlib.h"
 
@@ -150,9 +153,10 @@ void DawgLexicon::addWordsFromFile(std::istream& input) {
     } else {
         // plain text file
         input.seekg(0);
-        std::string line;
-        while (getline(input, line)) {
-            add(line);
+        std::string text;
+        readEntireStream(input, text);
+        for (StringView line : StringSplitter(text, '\n')) {
+            add(line.toString());
         }
     }
 }
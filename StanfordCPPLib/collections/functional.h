@@ -23,7 +23,25 @@
  * accepts a value to remove as its parameter, and partly because the more common
  * functional style is to expect a new collection result to be returned.
  *
+ * The stream function offers the same operations, and a few more, as a lazy
+ * pipeline: nothing is computed until a final operation such as reduce or
+ * toVector is called, and then each element passes through all of the steps
+ * in turn, with no intermediate collections.  Steps can be any callable,
+ * including lambdas that capture variables, and pipelines over a Vector or
+ * Grid can be run in parallel:
+ *
+ *<pre>
+ *    long total = functional::stream(v)
+ *            .filter([](int n) { return n % 2 == 0; })
+ *            .map([&](int n) { return (long) n * scale; })
+ *            .parallel()
+ *            .reduce(0L, [](long a, long b) { return a + b; });
+ *</pre>
+ *
  * @author Marty Stepp
+ * @version 2018/10/15
+ * - filter, map, and reduce take the collection by reference, not by value
+ * - added stream, range, and the Stream class for lazy pipelines
  * @version 2018/03/10
  * - initial version
  */
@@ -31,6 +49,13 @@
 #ifndef _functional_h
 #define _functional_h
 
+#include <functional>
+#include <type_traits>
+#include <vector>
+#include "grid.h"
+#include "threadpool.h"
+#include "vector.h"
+
 namespace functional {
 
 /*
@@ -39,7 +64,7 @@ namespace functional {
  * for which the given predicate function returns true.
  */
 template <typename CollectionType, typename ElementType>
-CollectionType filter(CollectionType collection,
+CollectionType filter(const CollectionType& collection,
                       bool (*predicate)(ElementType)) {
     CollectionType result;
     for (const ElementType& element : collection) {
@@ -56,7 +81,7 @@ CollectionType filter(CollectionType collection,
  * for which the given predicate function returns true.
  */
 template <typename CollectionType, typename ElementType>
-CollectionType filter(CollectionType collection,
+CollectionType filter(const CollectionType& collection,
                       bool (*predicate)(const ElementType&)) {
     CollectionType result;
     for (const ElementType& element : collection) {
@@ -75,7 +100,7 @@ CollectionType filter(CollectionType collection,
  * A reference to that same result is returned for convenience.
  */
 template <typename CollectionType, typename ElementType>
-CollectionType& filter(CollectionType collection,
+CollectionType& filter(const CollectionType& collection,
                        bool (*predicate)(ElementType),
                        CollectionType& result) {
     for (const ElementType& element : collection) {
@@ -94,7 +119,7 @@ CollectionType& filter(CollectionType collection,
  * A reference to that same result is returned for convenience.
  */
 template <typename CollectionType, typename ElementType>
-CollectionType& filter(CollectionType collection,
+CollectionType& filter(const CollectionType& collection,
                        bool (*predicate)(const ElementType&),
                        CollectionType& result) {
     for (const ElementType& element : collection) {
@@ -110,7 +135,7 @@ CollectionType& filter(CollectionType collection,
  * producing and returning a new collection containing the results.
  */
 template <typename CollectionType, typename ElementType>
-CollectionType map(CollectionType collection,
+CollectionType map(const CollectionType& collection,
                    ElementType (*fn)(ElementType)) {
     CollectionType result;
     for (const ElementType& element : collection) {
@@ -124,7 +149,7 @@ CollectionType map(CollectionType collection,
  * producing and returning a new collection containing the results.
  */
 template <typename CollectionType, typename ElementType>
-CollectionType map(CollectionType collection,
+CollectionType map(const CollectionType& collection,
                    ElementType (*fn)(const ElementType&)) {
     CollectionType result;
     for (const ElementType& element : collection) {
@@ -141,7 +166,7 @@ CollectionType map(CollectionType collection,
  */
 template <typename CollectionType, typename ElementType,
           typename CollectionType2, typename ElementType2>
-CollectionType2& map(CollectionType collection,
+CollectionType2& map(const CollectionType& collection,
                      ElementType2 (*fn)(ElementType),
                      CollectionType2& result) {
     for (const ElementType& element : collection) {
@@ -158,7 +183,7 @@ CollectionType2& map(CollectionType collection,
  */
 template <typename CollectionType, typename ElementType,
           typename CollectionType2, typename ElementType2>
-CollectionType2& map(CollectionType collection,
+CollectionType2& map(const CollectionType& collection,
                      ElementType2 (*fn)(const ElementType&),
                      CollectionType2& result) {
     for (const ElementType& element : collection) {
@@ -173,7 +198,7 @@ CollectionType2& map(CollectionType collection,
  * single value, which is then returned.
  */
 template <typename CollectionType, typename ElementType>
-ElementType reduce(CollectionType collection,
+ElementType reduce(const CollectionType& collection,
                    ElementType (*fn)(ElementType e1, ElementType e2),
                    ElementType startValue) {
     ElementType prev = startValue;
@@ -189,7 +214,7 @@ ElementType reduce(CollectionType collection,
  * single value, which is then returned.
  */
 template <typename CollectionType, typename ElementType>
-ElementType reduce(CollectionType collection,
+ElementType reduce(const CollectionType& collection,
                    ElementType (*fn)(ElementType e1, ElementType e2)) {
     bool first = true;
     ElementType prev;
@@ -212,7 +237,7 @@ ElementType reduce(CollectionType collection,
  * with each value from the collection one at a time.
  */
 template <typename CollectionType, typename ElementType>
-ElementType reduce(CollectionType collection,
+ElementType reduce(const CollectionType& collection,
                    ElementType (*fn)(const ElementType& e1, const ElementType& e2),
                    ElementType startValue) {
     ElementType prev = startValue;
@@ -230,7 +255,7 @@ ElementType reduce(CollectionType collection,
  * with each value from the collection one at a time.
  */
 template <typename CollectionType, typename ElementType>
-ElementType reduce(CollectionType collection,
+ElementType reduce(const CollectionType& collection,
                    ElementType (*fn)(const ElementType& e1, const ElementType& e2)) {
     bool first = true;
     ElementType prev;
@@ -245,6 +270,539 @@ ElementType reduce(CollectionType collection,
     return prev;
 }
 
+
+namespace internal {
+/*
+ * Internal classes used by Stream; not to be used by clients.
+ *
+ * A pipeline is a source followed by any number of steps.  Each has a
+ * value_type, the type of element it produces; a size, the number of
+ * elements in its source; and a run method that passes every element it
+ * produces to a "sink" function.  A step's run method wraps the sink in a
+ * sink of its own and runs the step before it, so a whole pipeline runs as
+ * one loop over the source.  Pipelines whose source can be indexed, such as
+ * a Vector, also have runRange, which does the same for only the source
+ * elements with indexes start through end - 1, so that the elements can be
+ * split into chunks that run in parallel.
+ */
+template <typename CollectionType>
+class CollectionSource {
+public:
+    typedef typename std::decay<decltype(*std::declval<const CollectionType&>().begin())>::type value_type;
+    static const bool indexed = false;
+
+    explicit CollectionSource(const CollectionType& collection)
+            : collection(&collection) {
+    }
+
+    int size() const {
+        return collection->size();
+    }
+
+    template <typename Sink>
+    void run(Sink& sink) const {
+        for (const auto& element : *collection) {
+            sink(element);
+        }
+    }
+
+private:
+    const CollectionType* collection;
+};
+
+/*
+ * Source over a collection that stores its elements contiguously, in
+ * the order in which it is iterated, such as a Vector or Grid.
+ */
+template <typename CollectionType, typename ValueType>
+class ContiguousSource {
+public:
+    typedef ValueType value_type;
+    static const bool indexed = true;
+
+    explicit ContiguousSource(const CollectionType& collection)
+            : collection(&collection) {
+    }
+
+    int size() const {
+        return collection->size();
+    }
+
+    template <typename Sink>
+    void run(Sink& sink) const {
+        runRange(0, size(), sink);
+    }
+
+    template <typename Sink>
+    void runRange(int start, int end, Sink& sink) const {
+        if (start >= end) {
+            return;
+        }
+        // index the storage directly, skipping the collection's bounds checks
+        const ValueType* data = &first(*collection);
+        for (int i = start; i < end; i++) {
+            sink(data[i]);
+        }
+    }
+
+private:
+    const CollectionType* collection;
+
+    static const ValueType& first(const Vector<ValueType>& vector) {
+        return vector[0];
+    }
+
+    static const ValueType& first(const Grid<ValueType>& grid) {
+        return grid.get(0, 0);
+    }
+};
+
+class RangeSource {
+public:
+    typedef int value_type;
+    static const bool indexed = true;
+
+    RangeSource(int start, int end)
+            : start(start),
+              end(end < start ? start : end) {
+    }
+
+    int size() const {
+        return end - start;
+    }
+
+    template <typename Sink>
+    void run(Sink& sink) const {
+        runRange(0, size(), sink);
+    }
+
+    template <typename Sink>
+    void runRange(int from, int to, Sink& sink) const {
+        for (int i = start + from; i < start + to; i++) {
+            sink(i);
+        }
+    }
+
+private:
+    int start;
+    int end;
+};
+
+template <typename Upstream, typename Predicate>
+class FilterStep {
+public:
+    typedef typename Upstream::value_type value_type;
+    static const bool indexed = Upstream::indexed;
+
+    FilterStep(const Upstream& upstream, const Predicate& predicate)
+            : upstream(upstream),
+              predicate(predicate) {
+    }
+
+    int size() const {
+        return upstream.size();
+    }
+
+    template <typename Sink>
+    void run(Sink& sink) const {
+        FilterSink<Sink> filterSink(predicate, sink);
+        upstream.run(filterSink);
+    }
+
+    template <typename Sink>
+    void runRange(int start, int end, Sink& sink) const {
+        FilterSink<Sink> filterSink(predicate, sink);
+        upstream.runRange(start, end, filterSink);
+    }
+
+private:
+    template <typename Sink>
+    struct FilterSink {
+        const Predicate& predicate;
+        Sink& sink;
+
+        FilterSink(const Predicate& predicate, Sink& sink)
+                : predicate(predicate),
+                  sink(sink) {
+        }
+
+        template <typename T>
+        void operator ()(const T& value) {
+            if (predicate(value)) {
+                sink(value);
+            }
+        }
+    };
+
+    Upstream upstream;
+    Predicate predicate;
+};
+
+template <typename Upstream, typename Function>
+class MapStep {
+public:
+    typedef typename std::decay<typename std::result_of<
+            const Function&(const typename Upstream::value_type&)>::type>::type value_type;
+    static const bool indexed = Upstream::indexed;
+
+    MapStep(const Upstream& upstream, const Function& function)
+            : upstream(upstream),
+              function(function) {
+    }
+
+    int size() const {
+        return upstream.size();
+    }
+
+    template <typename Sink>
+    void run(Sink& sink) const {
+        MapSink<Sink> mapSink(function, sink);
+        upstream.run(mapSink);
+    }
+
+    template <typename Sink>
+    void runRange(int start, int end, Sink& sink) const {
+        MapSink<Sink> mapSink(function, sink);
+        upstream.runRange(start, end, mapSink);
+    }
+
+private:
+    template <typename Sink>
+    struct MapSink {
+        const Function& function;
+        Sink& sink;
+
+        MapSink(const Function& function, Sink& sink)
+                : function(function),
+                  sink(sink) {
+        }
+
+        template <typename T>
+        void operator ()(const T& value) {
+            sink(function(value));
+        }
+    };
+
+    Upstream upstream;
+    Function function;
+};
+
+/*
+ * Sinks that final operations give to a pipeline; each chunk of a parallel
+ * run gets its own copy, and the copies are combined at the end.
+ */
+template <typename CollectionType>
+struct AddSink {
+    CollectionType* result;
+
+    explicit AddSink(CollectionType& result) : result(&result) {}
+
+    template <typename T>
+    void operator ()(const T& value) {
+        result->add(value);
+    }
+};
+
+struct CountSink {
+    int count;
+
+    CountSink() : count(0) {}
+
+    template <typename T>
+    void operator ()(const T&) {
+        count++;
+    }
+};
+
+template <typename Function>
+struct ForEachSink {
+    const Function* function;
+
+    explicit ForEachSink(const Function& function) : function(&function) {}
+
+    template <typename T>
+    void operator ()(const T& value) {
+        (*function)(value);
+    }
+};
+
+template <typename ResultType, typename Function>
+struct ReduceSink {
+    ResultType result;
+    const Function* function;
+
+    ReduceSink(const ResultType& startValue, const Function& function)
+            : result(startValue),
+              function(&function) {
+    }
+
+    template <typename T>
+    void operator ()(const T& value) {
+        result = (*function)(result, value);
+    }
+};
+
+template <typename ValueType>
+struct VectorSink {
+    Vector<ValueType> result;
+
+    template <typename T>
+    void operator ()(const T& value) {
+        result.add(value);
+    }
+};
+} // namespace internal
+
+/*
+ * Class: Stream
+ * -------------
+ * A lazy pipeline of operations over the elements of a collection, created
+ * by calling stream or range.  filter and map add a step to the pipeline
+ * and return the longer pipeline; the other methods run it.
+ *
+ * A stream refers to its collection rather than copying it, so the
+ * collection must still exist, and should not be changed, until the stream
+ * is done being used.
+ */
+template <typename Pipeline>
+class Stream {
+public:
+    typedef typename Pipeline::value_type value_type;
+
+    /*
+     * Creates a stream that runs the given pipeline; use stream or range
+     * rather than calling this directly.
+     */
+    explicit Stream(const Pipeline& pipeline, bool isParallel = false, int grainSize = 0)
+            : pipeline(pipeline),
+              isParallel(isParallel),
+              grainSize(grainSize) {
+    }
+
+    /*
+     * Adds all of the elements produced by this stream to the given
+     * collection, in order, using its add method, and returns the collection.
+     * This is always done sequentially.
+     */
+    template <typename CollectionType>
+    CollectionType& collect(CollectionType& result) const {
+        internal::AddSink<CollectionType> sink(result);
+        pipeline.run(sink);
+        return result;
+    }
+
+    /*
+     * Returns the number of elements produced by this stream.
+     */
+    int count() const {
+        int total = 0;
+        for (const internal::CountSink& sink : runSinks(internal::CountSink())) {
+            total += sink.count;
+        }
+        return total;
+    }
+
+    /*
+     * Returns a stream that keeps only the elements for which the given
+     * predicate returns true.
+     */
+    template <typename Predicate>
+    Stream<internal::FilterStep<Pipeline, Predicate>> filter(Predicate predicate) const {
+        return Stream<internal::FilterStep<Pipeline, Predicate>>(
+                internal::FilterStep<Pipeline, Predicate>(pipeline, predicate),
+                isParallel, grainSize);
+    }
+
+    /*
+     * Calls the given function on every element produced by this stream.
+     * If the stream is parallel, the function is called from several
+     * threads at once and in no particular order.
+     */
+    template <typename Function>
+    void forEach(Function function) const {
+        runSinks(internal::ForEachSink<Function>(function));
+    }
+
+    /*
+     * Returns a stream of the results of calling the given function on each
+     * element of this stream.  The function may return a different type.
+     */
+    template <typename Function>
+    Stream<internal::MapStep<Pipeline, Function>> map(Function function) const {
+        return Stream<internal::MapStep<Pipeline, Function>>(
+                internal::MapStep<Pipeline, Function>(pipeline, function),
+                isParallel, grainSize);
+    }
+
+    /*
+     * Returns a stream that runs in parallel on ThreadPool::getDefault(),
+     * splitting its elements into chunks of about grainSize elements each
+     * (chosen automatically if 0).  Only streams over a Vector, Grid, or
+     * range run in parallel; others run sequentially as before.
+     * The functions given to filter, map, forEach, and reduce must then be
+     * safe to call from several threads at once.
+     */
+    Stream<Pipeline> parallel(int grainSize = 0) const {
+        return Stream<Pipeline>(pipeline, true, grainSize);
+    }
+
+    /*
+     * Combines the elements of this stream into one value by starting with
+     * the given value and then calling result = function(result, element)
+     * for each element in turn.
+     * If the stream is parallel, each chunk is reduced starting from
+     * startValue, and then the chunks' results are combined in order with
+     * the same function.  So the function must be associative, like + or
+     * max, and startValue must not change the result, like 0 for +.
+     */
+    template <typename ResultType, typename Function>
+    ResultType reduce(ResultType startValue, Function function) const {
+        std::vector<internal::ReduceSink<ResultType, Function>> sinks =
+                runSinks(internal::ReduceSink<ResultType, Function>(startValue, function));
+        ResultType result = sinks[0].result;
+        for (int i = 1; i < (int) sinks.size(); i++) {
+            result = function(result, sinks[i].result);
+        }
+        return result;
+    }
+
+    /*
+     * Returns a stream that runs sequentially.
+     */
+    Stream<Pipeline> sequential() const {
+        return Stream<Pipeline>(pipeline, false, 0);
+    }
+
+    /*
+     * Returns the sum of the elements of this stream, using +,
+     * starting from value_type() (0 for numbers).
+     */
+    value_type sum() const {
+        return reduce(value_type(), std::plus<value_type>());
+    }
+
+    /*
+     * Returns a Vector of all of the elements produced by this stream,
+     * in order, even if the stream is parallel.
+     */
+    Vector<value_type> toVector() const {
+        std::vector<internal::VectorSink<value_type>> sinks =
+                runSinks(internal::VectorSink<value_type>());
+        if (sinks.size() == 1) {
+            return sinks[0].result;
+        }
+        int total = 0;
+        for (const internal::VectorSink<value_type>& sink : sinks) {
+            total += sink.result.size();
+        }
+        Vector<value_type> result;
+        result.ensureCapacity(total);
+        for (const internal::VectorSink<value_type>& sink : sinks) {
+            result.addAll(sink.result);
+        }
+        return result;
+    }
+
+private:
+    Pipeline pipeline;
+    bool isParallel;
+    int grainSize;
+
+    /*
+     * Runs the pipeline, giving its elements to copies of the given sink,
+     * one per chunk, and returns the copies in order.
+     * A sequential run has a single chunk.
+     */
+    template <typename Sink>
+    std::vector<Sink> runSinks(const Sink& initial) const {
+        return runSinks(initial, std::integral_constant<bool, Pipeline::indexed>());
+    }
+
+    template <typename Sink>
+    std::vector<Sink> runSinks(const Sink& initial, std::false_type /* indexed */) const {
+        std::vector<Sink> sinks(1, initial);
+        pipeline.run(sinks[0]);
+        return sinks;
+    }
+
+    template <typename Sink>
+    std::vector<Sink> runSinks(const Sink& initial, std::true_type /* indexed */) const {
+        // below this many elements, the cost of handing out chunks is
+        // likely to outweigh any gain from running them in parallel
+        static const int MIN_CHUNK_SIZE = 1024;
+
+        int size = pipeline.size();
+        int chunkSize = grainSize;
+        if (chunkSize <= 0) {
+            chunkSize = size / (ThreadPool::getDefault().getThreadCount() * 4);
+            if (chunkSize < MIN_CHUNK_SIZE) {
+                chunkSize = MIN_CHUNK_SIZE;
+            }
+        }
+        if (!isParallel || size <= chunkSize) {
+            return runSinks(initial, std::false_type());
+        }
+
+        int chunks = (int) ((size + (long long) chunkSize - 1) / chunkSize);
+        std::vector<Sink> sinks(chunks, initial);
+        TaskGroup group(ThreadPool::getDefault());
+        for (int i = 0; i < chunks; i++) {
+            int start = i * chunkSize;
+            int end = (size - start > chunkSize) ? start + chunkSize : size;
+            Sink* result = &sinks[i];
+            const Pipeline* pipeline = &this->pipeline;
+            group.run([result, pipeline, start, end]() {
+                // work on a local copy; neighboring sinks in the vector may
+                // share a cache line, which would slow down every update
+                Sink sink = *result;
+                pipeline->runRange(start, end, sink);
+                *result = sink;
+            });
+        }
+        group.wait();
+        return sinks;
+    }
+};
+
+/*
+ * Returns a stream over the elements of the given collection,
+ * in the order in which a for-each loop would visit them.
+ * The collection is not copied.
+ */
+template <typename CollectionType>
+Stream<internal::CollectionSource<CollectionType>> stream(const CollectionType& collection) {
+    return Stream<internal::CollectionSource<CollectionType>>(
+            internal::CollectionSource<CollectionType>(collection));
+}
+
+/*
+ * Returns a stream over the elements of the given vector, in order.
+ * This stream can be made parallel.
+ */
+template <typename ValueType>
+Stream<internal::ContiguousSource<Vector<ValueType>, ValueType>> stream(const Vector<ValueType>& vector) {
+    return Stream<internal::ContiguousSource<Vector<ValueType>, ValueType>>(
+            internal::ContiguousSource<Vector<ValueType>, ValueType>(vector));
+}
+
+/*
+ * Returns a stream over the elements of the given grid, in row-major order.
+ * This stream can be made parallel.
+ */
+template <typename ValueType>
+Stream<internal::ContiguousSource<Grid<ValueType>, ValueType>> stream(const Grid<ValueType>& grid) {
+    return Stream<internal::ContiguousSource<Grid<ValueType>, ValueType>>(
+            internal::ContiguousSource<Grid<ValueType>, ValueType>(grid));
+}
+
+/*
+ * Returns a stream of the integers from start up to but not including end.
+ * This stream can be made parallel.
+ */
+inline Stream<internal::RangeSource> range(int start, int end) {
+    return Stream<internal::RangeSource>(internal::RangeSource(start, end));
+}
+
 } // namespace functional
 
 #include "private/init.h"   // ensure that Stanford C++ lib is initialized
@@ -4,6 +4,11 @@
  * This file exports the <code>HashMap</code> class, which stores
  * a set of <i>key</i>-<i>value</i> pairs.
  * 
+ * @version 2018/10/15
+ * - expandAndRehash is timed by a TIMED_SCOPE (see profile.h)
+ * - added reserve method to size the table for a known number of entries
+ * - added bucketCount, shrinkToFit, getMaxLoadFactor, and setMaxLoadFactor
+ * - rehashing relinks the existing cells rather than copying them
  * @version 2018/03/10
  * - added methods front, back
  * @version 2017/11/30
@@ -48,6 +53,7 @@
 #include "collections.h"
 #include "error.h"
 #include "hashcode.h"
+#include "profile.h"
 #include "vector.h"
 
 /*
@@ -137,6 +143,16 @@ public:
      */
     KeyType back() const;
 
+    /*
+     * Method: bucketCount
+     * Usage: int n = map.bucketCount();
+     * ---------------------------------
+     * Returns the number of buckets in this map's hash table.
+     * The map enlarges its table when the number of entries exceeds the
+     * bucket count times the maximum load factor.
+     */
+    int bucketCount() const;
+
     /*
      * Method: clear
      * Usage: map.clear();
@@ -187,6 +203,15 @@ public:
      */
     ValueType get(const KeyType& key) const;
 
+    /*
+     * Method: getMaxLoadFactor
+     * Usage: double loadFactor = map.getMaxLoadFactor();
+     * --------------------------------------------------
+     * Returns the largest average number of entries per bucket this map
+     * allows before it enlarges its table.  The default is 0.7.
+     */
+    double getMaxLoadFactor() const;
+
     /*
      * Method: isEmpty
      * Usage: if (map.isEmpty()) ...
@@ -263,6 +288,16 @@ public:
     HashMap& removeAll(const HashMap& map2);
     HashMap& removeAll(std::initializer_list<std::pair<KeyType, ValueType> > list);
 
+    /*
+     * Method: reserve
+     * Usage: map.reserve(n);
+     * ----------------------
+     * Makes room for at least n entries in this map, so that adding that
+     * many entries will not make the map enlarge and rehash its table.
+     * Never shrinks the map.
+     */
+    void reserve(int n);
+
     /*
      * Method: retainAll
      * Usage: map.retainAll(map2);
@@ -276,6 +311,27 @@ public:
     HashMap& retainAll(const HashMap& map2);
     HashMap& retainAll(std::initializer_list<std::pair<KeyType, ValueType> > list);
 
+    /*
+     * Method: setMaxLoadFactor
+     * Usage: map.setMaxLoadFactor(loadFactor);
+     * ----------------------------------------
+     * Sets the largest average number of entries per bucket this map allows
+     * before it enlarges its table.  A larger load factor saves memory but
+     * makes lookups slower.  Enlarges the table now if the map already has
+     * more entries than the new load factor allows.
+     * Signals an error if the load factor is not positive.
+     */
+    void setMaxLoadFactor(double loadFactor);
+
+    /*
+     * Method: shrinkToFit
+     * Usage: map.shrinkToFit();
+     * -------------------------
+     * Shrinks this map's table to the smallest size that holds its current
+     * entries within the maximum load factor.
+     */
+    void shrinkToFit();
+
     /*
      * Method: size
      * Usage: int nEntries = map.size();
@@ -429,7 +485,7 @@ public:
 private:
     /* Constant definitions */
     static const int INITIAL_BUCKET_COUNT = 101;
-    static const int MAX_LOAD_PERCENTAGE = 70;
+    static const int DEFAULT_MAX_LOAD_PERCENTAGE = 70;
 
     /* Type definition for cells in the bucket chain */
     struct Cell {
@@ -442,6 +498,7 @@ private:
     Vector<Cell*> buckets;
     int nBuckets;
     int numEntries;
+    double m_maxLoadFactor = DEFAULT_MAX_LOAD_PERCENTAGE / 100.0;
     unsigned int m_version = 0; // structure version for detecting invalid iterators
 
     /* Private methods */
@@ -492,14 +549,45 @@ private:
      * enlarge and redistribute the entries.
      */
     void expandAndRehash() {
+        TIMED_SCOPE("HashMap::expandAndRehash");
+        rehash(buckets.size() * 2 + 1);
+    }
+
+    /*
+     * Private method: bucketsFor
+     * Usage: int nBuckets = bucketsFor(n);
+     * ------------------------------------
+     * Returns the number of buckets needed to hold n entries without
+     * exceeding the maximum load factor.
+     */
+    int bucketsFor(int n) const {
+        return (int) (n / m_maxLoadFactor) + 1;
+    }
+
+    /*
+     * Private method: rehash
+     * Usage: rehash(nBuckets);
+     * ------------------------
+     * Rebuilds the map's table with the given number of buckets and moves
+     * the existing cells into it.  The cells are relinked in the same order
+     * that put would have added them, so no cells are allocated or copied.
+     */
+    void rehash(int nBuckets) {
         Vector<Cell*> oldBuckets = buckets;
-        createBuckets(oldBuckets.size() * 2 + 1);
+        int oldEntries = numEntries;
+        createBuckets(nBuckets);
         for (int i = 0; i < oldBuckets.size(); i++) {
-            for (Cell* cp = oldBuckets[i]; cp != nullptr; cp = cp->next) {
-                put(cp->key, cp->value);
+            Cell* cp = oldBuckets[i];
+            while (cp) {
+                Cell* np = cp->next;
+                int bucket = hashCode(cp->key) % this->nBuckets;
+                cp->next = buckets[bucket];
+                buckets[bucket] = cp;
+                cp = np;
             }
         }
-        deleteBuckets(oldBuckets);
+        numEntries = oldEntries;
+        m_version++;
     }
 
     /*
@@ -531,6 +619,7 @@ private:
     }
 
     void deepCopy(const HashMap& src) {
+        m_maxLoadFactor = src.m_maxLoadFactor;
         createBuckets(src.nBuckets);
         for (int i = 0; i < src.nBuckets; i++) {
             // BUGFIX: was just calling put(), which reversed the chains;
@@ -770,6 +859,11 @@ KeyType HashMap<KeyType, ValueType>::back() const {
     return cell->key;
 }
 
+template <typename KeyType, typename ValueType>
+int HashMap<KeyType, ValueType>::bucketCount() const {
+    return nBuckets;
+}
+
 template <typename KeyType, typename ValueType>
 void HashMap<KeyType, ValueType>::clear() {
     deleteBuckets(buckets);
@@ -804,6 +898,11 @@ ValueType HashMap<KeyType, ValueType>::get(const KeyType& key) const {
     return cp->value;
 }
 
+template <typename KeyType, typename ValueType>
+double HashMap<KeyType, ValueType>::getMaxLoadFactor() const {
+    return m_maxLoadFactor;
+}
+
 template <typename KeyType, typename ValueType>
 bool HashMap<KeyType, ValueType>::isEmpty() const {
     return size() == 0;
@@ -908,6 +1007,14 @@ HashMap<KeyType, ValueType>& HashMap<KeyType, ValueType>::removeAll(
     return *this;
 }
 
+template <typename KeyType, typename ValueType>
+void HashMap<KeyType, ValueType>::reserve(int n) {
+    int needed = bucketsFor(n);
+    if (needed > nBuckets) {
+        rehash(needed);
+    }
+}
+
 template <typename KeyType, typename ValueType>
 HashMap<KeyType, ValueType>& HashMap<KeyType, ValueType>::retainAll(const HashMap& map2) {
     Vector<KeyType> toRemove;
@@ -930,6 +1037,25 @@ HashMap<KeyType, ValueType>& HashMap<KeyType, ValueType>::retainAll(
     return *this;
 }
 
+template <typename KeyType, typename ValueType>
+void HashMap<KeyType, ValueType>::setMaxLoadFactor(double loadFactor) {
+    if (!(loadFactor > 0)) {
+        error("HashMap::setMaxLoadFactor: load factor must be positive");
+    }
+    m_maxLoadFactor = loadFactor;
+    if (numEntries > m_maxLoadFactor * nBuckets) {
+        rehash(bucketsFor(numEntries));
+    }
+}
+
+template <typename KeyType, typename ValueType>
+void HashMap<KeyType, ValueType>::shrinkToFit() {
+    int needed = bucketsFor(numEntries);
+    if (needed < nBuckets) {
+        rehash(needed);
+    }
+}
+
 template <typename KeyType, typename ValueType>
 int HashMap<KeyType, ValueType>::size() const {
     return numEntries;
@@ -956,7 +1082,7 @@ ValueType& HashMap<KeyType, ValueType>::operator [](const KeyType& key) {
     int bucket = hashCode(key) % nBuckets;
     Cell* cp = findCell(bucket, key);
     if (!cp) {
-        if (numEntries > MAX_LOAD_PERCENTAGE * nBuckets / 100.0) {
+        if (numEntries > m_maxLoadFactor * nBuckets) {
             expandAndRehash();
             bucket = hashCode(key) % nBuckets;
         }
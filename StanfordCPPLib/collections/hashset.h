@@ -4,6 +4,9 @@
  * This file exports the <code>HashSet</code> class, which
  * implements an efficient abstraction for storing sets of values.
  * 
+ * @version 2018/10/15
+ * - added reserve, bucketCount, shrinkToFit, getMaxLoadFactor, and
+ *   setMaxLoadFactor methods
  * @version 2018/03/10
  * - added methods front, back
  * @version 2016/12/09
@@ -116,6 +119,16 @@ public:
      */
     ValueType back() const;
 
+    /*
+     * Method: bucketCount
+     * Usage: int n = set.bucketCount();
+     * ---------------------------------
+     * Returns the number of buckets in this set's hash table.
+     * The set enlarges its table when the number of elements exceeds the
+     * bucket count times the maximum load factor.
+     */
+    int bucketCount() const;
+
     /*
      * Method: clear
      * Usage: set.clear();
@@ -179,6 +192,15 @@ public:
      */
     ValueType front() const;
 
+    /*
+     * Method: getMaxLoadFactor
+     * Usage: double loadFactor = set.getMaxLoadFactor();
+     * --------------------------------------------------
+     * Returns the largest average number of elements per bucket this set
+     * allows before it enlarges its table.  The default is 0.7.
+     */
+    double getMaxLoadFactor() const;
+
     /*
      * Method: insert
      * Usage: set.insert(value);
@@ -259,6 +281,15 @@ public:
     HashSet<ValueType>& removeAll(const HashSet<ValueType>& set);
     HashSet<ValueType>& removeAll(std::initializer_list<ValueType> list);
 
+    /*
+     * Method: reserve
+     * Usage: set.reserve(n);
+     * ----------------------
+     * Makes room for at least n values in this set, so that adding that
+     * many values will not make the set enlarge and rehash its table.
+     */
+    void reserve(int n);
+
     /*
      * Method: retainAll
      * Usage: set.retainAll(set2);
@@ -272,6 +303,26 @@ public:
     HashSet<ValueType>& retainAll(const HashSet<ValueType>& set);
     HashSet<ValueType>& retainAll(std::initializer_list<ValueType> list);
 
+    /*
+     * Method: setMaxLoadFactor
+     * Usage: set.setMaxLoadFactor(loadFactor);
+     * ----------------------------------------
+     * Sets the largest average number of elements per bucket this set allows
+     * before it enlarges its table.  A larger load factor saves memory but
+     * makes lookups slower.
+     * Signals an error if the load factor is not positive.
+     */
+    void setMaxLoadFactor(double loadFactor);
+
+    /*
+     * Method: shrinkToFit
+     * Usage: set.shrinkToFit();
+     * -------------------------
+     * Shrinks this set's table to the smallest size that holds its current
+     * elements within the maximum load factor.
+     */
+    void shrinkToFit();
+
     /*
      * Method: size
      * Usage: count = set.size();
@@ -549,6 +600,11 @@ ValueType HashSet<ValueType>::back() const {
     return map.back();
 }
 
+template <typename ValueType>
+int HashSet<ValueType>::bucketCount() const {
+    return map.bucketCount();
+}
+
 template <typename ValueType>
 void HashSet<ValueType>::clear() {
     map.clear();
@@ -616,6 +672,11 @@ void HashSet<ValueType>::insert(const ValueType& value) {
     map.put(value, true);
 }
 
+template <typename ValueType>
+double HashSet<ValueType>::getMaxLoadFactor() const {
+    return map.getMaxLoadFactor();
+}
+
 template <typename ValueType>
 bool HashSet<ValueType>::isEmpty() const {
     return map.isEmpty();
@@ -693,6 +754,11 @@ HashSet<ValueType>& HashSet<ValueType>::removeAll(std::initializer_list<ValueTyp
     return *this;
 }
 
+template <typename ValueType>
+void HashSet<ValueType>::reserve(int n) {
+    map.reserve(n);
+}
+
 template <typename ValueType>
 HashSet<ValueType>& HashSet<ValueType>::retainAll(const HashSet& set2) {
     Vector<ValueType> toRemove;
@@ -713,6 +779,19 @@ HashSet<ValueType>& HashSet<ValueType>::retainAll(std::initializer_list<ValueTyp
     return retainAll(set2);
 }
 
+template <typename ValueType>
+void HashSet<ValueType>::setMaxLoadFactor(double loadFactor) {
+    if (!(loadFactor > 0)) {
+        error("HashSet::setMaxLoadFactor: load factor must be positive");
+    }
+    map.setMaxLoadFactor(loadFactor);
+}
+
+template <typename ValueType>
+void HashSet<ValueType>::shrinkToFit() {
+    map.shrinkToFit();
+}
+
 template <typename ValueType>
 int HashSet<ValueType>::size() const {
     return map.size();
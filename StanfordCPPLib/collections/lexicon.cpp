@@ -15,6 +15,8 @@
  *
  * The original DAWG implementation is retained as dawglexicon.h/cpp.
  * 
+ * @version 2018/10/03
+ * - plain-text word files are read in bulk rather than line by line
  * @version 2018/03/10
  * - added method front
  * @version 2016/09/24
@@ -125,9 +127,10 @@ void Lexicon::addWordsFromFile(std::istream& input) {
         if (input.fail()) {
             error("Lexicon::addWordsFromFile: Couldn't read from input");
         }
-        std::string line;
-        while (getline(input, line)) {
-            add(trim(line));
+        std::string text;
+        readEntireStream(input, text);
+        for (StringView line : StringSplitter(text, '\n')) {
+            add(trim(line.toString()));
         }
     }
 }
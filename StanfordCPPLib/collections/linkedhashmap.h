@@ -9,6 +9,9 @@
  * cost due to needing to store an extra copy of the keys.
  * 
  * @author Marty Stepp
+ * @version 2018/10/15
+ * - added bucketCount, reserve, shrinkToFit, getMaxLoadFactor, and
+ *   setMaxLoadFactor methods
  * @version 2018/03/10
  * - added methods front, back
  * @version 2016/09/24
@@ -116,6 +119,14 @@ public:
      */
     KeyType back() const;
 
+    /*
+     * Method: bucketCount
+     * Usage: int n = map.bucketCount();
+     * ---------------------------------
+     * Returns the number of buckets in this map's hash table.
+     */
+    int bucketCount() const;
+
     /*
      * Method: clear
      * Usage: map.clear();
@@ -161,6 +172,15 @@ public:
      */
     ValueType get(const KeyType& key) const;
 
+    /*
+     * Method: getMaxLoadFactor
+     * Usage: double loadFactor = map.getMaxLoadFactor();
+     * --------------------------------------------------
+     * Returns the largest average number of entries per bucket this map
+     * allows before it enlarges its table.  The default is 0.7.
+     */
+    double getMaxLoadFactor() const;
+
     /*
      * Method: isEmpty
      * Usage: if (map.isEmpty()) ...
@@ -235,6 +255,15 @@ public:
     LinkedHashMap& removeAll(const LinkedHashMap& map2);
     LinkedHashMap& removeAll(std::initializer_list<std::pair<KeyType, ValueType> > list);
 
+    /*
+     * Method: reserve
+     * Usage: map.reserve(n);
+     * ----------------------
+     * Makes room for at least n entries in this map, so that adding that
+     * many entries will not make the map enlarge its table or key list.
+     */
+    void reserve(int n);
+
     /*
      * Method: retainAll
      * Usage: map.retainAll(map2);
@@ -247,6 +276,24 @@ public:
     LinkedHashMap& retainAll(const LinkedHashMap& map2);
     LinkedHashMap& retainAll(std::initializer_list<std::pair<KeyType, ValueType> > list);
 
+    /*
+     * Method: setMaxLoadFactor
+     * Usage: map.setMaxLoadFactor(loadFactor);
+     * ----------------------------------------
+     * Sets the largest average number of entries per bucket this map allows
+     * before it enlarges its table.
+     * Signals an error if the load factor is not positive.
+     */
+    void setMaxLoadFactor(double loadFactor);
+
+    /*
+     * Method: shrinkToFit
+     * Usage: map.shrinkToFit();
+     * -------------------------
+     * Frees any storage this map holds beyond what its current entries need.
+     */
+    void shrinkToFit();
+
     /*
      * Method: size
      * Usage: int nEntries = map.size();
@@ -495,6 +542,11 @@ KeyType LinkedHashMap<KeyType, ValueType>::back() const {
     return keyVector.back();
 }
 
+template <typename KeyType, typename ValueType>
+int LinkedHashMap<KeyType, ValueType>::bucketCount() const {
+    return innerMap.bucketCount();
+}
+
 template <typename KeyType, typename ValueType>
 void LinkedHashMap<KeyType, ValueType>::clear() {
     innerMap.clear();
@@ -524,6 +576,11 @@ ValueType LinkedHashMap<KeyType, ValueType>::get(const KeyType& key) const {
     return innerMap.get(key);
 }
 
+template <typename KeyType, typename ValueType>
+double LinkedHashMap<KeyType, ValueType>::getMaxLoadFactor() const {
+    return innerMap.getMaxLoadFactor();
+}
+
 template <typename KeyType, typename ValueType>
 bool LinkedHashMap<KeyType, ValueType>::isEmpty() const {
     return innerMap.isEmpty();
@@ -628,6 +685,26 @@ LinkedHashMap<KeyType, ValueType>& LinkedHashMap<KeyType, ValueType>::retainAll(
     return *this;
 }
 
+template <typename KeyType, typename ValueType>
+void LinkedHashMap<KeyType, ValueType>::reserve(int n) {
+    innerMap.reserve(n);
+    keyVector.reserve(n);
+}
+
+template <typename KeyType, typename ValueType>
+void LinkedHashMap<KeyType, ValueType>::setMaxLoadFactor(double loadFactor) {
+    if (!(loadFactor > 0)) {
+        error("LinkedHashMap::setMaxLoadFactor: load factor must be positive");
+    }
+    innerMap.setMaxLoadFactor(loadFactor);
+}
+
+template <typename KeyType, typename ValueType>
+void LinkedHashMap<KeyType, ValueType>::shrinkToFit() {
+    innerMap.shrinkToFit();
+    keyVector.shrinkToFit();
+}
+
 template <typename KeyType, typename ValueType>
 int LinkedHashMap<KeyType, ValueType>::size() const {
     return innerMap.size();
@@ -4,6 +4,8 @@
  * This file exports the <code>PriorityQueue</code> class, a
  * collection in which values are processed in priority order.
  * 
+ * @version 2018/10/15
+ * - added capacity, reserve, and shrinkToFit methods
  * @version 2016/11/07
  * - small const-correctness bug fix in front() / back() (courtesy Truman Cranor)
  * @version 2016/10/14
@@ -107,6 +109,15 @@ public:
      * Returns the last value in the queue by reference.
      */
     ValueType& back();
+
+    /*
+     * Method: capacity
+     * Usage: int n = pq.capacity();
+     * -----------------------------
+     * Returns the number of values the priority queue can hold before it
+     * must enlarge its internal storage.
+     */
+    int capacity() const;
     
     /*
      * Method: changePriority
@@ -202,6 +213,24 @@ public:
      */
     ValueType remove();
 
+    /*
+     * Method: reserve
+     * Usage: pq.reserve(n);
+     * ---------------------
+     * Makes room for the given number of values in the priority queue, so
+     * that enqueuing up to that many values will not make it enlarge its
+     * storage.
+     */
+    void reserve(int n);
+
+    /*
+     * Method: shrinkToFit
+     * Usage: pq.shrinkToFit();
+     * ------------------------
+     * Frees any storage the priority queue holds beyond what its values need.
+     */
+    void shrinkToFit();
+
     /*
      * Method: size
      * Usage: int n = pq.size();
@@ -277,7 +306,6 @@ private:
     long enqueueCount;
     int backIndex;
     int count;
-    int capacity;
 
     /* Private function prototypes */
     const HeapEntry& heapGet(int index) const;
@@ -481,6 +509,11 @@ void PriorityQueue<ValueType>::changePriority(ValueType value, double newPriorit
     error("PriorityQueue::changePriority: Element value not found.");
 }
 
+template <typename ValueType>
+int PriorityQueue<ValueType>::capacity() const {
+    return heap.capacity();
+}
+
 template <typename ValueType>
 void PriorityQueue<ValueType>::clear() {
     heap.clear();
@@ -611,6 +644,20 @@ ValueType PriorityQueue<ValueType>::remove() {
     return dequeue();
 }
 
+template <typename ValueType>
+void PriorityQueue<ValueType>::reserve(int n) {
+    heap.reserve(n);
+}
+
+template <typename ValueType>
+void PriorityQueue<ValueType>::shrinkToFit() {
+    // entries past count are left over from dequeued values
+    while (heap.size() > count) {
+        heap.remove(heap.size() - 1);
+    }
+    heap.shrinkToFit();
+}
+
 template <typename ValueType>
 int PriorityQueue<ValueType>::size() const {
     return count;
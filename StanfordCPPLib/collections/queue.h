@@ -5,6 +5,9 @@
  * in which values are ordinarily processed in a first-in/first-out
  * (FIFO) order.
  * 
+ * @version 2018/10/15
+ * - added capacity, reserve, and shrinkToFit methods
+ * - the ring buffer grows in place rather than through a temporary copy
  * @version 2018/01/23
  * - fixed bad reference bug on queue.enqueue(queue.peek())
  * @version 2017/11/14
@@ -34,6 +37,7 @@
 #ifndef _queue_h
 #define _queue_h
 
+#include <algorithm>
 #include <deque>
 #include <initializer_list>
 #include <iterator>
@@ -94,6 +98,15 @@ public:
      */
     const ValueType& back() const;
 
+    /*
+     * Method: capacity
+     * Usage: int n = queue.capacity();
+     * --------------------------------
+     * Returns the number of values the queue can hold before it must
+     * enlarge its internal storage.
+     */
+    int capacity() const;
+
     /*
      * Method: clear
      * Usage: queue.clear();
@@ -165,6 +178,23 @@ public:
      */
     ValueType remove();
 
+    /*
+     * Method: reserve
+     * Usage: queue.reserve(n);
+     * ------------------------
+     * Makes room for the given number of values in the queue, so that
+     * enqueuing up to that many values will not make it enlarge its storage.
+     */
+    void reserve(int n);
+
+    /*
+     * Method: shrinkToFit
+     * Usage: queue.shrinkToFit();
+     * ---------------------------
+     * Frees any storage the queue holds beyond what its values need.
+     */
+    void shrinkToFit();
+
     /*
      * Method: size
      * Usage: int n = queue.size();
@@ -245,12 +275,13 @@ private:
     /* Instance variables */
     Vector<ValueType> ringBuffer;
     int count;
-    int capacity;
+    int m_capacity;
     int head;
     int tail;
 
     /* Private functions */
     void expandRingBufferCapacity();
+    void resizeRingBuffer(int newCapacity);
     int queueCompare(const Queue& queue2) const;
 
     /*
@@ -277,7 +308,7 @@ private:
 
         iterator& operator ++() {
             stanfordcpplib::collections::checkVersion(*gp, *this);
-            index = (index + 1) % gp->capacity;
+            index = (index + 1) % gp->m_capacity;
             return *this;
         }
 
@@ -391,13 +422,20 @@ const ValueType& Queue<ValueType>::back() const {
     if (count == 0) {
         error("Queue::back: Attempting to read back of an empty queue");
     }
-    return ringBuffer[(tail + capacity - 1) % capacity];
+    return ringBuffer[(tail + m_capacity - 1) % m_capacity];
+}
+
+template <typename ValueType>
+int Queue<ValueType>::capacity() const {
+    // one slot is always left empty, so that a full buffer is not mistaken
+    // for an empty one
+    return m_capacity - 1;
 }
 
 template <typename ValueType>
 void Queue<ValueType>::clear() {
-    capacity = INITIAL_CAPACITY;
-    ringBuffer = Vector<ValueType>(capacity);
+    m_capacity = INITIAL_CAPACITY;
+    ringBuffer = Vector<ValueType>(m_capacity);
     head = 0;
     tail = 0;
     count = 0;
@@ -415,14 +453,14 @@ ValueType Queue<ValueType>::dequeue() {
         error("Queue::dequeue: Attempting to dequeue an empty queue");
     }
     ValueType result = ringBuffer[head];
-    head = (head + 1) % capacity;
+    head = (head + 1) % m_capacity;
     count--;
     return result;
 }
 
 template <typename ValueType>
 void Queue<ValueType>::enqueue(const ValueType& value) {
-    if (count >= capacity - 1) {
+    if (count >= m_capacity - 1) {
         // Buffer almost full; need to resize buffer to a larger capacity.
         // BUGFIX: when calling queue.enqueue(queue.peek()), the resize here
         // was causing the reference to become invalid.
@@ -434,7 +472,7 @@ void Queue<ValueType>::enqueue(const ValueType& value) {
     } else {
         // standard add to end of ring buffer
         ringBuffer[tail] = value;
-        tail = (tail + 1) % capacity;
+        tail = (tail + 1) % m_capacity;
         count++;
     }
 }
@@ -475,6 +513,20 @@ ValueType Queue<ValueType>::remove() {
     return dequeue();
 }
 
+template <typename ValueType>
+void Queue<ValueType>::reserve(int n) {
+    if (n + 1 > m_capacity) {
+        resizeRingBuffer(n + 1);
+    }
+}
+
+template <typename ValueType>
+void Queue<ValueType>::shrinkToFit() {
+    if (count + 1 < m_capacity) {
+        resizeRingBuffer(count + 1);
+    }
+}
+
 template <typename ValueType>
 int Queue<ValueType>::size() const {
     return count;
@@ -484,7 +536,7 @@ template <typename ValueType>
 std::queue<ValueType> Queue<ValueType>::toStlDeque() const {
     std::deque<ValueType> result;
     for (int i = 0; i < count; i++) {
-        result.push_back(ringBuffer[(head + i) % capacity]);
+        result.push_back(ringBuffer[(head + i) % m_capacity]);
     }
     return result;
 }
@@ -493,7 +545,7 @@ template <typename ValueType>
 std::queue<ValueType> Queue<ValueType>::toStlQueue() const {
     std::queue<ValueType> result;
     for (int i = 0; i < count; i++) {
-        result.push(ringBuffer[(head + i) % capacity]);
+        result.push(ringBuffer[(head + i) % m_capacity]);
     }
     return result;
 }
@@ -511,22 +563,38 @@ unsigned int Queue<ValueType>::version() const {
 }
 
 /*
- * Implementation notes: expandRingBufferCapacity
- * ----------------------------------------------
- * This private method doubles the capacity of the ringBuffer vector.
- * Note that this implementation also shifts all the elements back to
- * the beginning of the vector.
+ * Implementation notes: expandRingBufferCapacity, resizeRingBuffer
+ * ----------------------------------------------------------------
+ * These private methods change the capacity of the ringBuffer vector.
+ * The elements are first rotated within the vector so that the head is
+ * at index 0, and then the vector grows or shrinks at its end, so no
+ * second vector is needed.
  */
 template <typename ValueType>
 void Queue<ValueType>::expandRingBufferCapacity() {
-    Vector<ValueType> copy = ringBuffer;
-    ringBuffer = Vector<ValueType>(2 * capacity);
-    for (int i = 0; i < count; i++) {
-        ringBuffer[i] = copy[(head + i) % capacity];
+    resizeRingBuffer(2 * m_capacity);
+}
+
+template <typename ValueType>
+void Queue<ValueType>::resizeRingBuffer(int newCapacity) {
+    if (head != 0) {
+        ValueType* first = &ringBuffer[0];
+        std::rotate(first, first + head, first + m_capacity);
     }
     head = 0;
     tail = count;
-    capacity *= 2;
+    if (newCapacity > m_capacity) {
+        ringBuffer.reserve(newCapacity);
+        while (ringBuffer.size() < newCapacity) {
+            ringBuffer.add(ValueType());
+        }
+    } else {
+        while (ringBuffer.size() > newCapacity) {
+            ringBuffer.remove(ringBuffer.size() - 1);
+        }
+        ringBuffer.shrinkToFit();
+    }
+    m_capacity = newCapacity;
 }
 
 template <typename ValueType>
@@ -538,9 +606,9 @@ int Queue<ValueType>::queueCompare(const Queue& queue2) const {
     for (int i1 = 0, i2 = 0;
          i1 < count && i2 < queue2.count;
          i1++, i2++) {
-        if (ringBuffer[(head + i1) % capacity] < queue2.ringBuffer[(queue2.head + i2) % queue2.capacity]) {
+        if (ringBuffer[(head + i1) % m_capacity] < queue2.ringBuffer[(queue2.head + i2) % queue2.m_capacity]) {
             return -1;
-        } else if (queue2.ringBuffer[(queue2.head + i2) % queue2.capacity] < ringBuffer[(head + i1) % capacity]) {
+        } else if (queue2.ringBuffer[(queue2.head + i2) % queue2.m_capacity] < ringBuffer[(head + i1) % m_capacity]) {
             return 1;
         }
     }
@@ -591,7 +659,7 @@ std::ostream& operator <<(std::ostream& os, const Queue<ValueType>& queue) {
         writeGenericValue(os, queue.ringBuffer[queue.head], /* forceQuotes */ true);
         for (int i = 1; i < queue.count; i++) {
             os << ", ";
-            writeGenericValue(os, queue.ringBuffer[(queue.head + i) % queue.capacity], /* forceQuotes */ true);
+            writeGenericValue(os, queue.ringBuffer[(queue.head + i) % queue.m_capacity], /* forceQuotes */ true);
         }
     }
     os << "}";
@@ -612,7 +680,7 @@ template <typename T>
 int hashCode(const Queue<T>& q) {
     int code = hashSeed();
     for (int i = 0; i < q.count; i++) {
-        code = hashMultiplier() * code + hashCode(q.ringBuffer[(q.head + i) % q.capacity]);
+        code = hashMultiplier() * code + hashCode(q.ringBuffer[(q.head + i) % q.m_capacity]);
     }
     return int(code & hashMask());
 }
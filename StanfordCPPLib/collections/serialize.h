@@ -0,0 +1,817 @@
+/*
+ * File: serialize.h
+ * -----------------
+ * Contains functions to save collections to a binary stream and load them
+ * back again, much faster than printing them with << and reading them
+ * with >>.
+ *
+ * serialize writes a collection to an output stream, and deserialize reads
+ * it back from an input stream, replacing the collection's contents.
+ * Vector, Grid, Map, HashMap, Set, HashSet, Lexicon, and Graph (including
+ * BasicGraph) are supported, with elements that are numbers, enums, bools,
+ * strings, or other supported collections:
+ *
+ *<pre>
+ *    ofstream out("words.dat", ios::binary);
+ *    serialize(out, wordCounts);      // a HashMap<string, int>
+ *    ...
+ *    ifstream in("words.dat", ios::binary);
+ *    deserialize(in, wordCounts);
+ *</pre>
+ *
+ * Each serialized collection starts with a short header giving the format
+ * version and what kind of collection follows, so reading data of the wrong
+ * kind fails cleanly rather than producing garbage.  Sizes are written
+ * before the data they describe, so a Vector, Grid, HashMap, or HashSet
+ * being read into is sized once up front rather than growing as it goes,
+ * and arrays of numbers in a Vector or Grid are copied as blocks.
+ * Sizes are checked against the amount of data left in the stream when
+ * the stream can tell (files and string streams can), so a damaged size
+ * is caught before anything is allocated for it; other streams are read
+ * into collections that are given room in moderate steps as data arrives.
+ * All data is stored in little-endian byte order.
+ * Nothing is read or written beyond the collection itself, so several
+ * collections can be written to the same stream one after another and read
+ * back in the same order.
+ *
+ * A Map can be read back as a HashMap and vice versa, and likewise a Set,
+ * HashSet, or Lexicon can be read back as any of the others.
+ * Numbers are written at their size on the machine writing them, so use
+ * types such as int and double, whose size is the same everywhere, rather
+ * than long, if the data will be read on a different platform.
+ *
+ * If the data is not a serialized collection of the right kind, or the
+ * stream ends early, deserialize sets the stream's fail state, just as >>
+ * does.  The collection is left holding whatever was read before the
+ * problem was found.
+ *
+ * @version 2018/10/15
+ * - initial version
+ * @since 2018/10/15
+ */
+
+#ifndef _serialize_h
+#define _serialize_h
+
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+#include "error.h"
+#include "graph.h"
+#include "grid.h"
+#include "hashmap.h"
+#include "hashset.h"
+#include "lexicon.h"
+#include "map.h"
+#include "set.h"
+#include "vector.h"
+
+namespace stanfordcpplib {
+namespace serialization {
+
+/*
+ * The first bytes of every serialized collection, and the version of the
+ * format that follows them.
+ */
+static const char MAGIC[4] = {'S', 'P', 'L', 'B'};
+static const unsigned char FORMAT_VERSION = 1;
+
+/*
+ * The kinds of collection; collections that can be read back as one another
+ * share a kind.
+ */
+enum Kind {
+    KIND_VECTOR = 1,
+    KIND_GRID = 2,
+    KIND_MAP = 3,
+    KIND_SET = 4,
+    KIND_GRAPH = 5
+};
+
+/*
+ * How many numbers are read into a Vector at a time.
+ */
+static const int READ_BLOCK_SIZE = 4096;
+
+/*
+ * The most elements that are made room for in advance when the stream
+ * cannot tell how much data it holds, so that a damaged size cannot make
+ * deserialize allocate a huge amount of memory.
+ */
+static const int MAX_UNCHECKED_RESERVE = 64 * 1024;
+
+/*
+ * Element types that are stored as their raw bytes, and can be copied
+ * in blocks.
+ * (bool is written as a single byte of its own.)
+ */
+template <typename T>
+struct IsBulk : std::integral_constant<bool,
+        (std::is_arithmetic<T>::value && !std::is_same<T, bool>::value) || std::is_enum<T>::value> {
+};
+
+/*
+ * The fewest bytes a serialized value of the given type can take:
+ * the size of a number, or the size that starts a string or collection.
+ */
+template <typename T, typename Enable = void>
+struct MinBytes : std::integral_constant<int, 4> {
+};
+
+template <typename T>
+struct MinBytes<T, typename std::enable_if<IsBulk<T>::value>::type>
+        : std::integral_constant<int, (int) sizeof(T)> {
+};
+
+template <>
+struct MinBytes<bool> : std::integral_constant<int, 1> {
+};
+
+inline bool isLittleEndian() {
+    const uint16_t one = 1;
+    unsigned char firstByte;
+    std::memcpy(&firstByte, &one, 1);
+    return firstByte == 1;
+}
+
+/*
+ * Reverses the bytes of each of the given elements, to convert them between
+ * little-endian and big-endian order.
+ */
+inline void swapBytes(char* data, int count, int elementSize) {
+    for (int i = 0; i < count; i++) {
+        char* element = data + (size_t) i * elementSize;
+        for (int a = 0, b = elementSize - 1; a < b; a++, b--) {
+            char temp = element[a];
+            element[a] = element[b];
+            element[b] = temp;
+        }
+    }
+}
+
+/*
+ * Writes bytes straight to an output stream's buffer.
+ */
+class Writer {
+public:
+    explicit Writer(std::ostream& out) : out(out) {}
+
+    void writeBytes(const void* data, size_t length) {
+        if (out && out.rdbuf()->sputn((const char*) data, (std::streamsize) length)
+                != (std::streamsize) length) {
+            out.setstate(std::ios_base::badbit);
+        }
+    }
+
+    template <typename T>
+    void writeArray(const T* data, int count) {
+        if (isLittleEndian() || sizeof(T) == 1) {
+            writeBytes(data, sizeof(T) * (size_t) count);
+        } else {
+            T buffer[256];
+            for (int i = 0; i < count; i += 256) {
+                int n = std::min(256, count - i);
+                std::memcpy(buffer, data + i, sizeof(T) * n);
+                swapBytes((char*) buffer, n, (int) sizeof(T));
+                writeBytes(buffer, sizeof(T) * n);
+            }
+        }
+    }
+
+    void writeSize(int size) {
+        uint32_t value = (uint32_t) size;
+        writeArray(&value, 1);
+    }
+
+private:
+    std::ostream& out;
+};
+
+/*
+ * Reads bytes straight from an input stream's buffer, never reading past
+ * the end of the collection.  After any failure the reader stays failed,
+ * and later reads give zeros.
+ */
+class Reader {
+public:
+    explicit Reader(std::istream& in) : in(in), failed(!in), available(-1) {
+        // find out how much data is left, if the stream can seek
+        std::streambuf* buffer = in.rdbuf();
+        if (!failed && buffer) {
+            std::streampos here = buffer->pubseekoff(0, std::ios_base::cur, std::ios_base::in);
+            if (here != std::streampos(-1)) {
+                std::streampos end = buffer->pubseekoff(0, std::ios_base::end, std::ios_base::in);
+                buffer->pubseekpos(here, std::ios_base::in);
+                if (end != std::streampos(-1)) {
+                    available = end - here;
+                }
+            }
+        }
+    }
+
+    explicit operator bool() const {
+        return !failed;
+    }
+
+    void fail() {
+        if (!failed) {
+            failed = true;
+            in.setstate(std::ios_base::failbit);
+        }
+    }
+
+    void readBytes(void* data, size_t length) {
+        if (failed || in.rdbuf()->sgetn((char*) data, (std::streamsize) length)
+                != (std::streamsize) length) {
+            std::memset(data, 0, length);
+            if (!failed) {
+                in.setstate(std::ios_base::eofbit);
+            }
+            fail();
+        } else if (available >= 0) {
+            available -= length;
+        }
+    }
+
+    /*
+     * Checks that the stream could hold the given number of values, each
+     * taking at least the given number of bytes, and fails if it cannot.
+     * Returns how many values to make room for in advance: all of them if
+     * the stream can tell how much data it holds, or else no more than
+     * MAX_UNCHECKED_RESERVE.
+     */
+    int reserveCount(int count, int minBytes) {
+        if (available < 0) {
+            return std::min(count, MAX_UNCHECKED_RESERVE);
+        } else if ((int64_t) count * minBytes > available) {
+            fail();
+            return 0;
+        } else {
+            return count;
+        }
+    }
+
+    template <typename T>
+    void readArray(T* data, int count) {
+        readBytes(data, sizeof(T) * (size_t) count);
+        if (!isLittleEndian() && sizeof(T) > 1) {
+            swapBytes((char*) data, count, (int) sizeof(T));
+        }
+    }
+
+    int readSize() {
+        uint32_t value = 0;
+        readArray(&value, 1);
+        if (value > (uint32_t) INT32_MAX) {
+            fail();
+            return 0;
+        }
+        return (int) value;
+    }
+
+private:
+    std::istream& in;
+    bool failed;
+    std::streamoff available;   // bytes left in the stream, or -1 if unknown
+};
+
+/*
+ * Element encoders, one per supported type.  They are all declared here
+ * first so that collections of collections find one another.
+ */
+template <typename T>
+typename std::enable_if<IsBulk<T>::value>::type writeValue(Writer& writer, const T& value);
+inline void writeValue(Writer& writer, bool value);
+inline void writeValue(Writer& writer, const std::string& value);
+template <typename T>
+void writeValue(Writer& writer, const Vector<T>& vec);
+template <typename T>
+void writeValue(Writer& writer, const Grid<T>& grid);
+template <typename K, typename V>
+void writeValue(Writer& writer, const Map<K, V>& map);
+template <typename K, typename V>
+void writeValue(Writer& writer, const HashMap<K, V>& map);
+template <typename T>
+void writeValue(Writer& writer, const Set<T>& set);
+template <typename T>
+void writeValue(Writer& writer, const HashSet<T>& set);
+inline void writeValue(Writer& writer, const Lexicon& lex);
+template <typename NodeType, typename ArcType>
+void writeValue(Writer& writer, const Graph<NodeType, ArcType>& graph);
+
+template <typename T>
+typename std::enable_if<IsBulk<T>::value>::type readValue(Reader& reader, T& value);
+inline void readValue(Reader& reader, bool& value);
+inline void readValue(Reader& reader, std::string& value);
+template <typename T>
+void readValue(Reader& reader, Vector<T>& vec);
+template <typename T>
+void readValue(Reader& reader, Grid<T>& grid);
+template <typename K, typename V>
+void readValue(Reader& reader, Map<K, V>& map);
+template <typename K, typename V>
+void readValue(Reader& reader, HashMap<K, V>& map);
+template <typename T>
+void readValue(Reader& reader, Set<T>& set);
+template <typename T>
+void readValue(Reader& reader, HashSet<T>& set);
+inline void readValue(Reader& reader, Lexicon& lex);
+template <typename NodeType, typename ArcType>
+void readValue(Reader& reader, Graph<NodeType, ArcType>& graph);
+
+/*
+ * Makes room for the given number of elements in a collection about to be
+ * read, if the collection has a reserve method; call as
+ * reserve(collection, size, 0).
+ */
+template <typename CollectionType>
+auto reserve(CollectionType& collection, int size, int)
+        -> decltype(collection.reserve(size), void()) {
+    collection.reserve(size);
+}
+
+template <typename CollectionType>
+void reserve(CollectionType& /* collection */, int /* size */, long) {
+    // trees such as Set and Map grow as they go
+}
+
+/*
+ * Writes or reads the elements of a collection that has begin/end,
+ * such as a Set or Lexicon.
+ */
+template <typename CollectionType>
+void writeElements(Writer& writer, const CollectionType& collection) {
+    writer.writeSize(collection.size());
+    for (const auto& element : collection) {
+        writeValue(writer, element);
+    }
+}
+
+template <typename CollectionType, typename ElementType>
+void readElements(Reader& reader, CollectionType& collection, ElementType& element) {
+    collection.clear();
+    int size = reader.readSize();
+    reserve(collection, reader.reserveCount(size, MinBytes<ElementType>::value), 0);
+    for (int i = 0; i < size && reader; i++) {
+        readValue(reader, element);
+        if (reader) {
+            collection.add(element);
+        }
+    }
+}
+
+template <typename MapType>
+void writeEntries(Writer& writer, const MapType& map) {
+    writer.writeSize(map.size());
+    for (const auto& key : map) {
+        writeValue(writer, key);
+        writeValue(writer, map.get(key));
+    }
+}
+
+template <typename MapType, typename KeyType, typename ValueType>
+void readEntries(Reader& reader, MapType& map, KeyType& key, ValueType& value) {
+    map.clear();
+    int size = reader.readSize();
+    reserve(map, reader.reserveCount(size, MinBytes<KeyType>::value + MinBytes<ValueType>::value), 0);
+    for (int i = 0; i < size && reader; i++) {
+        readValue(reader, key);
+        readValue(reader, value);
+        if (reader) {
+            map.put(key, value);
+        }
+    }
+}
+
+template <typename T>
+typename std::enable_if<IsBulk<T>::value>::type writeValue(Writer& writer, const T& value) {
+    writer.writeArray(&value, 1);
+}
+
+inline void writeValue(Writer& writer, bool value) {
+    unsigned char byte = value ? 1 : 0;
+    writer.writeBytes(&byte, 1);
+}
+
+inline void writeValue(Writer& writer, const std::string& value) {
+    writer.writeSize((int) value.length());
+    writer.writeBytes(value.data(), value.length());
+}
+
+/*
+ * Writes or reads an array of elements, as one block if they are numbers.
+ */
+template <typename T>
+void writeBlock(Writer& writer, const T* data, int count, std::true_type) {
+    writer.writeArray(data, count);
+}
+
+template <typename T>
+void writeBlock(Writer& writer, const T* data, int count, std::false_type) {
+    for (int i = 0; i < count; i++) {
+        writeValue(writer, data[i]);
+    }
+}
+
+template <typename T>
+void readBlock(Reader& reader, T* data, int count, std::true_type) {
+    reader.readArray(data, count);
+}
+
+template <typename T>
+void readBlock(Reader& reader, T* data, int count, std::false_type) {
+    for (int i = 0; i < count && reader; i++) {
+        readValue(reader, data[i]);
+    }
+}
+
+template <typename T>
+void writeValue(Writer& writer, const Vector<T>& vec) {
+    writer.writeSize(vec.size());
+    if (!vec.isEmpty()) {
+        writeBlock(writer, &vec[0], vec.size(), IsBulk<T>());
+    }
+}
+
+template <typename T>
+void writeValue(Writer& writer, const Grid<T>& grid) {
+    writer.writeSize(grid.numRows());
+    writer.writeSize(grid.numCols());
+    if (!grid.isEmpty()) {
+        writeBlock(writer, &grid.get(0, 0), grid.size(), IsBulk<T>());
+    }
+}
+
+template <typename K, typename V>
+void writeValue(Writer& writer, const Map<K, V>& map) {
+    writeEntries(writer, map);
+}
+
+template <typename K, typename V>
+void writeValue(Writer& writer, const HashMap<K, V>& map) {
+    writeEntries(writer, map);
+}
+
+template <typename T>
+void writeValue(Writer& writer, const Set<T>& set) {
+    writeElements(writer, set);
+}
+
+template <typename T>
+void writeValue(Writer& writer, const HashSet<T>& set) {
+    writeElements(writer, set);
+}
+
+inline void writeValue(Writer& writer, const Lexicon& lex) {
+    writeElements(writer, lex);
+}
+
+/*
+ * A graph is written as its node names, then its arcs, each of which
+ * refers to its start and finish nodes by their position in the names.
+ */
+template <typename NodeType, typename ArcType>
+void writeValue(Writer& writer, const Graph<NodeType, ArcType>& graph) {
+    std::unordered_map<const NodeType*, int> indexes;
+    writer.writeSize(graph.size());
+    for (const NodeType* node : graph.getNodeSet()) {
+        indexes[node] = (int) indexes.size();
+        writeValue(writer, node->name);
+    }
+    writer.writeSize(graph.getArcSet().size());
+    for (const ArcType* arc : graph.getArcSet()) {
+        writer.writeSize(indexes[arc->start]);
+        writer.writeSize(indexes[arc->finish]);
+        writeValue(writer, (double) arc->cost);
+    }
+}
+
+template <typename T>
+typename std::enable_if<IsBulk<T>::value>::type readValue(Reader& reader, T& value) {
+    reader.readArray(&value, 1);
+}
+
+inline void readValue(Reader& reader, bool& value) {
+    unsigned char byte = 0;
+    reader.readBytes(&byte, 1);
+    value = byte != 0;
+}
+
+inline void readValue(Reader& reader, std::string& value) {
+    int length = reader.readSize();
+    value.clear();
+    for (int done = 0; done < length && reader; ) {
+        int n = reader.reserveCount(length - done, 1);
+        value.resize(done + n);
+        reader.readBytes(&value[done], n);
+        done += n;
+    }
+}
+
+/*
+ * Reads the given number of elements onto the end of a vector.
+ * Numbers are read a block at a time.
+ */
+template <typename T>
+void readVectorElements(Reader& reader, Vector<T>& vec, int count, std::true_type) {
+    vec.reserve(vec.size() + reader.reserveCount(count, MinBytes<T>::value));
+    std::vector<T> buffer(std::min(count, READ_BLOCK_SIZE));
+    for (int done = 0; done < count && reader; done += READ_BLOCK_SIZE) {
+        int n = std::min(READ_BLOCK_SIZE, count - done);
+        reader.readArray(buffer.data(), n);
+        for (int i = 0; i < n && reader; i++) {
+            vec.add(buffer[i]);
+        }
+    }
+}
+
+template <typename T>
+void readVectorElements(Reader& reader, Vector<T>& vec, int count, std::false_type) {
+    vec.reserve(vec.size() + reader.reserveCount(count, MinBytes<T>::value));
+    T element;
+    for (int i = 0; i < count && reader; i++) {
+        readValue(reader, element);
+        if (reader) {
+            vec.add(element);
+        }
+    }
+}
+
+template <typename T>
+void readValue(Reader& reader, Vector<T>& vec) {
+    vec.clear();
+    int size = reader.readSize();
+    readVectorElements(reader, vec, size, IsBulk<T>());
+}
+
+template <typename T>
+void readValue(Reader& reader, Grid<T>& grid) {
+    int nRows = reader.readSize();
+    int nCols = reader.readSize();
+    if ((int64_t) nRows * nCols > INT32_MAX) {
+        reader.fail();
+        return;
+    }
+    int count = nRows * nCols;
+    if (!reader || reader.reserveCount(count, MinBytes<T>::value) < count) {
+        if (reader) {
+            // too big to allocate before seeing the data; read the elements
+            // into a growing vector first, then move them into the grid
+            Vector<T> elements;
+            readVectorElements(reader, elements, count, IsBulk<T>());
+            if (reader) {
+                grid.resize(nRows, nCols);
+                T* first = &grid[0][0];
+                for (int i = 0; i < count; i++) {
+                    first[i] = std::move(elements[i]);
+                }
+            }
+        }
+        return;
+    }
+    grid.resize(nRows, nCols);
+    if (grid.isEmpty()) {
+        return;
+    }
+    readBlock(reader, &grid[0][0], grid.size(), IsBulk<T>());
+}
+
+template <typename K, typename V>
+void readValue(Reader& reader, Map<K, V>& map) {
+    K key;
+    V value;
+    readEntries(reader, map, key, value);
+}
+
+/*
+ * The table is sized for all of the entries before any are added, so
+ * reading a HashMap from a file or string stream never has to rehash it.
+ */
+template <typename K, typename V>
+void readValue(Reader& reader, HashMap<K, V>& map) {
+    K key;
+    V value;
+    readEntries(reader, map, key, value);
+}
+
+template <typename T>
+void readValue(Reader& reader, Set<T>& set) {
+    T element;
+    readElements(reader, set, element);
+}
+
+template <typename T>
+void readValue(Reader& reader, HashSet<T>& set) {
+    T element;
+    readElements(reader, set, element);
+}
+
+inline void readValue(Reader& reader, Lexicon& lex) {
+    std::string word;
+    readElements(reader, lex, word);
+}
+
+template <typename NodeType, typename ArcType>
+void readValue(Reader& reader, Graph<NodeType, ArcType>& graph) {
+    graph.clear();
+    Vector<NodeType*> nodes;
+    int nodeCount = reader.readSize();
+    std::string name;
+    for (int i = 0; i < nodeCount && reader; i++) {
+        readValue(reader, name);
+        if (reader) {
+            nodes.add(graph.addNode(name));
+        }
+    }
+    int arcCount = reader.readSize();
+    for (int i = 0; i < arcCount && reader; i++) {
+        int start = reader.readSize();
+        int finish = reader.readSize();
+        double cost = 0;
+        readValue(reader, cost);
+        if (start >= nodes.size() || finish >= nodes.size()) {
+            reader.fail();
+        }
+        if (reader) {
+            ArcType* arc = new ArcType();
+            arc->start = nodes[start];
+            arc->finish = nodes[finish];
+            arc->cost = cost;
+            graph.addArc(arc);
+        }
+    }
+}
+
+inline void writeHeader(Writer& writer, Kind kind) {
+    writer.writeBytes(MAGIC, sizeof(MAGIC));
+    unsigned char bytes[2] = {FORMAT_VERSION, (unsigned char) kind};
+    writer.writeBytes(bytes, sizeof(bytes));
+}
+
+/*
+ * Reads a header and checks that it is for the given kind of collection.
+ */
+inline void readHeader(Reader& reader, Kind kind, const std::string& descriptor) {
+    char magic[sizeof(MAGIC)];
+    unsigned char bytes[2];
+    reader.readBytes(magic, sizeof(magic));
+    reader.readBytes(bytes, sizeof(bytes));
+    std::string problem;
+    if (!reader) {
+        problem = "unexpected end of input";
+    } else if (std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) {
+        problem = "not serialized data";
+    } else if (bytes[0] != FORMAT_VERSION) {
+        problem = "unsupported format version " + std::to_string(bytes[0]);
+    } else if (bytes[1] != kind) {
+        problem = "data is for a different kind of collection";
+    }
+    if (!problem.empty()) {
+        reader.fail();
+#ifdef SPL_ERROR_ON_COLLECTION_PARSE
+        error(descriptor + ": " + problem);
+#else
+        (void) descriptor;
+#endif
+    }
+}
+
+template <typename CollectionType>
+std::ostream& serializeCollection(std::ostream& out, const CollectionType& collection, Kind kind) {
+    Writer writer(out);
+    writeHeader(writer, kind);
+    writeValue(writer, collection);
+    out.flush();
+    return out;
+}
+
+template <typename CollectionType>
+std::istream& deserializeCollection(std::istream& in, CollectionType& collection, Kind kind,
+                                    const std::string& descriptor) {
+    Reader reader(in);
+    readHeader(reader, kind, descriptor);
+    if (reader) {
+        readValue(reader, collection);
+#ifdef SPL_ERROR_ON_COLLECTION_PARSE
+        if (!reader) {
+            error(descriptor + ": unexpected end of input");
+        }
+#endif
+    }
+    return in;
+}
+
+} // namespace serialization
+} // namespace stanfordcpplib
+
+/*
+ * Function: serialize
+ * Usage: serialize(out, collection);
+ * ----------------------------------
+ * Writes the given collection to the given output stream in binary form,
+ * to be read back with deserialize.  The stream should be opened in binary
+ * mode.  Returns the stream, which is in a failed state if writing failed.
+ */
+template <typename T>
+std::ostream& serialize(std::ostream& out, const Vector<T>& vec) {
+    return stanfordcpplib::serialization::serializeCollection(out, vec, stanfordcpplib::serialization::KIND_VECTOR);
+}
+
+template <typename T>
+std::ostream& serialize(std::ostream& out, const Grid<T>& grid) {
+    return stanfordcpplib::serialization::serializeCollection(out, grid, stanfordcpplib::serialization::KIND_GRID);
+}
+
+template <typename K, typename V>
+std::ostream& serialize(std::ostream& out, const Map<K, V>& map) {
+    return stanfordcpplib::serialization::serializeCollection(out, map, stanfordcpplib::serialization::KIND_MAP);
+}
+
+template <typename K, typename V>
+std::ostream& serialize(std::ostream& out, const HashMap<K, V>& map) {
+    return stanfordcpplib::serialization::serializeCollection(out, map, stanfordcpplib::serialization::KIND_MAP);
+}
+
+template <typename T>
+std::ostream& serialize(std::ostream& out, const Set<T>& set) {
+    return stanfordcpplib::serialization::serializeCollection(out, set, stanfordcpplib::serialization::KIND_SET);
+}
+
+template <typename T>
+std::ostream& serialize(std::ostream& out, const HashSet<T>& set) {
+    return stanfordcpplib::serialization::serializeCollection(out, set, stanfordcpplib::serialization::KIND_SET);
+}
+
+inline std::ostream& serialize(std::ostream& out, const Lexicon& lex) {
+    return stanfordcpplib::serialization::serializeCollection(out, lex, stanfordcpplib::serialization::KIND_SET);
+}
+
+template <typename NodeType, typename ArcType>
+std::ostream& serialize(std::ostream& out, const Graph<NodeType, ArcType>& graph) {
+    return stanfordcpplib::serialization::serializeCollection(out, graph, stanfordcpplib::serialization::KIND_GRAPH);
+}
+
+/*
+ * Function: deserialize
+ * Usage: deserialize(in, collection);
+ * -----------------------------------
+ * Reads a collection written by serialize from the given input stream,
+ * replacing the contents of the given collection.  The stream should be
+ * opened in binary mode.  Returns the stream, which is in a failed state if
+ * it did not hold a serialized collection of the right kind.
+ */
+template <typename T>
+std::istream& deserialize(std::istream& in, Vector<T>& vec) {
+    return stanfordcpplib::serialization::deserializeCollection(in, vec,
+            stanfordcpplib::serialization::KIND_VECTOR, "Vector::deserialize");
+}
+
+template <typename T>
+std::istream& deserialize(std::istream& in, Grid<T>& grid) {
+    return stanfordcpplib::serialization::deserializeCollection(in, grid,
+            stanfordcpplib::serialization::KIND_GRID, "Grid::deserialize");
+}
+
+template <typename K, typename V>
+std::istream& deserialize(std::istream& in, Map<K, V>& map) {
+    return stanfordcpplib::serialization::deserializeCollection(in, map,
+            stanfordcpplib::serialization::KIND_MAP, "Map::deserialize");
+}
+
+template <typename K, typename V>
+std::istream& deserialize(std::istream& in, HashMap<K, V>& map) {
+    return stanfordcpplib::serialization::deserializeCollection(in, map,
+            stanfordcpplib::serialization::KIND_MAP, "HashMap::deserialize");
+}
+
+template <typename T>
+std::istream& deserialize(std::istream& in, Set<T>& set) {
+    return stanfordcpplib::serialization::deserializeCollection(in, set,
+            stanfordcpplib::serialization::KIND_SET, "Set::deserialize");
+}
+
+template <typename T>
+std::istream& deserialize(std::istream& in, HashSet<T>& set) {
+    return stanfordcpplib::serialization::deserializeCollection(in, set,
+            stanfordcpplib::serialization::KIND_SET, "HashSet::deserialize");
+}
+
+inline std::istream& deserialize(std::istream& in, Lexicon& lex) {
+    return stanfordcpplib::serialization::deserializeCollection(in, lex,
+            stanfordcpplib::serialization::KIND_SET, "Lexicon::deserialize");
+}
+
+template <typename NodeType, typename ArcType>
+std::istream& deserialize(std::istream& in, Graph<NodeType, ArcType>& graph) {
+    return stanfordcpplib::serialization::deserializeCollection(in, graph,
+            stanfordcpplib::serialization::KIND_GRAPH, "Graph::deserialize");
+}
+
+#include "private/init.h"   // ensure that Stanford C++ lib is initialized
+
+#endif // _serialize_h
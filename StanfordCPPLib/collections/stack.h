@@ -4,6 +4,8 @@
  * This file exports the <code>Stack</code> class, which implements
  * a collection that processes values in a last-in/first-out (LIFO) order.
  * 
+ * @version 2018/10/15
+ * - added capacity, reserve, and shrinkToFit methods
  * @version 2016/12/09
  * - added iterator version checking support (implicitly via Vector)
  * @version 2016/09/24
@@ -74,6 +76,15 @@ public:
      * A synonym for the push method.
      */
     void add(const ValueType& value);
+
+    /*
+     * Method: capacity
+     * Usage: int n = stack.capacity();
+     * --------------------------------
+     * Returns the number of values this stack can hold before it must
+     * enlarge its internal storage.
+     */
+    int capacity() const;
     
     /*
      * Method: clear
@@ -136,6 +147,15 @@ public:
      */
     ValueType remove();
 
+    /*
+     * Method: reserve
+     * Usage: stack.reserve(n);
+     * ------------------------
+     * Makes room for the given number of values in this stack, so that
+     * pushing up to that many values will not make it enlarge its storage.
+     */
+    void reserve(int n);
+
     /*
      * Method: size
      * Usage: int n = stack.size();
@@ -143,6 +163,14 @@ public:
      * Returns the number of values in this stack.
      */
     int size() const;
+
+    /*
+     * Method: shrinkToFit
+     * Usage: stack.shrinkToFit();
+     * ---------------------------
+     * Frees any storage this stack holds beyond what its values need.
+     */
+    void shrinkToFit();
     
     /*
      * Method: top
@@ -309,6 +337,11 @@ void Stack<ValueType>::add(const ValueType& value) {
     push(value);
 }
 
+template <typename ValueType>
+int Stack<ValueType>::capacity() const {
+    return elements.capacity();
+}
+
 template <typename ValueType>
 void Stack<ValueType>::clear() {
     elements.clear();
@@ -352,6 +385,16 @@ ValueType Stack<ValueType>::remove() {
     return pop();
 }
 
+template <typename ValueType>
+void Stack<ValueType>::reserve(int n) {
+    elements.reserve(n);
+}
+
+template <typename ValueType>
+void Stack<ValueType>::shrinkToFit() {
+    elements.shrinkToFit();
+}
+
 template <typename ValueType>
 int Stack<ValueType>::size() const {
     return elements.size();
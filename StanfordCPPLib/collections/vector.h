@@ -4,6 +4,10 @@
  * This file exports the <code>Vector</code> class, which provides an
  * efficient, safe, convenient replacement for the array type in C++.
  *
+ * @version 2018/10/15
+ * - expandCapacity is timed by a TIMED_SCOPE (see profile.h)
+ * - added capacity, reserve, and shrinkToFit methods
+ * - growing the array moves the elements rather than copying them
  * @version 2018/09/06
  * - refreshed doc comments for new documentation generation
  * @version 2018/01/07
@@ -50,10 +54,12 @@
 #include <iterator>
 #include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
 #include "collections.h"
 #include "error.h"
 #include "hashcode.h"
+#include "profile.h"
 #include "random.h"
 #include "strlib.h"
 
@@ -136,6 +142,13 @@ public:
      */
     const ValueType& back() const;
 
+    /**
+     * Returns the number of elements this vector can hold before it must
+     * enlarge its internal array.
+     * @bigoh O(1)
+     */
+    int capacity() const;
+
     /**
      * Removes all elements from this vector.
      * @bigoh O(1)
@@ -303,6 +316,16 @@ public:
      */
     void removeValue(const ValueType& value);
 
+    /**
+     * Makes the vector's internal array large enough to hold the given number
+     * of elements, so that adding up to that many elements will not make it
+     * enlarge the array again.
+     * Unlike ensureCapacity, allocates exactly the given length, not more.
+     * Never shrinks the array.
+     * @bigoh O(N)
+     */
+    void reserve(int n);
+
     /**
      * Reverses the order of the elements in this vector.
      * For example, if vector stores {1, 3, 4, 9}, changes it to store {9, 4, 3, 1}.
@@ -318,6 +341,13 @@ public:
      * @bigoh O(1)
      */
     void set(int index, const ValueType& value);
+
+    /**
+     * Shrinks the vector's internal array to hold only its current elements,
+     * freeing the unused space.
+     * @bigoh O(N)
+     */
+    void shrinkToFit();
     
     /**
      * Returns the number of elements in this vector.
@@ -501,7 +531,7 @@ private:
 
     /* Instance variables */
     ValueType* elements;        // a dynamic array of the elements
-    int capacity;               // the allocated size of the array
+    int m_capacity;               // the allocated size of the array
     int count;                  // the number of elements in use
     unsigned int m_version = 0; // structure version for detecting invalid iterators
 
@@ -519,6 +549,7 @@ private:
 
     void expandCapacity();
     void deepCopy(const Vector& src);
+    void reallocate(int newCapacity);
 
     /*
      * Hidden features
@@ -736,7 +767,7 @@ public:
 template <typename ValueType>
 Vector<ValueType>::Vector()
         : elements(nullptr),
-          capacity(0),
+          m_capacity(0),
           count(0) {
     // empty
 }
@@ -744,7 +775,7 @@ Vector<ValueType>::Vector()
 template <typename ValueType>
 Vector<ValueType>::Vector(int n, ValueType value)
         : elements(nullptr),
-          capacity(n),
+          m_capacity(n),
           count(n) {
     if (n < 0) {
         error("Vector::constructor: n cannot be negative: " + integerToString(n));
@@ -759,7 +790,7 @@ Vector<ValueType>::Vector(int n, ValueType value)
 template <typename ValueType>
 Vector<ValueType>::Vector(const std::vector<ValueType>& v) {
     count = v.size();
-    capacity = v.size();
+    m_capacity = v.size();
     elements = new ValueType[count];
     for (int i = 0; i < count; i++) {
         elements[i] = v[i];
@@ -769,8 +800,8 @@ Vector<ValueType>::Vector(const std::vector<ValueType>& v) {
 template <typename ValueType>
 Vector<ValueType>::Vector(std::initializer_list<ValueType> list)
         : count(0) {
-    capacity = list.size();
-    elements = new ValueType[capacity];
+    m_capacity = list.size();
+    elements = new ValueType[m_capacity];
     addAll(list);
 }
 
@@ -836,13 +867,18 @@ const ValueType& Vector<ValueType>::back() const {
     return elements[count - 1];
 }
 
+template <typename ValueType>
+int Vector<ValueType>::capacity() const {
+    return m_capacity;
+}
+
 template <typename ValueType>
 void Vector<ValueType>::clear() {
     if (elements) {
         delete[] elements;
     }
     count = 0;
-    capacity = 0;
+    m_capacity = 0;
     elements = nullptr;
     m_version++;
 }
@@ -857,16 +893,8 @@ bool Vector<ValueType>::contains(const ValueType& value) const {
 // See also: expandCapacity
 template <typename ValueType>
 void Vector<ValueType>::ensureCapacity(int cap) {
-    if (cap >= 1 && capacity < cap) {
-        capacity = std::max(cap, capacity * 2);
-        ValueType* array = new ValueType[capacity];
-        if (elements) {
-            for (int i = 0; i < count; i++) {
-                array[i] = elements[i];
-            }
-            delete[] elements;
-        }
-        elements = array;
+    if (cap >= 1 && m_capacity < cap) {
+        reallocate(std::max(cap, m_capacity * 2));
     }
 }
 
@@ -878,21 +906,33 @@ bool Vector<ValueType>::equals(const Vector<ValueType>& v) const {
 /*
  * Implementation notes: expandCapacity
  * ------------------------------------
- * This function doubles the array capacity, copies the old elements
+ * This function doubles the array capacity, moves the old elements
  * into the new array, and then frees the old one.
  * See also: ensureCapacity
  */
 template <typename ValueType>
 void Vector<ValueType>::expandCapacity() {
-    capacity = std::max(1, capacity * 2);
-    ValueType* array = new ValueType[capacity];
+    TIMED_SCOPE("Vector::expandCapacity");
+    reallocate(std::max(1, m_capacity * 2));
+}
+
+/*
+ * Implementation notes: reallocate
+ * --------------------------------
+ * This function replaces the array with one of the given length, which
+ * must be at least count, and moves the elements into it.
+ */
+template <typename ValueType>
+void Vector<ValueType>::reallocate(int newCapacity) {
+    ValueType* array = (newCapacity == 0) ? nullptr : new ValueType[newCapacity];
     if (elements) {
         for (int i = 0; i < count; i++) {
-            array[i] = elements[i];
+            array[i] = std::move(elements[i]);
         }
         delete[] elements;
     }
     elements = array;
+    m_capacity = newCapacity;
 }
 
 template <typename ValueType>
@@ -937,7 +977,7 @@ int Vector<ValueType>::indexOf(const ValueType& value) const {
 template <typename ValueType>
 void Vector<ValueType>::insert(int index, const ValueType& value) {
     checkIndex(index, 0, count, "insert");
-    if (count == capacity) {
+    if (count == m_capacity) {
         expandCapacity();
     }
     for (int i = count; i > index; i--) {
@@ -1031,6 +1071,13 @@ void Vector<ValueType>::remove(int index) {
     m_version++;
 }
 
+template <typename ValueType>
+void Vector<ValueType>::reserve(int n) {
+    if (m_capacity < n) {
+        reallocate(n);
+    }
+}
+
 template <typename ValueType>
 ValueType Vector<ValueType>::removeBack() {
     return pop_back();
@@ -1067,6 +1114,13 @@ int Vector<ValueType>::size() const {
     return count;
 }
 
+template <typename ValueType>
+void Vector<ValueType>::shrinkToFit() {
+    if (m_capacity > count) {
+        reallocate(count);
+    }
+}
+
 template <typename ValueType>
 void Vector<ValueType>::shuffle() {
     for (int i = 0; i < count; i++) {
@@ -1230,8 +1284,8 @@ void Vector<ValueType>::checkIndex(int index, int min, int max, std::string pref
 template <typename ValueType>
 void Vector<ValueType>::deepCopy(const Vector& src) {
     count = src.count;
-    capacity = src.count;
-    elements = (capacity == 0) ? nullptr : new ValueType[capacity];
+    m_capacity = src.count;
+    elements = (m_capacity == 0) ? nullptr : new ValueType[m_capacity];
     for (int i = 0; i < count; i++) {
         elements[i] = src.elements[i];
     }
@@ -2,6 +2,8 @@
  * File: gcanvas.cpp
  * -----------------
  *
+ * @version 2018/10/15
+ * - added beginUpdate/endUpdate to batch repaints of both layers
  * @version 2018/09/04
  * - added double-click event support
  * @version 2018/08/23
@@ -122,6 +124,10 @@ void GCanvas::add(GObject& gobj, double x, double y) {
     _gcompound.add(gobj, x, y);   // calls conditionalRepaint
 }
 
+void GCanvas::beginUpdate() {
+    _gcompound.beginUpdate();
+}
+
 void GCanvas::clear() {
     clearPixels();
     clearObjects();
@@ -143,6 +149,18 @@ void GCanvas::clearPixels() {
     conditionalRepaint();
 }
 
+void GCanvas::conditionalRepaint() {
+    _gcompound.conditionalRepaint();   // deferred if inside beginUpdate
+}
+
+void GCanvas::conditionalRepaintRegion(int x, int y, int width, int height) {
+    _gcompound.conditionalRepaintRegion(x, y, width, height);   // deferred if inside beginUpdate
+}
+
+void GCanvas::conditionalRepaintRegion(const GRectangle& bounds) {
+    _gcompound.conditionalRepaintRegion(bounds);   // deferred if inside beginUpdate
+}
+
 bool GCanvas::contains(double x, double y) const {
     return _gcompound.contains(x, y);
 }
@@ -280,6 +298,10 @@ void GCanvas::ensureBackgroundImageConstHack() const {
     }
 }
 
+void GCanvas::endUpdate() {
+    _gcompound.endUpdate();
+}
+
 bool GCanvas::equals(const GCanvas& other) const {
     if (getSize() != other.getSize()) {
         return false;
@@ -433,6 +455,10 @@ bool GCanvas::isAutoRepaint() const {
     return _gcompound.isAutoRepaint();
 }
 
+bool GCanvas::isUpdating() const {
+    return _gcompound.isUpdating();
+}
+
 void GCanvas::load(const std::string& filename) {
     // for efficiency, let's at least check whether the file exists
     // and throw error immediately rather than contacting the back-end
@@ -3,6 +3,8 @@
  * ---------------
  *
  * @author Marty Stepp
+ * @version 2018/10/15
+ * - added beginUpdate/endUpdate to batch repaints of both layers
  * @version 2018/09/10
  * - added doc comments for new documentation generation
  * @version 2018/09/04
@@ -170,6 +172,9 @@ public:
      */
     virtual void add(GObject& gobj, double x, double y);
 
+    /* @inherit */
+    virtual void beginUpdate() Q_DECL_OVERRIDE;
+
     /**
      * Removes all graphical objects from the canvas foreground layer
      * and wipes the background layer to show the current background color.
@@ -197,6 +202,15 @@ public:
      */
     virtual void clearPixels();
 
+    /* @inherit */
+    virtual void conditionalRepaint() Q_DECL_OVERRIDE;
+
+    /* @inherit */
+    virtual void conditionalRepaintRegion(int x, int y, int width, int height) Q_DECL_OVERRIDE;
+
+    /* @inherit */
+    virtual void conditionalRepaintRegion(const GRectangle& bounds) Q_DECL_OVERRIDE;
+
     /**
      * Returns true if any of the graphical objects in the foreground layer of
      * the canvas touch the given x/y pixel.
@@ -273,6 +287,9 @@ public:
      */
     virtual void draw(QPainter* painter) Q_DECL_OVERRIDE;
 
+    /* @inherit */
+    virtual void endUpdate() Q_DECL_OVERRIDE;
+
     /**
      * Returns true if the two given canvases contain exactly the same pixel data.
      */
@@ -424,6 +441,9 @@ public:
     /* @inherit */
     virtual bool isAutoRepaint() const Q_DECL_OVERRIDE;
 
+    /* @inherit */
+    virtual bool isUpdating() const Q_DECL_OVERRIDE;
+
     /**
      * Reads the canvas's pixel contents from the given image file.
      * @throw ErrorException if the given file does not exist or cannot be read
@@ -4,14 +4,23 @@
  * This file implements the gconsolewindow.h interface.
  *
  * @author Marty Stepp
+ * @version 2018/10/15
+ * - getAllOutput includes queued output that has not been drawn yet
+ * - the record of all output kept for getAllOutput is capped
+ * @version 2018/10/01
+ * - print() queues output; queued output is drawn in one batch per frame
+ * - retained scrollback is capped (oldest lines are discarded first)
  * @version 2018/08/23
  * - initial version, separated out from console.cpp
  */
 
 #include "gconsolewindow.h"
+#include <algorithm>
 #include <cstdio>
 #include <QAction>
+#include <QTextDocument>
 #include <QTextDocumentFragment>
+#include <QTimer>
 #include "error.h"
 #include "exceptions.h"
 #include "filelib.h"
@@ -26,6 +35,7 @@
 #include "goptionpane.h"
 #include "gthread.h"
 #include "qtgui.h"
+#include "require.h"
 #include "private/static.h"
 #include "private/version.h"
 
@@ -48,9 +58,31 @@ const std::string GConsoleWindow::DEFAULT_BACKGROUND_COLOR = "white";
 const std::string GConsoleWindow::DEFAULT_ERROR_COLOR = "red";
 const std::string GConsoleWindow::DEFAULT_OUTPUT_COLOR = "black";
 const std::string GConsoleWindow::USER_INPUT_COLOR = "blue";
+const int GConsoleWindow::DEFAULT_MAX_SCROLLBACK_LINES = 100000;
+const int GConsoleWindow::OUTPUT_FLUSH_DELAY_MS = 16;        // ~1 frame at 60fps
+const int GConsoleWindow::OUTPUT_FLUSH_MAX_BYTES = 1 << 20;  // 1MB of pending text
+const int GConsoleWindow::MAX_ALL_OUTPUT_BYTES = 16 << 20;   // 16MB kept for getAllOutput
 GConsoleWindow* GConsoleWindow::_instance = nullptr;
 bool GConsoleWindow::_consoleEnabled = false;
 
+/*
+ * Adds the given text to a record of all console output.  Once the record
+ * reaches the given size, the rest of the text and all later text are left
+ * out, so a program stuck printing in a loop can't use up all memory; a
+ * note at the end of the record says that it was cut short.
+ */
+static void appendOutputRecord(std::string& record, const std::string& text, int maxBytes) {
+    if ((int) record.length() >= maxBytes) {
+        return;   // already cut short
+    }
+    if ((int) (record.length() + text.length()) < maxBytes) {
+        record += text;
+    } else {
+        record.append(text, 0, maxBytes - record.length());
+        record += "\n... (output truncated)\n";
+    }
+}
+
 /* static */ bool GConsoleWindow::consoleEnabled() {
     return _consoleEnabled;
 }
@@ -92,7 +124,13 @@ GConsoleWindow::GConsoleWindow()
           _inputBuffer(""),
           _lastSaveFileName(""),
           _cinout_new_buf(nullptr),
-          _cerr_new_buf(nullptr) {
+          _cerr_new_buf(nullptr),
+          _pendingOutputBytes(0),
+          _outputFlushScheduled(false),
+          _maxScrollbackLines(DEFAULT_MAX_SCROLLBACK_LINES),
+          _outputLineCount(0),
+          _outputStartTimeMS(0),
+          _outputLastTimeMS(0) {
     _initMenuBar();
     _initWidgets();
     _initStreams();
@@ -197,6 +235,7 @@ void GConsoleWindow::_initWidgets() {
     // _textArea->setRowsColumns(25, 70);
     QTextEdit* rawTextEdit = static_cast<QTextEdit*>(_textArea->getWidget());
     rawTextEdit->setTabChangesFocus(false);
+    rawTextEdit->document()->setMaximumBlockCount(_maxScrollbackLines);
     _textArea->setKeyListener([this](GEvent event) {
         if (event.getEventType() == KEY_PRESSED) {
             this->processKeyPress(event);
@@ -270,6 +309,10 @@ void GConsoleWindow::clearConsole() {
         printf("%s\n", msg.c_str());
 
         // clear the graphical console window
+        // (draw any queued output first so that it is cleared too)
+        GThread::runOnQtGuiThread([this]() {
+            flushOutput();
+        });
         _coutMutex.lock();
         _textArea->clearText();
         _coutMutex.unlock();
@@ -342,6 +385,36 @@ void GConsoleWindow::clipboardPaste() {
     }
 }
 
+void GConsoleWindow::flushOutput() {
+    // grab everything queued so far; writers may keep queueing while we draw.
+    // _coutMutex is held from here on so that getAllOutput sees each run
+    // either still queued or already recorded, never neither
+    Vector<OutputRun> runs;
+    _coutMutex.lock();
+    _pendingOutputMutex.lock();
+    std::swap(runs, _pendingOutput);
+    _pendingOutputBytes = 0;
+    _outputFlushScheduled = false;
+    _pendingOutputMutex.unlock();
+
+    if (runs.isEmpty()) {
+        _coutMutex.unlock();
+        return;
+    }
+
+    long lines = 0;
+    for (const OutputRun& run : runs) {
+        appendOutputRecord(_allOutputBuffer, run.text, MAX_ALL_OUTPUT_BYTES);
+        _textArea->appendFormattedText(run.text, run.isStdErr ? getErrorColor() : getOutputColor());
+        lines += (long) std::count(run.text.begin(), run.text.end(), '\n');
+    }
+    _textArea->moveCursorToEnd();
+    _textArea->scrollToBottom();
+    _outputLineCount += lines;
+    _outputLastTimeMS = GEvent::getCurrentTimeMS();
+    _coutMutex.unlock();
+}
+
 void GConsoleWindow::close() {
     shutdown();
     GWindow::close();   // call super
@@ -365,7 +438,14 @@ void GConsoleWindow::compareOutput(const std::string& filename) {
 std::string GConsoleWindow::getAllOutput() const {
     GConsoleWindow* thisHack = (GConsoleWindow*) this;
     thisHack->_coutMutex.lock();
-    std::string allOutput = thisHack->_allOutputBuffer.str();
+    std::string allOutput = _allOutputBuffer;
+
+    // include output that has been queued but not yet drawn
+    thisHack->_pendingOutputMutex.lock();
+    for (const OutputRun& run : _pendingOutput) {
+        appendOutputRecord(allOutput, run.text, MAX_ALL_OUTPUT_BYTES);
+    }
+    thisHack->_pendingOutputMutex.unlock();
     thisHack->_coutMutex.unlock();
     return allOutput;
 }
@@ -394,6 +474,22 @@ std::string GConsoleWindow::getForeground() const {
     return getOutputColor();
 }
 
+int GConsoleWindow::getMaxScrollbackLines() const {
+    return _maxScrollbackLines;
+}
+
+double GConsoleWindow::getOutputLinesPerSecond() const {
+    GConsoleWindow* thisHack = (GConsoleWindow*) this;
+    thisHack->_coutMutex.lock();
+    long lines = _outputLineCount;
+    long elapsedMS = _outputLastTimeMS - _outputStartTimeMS;
+    thisHack->_coutMutex.unlock();
+    if (lines == 0 || elapsedMS <= 0) {
+        return 0.0;
+    }
+    return lines * 1000.0 / elapsedMS;
+}
+
 int GConsoleWindow::getForegroundInt() const {
     return GColor::convertColorToRGB(getOutputColor());
 }
@@ -570,14 +666,36 @@ void GConsoleWindow::print(const std::string& str, bool isStdErr) {
             fflush(isStdErr ? stdout : stderr);
         }
     }
-    GThread::runOnQtGuiThreadAsync([this, str, isStdErr]() {
-        _coutMutex.lock();
-        _allOutputBuffer << str;
-        this->_textArea->appendFormattedText(str, isStdErr ? getErrorColor() : getOutputColor());
-        this->_textArea->moveCursorToEnd();
-        this->_textArea->scrollToBottom();
-        _coutMutex.unlock();
-    });
+
+    // queue the text; consecutive writes to the same stream share one run
+    _pendingOutputMutex.lock();
+    if (_outputStartTimeMS == 0) {
+        _outputStartTimeMS = GEvent::getCurrentTimeMS();
+    }
+    if (!_pendingOutput.isEmpty() && _pendingOutput.back().isStdErr == isStdErr) {
+        _pendingOutput.back().text += str;
+    } else {
+        _pendingOutput.add(OutputRun{str, isStdErr});
+    }
+    _pendingOutputBytes += (int) str.length();
+    bool scheduleFlush = !_outputFlushScheduled;
+    _outputFlushScheduled = true;
+    bool backlogged = _pendingOutputBytes >= OUTPUT_FLUSH_MAX_BYTES;
+    _pendingOutputMutex.unlock();
+
+    if (backlogged) {
+        // GUI is falling behind; make the writer wait for it to catch up
+        GThread::runOnQtGuiThread([this]() {
+            flushOutput();
+        });
+    } else if (scheduleFlush) {
+        // draw everything that arrives within the next frame in one batch
+        GThread::runOnQtGuiThreadAsync([this]() {
+            QTimer::singleShot(OUTPUT_FLUSH_DELAY_MS, [this]() {
+                flushOutput();
+            });
+        });
+    }
 }
 
 void GConsoleWindow::println(bool isStdErr) {
@@ -900,7 +1018,9 @@ void GConsoleWindow::processUserInputEnterKey() {
     _inputCommandHistory.add(_inputBuffer);
     _commandHistoryIndex = _inputCommandHistory.size();
     _cinQueueMutex.unlock();
-    _allOutputBuffer << _inputBuffer << std::endl;
+    _coutMutex.lock();
+    appendOutputRecord(_allOutputBuffer, _inputBuffer + "\n", MAX_ALL_OUTPUT_BYTES);
+    _coutMutex.unlock();
     _inputBuffer = "";   // clear input buffer
     this->_textArea->appendFormattedText("\n", USER_INPUT_COLOR);
     _cinMutex.unlock();
@@ -980,6 +1100,10 @@ std::string GConsoleWindow::readLine() {
         return line;
     }
 
+    // make sure the prompt is drawn before any echoed input
+    GThread::runOnQtGuiThread([this]() {
+        flushOutput();
+    });
     this->_textArea->moveCursorToEnd();
     this->_textArea->scrollToBottom();
     this->toFront();   // move window to front on prompt for input
@@ -1000,7 +1124,7 @@ std::string GConsoleWindow::readLine() {
             // echo user input, as if the user had just typed it
             GThread::runOnQtGuiThreadAsync([this, line]() {
                 _coutMutex.lock();
-                _allOutputBuffer << line << std::endl;
+                appendOutputRecord(_allOutputBuffer, line + "\n", MAX_ALL_OUTPUT_BYTES);
                 _textArea->appendFormattedText(line + "\n", USER_INPUT_COLOR, "*-*-Bold");
                 _coutMutex.unlock();
             });
@@ -1157,6 +1281,15 @@ void GConsoleWindow::setErrorColor(const std::string& errorColor) {
     _errorColor = errorColor;
 }
 
+void GConsoleWindow::setMaxScrollbackLines(int lines) {
+    require::nonNegative(lines, "GConsoleWindow::setMaxScrollbackLines", "lines");
+    _maxScrollbackLines = lines;
+    GThread::runOnQtGuiThread([this, lines]() {
+        QTextEdit* rawTextEdit = static_cast<QTextEdit*>(_textArea->getWidget());
+        rawTextEdit->document()->setMaximumBlockCount(lines);
+    });
+}
+
 void GConsoleWindow::setOutputColor(int rgb) {
     setOutputColor(GColor::convertRGBToColor(rgb));
 }
@@ -3,6 +3,10 @@
  * ----------------------
  * 
  * @author Marty Stepp
+ * @version 2018/10/15
+ * - getAllOutput includes output not yet drawn; its record is capped
+ * @version 2018/10/01
+ * - coalesced output pipeline; scrollback limit; output throughput stats
  * @version 2018/09/07
  * - added doc comments for new documentation generation
  * @version 2018/08/23
@@ -65,6 +69,8 @@ public:
     virtual std::string getErrorColor() const;
     virtual std::string getForeground() const Q_DECL_OVERRIDE;
     virtual int getForegroundInt() const Q_DECL_OVERRIDE;
+    virtual int getMaxScrollbackLines() const;
+    virtual double getOutputLinesPerSecond() const;
     virtual std::string getOutputColor() const;
     virtual bool isClearEnabled() const;
     virtual bool isEcho() const;
@@ -101,6 +107,7 @@ public:
     virtual void setForeground(const std::string& color) Q_DECL_OVERRIDE;
     virtual void setLocationSaved(bool locationSaved);
     virtual void setLocked(bool locked);
+    virtual void setMaxScrollbackLines(int lines);
     virtual void setOutputColor(int rgb);
     virtual void setOutputColor(const std::string& outputColor);
     virtual void shutdown();
@@ -122,9 +129,22 @@ private:
     static const std::string DEFAULT_ERROR_COLOR;
     static const std::string DEFAULT_OUTPUT_COLOR;
     static const std::string USER_INPUT_COLOR;
+    static const int DEFAULT_MAX_SCROLLBACK_LINES;
+    static const int OUTPUT_FLUSH_DELAY_MS;
+    static const int OUTPUT_FLUSH_MAX_BYTES;
+    static const int MAX_ALL_OUTPUT_BYTES;
     static GConsoleWindow* _instance;
     static bool _consoleEnabled;
 
+    /*
+     * A run of consecutive output written to the same stream (cout or cerr),
+     * waiting to be drawn onto the text area by flushOutput.
+     */
+    struct OutputRun {
+        std::string text;
+        bool isStdErr;
+    };
+
     Q_DISABLE_COPY(GConsoleWindow)
 
     GConsoleWindow();
@@ -133,6 +153,7 @@ private:
     void _initWidgets();
     void _initStreams();
     virtual void checkForUpdates();
+    void flushOutput();
     QTextFragment getUserInputFragment() const;
     int getUserInputStart() const;
     int getUserInputEnd() const;
@@ -163,7 +184,16 @@ private:
     Vector<std::string> _inputCommandHistory;
     stanfordcpplib::qtgui::ConsoleStreambufQt* _cinout_new_buf;
     stanfordcpplib::qtgui::ConsoleStreambufQt* _cerr_new_buf;
-    std::ostringstream _allOutputBuffer;
+    std::string _allOutputBuffer;   // everything printed and typed, for getAllOutput;
+                                    // guarded by _coutMutex, capped at MAX_ALL_OUTPUT_BYTES
+    Vector<OutputRun> _pendingOutput;
+    int _pendingOutputBytes;
+    bool _outputFlushScheduled;
+    int _maxScrollbackLines;
+    long _outputLineCount;
+    long _outputStartTimeMS;
+    long _outputLastTimeMS;
+    QMutex _pendingOutputMutex;
     QReadWriteLock _cinMutex;
     QReadWriteLock _cinQueueMutex;
     QMutex _coutMutex;
@@ -3,6 +3,10 @@
  * -------------------------
  *
  * @author Marty Stepp
+ * @version 2018/10/19
+ * - GBatchUpdate's destructor never throws
+ * @version 2018/10/15
+ * - added beginUpdate/endUpdate and GBatchUpdate to batch repaints
  * @version 2018/08/23
  * - renamed to gdrawingsurface.cpp to replace Java version
  * @version 2018/07/11
@@ -11,6 +15,7 @@
 
 #include "gdrawingsurface.h"
 #include <QPainter>
+#include "error.h"
 #include "gcolor.h"
 #include "gfont.h"
 #include "require.h"
@@ -27,7 +32,9 @@ GDrawingSurface::GDrawingSurface()
           _fillColorInt(0),
           _lineStyle(GObject::LINE_SOLID),
           _lineWidth(1),
-          _autoRepaint(true) {
+          _autoRepaint(true),
+          _updateDepth(0),
+          _updateDirty(false) {
     // empty
 }
 
@@ -35,6 +42,14 @@ GDrawingSurface::~GDrawingSurface() {
     _forwardTarget = nullptr;
 }
 
+void GDrawingSurface::beginUpdate() {
+    if (_forwardTarget) {
+        _forwardTarget->beginUpdate();
+    } else {
+        _updateDepth++;
+    }
+}
+
 void GDrawingSurface::checkBounds(const std::string& member, double x, double y, double width, double height) const {
     require::inRange2D(x, y, width - 1, height - 1, member);
 }
@@ -61,6 +76,8 @@ void GDrawingSurface::checkSize(const std::string& /* member */, double /* width
 void GDrawingSurface::conditionalRepaint() {
     if (_forwardTarget) {
         _forwardTarget->conditionalRepaint();
+    } else if (_updateDepth > 0) {
+        _updateDirty = true;
     } else {
         if (isAutoRepaint()) {
             repaint();
@@ -69,15 +86,18 @@ void GDrawingSurface::conditionalRepaint() {
 }
 
 void GDrawingSurface::conditionalRepaintRegion(int x, int y, int width, int height) {
-    if (isAutoRepaint()) {
+    if (_forwardTarget) {
+        _forwardTarget->conditionalRepaintRegion(x, y, width, height);
+    } else if (_updateDepth > 0) {
+        _updateDirty = true;
+    } else if (isAutoRepaint()) {
         repaintRegion(x, y, width, height);
     }
 }
 
 void GDrawingSurface::conditionalRepaintRegion(const GRectangle& bounds) {
-    if (isAutoRepaint()) {
-        repaintRegion(bounds);
-    }
+    conditionalRepaintRegion((int) bounds.getX(), (int) bounds.getY(),
+                             (int) bounds.getWidth(), (int) bounds.getHeight());
 }
 
 void GDrawingSurface::draw(GObject* gobj, double x, double y) {
@@ -177,6 +197,21 @@ void GDrawingSurface::drawString(const std::string& text, double x, double y) {
     draw(str);
 }
 
+void GDrawingSurface::endUpdate() {
+    if (_forwardTarget) {
+        _forwardTarget->endUpdate();
+        return;
+    }
+    if (_updateDepth <= 0) {
+        error("GDrawingSurface::endUpdate: called without a matching beginUpdate");
+    }
+    _updateDepth--;
+    if (_updateDepth == 0 && _updateDirty) {
+        _updateDirty = false;
+        conditionalRepaint();
+    }
+}
+
 void GDrawingSurface::fillArc(double x, double y, double width, double height, double start, double sweep) {
     GArc arc(x, y, width, height, start, sweep);
     initializeGObject(arc, /* filled */ true);
@@ -335,6 +370,14 @@ bool GDrawingSurface::isRepaintImmediately() const {
     return isAutoRepaint();
 }
 
+bool GDrawingSurface::isUpdating() const {
+    if (_forwardTarget) {
+        return _forwardTarget->isUpdating();
+    } else {
+        return _updateDepth > 0;
+    }
+}
+
 void GDrawingSurface::repaintRegion(const GRectangle& bounds) {
     repaintRegion((int) bounds.getX(), (int) bounds.getY(),
                   (int) bounds.getWidth(), (int) bounds.getHeight());
@@ -483,6 +526,11 @@ void GDrawingSurface::setRGB(double x, double y, const std::string& color) {
 }
 
 
+void GForwardDrawingSurface::beginUpdate() {
+    ensureForwardTarget();
+    _forwardTarget->beginUpdate();
+}
+
 void GForwardDrawingSurface::clear() {
     if (_forwardTarget) {
         _forwardTarget->clear();
@@ -514,6 +562,11 @@ void GForwardDrawingSurface::draw(QPainter* painter) {
     _forwardTarget->draw(painter);
 }
 
+void GForwardDrawingSurface::endUpdate() {
+    ensureForwardTarget();
+    _forwardTarget->endUpdate();
+}
+
 void GForwardDrawingSurface::ensureForwardTargetConstHack() const {
     if (!_forwardTarget) {
         // Your whole life has been a lie.
@@ -548,6 +601,11 @@ bool GForwardDrawingSurface::isAutoRepaint() const {
     return _forwardTarget->isAutoRepaint();
 }
 
+bool GForwardDrawingSurface::isUpdating() const {
+    ensureForwardTargetConstHack();
+    return _forwardTarget->isUpdating();
+}
+
 void GForwardDrawingSurface::repaint() {
     if (_forwardTarget) {
         _forwardTarget->repaint();
@@ -644,3 +702,47 @@ void GForwardDrawingSurface::setRepaintImmediately(bool repaintImmediately) {
     ensureForwardTarget();
     _forwardTarget->setAutoRepaint(repaintImmediately);
 }
+
+
+GBatchUpdate::GBatchUpdate(GDrawingSurface& surface)
+        : _surface(&surface),
+          _compound(nullptr) {
+    _surface->beginUpdate();
+}
+
+GBatchUpdate::GBatchUpdate(GDrawingSurface* surface)
+        : _surface(surface),
+          _compound(nullptr) {
+    require::nonNull(surface, "GBatchUpdate::constructor");
+    _surface->beginUpdate();
+}
+
+GBatchUpdate::GBatchUpdate(GCompound& compound)
+        : _surface(nullptr),
+          _compound(&compound) {
+    _compound->beginUpdate();
+}
+
+GBatchUpdate::GBatchUpdate(GCompound* compound)
+        : _surface(nullptr),
+          _compound(compound) {
+    require::nonNull(compound, "GBatchUpdate::constructor");
+    _compound->beginUpdate();
+}
+
+GBatchUpdate::~GBatchUpdate() {
+    // a destructor must not throw, possibly while another exception is
+    // already unwinding the stack; so end the batch only if it is still
+    // open, and drop any error from the repaint that ends it
+    try {
+        if (_surface) {
+            if (_surface->isUpdating()) {
+                _surface->endUpdate();
+            }
+        } else if (_compound->isUpdating()) {
+            _compound->endUpdate();
+        }
+    } catch (...) {
+        // empty
+    }
+}
@@ -3,6 +3,10 @@
  * -----------------------
  *
  * @author Marty Stepp
+ * @version 2018/10/19
+ * - GBatchUpdate's destructor never throws
+ * @version 2018/10/15
+ * - added beginUpdate/endUpdate and GBatchUpdate to batch repaints
  * @version 2018/09/10
  * - added doc comments for new documentation generation
  * @version 2018/08/23
@@ -28,6 +32,17 @@
  */
 class GDrawingSurface {
 public:
+    /**
+     * Starts a batch of changes to the drawing surface and the graphical
+     * objects on it.  Until the matching call to endUpdate, changes do not
+     * repaint the surface; endUpdate repaints everything they touched at once.
+     * Making many changes inside a batch is much faster than repainting after
+     * each one, and unlike setAutoRepaint(false) you do not need to remember
+     * to repaint afterward.  Calls can be nested; only the outermost
+     * endUpdate repaints.  See also the GBatchUpdate class.
+     */
+    virtual void beginUpdate();
+
     /**
      * Erases any pixel data from the drawing surface.
      */
@@ -197,6 +212,13 @@ public:
      */
     virtual void drawString(const std::string& text, double x, double y);
 
+    /**
+     * Ends a batch of changes started by beginUpdate, repainting whatever
+     * changed during it if this is the outermost batch.
+     * @throw ErrorException if there is no matching call to beginUpdate
+     */
+    virtual void endUpdate();
+
     /**
      * Draws a filled arc with the given attributes onto the background pixel
      * layer of this interactor in the current color and fill color.
@@ -436,6 +458,12 @@ public:
      */
     virtual bool isRepaintImmediately() const;
 
+    /**
+     * Returns true if the drawing surface is inside a batch of changes
+     * started by beginUpdate and not yet ended by endUpdate.
+     */
+    virtual bool isUpdating() const;
+
     /**
      * Instructs the interactor to redraw itself on the screen.
      * By default the interactor will automatically repaint itself whenever you
@@ -720,6 +748,8 @@ protected:
     GObject::LineStyle _lineStyle;
     double _lineWidth;
     bool _autoRepaint;
+    int _updateDepth;     // number of beginUpdate calls not yet ended
+    bool _updateDirty;    // true if a change was made since beginUpdate
 
     /**
      * Throws an error if the given x/y values are out of bounds.
@@ -769,17 +799,20 @@ protected:
  */
 class GForwardDrawingSurface : public virtual GDrawingSurface {
 public:
+    virtual void beginUpdate() Q_DECL_OVERRIDE;
     virtual void clear() Q_DECL_OVERRIDE;
     virtual void draw(GObject* gobj) Q_DECL_OVERRIDE;
     virtual void draw(GObject* gobj, double x, double y) Q_DECL_OVERRIDE;
     virtual void draw(GObject& gobj) Q_DECL_OVERRIDE;
     virtual void draw(GObject& gobj, double x, double y) Q_DECL_OVERRIDE;
     virtual void draw(QPainter* painter) Q_DECL_OVERRIDE;
+    virtual void endUpdate() Q_DECL_OVERRIDE;
     virtual int getPixel(double x, double y) const Q_DECL_OVERRIDE;
     virtual int getPixelARGB(double x, double y) const Q_DECL_OVERRIDE;
     virtual Grid<int> getPixels() const Q_DECL_OVERRIDE;
     virtual Grid<int> getPixelsARGB() const Q_DECL_OVERRIDE;
     virtual bool isAutoRepaint() const Q_DECL_OVERRIDE;
+    virtual bool isUpdating() const Q_DECL_OVERRIDE;
     virtual void repaint() Q_DECL_OVERRIDE;
     virtual void repaintRegion(int x, int y, int width, int height) Q_DECL_OVERRIDE;
     virtual void setAutoRepaint(bool autoRepaint) Q_DECL_OVERRIDE;
@@ -805,6 +838,46 @@ protected:
     virtual void ensureForwardTargetConstHack() const;
 };
 
+/**
+ * A GBatchUpdate groups the changes made while it exists into one repaint
+ * of a drawing surface such as a GWindow or GCanvas, or of a GCompound.
+ * It calls beginUpdate when it is created and endUpdate when it goes out of
+ * scope, even if an exception is thrown in between.
+ *
+ * <pre>
+ *     {
+ *         GBatchUpdate batch(window);
+ *         for (GObject* sprite : sprites) {
+ *             sprite->move(dx, dy);   // does not repaint yet
+ *         }
+ *     }   // window repaints here
+ * </pre>
+ */
+class GBatchUpdate {
+public:
+    /**
+     * Begins a batch of changes to the given drawing surface or compound.
+     * @throw ErrorException if the pointer is null
+     */
+    GBatchUpdate(GDrawingSurface& surface);
+    GBatchUpdate(GDrawingSurface* surface);
+    GBatchUpdate(GCompound& compound);
+    GBatchUpdate(GCompound* compound);
+
+    /**
+     * Ends the batch, repainting whatever changed during it.
+     * Never throws: if the batch was already ended by an extra call to
+     * endUpdate, or the repaint fails, the error is ignored.
+     */
+    virtual ~GBatchUpdate();
+
+private:
+    Q_DISABLE_COPY(GBatchUpdate)
+
+    GDrawingSurface* _surface;
+    GCompound* _compound;
+};
+
 #include "private/init.h"   // ensure that Stanford C++ lib is initialized
 
 #endif // _gcanvas_h
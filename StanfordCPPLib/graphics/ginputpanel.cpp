@@ -6,6 +6,8 @@
  * See ginputpanel.h for documentation of each function.
  * 
  * @author Marty Stepp
+ * @version 2018/10/15
+ * - load reads the XML file as an owned, cached XmlDocument
  * @version 2018/08/28
  * - refactored from free functions to GInputPanel class
  * @version 2016/10/04
@@ -65,11 +67,14 @@ void GInputPanel::load(const std::string& xmlFilename) {
     }
 
     _loaded = true;
-    rapidxml::xml_node<>* doc = xmlutils::openXmlDocument(xmlFilename, "inputpanel");
-    for (rapidxml::xml_node<>* category : xmlutils::getChildNodes(doc, "category")) {
+    std::shared_ptr<const xmlutils::XmlDocument> document = xmlutils::XmlDocument::open(xmlFilename);
+    if (!document) {
+        return;
+    }
+    for (rapidxml::xml_node<>* category : document->query("inputpanel/category")) {
         std::string categoryName = xmlutils::getAttribute(category, "name");
         addCategory(categoryName);
-        for (rapidxml::xml_node<>* button : xmlutils::getChildNodes(category, "button")) {
+        for (rapidxml::xml_node<>* button : xmlutils::query(category, "button")) {
             std::string text = xmlutils::getAttribute(button, "text");
             std::string input = text;
             if (xmlutils::hasAttribute(button, "input")) {
@@ -6,6 +6,8 @@
  * interactors in your project with a single include statement.
  *
  * @author Marty Stepp
+ * @version 2018/10/15
+ * - added gvirtualtable.h
  * @version 2018/08/23
  * - renamed to ginteractors.h to replace Java version
  * @version 2018/07/04
@@ -35,6 +37,7 @@
 #include "gtable.h"
 #include "gtextarea.h"
 #include "gtextfield.h"
+#include "gvirtualtable.h"
 #include "gwindow.h"
 
 #include "private/init.h"   // ensure that Stanford C++ lib is initialized
@@ -4,6 +4,10 @@
  * This file implements the gobjects.h interface.
  *
  * @author Marty Stepp
+ * @version 2018/10/15
+ * - added GCompound beginUpdate/endUpdate to batch repaints
+ * - GCompound draws runs of same-styled GRects/GLines in bulk; invisible
+ *   objects are no longer drawn; painter state is set only when it changes
  * @version 2018/08/23
  * - renamed to gobjects.cpp to replace Java version
  * @version 2018/06/30
@@ -17,9 +21,12 @@
 #include <iostream>
 #include <QBrush>
 #include <QFont>
+#include <QLine>
 #include <QPointF>
 #include <QPolygon>
+#include <QRect>
 #include <QVector>
+#include <typeinfo>
 #include <sstream>
 #include <string>
 #include "filelib.h"
@@ -171,39 +178,64 @@ double GObject::getY() const {
     return _y;
 }
 
+const QFont& GObject::getCachedQFont() const {
+    if (_qfontString != _font) {
+        _qfont = GFont::toQFont(_font);
+        _qfontString = _font;
+    }
+    return _qfont;
+}
+
 void GObject::initializeBrushAndPen(QPainter* painter) {
     if (!painter) {
         return;
     }
-    _pen.setColor(QColor(_colorInt));
-    _pen.setWidth((int) _lineWidth);
-    _pen.setStyle(toQtPenStyle(_lineStyle));
+
+    // Consecutive objects often share a style, so the pen, brush and font are
+    // only handed to the painter when they differ from what it already has.
+    // Likewise our own pen and brush are only modified when this object's
+    // style changes, since modifying one that the painter shares copies it.
+    QColor color(_colorInt);
+    Qt::PenStyle penStyle = toQtPenStyle(_lineStyle);
+    if (_pen.color() != color || _pen.width() != (int) _lineWidth || _pen.style() != penStyle) {
+        _pen.setColor(color);
+        _pen.setWidth((int) _lineWidth);
+        _pen.setStyle(penStyle);
+    }
 
     // http://doc.qt.io/qt-5/qpen.html#join-style
-    painter->setPen(_pen);
+    if (painter->pen() != _pen) {
+        painter->setPen(_pen);
+    }
 
     // font
     if (!STATIC_VARIABLE(DEFAULT_QFONT_SET)) {
         STATIC_VARIABLE(DEFAULT_QFONT) = painter->font();
         STATIC_VARIABLE(DEFAULT_BRUSH).setColor(QColor(0x00ffffff));
+        STATIC_VARIABLE(DEFAULT_QFONT_SET) = true;
     }
-    if (_font.empty()) {
-        painter->setFont(STATIC_VARIABLE(DEFAULT_QFONT));
-    } else {
-        painter->setFont(GFont::toQFont(_font));
+    const QFont& font = _font.empty() ? STATIC_VARIABLE(DEFAULT_QFONT) : getCachedQFont();
+    if (painter->font() != font) {
+        painter->setFont(font);
     }
 
-
     // fill color
     if (_fillFlag) {
-        _brush.setColor(QColor(_fillColorInt));
-        painter->setBrush(_brush);
-    } else {
+        QColor fillColor(_fillColorInt);
+        if (_brush.color() != fillColor) {
+            _brush.setColor(fillColor);
+        }
+        if (painter->brush() != _brush) {
+            painter->setBrush(_brush);
+        }
+    } else if (painter->brush() != STATIC_VARIABLE(DEFAULT_BRUSH)) {
         painter->setBrush(STATIC_VARIABLE(DEFAULT_BRUSH));
     }
 
     // transform
-    painter->setTransform(_transform, /* combine */ false);
+    if (_transformed || !painter->transform().isIdentity()) {
+        painter->setTransform(_transform, /* combine */ false);
+    }
 }
 
 bool GObject::isAntiAliasing() {
@@ -650,7 +682,15 @@ std::string GArc::toStringExtra() const {
 
 
 GCompound::GCompound()
-        : _autoRepaint(true) {
+        : _widget(nullptr),
+          _autoRepaint(true),
+          _updateDepth(0),
+          _dirtyAll(false),
+          _dirtyRegionSet(false),
+          _dirtyXMin(0),
+          _dirtyYMin(0),
+          _dirtyXMax(0),
+          _dirtyYMax(0) {
     // empty
 }
 
@@ -675,26 +715,45 @@ void GCompound::add(GObject& gobj, double x, double y) {
     add(&gobj, x, y);
 }
 
+void GCompound::beginUpdate() {
+    _updateDepth++;
+}
+
 void GCompound::clear() {
     removeAll();   // calls conditionalRepaint
 }
 
 void GCompound::conditionalRepaint() {
-    if (_autoRepaint) {
+    if (_updateDepth > 0) {
+        _dirtyAll = true;
+    } else if (_autoRepaint) {
         repaint();
     }
 }
 
 void GCompound::conditionalRepaintRegion(int x, int y, int width, int height) {
-    if (_autoRepaint) {
+    if (_updateDepth > 0) {
+        // remember the union of all regions changed in this batch
+        if (_dirtyRegionSet) {
+            _dirtyXMin = std::min(_dirtyXMin, (double) x);
+            _dirtyYMin = std::min(_dirtyYMin, (double) y);
+            _dirtyXMax = std::max(_dirtyXMax, (double) x + width);
+            _dirtyYMax = std::max(_dirtyYMax, (double) y + height);
+        } else {
+            _dirtyXMin = x;
+            _dirtyYMin = y;
+            _dirtyXMax = x + width;
+            _dirtyYMax = y + height;
+            _dirtyRegionSet = true;
+        }
+    } else if (_autoRepaint) {
         repaintRegion(x, y, width, height);
     }
 }
 
 void GCompound::conditionalRepaintRegion(const GRectangle& bounds) {
-    if (_autoRepaint) {
-        repaintRegion(bounds);
-    }
+    conditionalRepaintRegion((int) bounds.getX(), (int) bounds.getY(),
+                             (int) bounds.getWidth(), (int) bounds.getHeight());
 }
 
 bool GCompound::contains(double x, double y) const {
@@ -714,9 +773,81 @@ void GCompound::draw(QPainter* painter) {
     if (!painter) {
         return;
     }
-    // initializeBrushAndPen(painter);   //
-    for (GObject* obj : _contents) {
-        obj->draw(painter);
+
+    // A run of consecutive GRects (or GLines) with the same colors and line
+    // style is drawn with one drawRects (or drawLines) call using the first
+    // one's pen and brush.  Runs never skip over other objects, so everything
+    // is still drawn in order from back to front.
+    QVector<QRect> rects;
+    QVector<QLine> lines;
+    int n = _contents.size();
+    for (int i = 0; i < n; ) {
+        GObject* obj = _contents[i];
+        if (!obj->_visible) {
+            i++;
+            continue;
+        }
+        int kind = getBulkDrawKind(obj);
+        int end = i + 1;
+        if (kind != BULK_NONE) {
+            // invisible objects are skipped, so they don't break up a run
+            while (end < n && (!_contents[end]->_visible
+                               || (getBulkDrawKind(_contents[end]) == kind
+                                   && hasSameDrawStyle(obj, _contents[end])))) {
+                end++;
+            }
+        }
+        if (end == i + 1) {
+            obj->draw(painter);
+            i++;
+            continue;
+        }
+
+        obj->initializeBrushAndPen(painter);
+        if (kind == BULK_RECTS) {
+            rects.resize(0);   // keeps capacity, unlike clear()
+            for (int j = i; j < end; j++) {
+                GObject* rect = _contents[j];
+                if (rect->_visible) {
+                    rects.append(QRect((int) rect->getX(), (int) rect->getY(),
+                                       (int) rect->getWidth(), (int) rect->getHeight()));
+                }
+            }
+            painter->drawRects(rects.constData(), rects.size());
+        } else {
+            lines.resize(0);
+            for (int j = i; j < end; j++) {
+                if (_contents[j]->_visible) {
+                    GLine* line = static_cast<GLine*>(_contents[j]);
+                    lines.append(QLine((int) line->getX(), (int) line->getY(),
+                                       (int) line->getEndX(), (int) line->getEndY()));
+                }
+            }
+            painter->drawLines(lines.constData(), lines.size());
+        }
+        i = end;
+    }
+}
+
+void GCompound::endUpdate() {
+    if (_updateDepth <= 0) {
+        error("GCompound::endUpdate: called without a matching beginUpdate");
+    }
+    _updateDepth--;
+    if (_updateDepth > 0) {
+        return;
+    }
+
+    bool dirtyAll = _dirtyAll;
+    bool dirtyRegionSet = _dirtyRegionSet;
+    _dirtyAll = false;
+    _dirtyRegionSet = false;
+    if (dirtyAll) {
+        conditionalRepaint();
+    } else if (dirtyRegionSet) {
+        conditionalRepaintRegion((int) _dirtyXMin, (int) _dirtyYMin,
+                                 (int) std::ceil(_dirtyXMax - (int) _dirtyXMin),
+                                 (int) std::ceil(_dirtyYMax - (int) _dirtyYMin));
     }
 }
 
@@ -767,6 +898,19 @@ int GCompound::getElementCount() const {
     return _contents.size();
 }
 
+int GCompound::getBulkDrawKind(GObject* obj) {
+    // subclasses such as GRoundRect draw themselves differently
+    if (obj->_transformed) {
+        return BULK_NONE;
+    } else if (typeid(*obj) == typeid(GRect)) {
+        return BULK_RECTS;
+    } else if (typeid(*obj) == typeid(GLine)) {
+        return BULK_LINES;
+    } else {
+        return BULK_NONE;
+    }
+}
+
 std::string GCompound::getType() const {
     return "GCompound";
 }
@@ -775,6 +919,14 @@ QWidget* GCompound::getWidget() const {
     return _widget;
 }
 
+bool GCompound::hasSameDrawStyle(GObject* obj1, GObject* obj2) {
+    return obj1->_colorInt == obj2->_colorInt
+            && obj1->_lineWidth == obj2->_lineWidth
+            && obj1->_lineStyle == obj2->_lineStyle
+            && obj1->_fillFlag == obj2->_fillFlag
+            && (!obj1->_fillFlag || obj1->_fillColorInt == obj2->_fillColorInt);
+}
+
 bool GCompound::isAutoRepaint() const {
     return _autoRepaint;
 }
@@ -783,6 +935,10 @@ bool GCompound::isEmpty() const {
     return _contents.size() == 0;
 }
 
+bool GCompound::isUpdating() const {
+    return _updateDepth > 0;
+}
+
 void GCompound::remove(GObject* gobj) {
     require::nonNull(gobj, "GCompound::remove");
     int index = findGObject(gobj);
@@ -1024,7 +1180,7 @@ void GLine::draw(QPainter* painter) {
         return;
     }
     initializeBrushAndPen(painter);
-    painter->drawLine((int) getX(), (int) getY(), (int) (getX() + _dx), (int) getY() + _dy);
+    painter->drawLine((int) getX(), (int) getY(), (int) getEndX(), (int) getEndY());
 }
 
 GRectangle GLine::getBounds() const {
@@ -1239,7 +1395,7 @@ void GPolygon::draw(QPainter* painter) {
         return;
     }
     initializeBrushAndPen(painter);
-    painter->drawPolygon(QPolygonF(_vertices));
+    painter->drawPolygon(_vertices);
 }
 
 GRectangle GPolygon::getBounds() const {
@@ -6,6 +6,10 @@
  * <include src="pictures/ClassHierarchies/GObjectHierarchy-h.html">
  *
  * @author Marty Stepp
+ * @version 2018/10/15
+ * - added GCompound beginUpdate/endUpdate to batch repaints
+ * - GCompound draws runs of same-styled GRects/GLines in bulk; invisible
+ *   objects are no longer drawn; painter state is set only when it changes
  * @version 2018/09/08
  * - added doc comments for new documentation generation
  * @version 2018/08/23
@@ -23,6 +27,7 @@
 #include <QImage>
 #include <QPainter>
 #include <QPen>
+#include <QPolygonF>
 #include <QWidget>
 #include "gtypes.h"
 #include "vector.h"
@@ -567,6 +572,8 @@ protected:
     QPen _pen;                       // for outlines
     QBrush _brush;                   // for filling
     QTransform _transform;           // for transformations (rotate, scale)
+    mutable QFont _qfont;            // _font as a Qt font; parsed when needed
+    mutable std::string _qfontString;   // value of _font that _qfont came from
 
 protected:
     /**
@@ -582,6 +589,13 @@ protected:
      */
     virtual void initializeBrushAndPen(QPainter* painter = nullptr);
 
+    /**
+     * Returns the Qt font for this object's font string, parsing the string
+     * only when it has changed since the last call.
+     * @private
+     */
+    const QFont& getCachedQFont() const;
+
     /**
      * Converts our line style enums into Qt pen styles for drawing.
      * @private
@@ -747,6 +761,19 @@ public:
      */
     virtual void add(GObject& gobj, double x, double y);
 
+    /**
+     * Starts a batch of changes to the compound and its contents.
+     * Until the matching call to endUpdate, changes do not repaint anything;
+     * the areas they touch are remembered instead, and endUpdate repaints them
+     * all at once.  This makes it much faster to move or change many objects
+     * at a time, such as every sprite in a frame of an animation.
+     * Objects report their changes to the outermost compound that holds them,
+     * which for objects on a canvas is the canvas's own compound, so this is
+     * usually called through GCanvas or GWindow.
+     * Calls can be nested; only the outermost endUpdate repaints.
+     */
+    virtual void beginUpdate();
+
     /**
      * Removes all graphical objects from the compound.
      * Equivalent to removeAll.
@@ -780,6 +807,14 @@ public:
      */
     virtual void draw(QPainter* painter);
 
+    /**
+     * Ends a batch of changes started by beginUpdate.  When the outermost
+     * batch ends, repaints the union of all regions changed during it,
+     * or the whole compound if any change affected it as a whole.
+     * @throw ErrorException if there is no matching call to beginUpdate
+     */
+    virtual void endUpdate();
+
     /* @inherit */
     virtual GRectangle getBounds() const Q_DECL_OVERRIDE;
 
@@ -825,6 +860,12 @@ public:
      */
     virtual bool isEmpty() const;
 
+    /**
+     * Returns true if the compound is inside a batch of changes started by
+     * beginUpdate and not yet ended by endUpdate.
+     */
+    virtual bool isUpdating() const;
+
     /**
      * Removes the specified object from the compound.
      * @throw ErrorException if the object is null
@@ -887,11 +928,30 @@ private:
     virtual int findGObject(GObject* gobj) const;
     virtual void removeAt(int index);
 
+    // which bulk Qt drawing call, if any, can draw an object along with its
+    // neighbors in draw(); only plain GRects and GLines qualify
+    enum BulkDrawKind {
+        BULK_NONE,
+        BULK_RECTS,
+        BULK_LINES
+    };
+    static int getBulkDrawKind(GObject* obj);
+    static bool hasSameDrawStyle(GObject* obj1, GObject* obj2);
+
     // instance variables
     Vector<GObject*> _contents;
     QWidget* _widget;    // widget containing this compound
     bool _autoRepaint;   // automatically repaint on any change; default true
 
+    // changes made since beginUpdate, to be repainted by endUpdate
+    int _updateDepth;          // number of beginUpdate calls not yet ended
+    bool _dirtyAll;            // true if the whole compound needs repainting
+    bool _dirtyRegionSet;      // true if _dirtyXMin etc. hold a region
+    double _dirtyXMin;
+    double _dirtyYMin;
+    double _dirtyXMax;
+    double _dirtyYMax;
+
     friend class GObject;
 };
 
@@ -1193,7 +1253,7 @@ public:
 
 private:
     /* Instance variables */
-    QVector<QPointF> _vertices;   // the vertices of the polygon
+    QPolygonF _vertices;          // the vertices of the polygon
     double _cx;                   // the most recent x coordinate
     double _cy;                   // the most recent y coordinate
 };
@@ -1381,7 +1441,6 @@ public:
 private:
     /* Instance variables */
     std::string _text;   // the string displayed by the label
-    QFont _qfont;
 
     // update width and height when font or text changes
     void updateSize();
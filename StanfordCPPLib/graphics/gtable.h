@@ -4,6 +4,8 @@
  * This file exports the GTable class for a graphical editable 2D table.
  *
  * @author Marty Stepp
+ * @version 2018/10/15
+ * - added GVirtualTable (see gvirtualtable.h) for very large read-only tables
  * @version 2018/08/23
  * - renamed to gtable.h to replace Java version
  * @version 2018/07/17
@@ -608,6 +610,7 @@ private:
     void updateColumnHeaders();
 
     friend class _Internal_QTableWidget;
+    friend class GVirtualTable;
 };
 
 /**
@@ -2,6 +2,10 @@
  * File: gthread.cpp
  * -----------------
  *
+ * @version 2018/10/19
+ * - added _autograder_setQtGuiThreadAvailable
+ * @version 2018/10/15
+ * - runOnQtGuiThread is timed by a TIMED_SCOPE (see profile.h)
  * @version 2018/08/23
  * - renamed to gthread.h to replace Java version
  * @version 2018/07/28
@@ -10,6 +14,7 @@
 
 #include "gthread.h"
 #include "geventqueue.h"
+#include "profile.h"
 #include "require.h"
 
 GFunctionThread::GFunctionThread(GThunk func)
@@ -24,6 +29,7 @@ void GFunctionThread::run() {
 
 QThread* GThread::_qtMainThread = nullptr;
 QThread* GThread::_studentThread = nullptr;
+bool GThread::_qtGuiThreadAvailable = true;
 
 GThread::GThread() {
     // empty
@@ -80,10 +86,16 @@ void GThread::runOnQtGuiThread(GThunk func) {
 //        error("GThread::runOnQtGuiThread: Qt GUI system has not been initialized.\n"
 //              "You must #include one of the \"q*.h\" files in your main program file.");
 //    }
+    if (!_qtGuiThreadAvailable) {
+        error("GThread::runOnQtGuiThread: the Qt GUI thread is not available in this process.\n"
+              "Code run in a forked autograder worker process cannot create or update\n"
+              "graphical objects.");
+    }
     if (iAmRunningOnTheQtGuiThread()) {
         // already on Qt GUI thread; just run the function!
         func();
     } else if (qtGuiThreadExists()) {
+        TIMED_SCOPE("GThread::runOnQtGuiThread");
         GEventQueue::instance()->runOnQtGuiThreadSync(func);
     } else {
         error("GThread::runOnQtGuiThread: Qt GUI thread has not been initialized properly. \n"
@@ -93,6 +105,11 @@ void GThread::runOnQtGuiThread(GThunk func) {
 }
 
 void GThread::runOnQtGuiThreadAsync(GThunk func) {
+    if (!_qtGuiThreadAvailable) {
+        error("GThread::runOnQtGuiThreadAsync: the Qt GUI thread is not available in this process.\n"
+              "Code run in a forked autograder worker process cannot create or update\n"
+              "graphical objects.");
+    }
     if (iAmRunningOnTheQtGuiThread()) {
         // already on Qt GUI thread; just run the function!
         func();
@@ -105,6 +122,10 @@ void GThread::runOnQtGuiThreadAsync(GThunk func) {
     }
 }
 
+void GThread::_autograder_setQtGuiThreadAvailable(bool available) {
+    _qtGuiThreadAvailable = available;
+}
+
 void GThread::setMainThread() {
     if (!_qtMainThread) {
         _qtMainThread = QThread::currentThread();
@@ -2,6 +2,8 @@
  * File: gthread.h
  * ---------------
  *
+ * @version 2018/10/19
+ * - added _autograder_setQtGuiThreadAvailable
  * @version 2018/09/08
  * - added doc comments for new documentation generation
  * @version 2018/08/23
@@ -180,10 +182,22 @@ public:
      */
     static void yield();
 
+    /**
+     * Sets whether the Qt GUI thread can be reached from this process.
+     * If not, runOnQtGuiThread and runOnQtGuiThreadAsync throw an error right
+     * away instead of waiting forever for a thread that is not there.
+     * The autograder turns this off in worker processes that it forks,
+     * which get a copy of the library's state but none of its other threads.
+     * Clients should not call this method.
+     * @private
+     */
+    static void _autograder_setQtGuiThreadAvailable(bool available);
+
 protected:
     // pointers to the two core library threads
     static QThread* _qtMainThread;
     static QThread* _studentThread;
+    static bool _qtGuiThreadAvailable;
 
     // forbid construction
     GThread();
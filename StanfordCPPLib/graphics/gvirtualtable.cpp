@@ -0,0 +1,511 @@
+/*
+ * File: gvirtualtable.cpp
+ * -----------------------
+ * This file implements the gvirtualtable.h interface.
+ * See that file for documentation of each member.
+ *
+ * @author Marty Stepp
+ * @version 2018/10/19
+ * - resize changes the row and column counts on the Qt GUI thread
+ * @version 2018/10/15
+ * - initial version
+ * @since 2018/10/15
+ */
+
+#include "gvirtualtable.h"
+#include <algorithm>
+#include <QHeaderView>
+#include "error.h"
+#include "gevent.h"
+#include "gthread.h"
+#include "require.h"
+#include "strlib.h"
+
+GVirtualTable::GVirtualTable(int rows, int columns, CellFunction cellFunction,
+                             double width, double height, QWidget* parent)
+        : _cellFunction(cellFunction) {
+    require::nonNegative2D(rows, columns, "GVirtualTable::constructor", "rows", "columns");
+    if (!cellFunction) {
+        error("GVirtualTable::constructor: cell function cannot be null");
+    }
+    init(rows, columns, width, height, parent);
+}
+
+GVirtualTable::GVirtualTable(const Grid<std::string>& grid,
+                             double width, double height, QWidget* parent) {
+    const Grid<std::string>* gridPtr = &grid;
+    _cellFunction = [gridPtr](int row, int column) {
+        return gridPtr->get(row, column);
+    };
+    init(grid.numRows(), grid.numCols(), width, height, parent);
+}
+
+GVirtualTable::~GVirtualTable() {
+    // TODO: delete _iqtableview;
+    _iqtableview = nullptr;
+    _model = nullptr;
+}
+
+void GVirtualTable::beginUpdate() {
+    _updateDepth++;
+}
+
+void GVirtualTable::checkColumn(const std::string& member, int column) const {
+    require::inRange(column, 0, numCols() - 1, "GVirtualTable::" + member, "column");
+}
+
+void GVirtualTable::checkIndex(const std::string& member, int row, int column) const {
+    require::inRange2D(row, column, 0, 0, numRows() - 1, numCols() - 1,
+                       "GVirtualTable::" + member, "row", "column");
+}
+
+void GVirtualTable::checkRow(const std::string& member, int row) const {
+    require::inRange(row, 0, numRows() - 1, "GVirtualTable::" + member, "row");
+}
+
+void GVirtualTable::clearSelection() {
+    GThread::runOnQtGuiThread([this]() {
+        _iqtableview->clearSelection();
+    });
+}
+
+void GVirtualTable::endUpdate() {
+    if (_updateDepth <= 0) {
+        error("GVirtualTable::endUpdate: called without a matching beginUpdate");
+    }
+    _updateDepth--;
+    if (_updateDepth > 0) {
+        return;
+    }
+    if (_updateNeedsReset) {
+        _updateNeedsReset = false;
+        _updateRowMin = -1;
+        _updateRowMax = -1;
+        reorderRows();
+    } else if (_updateRowMin >= 0) {
+        int rowMin = _updateRowMin;
+        int rowMax = _updateRowMax;
+        _updateRowMin = -1;
+        _updateRowMax = -1;
+        refreshRows(rowMin, rowMax);
+    }
+}
+
+std::string GVirtualTable::get(int row, int column) const {
+    checkIndex("get", row, column);
+    return _cellFunction(row, column);
+}
+
+GTable::ColumnHeaderStyle GVirtualTable::getColumnHeaderStyle() const {
+    return _columnHeaderStyle;
+}
+
+std::string GVirtualTable::getColumnHeader(int column) const {
+    if (_columnHeaderStyle == GTable::COLUMN_HEADER_EXCEL) {
+        return GTable::toExcelColumnName(column);
+    } else {
+        // style == GTable::COLUMN_HEADER_NUMERIC
+        return integerToString(column);
+    }
+}
+
+int GVirtualTable::getDisplayedRowCount() const {
+    return _model->rowCount();
+}
+
+_Internal_QWidget* GVirtualTable::getInternalWidget() const {
+    return _iqtableview;
+}
+
+GridLocation GVirtualTable::getSelectedCell() const {
+    QModelIndexList list = _iqtableview->selectionModel()->selectedIndexes();
+    if (list.empty()) {
+        return GridLocation(-1, -1);
+    } else {
+        QModelIndex index = list.at(0);
+        return GridLocation(toRow(index.row()), index.column());
+    }
+}
+
+int GVirtualTable::getSelectedColumn() const {
+    return getSelectedCell().col;
+}
+
+int GVirtualTable::getSelectedRow() const {
+    return getSelectedCell().row;
+}
+
+std::string GVirtualTable::getType() const {
+    return "GVirtualTable";
+}
+
+QWidget* GVirtualTable::getWidget() const {
+    return static_cast<QWidget*>(_iqtableview);
+}
+
+int GVirtualTable::height() const {
+    return numRows();
+}
+
+bool GVirtualTable::inBounds(int row, int column) const {
+    return 0 <= row && row < numRows() && 0 <= column && column < numCols();
+}
+
+void GVirtualTable::init(int rows, int columns, double width, double height, QWidget* parent) {
+    require::nonNegative2D(width, height, "GVirtualTable::constructor", "width", "height");
+    _iqtableview = nullptr;
+    _model = nullptr;
+    _columnHeaderStyle = GTable::COLUMN_HEADER_NONE;
+    _rows = rows;
+    _columns = columns;
+    _sortColumn = -1;
+    _sortAscending = true;
+    _rowsReordered = false;
+    _updateDepth = 0;
+    _updateNeedsReset = false;
+    _updateRowMin = -1;
+    _updateRowMax = -1;
+    GThread::runOnQtGuiThread([this, parent]() {
+        _iqtableview = new _Internal_QTableView(this, getInternalParent(parent));
+        _model = new _Internal_QVirtualTableModel(this, _iqtableview);
+        _iqtableview->setModel(_model);
+        _iqtableview->connect(_iqtableview->selectionModel(),
+                SIGNAL(selectionChanged(const QItemSelection&, const QItemSelection&)),
+                _iqtableview,
+                SLOT(handleSelectionChange(const QItemSelection&, const QItemSelection&)));
+    });
+    if (width > 0 && height > 0) {
+        setPreferredSize(width, height);
+    }
+    setVisible(false);   // all widgets are not shown until added to a window
+}
+
+bool GVirtualTable::isUpdating() const {
+    return _updateDepth > 0;
+}
+
+int GVirtualTable::numCols() const {
+    return _columns;
+}
+
+int GVirtualTable::numRows() const {
+    return _rows;
+}
+
+void GVirtualTable::refresh() {
+    if (_rowFilter || _sortColumn >= 0) {
+        // the data changed, so the rows may belong in a different order
+        if (_updateDepth > 0) {
+            _updateNeedsReset = true;
+        } else {
+            reorderRows();
+        }
+    } else if (_rows > 0) {
+        refreshRows(0, _rows - 1);
+    }
+}
+
+void GVirtualTable::refreshCell(int row, int column) {
+    checkIndex("refreshCell", row, column);
+    refreshRows(row, row);
+}
+
+void GVirtualTable::refreshRows(int startRow, int endRow) {
+    checkRow("refreshRows", startRow);
+    checkRow("refreshRows", endRow);
+    if (startRow > endRow) {
+        std::swap(startRow, endRow);
+    }
+    if (_updateDepth > 0) {
+        // remember the range covering all rows changed during the update
+        if (_updateRowMin < 0) {
+            _updateRowMin = startRow;
+            _updateRowMax = endRow;
+        } else {
+            _updateRowMin = std::min(_updateRowMin, startRow);
+            _updateRowMax = std::max(_updateRowMax, endRow);
+        }
+        return;
+    }
+    GThread::runOnQtGuiThread([this, startRow, endRow]() {
+        if (_rowsReordered) {
+            // the rows may be anywhere on screen; the view redraws only
+            // the visible part of the range anyway
+            _model->fireDataChanged(0, _model->rowCount() - 1);
+        } else {
+            _model->fireDataChanged(startRow, std::min(endRow, _model->rowCount() - 1));
+        }
+    });
+}
+
+void GVirtualTable::removeRowFilter() {
+    if (_rowFilter) {
+        _rowFilter = nullptr;
+        reorderRows();
+    }
+}
+
+void GVirtualTable::removeTableListener() {
+    removeEventListeners({"table",
+                          "tableselect"});
+}
+
+void GVirtualTable::reorderRows() {
+    if (_updateDepth > 0) {
+        _updateNeedsReset = true;
+        return;
+    }
+
+    // compute the new row order here on the calling thread, so that the
+    // Qt GUI thread only has to swap it in
+    bool reordered = _rowFilter || _sortColumn >= 0;
+    std::vector<int> order;
+    if (reordered) {
+        if (!_rowFilter) {
+            order.reserve(_rows);
+        }
+        for (int row = 0; row < _rows; row++) {
+            if (!_rowFilter || _rowFilter(row)) {
+                order.push_back(row);
+            }
+        }
+    }
+    if (_sortColumn >= 0) {
+        // get each row's text once, rather than once per comparison
+        std::vector<std::string> keys(_rows);
+        for (int row : order) {
+            keys[row] = _cellFunction(row, _sortColumn);
+        }
+        if (_sortAscending) {
+            std::stable_sort(order.begin(), order.end(), [&keys](int a, int b) {
+                return keys[a] < keys[b];
+            });
+        } else {
+            std::stable_sort(order.begin(), order.end(), [&keys](int a, int b) {
+                return keys[b] < keys[a];
+            });
+        }
+    }
+
+    _model->fireReset([this, reordered, &order]() {
+        _rowOrder.swap(order);
+        _rowsReordered = reordered;
+    });
+}
+
+void GVirtualTable::resize(int newNumRows, int newNumCols) {
+    require::nonNegative2D(newNumRows, newNumCols, "GVirtualTable::resize", "rows", "columns");
+    // the model reads the size on the Qt GUI thread, so change it there
+    GThread::runOnQtGuiThread([this, newNumRows, newNumCols]() {
+        _rows = newNumRows;
+        _columns = newNumCols;
+        if (_sortColumn >= _columns) {
+            _sortColumn = -1;
+        }
+    });
+    reorderRows();
+}
+
+bool GVirtualTable::rowColumnHeadersVisible() const {
+    return _iqtableview->horizontalHeader()->isVisible()
+            && _iqtableview->verticalHeader()->isVisible();
+}
+
+void GVirtualTable::select(int row, int column) {
+    checkIndex("select", row, column);
+    int displayRow = toDisplayRow(row);
+    if (displayRow < 0) {
+        error("GVirtualTable::select: row " + integerToString(row)
+              + " is hidden by the row filter");
+    }
+    GThread::runOnQtGuiThread([this, displayRow, column]() {
+        QModelIndex index = _model->index(displayRow, column);
+        _iqtableview->setCurrentIndex(index);
+        _iqtableview->scrollTo(index);
+    });
+}
+
+void GVirtualTable::setCellFunction(CellFunction cellFunction) {
+    if (!cellFunction) {
+        error("GVirtualTable::setCellFunction: cell function cannot be null");
+    }
+    GThread::runOnQtGuiThread([this, cellFunction]() {
+        _cellFunction = cellFunction;
+    });
+    refresh();
+}
+
+void GVirtualTable::setColumnHeaderStyle(GTable::ColumnHeaderStyle style) {
+    GThread::runOnQtGuiThread([this, style]() {
+        _columnHeaderStyle = style;
+        if (style == GTable::COLUMN_HEADER_NONE) {
+            // no headers
+            setRowColumnHeadersVisible(false);
+        } else {
+            if (_model->columnCount() > 0) {
+                emit _model->headerDataChanged(Qt::Horizontal, 0, _model->columnCount() - 1);
+            }
+            setRowColumnHeadersVisible(true);
+        }
+    });
+}
+
+void GVirtualTable::setRowColumnHeadersVisible(bool visible) {
+    GThread::runOnQtGuiThread([this, visible]() {
+        _iqtableview->horizontalHeader()->setVisible(visible);
+        _iqtableview->verticalHeader()->setVisible(visible);
+    });
+}
+
+void GVirtualTable::setRowFilter(RowFilter filter) {
+    if (!filter) {
+        error("GVirtualTable::setRowFilter: filter cannot be null");
+    }
+    _rowFilter = filter;
+    reorderRows();
+}
+
+void GVirtualTable::setTableListener(GEventListener func) {
+    setEventListeners({"table",
+                       "tableselect"}, func);
+}
+
+void GVirtualTable::setTableListener(GEventListenerVoid func) {
+    setEventListeners({"table",
+                       "tableselect"}, func);
+}
+
+void GVirtualTable::sortByColumn(int column, bool ascending) {
+    checkColumn("sortByColumn", column);
+    _sortColumn = column;
+    _sortAscending = ascending;
+    reorderRows();
+}
+
+int GVirtualTable::toDisplayRow(int row) const {
+    if (!_rowsReordered) {
+        return row;
+    }
+    for (int i = 0, n = (int) _rowOrder.size(); i < n; i++) {
+        if (_rowOrder[i] == row) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int GVirtualTable::toRow(int displayRow) const {
+    return _rowsReordered ? _rowOrder[displayRow] : displayRow;
+}
+
+void GVirtualTable::unsort() {
+    if (_sortColumn >= 0) {
+        _sortColumn = -1;
+        reorderRows();
+    }
+}
+
+int GVirtualTable::width() const {
+    return numCols();
+}
+
+
+_Internal_QVirtualTableModel::_Internal_QVirtualTableModel(GVirtualTable* gtable, QObject* parent)
+        : QAbstractTableModel(parent),
+          _gtable(gtable),
+          _rowCount(gtable->_rows),
+          _columnCount(gtable->_columns) {
+    // empty
+}
+
+int _Internal_QVirtualTableModel::columnCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : _columnCount;
+}
+
+QVariant _Internal_QVirtualTableModel::data(const QModelIndex& index, int role) const {
+    if (role != Qt::DisplayRole || !index.isValid()) {
+        return QVariant();
+    }
+    int row = _gtable->toRow(index.row());
+    int column = index.column();
+    if (row >= _gtable->_rows || column >= _gtable->_columns) {
+        // table was shrunk during a beginUpdate/endUpdate batch
+        return QVariant();
+    }
+    return QString::fromStdString(_gtable->_cellFunction(row, column));
+}
+
+void _Internal_QVirtualTableModel::fireDataChanged(int startDisplayRow, int endDisplayRow) {
+    if (startDisplayRow <= endDisplayRow && _columnCount > 0) {
+        emit dataChanged(index(startDisplayRow, 0), index(endDisplayRow, _columnCount - 1));
+    }
+}
+
+void _Internal_QVirtualTableModel::fireReset(std::function<void ()> change) {
+    GThread::runOnQtGuiThread([this, &change]() {
+        beginResetModel();
+        change();
+        _rowCount = _gtable->_rowsReordered ? (int) _gtable->_rowOrder.size() : _gtable->_rows;
+        _columnCount = _gtable->_columns;
+        endResetModel();
+    });
+}
+
+QVariant _Internal_QVirtualTableModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (role != Qt::DisplayRole) {
+        return QVariant();
+    }
+    if (orientation == Qt::Horizontal) {
+        if (_gtable->_columnHeaderStyle == GTable::COLUMN_HEADER_NONE) {
+            return QAbstractTableModel::headerData(section, orientation, role);
+        }
+        return QString::fromStdString(_gtable->getColumnHeader(section));
+    } else {
+        // number each row by its place in the data, even when sorted
+        return _gtable->toRow(section) + 1;
+    }
+}
+
+int _Internal_QVirtualTableModel::rowCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : _rowCount;
+}
+
+
+_Internal_QTableView::_Internal_QTableView(GVirtualTable* gtable, QWidget* parent)
+        : QTableView(parent),
+          _gtable(gtable) {
+    require::nonNull(gtable, "_Internal_QTableView::constructor");
+    setObjectName(QString::fromStdString("_Internal_QTableView_" + integerToString(gtable->getID())));
+    setEditTriggers(QAbstractItemView::NoEditTriggers);
+    setSelectionMode(QAbstractItemView::SingleSelection);
+    setWordWrap(false);
+    horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    horizontalHeader()->setVisible(false);
+
+    // all rows are the same height, so the view never has to measure
+    // the contents of a row to know where it goes on screen
+    verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    verticalHeader()->setVisible(false);
+}
+
+void _Internal_QTableView::handleSelectionChange(const QItemSelection& selected, const QItemSelection& /*deselected*/) {
+    if (!selected.empty()) {
+        QModelIndex index = selected.at(0).topLeft();
+        GEvent tableEvent(
+                    /* class  */ TABLE_EVENT,
+                    /* type   */ TABLE_SELECTED,
+                    /* name   */ "tableselect",
+                    /* source */ _gtable);
+        tableEvent.setRowAndColumn(_gtable->toRow(index.row()), index.column());
+        tableEvent.setActionCommand(_gtable->getActionCommand());
+        _gtable->fireEvent(tableEvent);
+    }
+}
+
+QSize _Internal_QTableView::sizeHint() const {
+    if (hasPreferredSize()) {
+        return getPreferredSize();
+    } else {
+        return QTableView::sizeHint();
+    }
+}
@@ -0,0 +1,380 @@
+/*
+ * File: gvirtualtable.h
+ * ---------------------
+ * This file exports the GVirtualTable class for a graphical read-only 2D table
+ * whose cell values are computed on demand rather than stored in the table.
+ *
+ * @author Marty Stepp
+ * @version 2018/10/15
+ * - initial version
+ * @since 2018/10/15
+ */
+
+#ifndef _gvirtualtable_h
+#define _gvirtualtable_h
+
+#include <functional>
+#include <string>
+#include <vector>
+#include <QAbstractTableModel>
+#include <QItemSelection>
+#include <QTableView>
+#include <QWidget>
+#include "grid.h"
+#include "ginteractor.h"
+#include "gtable.h"
+
+class _Internal_QTableView;
+class _Internal_QVirtualTableModel;
+
+/**
+ * A GVirtualTable is a read-only table for showing large amounts of data,
+ * such as a million rows, that would be too slow or take too much memory to
+ * store in a GTable.
+ *
+ * A GTable stores a separate item for every cell.  A GVirtualTable stores no
+ * cells at all; instead, when a cell scrolls into view, the table asks a
+ * function you provide (or a Grid you provide) for that cell's text.  So only
+ * the few dozen rows on screen are ever looked at, and resizing the table to
+ * have more rows costs nothing.
+ *
+ * Because the table doesn't know when your data changes, call refresh,
+ * refreshCell, or refreshRows after changing it.  To make many changes at
+ * once, wrap them in beginUpdate and endUpdate so that the table is redrawn
+ * only once at the end.
+ *
+ * The rows can be sorted and filtered for display with sortByColumn and
+ * setRowFilter.  This does not change your data; row and column indexes
+ * passed to and returned by this class's methods are always indexes into
+ * your data, not positions on the screen.
+ *
+ * All row/column indexes in this class are 0-based.
+ */
+class GVirtualTable : public GInteractor {
+public:
+    /**
+     * The type of a function that returns the text to show in a given cell.
+     */
+    typedef std::function<std::string (int row, int column)> CellFunction;
+
+    /**
+     * The type of a function that returns whether a given row should be shown.
+     */
+    typedef std::function<bool (int row)> RowFilter;
+
+    /**
+     * Constructs a new table with the given dimensions that gets the text of
+     * each cell by calling the given function.
+     * The function is called on the Qt GUI thread whenever a cell needs to be
+     * drawn, so it should be fast and should not wait for anything.
+     * If width or height are omitted, they are set automatically by the
+     * layout manager of the GWindow into which the table is placed.
+     * @throw ErrorException if the number of rows, columns, width, or height is negative
+     */
+    GVirtualTable(int rows, int columns, CellFunction cellFunction,
+                  double width = 0, double height = 0, QWidget* parent = nullptr);
+
+    /**
+     * Constructs a new table that shows the contents of the given grid.
+     * The grid is not copied, so it must not be destroyed before the table is;
+     * if it is resized, call resize to match.
+     * @throw ErrorException if width or height is negative
+     */
+    GVirtualTable(const Grid<std::string>& grid,
+                  double width = 0, double height = 0, QWidget* parent = nullptr);
+
+    virtual ~GVirtualTable();
+
+    /**
+     * Starts a batch of changes, during which calls to refresh, refreshCell,
+     * refreshRows, and resize are saved up rather than redrawing the table.
+     * Every call must be matched by a call to endUpdate; calls can be nested.
+     */
+    virtual void beginUpdate();
+
+    /**
+     * Deselects any currently selected cell.
+     * If no cell is selected, calling this has no effect.
+     */
+    virtual void clearSelection();
+
+    /**
+     * Ends a batch of changes started by beginUpdate.  When the outermost
+     * batch ends, the table is redrawn once to show all of the changes.
+     * @throw ErrorException if there is no matching call to beginUpdate
+     */
+    virtual void endUpdate();
+
+    /**
+     * Returns the text of the given cell, as computed by the cell function.
+     * @throw ErrorException if the given row or column are out of bounds
+     */
+    virtual std::string get(int row, int column) const;
+
+    /**
+     * Returns the column headers style.
+     * Default is none, but can be set to Excel style or numeric instead.
+     */
+    virtual GTable::ColumnHeaderStyle getColumnHeaderStyle() const;
+
+    /**
+     * Returns the number of rows currently shown, which is less than
+     * numRows if a row filter is set.
+     */
+    virtual int getDisplayedRowCount() const;
+
+    /* @inherit */
+    virtual _Internal_QWidget* getInternalWidget() const Q_DECL_OVERRIDE;
+
+    /**
+     * Returns the row and column of the cell that is currently selected.
+     * Sets both row and column to -1 if no cell is currently selected.
+     */
+    virtual GridLocation getSelectedCell() const;
+
+    /**
+     * Returns the column of the cell that is currently selected, or -1 if no cell
+     * is currently selected.
+     */
+    virtual int getSelectedColumn() const;
+
+    /**
+     * Returns the row of the cell that is currently selected, or -1 if no cell
+     * is currently selected.
+     */
+    virtual int getSelectedRow() const;
+
+    /* @inherit */
+    virtual std::string getType() const Q_DECL_OVERRIDE;
+
+    /* @inherit */
+    virtual QWidget* getWidget() const Q_DECL_OVERRIDE;
+
+    /**
+     * Returns the number of rows in the table.
+     * Equivalent to numRows().
+     */
+    virtual int height() const;
+
+    /**
+     * Returns true if the given 0-based row/column index is within the bounds
+     * of the table.
+     */
+    virtual bool inBounds(int row, int column) const;
+
+    /**
+     * Returns true if beginUpdate has been called more times than endUpdate.
+     */
+    virtual bool isUpdating() const;
+
+    /**
+     * Returns the number of columns in the table.
+     * Equivalent to width().
+     */
+    virtual int numCols() const;
+
+    /**
+     * Returns the number of rows in the table, including any rows hidden by
+     * a row filter.
+     * Equivalent to height().
+     */
+    virtual int numRows() const;
+
+    /**
+     * Redraws every visible cell, asking the cell function for its text again.
+     * Call this after changing the data shown in the table.
+     * If the table is sorted or filtered, the sort and filter are redone.
+     */
+    virtual void refresh();
+
+    /**
+     * Redraws the given cell if it is visible, asking the cell function for
+     * its text again.  Does not re-sort or re-filter the table.
+     * @throw ErrorException if the given row or column are out of bounds
+     */
+    virtual void refreshCell(int row, int column);
+
+    /**
+     * Redraws the given range of rows, from startRow through endRow inclusive,
+     * asking the cell function for their text again.
+     * Does not re-sort or re-filter the table.
+     * @throw ErrorException if the given rows are out of bounds
+     */
+    virtual void refreshRows(int startRow, int endRow);
+
+    /**
+     * Removes any row filter so that all rows are shown.
+     */
+    virtual void removeRowFilter();
+
+    /**
+     * Removes the table listener from this table so that it will no longer
+     * call it when events occur.
+     */
+    virtual void removeTableListener();
+
+    /**
+     * Modifies the table to have the given number of rows and columns.
+     * No cells are created, so this is fast even for very large tables.
+     * If the table is sorted or filtered, the sort and filter are redone.
+     * @throw ErrorException if numRows or numCols is negative
+     */
+    virtual void resize(int numRows, int numCols);
+
+    /**
+     * Returns whether row and column headers are shown in the table.
+     * Initially false.
+     */
+    virtual bool rowColumnHeadersVisible() const;
+
+    /**
+     * Sets the given cell to become currently selected and scrolls it into view,
+     * replacing any previous selection.
+     * @throw ErrorException if the given row or column are out of bounds,
+     *        or if the row is hidden by the row filter
+     */
+    virtual void select(int row, int column);
+
+    /**
+     * Sets the function used to compute the text of each cell, and redraws
+     * the table.
+     */
+    virtual void setCellFunction(CellFunction cellFunction);
+
+    /**
+     * Sets the column headers to use the given style.
+     * Default is none, but can be set to Excel style or numeric instead.
+     */
+    virtual void setColumnHeaderStyle(GTable::ColumnHeaderStyle style);
+
+    /**
+     * Shows only the rows for which the given function returns true.
+     * The function is called once for every row, on the calling thread.
+     */
+    virtual void setRowFilter(RowFilter filter);
+
+    /**
+     * Sets whether row and column headers should be shown in the table.
+     * Row headers show each row's index in your data, starting from 1.
+     * Initially false.
+     */
+    virtual void setRowColumnHeadersVisible(bool visible);
+
+    /**
+     * Sets the given function to be called when events occur in this table.
+     * Any existing table listener will be replaced.
+     */
+    virtual void setTableListener(GEventListener func);
+
+    /**
+     * Sets the given function to be called when events occur in this table.
+     * Any existing table listener will be replaced.
+     */
+    virtual void setTableListener(GEventListenerVoid func);
+
+    /**
+     * Shows the rows sorted by the text in the given column, in ascending or
+     * descending order.  Rows with equal text stay in their original order.
+     * The sorting is done on the calling thread, not the Qt GUI thread,
+     * so the window stays responsive while it happens; the new order is shown
+     * once it is ready.
+     * @throw ErrorException if the given column is out of bounds
+     */
+    virtual void sortByColumn(int column, bool ascending = true);
+
+    /**
+     * Returns the rows to their original order, as if never sorted.
+     */
+    virtual void unsort();
+
+    /**
+     * Returns the number of columns in the table.
+     * Equivalent to numCols().
+     */
+    virtual int width() const;
+
+private:
+    Q_DISABLE_COPY(GVirtualTable)
+
+    _Internal_QTableView* _iqtableview;
+    _Internal_QVirtualTableModel* _model;
+    CellFunction _cellFunction;
+    RowFilter _rowFilter;
+    GTable::ColumnHeaderStyle _columnHeaderStyle;
+    int _rows;
+    int _columns;
+    int _sortColumn;       // -1 if not sorted
+    bool _sortAscending;
+
+    // which data row is shown at each position on screen, if the rows are
+    // sorted or filtered; otherwise row i is shown at position i
+    std::vector<int> _rowOrder;
+    bool _rowsReordered;
+
+    // changes saved up between beginUpdate and endUpdate
+    int _updateDepth;
+    bool _updateNeedsReset;     // row order or size changed
+    int _updateRowMin;          // range of rows whose data changed, or -1
+    int _updateRowMax;
+
+    void checkColumn(const std::string& member, int column) const;
+    void checkIndex(const std::string& member, int row, int column) const;
+    void checkRow(const std::string& member, int row) const;
+    std::string getColumnHeader(int column) const;
+    void init(int rows, int columns, double width, double height, QWidget* parent);
+    void reorderRows();
+    int toDisplayRow(int row) const;
+    int toRow(int displayRow) const;
+
+    friend class _Internal_QTableView;
+    friend class _Internal_QVirtualTableModel;
+};
+
+/**
+ * Internal class; not to be used by clients.
+ * @private
+ */
+class _Internal_QVirtualTableModel : public QAbstractTableModel {
+    Q_OBJECT
+
+public:
+    _Internal_QVirtualTableModel(GVirtualTable* gtable, QObject* parent = nullptr);
+    virtual int columnCount(const QModelIndex& parent = QModelIndex()) const Q_DECL_OVERRIDE;
+    virtual QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const Q_DECL_OVERRIDE;
+    virtual QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const Q_DECL_OVERRIDE;
+    virtual int rowCount(const QModelIndex& parent = QModelIndex()) const Q_DECL_OVERRIDE;
+
+private:
+    GVirtualTable* _gtable;
+    int _rowCount;       // as last told to the views, which may lag behind
+    int _columnCount;    // the table's size during a beginUpdate/endUpdate
+
+    // tell the views about changes; beginResetModel and endResetModel are
+    // protected, so the owning table calls these instead
+    void fireDataChanged(int startDisplayRow, int endDisplayRow);
+    void fireReset(std::function<void ()> change);
+
+    friend class GVirtualTable;
+};
+
+/**
+ * Internal class; not to be used by clients.
+ * @private
+ */
+class _Internal_QTableView : public QTableView, public _Internal_QWidget {
+    Q_OBJECT
+
+public:
+    _Internal_QTableView(GVirtualTable* gtable, QWidget* parent = nullptr);
+    virtual QSize sizeHint() const Q_DECL_OVERRIDE;
+
+public slots:
+    void handleSelectionChange(const QItemSelection& selected, const QItemSelection& deselected);
+
+private:
+    GVirtualTable* _gtable;
+};
+
+#include "private/init.h"   // ensure that Stanford C++ lib is initialized
+
+#endif // _gvirtualtable_h
@@ -2,6 +2,8 @@
  * File: gwindow.cpp
  * -----------------
  *
+ * @version 2018/10/15
+ * - added animate for frame-paced animation loops
  * @version 2018/09/05
  * - refactored to use a border layout GContainer "content pane" for storing all interactors
  * @version 2018/08/23
@@ -15,6 +17,7 @@
  */
 
 #include "gwindow.h"
+#include <chrono>
 #include <QDesktopWidget>
 #include <QMenu>
 #include <QMenuBar>
@@ -310,6 +313,38 @@ void GWindow::addToRegion(GInteractor& interactor, const std::string& region) {
     addToRegion(&interactor, region);
 }
 
+void GWindow::animate(std::function<bool (double elapsedMS)> frameFunc, double framesPerSecond) {
+    require::positive(framesPerSecond, "GWindow::animate", "framesPerSecond");
+    typedef std::chrono::steady_clock Clock;
+    const Clock::duration frameTime = std::chrono::duration_cast<Clock::duration>(
+                std::chrono::duration<double>(1.0 / framesPerSecond));
+    Clock::time_point frameStart = Clock::now();
+    Clock::time_point lastFrameStart = frameStart;
+    Clock::time_point nextFrameStart = frameStart + frameTime;
+    while (isVisible()) {
+        double elapsedMS = std::chrono::duration<double, std::milli>(frameStart - lastFrameStart).count();
+        bool keepGoing;
+        {
+            GBatchUpdate batch(this);   // repaints once, when the frame is done
+            keepGoing = frameFunc(elapsedMS);
+        }
+        if (!keepGoing) {
+            break;
+        }
+
+        // wait for the next frame; if we are already late for it, start it now
+        // and schedule the ones after it from here, rather than rushing to catch up
+        Clock::time_point now = Clock::now();
+        bool late = now >= nextFrameStart;
+        if (!late) {
+            GThread::sleep(std::chrono::duration<double, std::milli>(nextFrameStart - now).count());
+        }
+        lastFrameStart = frameStart;
+        frameStart = Clock::now();
+        nextFrameStart = (late ? frameStart : nextFrameStart) + frameTime;
+    }
+}
+
 void GWindow::clear() {
     _contentPane->clear();
 }
@@ -3,6 +3,8 @@
  * ---------------
  *
  * @author Marty Stepp
+ * @version 2018/10/15
+ * - added animate for frame-paced animation loops
  * @version 2018/09/09
  * - added doc comments for new documentation generation
  * @version 2018/09/05
@@ -18,6 +20,7 @@
 #ifndef _gwindow_h
 #define _gwindow_h
 
+#include <functional>
 #include <string>
 #include <QApplication>
 #include <QWindow>
@@ -294,6 +297,22 @@ public:
      */
     virtual void addToRegion(GInteractor& interactor, const std::string& region = "Center");
 
+    /**
+     * Runs an animation by calling the given function once per frame, the
+     * given number of times per second, until the function returns false or
+     * the window is closed.  The function is passed the number of milliseconds
+     * since the start of the previous frame (0 for the first frame), so that
+     * motion can be scaled to keep a steady speed if frames run late.
+     * Each call is made inside beginUpdate/endUpdate, so however many objects
+     * it moves or changes, the window repaints once per frame.
+     * Frames are timed from when the animation started rather than from the
+     * end of the previous frame, so slow frames do not make it drift; if a
+     * frame runs past the time for the next one, the next one starts at once.
+     * @throw ErrorException if framesPerSecond is not positive
+     */
+    virtual void animate(std::function<bool (double elapsedMS)> frameFunc,
+                         double framesPerSecond = 60);
+
     /**
      * Removes all interactors from all regionss of the window.
      */
@@ -6,6 +6,10 @@
  * http://en.wikipedia.org/wiki/Base64
  *
  * @author Marty Stepp, based upon open-source Apache Base64 en/decoder
+ * @version 2018/10/15
+ * - Base64::encode/decode no longer copy through C buffers; vectorized codec
+ * - decode no longer appends extra '\0' bytes to its result
+ * - added URL_SAFE/NO_PADDING flags and streaming Encoder/Decoder
  * @version 2017/10/18
  * - fixed compiler warnings
  * @version 2014/10/08
@@ -16,8 +20,8 @@
  */
 
 #include "base64.h"
+#include <algorithm>
 #include <cstring>
-#include <sstream>
 
 /* aaaack but it's fast and const should make it shared text page. */
 static const unsigned char pr2six[256] = {
@@ -133,41 +137,492 @@ int Base64encode(char *encoded, const char *string, int len) {
     return p - encoded;
 }
 
+
+/*
+ * The C++ functions below use their own codec rather than the C functions
+ * above, since those need a NUL-terminated copy of their input and a
+ * separate pass to find its length.  Whole groups of 3 bytes / 4 characters
+ * are converted 12 or 24 bytes at a time with SSSE3 or AVX2 instructions
+ * when the compiler and CPU support them, and by table lookup otherwise.
+ * The vector code follows Wojciech Mula's and Daniel Lemire's published
+ * base64 algorithms.
+ */
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define SPL_BASE64_X86
+#include <immintrin.h>
+#endif
+
 namespace Base64 {
-std::string encode(const std::string& s) {
-    // make C char* buffer to store the encoded output (for compatibility)
-    int len = Base64encode_len(s.length());
-    char* buf = (char*) malloc(len);
-    memset(buf, 0, len);
-    Base64encode(buf, s.c_str(), s.length());
-    
-    // convert back into a C++ string, and return it
-    // (unlike below in decode(), I can just directly construct the C++
-    // string from the C one, because the Base64-encoded C string will
-    // not contain any intermediate null bytes by definition)
-    std::string result(buf);
-    free(buf);
+static const char STANDARD_ALPHABET[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+static const char URL_SAFE_ALPHABET[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+static const unsigned char INVALID = 0xFF;
+
+static const int BLOCK_BYTES = 3 * 4096;   // bytes encoded per stream write
+static const int BLOCK_CHARS = 4 * 4096;   // chars decoded per stream write
+static const int SIMD_SLACK = 32;          // vector stores may write this many
+                                           // bytes past the end of their output
+
+/*
+ * Tables from each character to its 6-bit value, or INVALID.
+ */
+struct DecodeTables {
+    unsigned char table[2][256];
+
+    DecodeTables() {
+        memset(table, INVALID, sizeof(table));
+        for (int i = 0; i < 64; i++) {
+            table[0][(unsigned char) STANDARD_ALPHABET[i]] = (unsigned char) i;
+            table[1][(unsigned char) URL_SAFE_ALPHABET[i]] = (unsigned char) i;
+        }
+    }
+};
+
+static const unsigned char* getDecodeTable(int flags) {
+    static const DecodeTables tables;
+    return tables.table[(flags & URL_SAFE) ? 1 : 0];
+}
+
+#ifdef SPL_BASE64_X86
+static bool hasAVX2() {
+    static const bool result = (__builtin_cpu_init(), __builtin_cpu_supports("avx2"));
     return result;
 }
 
-std::string decode(const std::string& s) {
-    // convert into C string and decode into that char* buffer
-    const char* cstr = s.c_str();
-    int len = Base64decode_len(cstr);
-    char* buf = (char*) malloc(len);
-    memset(buf, 0, len);
-    Base64decode(buf, cstr);
-    
-    // read bytes from that buffer into a C++ string
-    // (cannot just construct/assign C++ string from C char* buffer,
-    // because that will terminate the string at the first null \0 byte)
-    std::ostringstream out;
-    for (int i = 0; i < len; i++) {
-        out << buf[i];
-    }
-    std::string result = out.str();
-    
-    free(buf);
+static bool hasSSSE3() {
+    static const bool result = (__builtin_cpu_init(), __builtin_cpu_supports("ssse3"));
     return result;
 }
+
+/*
+ * Vector helpers.  Each encode function converts 12/24-byte blocks and
+ * returns the number of bytes consumed; each decode function converts
+ * 16/32-character blocks, stops before the first block holding a character
+ * that is not in the alphabet, and returns the number of chars consumed.
+ */
+#define SPL_BASE64_ENCODE_SHUFFLE \
+    _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1)
+#define SPL_BASE64_ENCODE_OFFSETS(urlSafe) \
+    _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, \
+                  '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, \
+                  (urlSafe) ? '-' - 62 : '+' - 62, (urlSafe) ? '_' - 63 : '/' - 63, \
+                  'A', 0, 0)
+#define SPL_BASE64_DECODE_LUT_LO \
+    _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, \
+                  0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A)
+#define SPL_BASE64_DECODE_LUT_HI \
+    _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, \
+                  0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10)
+#define SPL_BASE64_DECODE_LUT_ROLL \
+    _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0)
+#define SPL_BASE64_DECODE_PACK \
+    _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1)
+
+__attribute__((target("ssse3")))
+static size_t encodeSSSE3(const unsigned char* in, size_t len, char* out, bool urlSafe) {
+    const __m128i shuffle = SPL_BASE64_ENCODE_SHUFFLE;
+    const __m128i offsets = SPL_BASE64_ENCODE_OFFSETS(urlSafe);
+    size_t i = 0;
+    for (; i + 16 <= len; i += 12, out += 16) {
+        // spread each 3 bytes over 4 bytes, then move each 6 bits into place
+        __m128i v = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) (in + i)), shuffle);
+        __m128i t0 = _mm_mulhi_epu16(_mm_and_si128(v, _mm_set1_epi32(0x0fc0fc00)),
+                                     _mm_set1_epi32(0x04000040));
+        __m128i t1 = _mm_mullo_epi16(_mm_and_si128(v, _mm_set1_epi32(0x003f03f0)),
+                                     _mm_set1_epi32(0x01000010));
+        __m128i indexes = _mm_or_si128(t0, t1);
+
+        // map 0-25, 26-51, 52-61, 62, 63 to offsets 13, 0, 1-10, 11, 12
+        __m128i range = _mm_subs_epu8(indexes, _mm_set1_epi8(51));
+        __m128i upper = _mm_cmpgt_epi8(_mm_set1_epi8(26), indexes);
+        range = _mm_or_si128(range, _mm_and_si128(upper, _mm_set1_epi8(13)));
+        __m128i chars = _mm_add_epi8(indexes, _mm_shuffle_epi8(offsets, range));
+        _mm_storeu_si128((__m128i*) out, chars);
+    }
+    return i;
+}
+
+__attribute__((target("avx2")))
+static size_t encodeAVX2(const unsigned char* in, size_t len, char* out, bool urlSafe) {
+    const __m256i shuffle = _mm256_broadcastsi128_si256(SPL_BASE64_ENCODE_SHUFFLE);
+    const __m256i offsets = _mm256_broadcastsi128_si256(SPL_BASE64_ENCODE_OFFSETS(urlSafe));
+    size_t i = 0;
+    for (; i + 28 <= len; i += 24, out += 32) {
+        __m256i v = _mm256_inserti128_si256(
+                    _mm256_castsi128_si256(_mm_loadu_si128((const __m128i*) (in + i))),
+                    _mm_loadu_si128((const __m128i*) (in + i + 12)), 1);
+        v = _mm256_shuffle_epi8(v, shuffle);
+        __m256i t0 = _mm256_mulhi_epu16(_mm256_and_si256(v, _mm256_set1_epi32(0x0fc0fc00)),
+                                        _mm256_set1_epi32(0x04000040));
+        __m256i t1 = _mm256_mullo_epi16(_mm256_and_si256(v, _mm256_set1_epi32(0x003f03f0)),
+                                        _mm256_set1_epi32(0x01000010));
+        __m256i indexes = _mm256_or_si256(t0, t1);
+
+        __m256i range = _mm256_subs_epu8(indexes, _mm256_set1_epi8(51));
+        __m256i upper = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indexes);
+        range = _mm256_or_si256(range, _mm256_and_si256(upper, _mm256_set1_epi8(13)));
+        __m256i chars = _mm256_add_epi8(indexes, _mm256_shuffle_epi8(offsets, range));
+        _mm256_storeu_si256((__m256i*) out, chars);
+    }
+    return i;
+}
+
+__attribute__((target("ssse3")))
+static size_t decodeSSSE3(const unsigned char* in, size_t len, unsigned char* out, bool urlSafe) {
+    const __m128i lutLo = SPL_BASE64_DECODE_LUT_LO;
+    const __m128i lutHi = SPL_BASE64_DECODE_LUT_HI;
+    const __m128i lutRoll = SPL_BASE64_DECODE_LUT_ROLL;
+    const __m128i pack = SPL_BASE64_DECODE_PACK;
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16, out += 12) {
+        __m128i v = _mm_loadu_si128((const __m128i*) (in + i));
+        if (urlSafe) {
+            // '+' and '/' are not in this alphabet; turn '-' and '_' into them
+            __m128i standard = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('+')),
+                                            _mm_cmpeq_epi8(v, _mm_set1_epi8('/')));
+            if (_mm_movemask_epi8(standard) != 0) {
+                break;
+            }
+            v = _mm_add_epi8(v, _mm_and_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('-')),
+                                              _mm_set1_epi8('+' - '-')));
+            v = _mm_add_epi8(v, _mm_and_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('_')),
+                                              _mm_set1_epi8('/' - '_')));
+        }
+
+        // a character is valid if its nibbles' classes have no bit in common
+        __m128i hiNibbles = _mm_and_si128(_mm_srli_epi32(v, 4), _mm_set1_epi8(0x0F));
+        __m128i loNibbles = _mm_and_si128(v, _mm_set1_epi8(0x0F));
+        __m128i classes = _mm_and_si128(_mm_shuffle_epi8(lutLo, loNibbles),
+                                        _mm_shuffle_epi8(lutHi, hiNibbles));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(classes, zero)) != 0xFFFF) {
+            break;
+        }
+
+        // 6-bit values, then pack each 4 of them into 3 bytes
+        __m128i isSlash = _mm_cmpeq_epi8(v, _mm_set1_epi8('/'));
+        v = _mm_add_epi8(v, _mm_shuffle_epi8(lutRoll, _mm_add_epi8(isSlash, hiNibbles)));
+        v = _mm_maddubs_epi16(v, _mm_set1_epi32(0x01400140));
+        v = _mm_madd_epi16(v, _mm_set1_epi32(0x00011000));
+        _mm_storeu_si128((__m128i*) out, _mm_shuffle_epi8(v, pack));
+    }
+    return i;
+}
+
+__attribute__((target("avx2")))
+static size_t decodeAVX2(const unsigned char* in, size_t len, unsigned char* out, bool urlSafe) {
+    const __m256i lutLo = _mm256_broadcastsi128_si256(SPL_BASE64_DECODE_LUT_LO);
+    const __m256i lutHi = _mm256_broadcastsi128_si256(SPL_BASE64_DECODE_LUT_HI);
+    const __m256i lutRoll = _mm256_broadcastsi128_si256(SPL_BASE64_DECODE_LUT_ROLL);
+    const __m256i pack = _mm256_broadcastsi128_si256(SPL_BASE64_DECODE_PACK);
+    const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7);
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32, out += 24) {
+        __m256i v = _mm256_loadu_si256((const __m256i*) (in + i));
+        if (urlSafe) {
+            __m256i standard = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('+')),
+                                               _mm256_cmpeq_epi8(v, _mm256_set1_epi8('/')));
+            if (!_mm256_testz_si256(standard, standard)) {
+                break;
+            }
+            v = _mm256_add_epi8(v, _mm256_and_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('-')),
+                                                    _mm256_set1_epi8('+' - '-')));
+            v = _mm256_add_epi8(v, _mm256_and_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('_')),
+                                                    _mm256_set1_epi8('/' - '_')));
+        }
+
+        __m256i hiNibbles = _mm256_and_si256(_mm256_srli_epi32(v, 4), _mm256_set1_epi8(0x0F));
+        __m256i loNibbles = _mm256_and_si256(v, _mm256_set1_epi8(0x0F));
+        __m256i classes = _mm256_and_si256(_mm256_shuffle_epi8(lutLo, loNibbles),
+                                           _mm256_shuffle_epi8(lutHi, hiNibbles));
+        if (!_mm256_testz_si256(classes, classes)) {
+            break;
+        }
+
+        __m256i isSlash = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('/'));
+        v = _mm256_add_epi8(v, _mm256_shuffle_epi8(lutRoll, _mm256_add_epi8(isSlash, hiNibbles)));
+        v = _mm256_maddubs_epi16(v, _mm256_set1_epi32(0x01400140));
+        v = _mm256_madd_epi16(v, _mm256_set1_epi32(0x00011000));
+        // 12 bytes at the start of each 128-bit lane; move them together
+        v = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(v, pack), lanes);
+        _mm256_storeu_si256((__m256i*) out, v);
+    }
+    return i;
+}
+#endif // SPL_BASE64_X86
+
+/*
+ * Encodes the whole 3-byte groups at the start of the given bytes, and
+ * returns the number of characters written.
+ */
+static size_t encodeGroups(const unsigned char* in, size_t len, char* out, int flags) {
+    bool urlSafe = (flags & URL_SAFE) != 0;
+    const char* alphabet = urlSafe ? URL_SAFE_ALPHABET : STANDARD_ALPHABET;
+    size_t i = 0;
+    char* start = out;
+#ifdef SPL_BASE64_X86
+    if (hasAVX2()) {
+        i = encodeAVX2(in, len, out, urlSafe);
+    } else if (hasSSSE3()) {
+        i = encodeSSSE3(in, len, out, urlSafe);
+    }
+    out += i / 3 * 4;
+#endif // SPL_BASE64_X86
+    for (; i + 3 <= len; i += 3, out += 4) {
+        unsigned int group = (in[i] << 16) | (in[i + 1] << 8) | in[i + 2];
+        out[0] = alphabet[group >> 18];
+        out[1] = alphabet[(group >> 12) & 0x3F];
+        out[2] = alphabet[(group >> 6) & 0x3F];
+        out[3] = alphabet[group & 0x3F];
+    }
+    return out - start;
+}
+
+/*
+ * Encodes the final 0-2 bytes left over after encodeGroups, and returns
+ * the number of characters written.
+ */
+static size_t encodeTail(const unsigned char* in, size_t len, char* out, int flags) {
+    if (len == 0) {
+        return 0;
+    }
+    const char* alphabet = (flags & URL_SAFE) ? URL_SAFE_ALPHABET : STANDARD_ALPHABET;
+    unsigned int group = (in[0] << 16) | (len > 1 ? in[1] << 8 : 0);
+    size_t count = 0;
+    out[count++] = alphabet[group >> 18];
+    out[count++] = alphabet[(group >> 12) & 0x3F];
+    if (len > 1) {
+        out[count++] = alphabet[(group >> 6) & 0x3F];
+    }
+    if (!(flags & NO_PADDING)) {
+        while (count < 4) {
+            out[count++] = '=';
+        }
+    }
+    return count;
+}
+
+/*
+ * Decodes the given 0-3 characters left at the end of an encoding, all of
+ * which must be valid, and returns the number of bytes written.
+ * A single leftover character holds less than a byte and is ignored.
+ */
+static size_t decodeTail(const unsigned char* in, size_t len, unsigned char* out,
+                         const unsigned char* table) {
+    if (len < 2) {
+        return 0;
+    }
+    unsigned int group = (table[in[0]] << 18) | (table[in[1]] << 12)
+            | (len > 2 ? table[in[2]] << 6 : 0);
+    out[0] = (unsigned char) (group >> 16);
+    if (len > 2) {
+        out[1] = (unsigned char) (group >> 8);
+        return 2;
+    }
+    return 1;
+}
+
+/*
+ * Decodes as much of the given characters as possible, and returns the
+ * number of bytes written.  If a character outside the alphabet is found,
+ * decodes everything before it, sets stopped to true, and sets used to len.
+ * Otherwise decodes all whole 4-char groups and sets used to the number of
+ * characters they hold; the remaining 0-3 are left for the caller.
+ */
+static size_t decodeSome(const unsigned char* in, size_t len, unsigned char* out,
+                         int flags, size_t& used, bool& stopped) {
+    const unsigned char* table = getDecodeTable(flags);
+    size_t i = 0;
+    unsigned char* start = out;
+#ifdef SPL_BASE64_X86
+    bool urlSafe = (flags & URL_SAFE) != 0;
+    if (hasAVX2()) {
+        i = decodeAVX2(in, len, out, urlSafe);
+    } else if (hasSSSE3()) {
+        i = decodeSSSE3(in, len, out, urlSafe);
+    }
+    out += i / 4 * 3;
+#endif // SPL_BASE64_X86
+    for (; i + 4 <= len; i += 4, out += 3) {
+        unsigned int a = table[in[i]];
+        unsigned int b = table[in[i + 1]];
+        unsigned int c = table[in[i + 2]];
+        unsigned int d = table[in[i + 3]];
+        if ((a | b | c | d) > 63) {
+            break;
+        }
+        unsigned int group = (a << 18) | (b << 12) | (c << 6) | d;
+        out[0] = (unsigned char) (group >> 16);
+        out[1] = (unsigned char) (group >> 8);
+        out[2] = (unsigned char) group;
+    }
+
+    size_t end = i;
+    while (end < len && table[in[end]] != INVALID) {
+        end++;
+    }
+    if (end < len) {
+        out += decodeTail(in + i, end - i, out, table);
+        stopped = true;
+        used = len;
+    } else {
+        used = i;
+    }
+    return out - start;
+}
+
+std::string encode(const std::string& s, int flags) {
+    const unsigned char* in = (const unsigned char*) s.data();
+    size_t len = s.length();
+    std::string result;
+    result.resize((len + 2) / 3 * 4 + SIMD_SLACK);
+    char* out = &result[0];
+    size_t count = encodeGroups(in, len, out, flags);
+    count += encodeTail(in + len - len % 3, len % 3, out + count, flags);
+    result.resize(count);
+    return result;
+}
+
+std::string decode(const std::string& s, int flags) {
+    const unsigned char* in = (const unsigned char*) s.data();
+    size_t len = s.length();
+    std::string result;
+    result.resize(len / 4 * 3 + 3 + SIMD_SLACK);
+    unsigned char* out = (unsigned char*) &result[0];
+    size_t used = 0;
+    bool stopped = false;
+    size_t count = decodeSome(in, len, out, flags, used, stopped);
+    if (!stopped) {
+        count += decodeTail(in + used, len - used, out + count, getDecodeTable(flags));
+    }
+    result.resize(count);
+    return result;
+}
+
+void encode(std::istream& input, std::ostream& output, int flags) {
+    Encoder encoder(output, flags);
+    char buffer[BLOCK_BYTES];
+    while (input.read(buffer, sizeof(buffer)) || input.gcount() > 0) {
+        encoder.write(buffer, (int) input.gcount());
+    }
+    encoder.finish();
+}
+
+void decode(std::istream& input, std::ostream& output, int flags) {
+    Decoder decoder(output, flags);
+    char buffer[BLOCK_CHARS];
+    while (input.read(buffer, sizeof(buffer)) || input.gcount() > 0) {
+        decoder.write(buffer, (int) input.gcount());
+    }
+    decoder.finish();
+}
+
+Encoder::Encoder(std::ostream& output, int flags)
+        : output(&output),
+          flags(flags),
+          pendingCount(0) {
+    // empty
+}
+
+void Encoder::finish() {
+    char buffer[4];
+    size_t count = encodeTail(pending, pendingCount, buffer, flags);
+    output->write(buffer, count);
+    pendingCount = 0;
+}
+
+void Encoder::write(const char* data, int length) {
+    const unsigned char* in = (const unsigned char*) data;
+    char buffer[BLOCK_BYTES / 3 * 4 + SIMD_SLACK];
+    if (pendingCount > 0) {
+        while (pendingCount < 3 && length > 0) {
+            pending[pendingCount++] = *in++;
+            length--;
+        }
+        if (pendingCount < 3) {
+            return;
+        }
+        output->write(buffer, encodeGroups(pending, 3, buffer, flags));
+        pendingCount = 0;
+    }
+    while (length >= 3) {
+        int blockLength = std::min(length - length % 3, BLOCK_BYTES);
+        output->write(buffer, encodeGroups(in, blockLength, buffer, flags));
+        in += blockLength;
+        length -= blockLength;
+    }
+    while (length > 0) {
+        pending[pendingCount++] = *in++;
+        length--;
+    }
+}
+
+void Encoder::write(const std::string& data) {
+    write(data.data(), (int) data.length());
+}
+
+Decoder::Decoder(std::ostream& output, int flags)
+        : output(&output),
+          flags(flags),
+          pendingCount(0),
+          stopped(false) {
+    // empty
+}
+
+void Decoder::finish() {
+    if (!stopped) {
+        const unsigned char* table = getDecodeTable(flags);
+        int end = 0;
+        while (end < pendingCount && table[pending[end]] != INVALID) {
+            end++;
+        }
+        unsigned char buffer[3];
+        output->write((const char*) buffer, decodeTail(pending, end, buffer, table));
+    }
+    pendingCount = 0;
+    stopped = false;
+}
+
+void Decoder::write(const char* data, int length) {
+    const unsigned char* in = (const unsigned char*) data;
+    unsigned char buffer[BLOCK_CHARS / 4 * 3 + SIMD_SLACK];
+    size_t used = 0;
+    if (stopped) {
+        return;
+    }
+    if (pendingCount > 0) {
+        while (pendingCount < 4 && length > 0) {
+            pending[pendingCount++] = *in++;
+            length--;
+        }
+        if (pendingCount < 4) {
+            return;
+        }
+        size_t count = decodeSome(pending, 4, buffer, flags, used, stopped);
+        output->write((const char*) buffer, count);
+        pendingCount = 0;
+        if (stopped) {
+            return;
+        }
+    }
+    while (length >= 4) {
+        int blockLength = std::min(length - length % 4, BLOCK_CHARS);
+        size_t count = decodeSome(in, blockLength, buffer, flags, used, stopped);
+        output->write((const char*) buffer, count);
+        if (stopped) {
+            return;
+        }
+        in += blockLength;
+        length -= blockLength;
+    }
+    while (length > 0) {
+        pending[pendingCount++] = *in++;
+        length--;
+    }
+}
+
+void Decoder::write(const std::string& data) {
+    write(data.data(), (int) data.length());
+}
 }
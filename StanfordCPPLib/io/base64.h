@@ -6,6 +6,10 @@
  * http://en.wikipedia.org/wiki/Base64
  *
  * @author Marty Stepp, based upon open-source Apache Base64 en/decoder
+ * @version 2018/10/15
+ * - Base64::encode/decode use a faster codec (SSSE3/AVX2 where available)
+ * - added URL_SAFE and NO_PADDING flags
+ * - added streaming Encoder and Decoder classes
  * @version 2014/08/03
  * @since 2014/08/03
  */
@@ -27,19 +31,86 @@ int Base64decode(char* plain_dst, const char* coded_src);
 #ifdef __cplusplus
 }
 
+#include <iostream>
 #include <string>
 
 namespace Base64 {
+/*
+ * Flags that can be passed to the functions and classes below, combined
+ * with | if needed.
+ * URL_SAFE uses '-' and '_' in place of '+' and '/', as in URLs and filenames.
+ * NO_PADDING leaves off the trailing '=' characters when encoding; decoding
+ * always accepts data with or without them.
+ */
+enum Flags {
+    STANDARD   = 0x0,
+    URL_SAFE   = 0x1,
+    NO_PADDING = 0x2
+};
+
 /*
  * Returns a Base64-encoded equivalent of the given string.
  */
-std::string encode(const std::string& s);
+std::string encode(const std::string& s, int flags = STANDARD);
 
 /*
  * Decodes the given Base64-encoded string and returns the decoded
- * original contents.
+ * original contents.  Decoding stops at the first character that is
+ * not part of the encoding, such as '=' padding.
+ */
+std::string decode(const std::string& s, int flags = STANDARD);
+
+/*
+ * Reads the rest of the given input and writes its Base64 encoding/decoding
+ * to the given output, a block at a time.
+ */
+void encode(std::istream& input, std::ostream& output, int flags = STANDARD);
+void decode(std::istream& input, std::ostream& output, int flags = STANDARD);
+
+/*
+ * Class: Encoder
+ * --------------
+ * Encodes data given to it in pieces and writes the encoded text to an
+ * output stream as it goes, so that the whole encoding never needs to be
+ * in memory at once.  Call finish after the last piece to write the
+ * final characters and padding.
+ */
+class Encoder {
+public:
+    Encoder(std::ostream& output, int flags = STANDARD);
+    void finish();
+    void write(const char* data, int length);
+    void write(const std::string& data);
+
+private:
+    std::ostream* output;
+    int flags;
+    unsigned char pending[3];   // bytes not yet encoded (fewer than 3)
+    int pendingCount;
+};
+
+/*
+ * Class: Decoder
+ * --------------
+ * Decodes Base64 text given to it in pieces and writes the decoded bytes
+ * to an output stream as it goes.  Call finish after the last piece to
+ * write any final bytes.  As with decode, everything from the first
+ * character that is not part of the encoding on is ignored.
  */
-std::string decode(const std::string& s);
+class Decoder {
+public:
+    Decoder(std::ostream& output, int flags = STANDARD);
+    void finish();
+    void write(const char* data, int length);
+    void write(const std::string& data);
+
+private:
+    std::ostream* output;
+    int flags;
+    unsigned char pending[4];   // characters not yet decoded (fewer than 4)
+    int pendingCount;
+    bool stopped;               // true once the end of the encoding was seen
+};
 }
 #endif // __cplusplus
 
@@ -7,6 +7,10 @@
  * how a client properly uses these classes.
  *
  * @author Keith Schwarz, Eric Roberts, Marty Stepp
+ * @version 2018/10/13
+ * - readBit/writeBit track the stream buffer's pointers instead of calling
+ *   tellg/tellp on every bit and seekp/put on every 1 bit
+ * - added readBits, writeBits, readBytes, writeBytes, flushBits
  * @version 2016/11/12
  * - made toPrintable non-static and visible
  * @version 2014/10/08
@@ -18,6 +22,7 @@
  */
 
 #include "bitstream.h"
+#include <algorithm>
 #include <iostream>
 #include "error.h"
 #include "strlib.h"
@@ -32,6 +37,27 @@ inline void SetNthBit(int n, int & inByte) {
     inByte |= (1 << n);
 }
 
+/*
+ * Gives access to a stream buffer's get and put pointers, which are protected
+ * members of std::streambuf.  If a bitstreambuf's pointer and generation are
+ * both unchanged since the last bit operation, then nothing else has read,
+ * written, or seeked in between, which is what the bit streams otherwise have
+ * to call the (slow) tellg/tellp to find out.
+ */
+struct StreambufAccess : public std::streambuf {
+    static char* gptrOf(std::streambuf* sb) {
+        return (sb->*(&StreambufAccess::gptr))();
+    }
+
+    static char* pbaseOf(std::streambuf* sb) {
+        return (sb->*(&StreambufAccess::pbase))();
+    }
+
+    static char* pptrOf(std::streambuf* sb) {
+        return (sb->*(&StreambufAccess::pptr))();
+    }
+};
+
 std::string toPrintable(int ch) {
     if (ch == '\n') {
         return "'\\n'";
@@ -60,15 +86,19 @@ std::string toPrintable(int ch) {
 
 /* Constructor ibitstream::ibitstream
  * ----------------------------------
- * Each ibitstream tracks 3 integers as private data.
- * "lastTell" is streampos of the last byte that was read (this is used
- * to detect when other non-readBit activity has changed the tell)
+ * Each ibitstream tracks the following as private data.
+ * "lastPtr" and "lastGeneration" are the tracked stream buffer's read pointer
+ * and generation just after the last byte that was read, and "lastTell" is
+ * the streampos used instead for other stream buffers (this is used to
+ * detect when other non-readBit activity has happened)
  * "curByte" contains contents of byte currently being read
  * "pos" is the bit position within curByte that is next to read
  * We set initial state for lastTell and curByte to 0, then pos is
  * set at 8 so that next readBit will trigger a fresh read.
  */
-ibitstream::ibitstream() : std::istream(nullptr), lastTell(0), curByte(0), pos(NUM_BITS_IN_BYTE) {
+ibitstream::ibitstream() : std::istream(nullptr), lastTell(0),
+        trackedBuf(nullptr), trackedGeneration(nullptr), lastGeneration(0), lastPtr(nullptr),
+        curByte(0), pos(NUM_BITS_IN_BYTE) {
     this->fake = false;
 }
 
@@ -93,13 +123,12 @@ int ibitstream::readBit() {
         }
     } else {
         // if just finished bits from curByte or if data read from stream after last readBit()
-        if (lastTell != tellg() || pos == NUM_BITS_IN_BYTE) {
-            if ((curByte = get()) == EOF) {
+        if (!hasPartialByte()) {
+            if ((curByte = nextByte()) == EOF) {
                 // read next single byte from file
                 return EOF;
             }
             pos = 0; // start reading from first bit of new byte
-            lastTell = tellg();
         }
         int result = GetNthBit(pos, curByte);
         pos++;   // advance bit position for next call to readBit
@@ -107,6 +136,75 @@ int ibitstream::readBit() {
     }
 }
 
+/* Member function ibitstream::readBits
+ * ------------------------------------
+ * Takes whatever bits remain in curByte, then whole bytes, then the first
+ * bits of one more byte, which becomes the new curByte; the bits are
+ * accumulated into a 64-bit result as they are read.
+ */
+long long ibitstream::readBits(int n) {
+    if (n < 0 || n > 63) {
+        error("ibitstream::readBits: number of bits must be between 0 and 63; you passed "
+              + integerToString(n));
+    }
+    if (!is_open()) {
+        error("ibitstream::readBits: Cannot read bits from a stream that is not open.");
+    }
+
+    long long result = 0;
+    int count = 0;
+    if (this->fake) {
+        for (; count < n; count++) {
+            int bit = readBit();
+            if (bit == EOF) {
+                return EOF;
+            }
+            result |= (long long) bit << count;
+        }
+        return result;
+    }
+
+    if (n > 0 && hasPartialByte()) {
+        int take = std::min(NUM_BITS_IN_BYTE - pos, n);
+        result = (curByte >> pos) & ((1 << take) - 1);
+        pos += take;
+        count = take;
+    }
+    while (count < n) {
+        int ch = nextByte();
+        if (ch == EOF) {
+            pos = NUM_BITS_IN_BYTE;
+            return EOF;
+        }
+        int take = std::min(NUM_BITS_IN_BYTE, n - count);
+        result |= (long long) (ch & ((1 << take) - 1)) << count;
+        curByte = ch;
+        pos = take;
+        count += take;
+    }
+    return result;
+}
+
+/* Member function ibitstream::readBytes
+ * -------------------------------------
+ * Drops the rest of curByte, then reads directly from the stream buffer.
+ */
+int ibitstream::readBytes(char* data, int length) {
+    if (!is_open()) {
+        error("ibitstream::readBytes: Cannot read bytes from a stream that is not open.");
+    }
+    pos = NUM_BITS_IN_BYTE;
+    if (length <= 0) {
+        return 0;
+    }
+    std::streambuf* sb = rdbuf();
+    int count = (sb && good()) ? (int) sb->sgetn(data, length) : 0;
+    if (count < length) {
+        setstate(std::ios::eofbit | std::ios::failbit);
+    }
+    return count;
+}
+
 /* Member function ibitstream::rewind
  * ----------------------------------
  * Simply seeks back to beginning of file, so reading begins again
@@ -124,6 +222,68 @@ void ibitstream::setFake(bool fake) {
     this->fake = fake;
 }
 
+/* Member function ibitstream::hasPartialByte
+ * ------------------------------------------
+ * Returns true if the next bit should come from curByte, that is, if
+ * bits remain in it and nothing else has read from or moved the stream
+ * since it was read.
+ */
+bool ibitstream::hasPartialByte() {
+    if (pos >= NUM_BITS_IN_BYTE) {
+        return false;
+    }
+    std::streambuf* sb = rdbuf();
+    if (!sb || fail()) {
+        return false;
+    } else if (lastPtr) {
+        return sb == trackedBuf && *trackedGeneration == lastGeneration
+                && StreambufAccess::gptrOf(sb) == lastPtr;
+    } else {
+        return lastTell == tellg();
+    }
+}
+
+/* Member function ibitstream::nextByte
+ * ------------------------------------
+ * Reads the next byte straight from the stream buffer, or returns EOF,
+ * and remembers where in the stream the read left off.
+ */
+int ibitstream::nextByte() {
+    std::streambuf* sb = rdbuf();
+    if (!sb || !good()) {
+        setstate(std::ios::failbit);
+        return EOF;
+    }
+    int ch = sb->sbumpc();
+    if (ch == EOF) {
+        setstate(std::ios::eofbit | std::ios::failbit);
+        return EOF;
+    }
+    rememberPosition();
+    return ch;
+}
+
+/* Member function ibitstream::rememberPosition
+ * --------------------------------------------
+ * Records where in the stream curByte was read from.
+ */
+void ibitstream::rememberPosition() {
+    std::streambuf* sb = rdbuf();
+    lastPtr = nullptr;
+    if (sb && sb == trackedBuf) {
+        lastPtr = StreambufAccess::gptrOf(sb);
+        lastGeneration = *trackedGeneration;
+    }
+    if (!lastPtr) {
+        lastTell = tellg();
+    }
+}
+
+void ibitstream::trackBuffer(std::streambuf* buf, const unsigned int* generation) {
+    trackedBuf = buf;
+    trackedGeneration = generation;
+}
+
 /* Member function ibitstream::size
  * --------------------------------
  * Seek to file end and use tell to retrieve position.
@@ -135,10 +295,14 @@ long ibitstream::size() {
         error("ibitstream::size: Cannot get size of stream which is not open.");
     }
     clear();                    // clear any error state
+    bool partial = hasPartialByte();
     streampos cur = tellg();    // save current streampos
     seekg(0, std::ios::end);    // seek to end
     streampos end = tellg();    // get offset
     seekg(cur);                 // seek back to original pos
+    if (partial) {
+        rememberPosition();     // keep reading bits from the same byte
+    }
     return long(end);
 }
 
@@ -153,15 +317,19 @@ bool ibitstream::is_open() {
 
 /* Constructor obitstream::obitstream
  * ----------------------------------
- * Each obitstream tracks 3 integers as private data.
- * "lastTell" is streampos of the last byte that was written (this is used
- * to detect when other non-writeBit activity has changed the tell)
+ * Each obitstream tracks the following as private data.
+ * "lastPtr" and "lastGeneration" are the tracked stream buffer's write pointer
+ * and generation just after the last byte that was written, and "lastTell" is
+ * the streampos used instead for other stream buffers (this is used to
+ * detect when other non-writeBit activity has happened)
  * "curByte" contains contents of byte currently being written
  * "pos" is the bit position within curByte that is next to write
  * We set initial state for lastTell and curByte to 0, then pos is
  * set at 8 so that next writeBit will start a new byte.
  */
-obitstream::obitstream() : std::ostream(nullptr), lastTell(0), curByte(0), pos(NUM_BITS_IN_BYTE) {
+obitstream::obitstream() : std::ostream(nullptr), lastTell(0),
+        trackedBuf(nullptr), trackedGeneration(nullptr), lastGeneration(0), lastPtr(nullptr),
+        curByte(0), pos(NUM_BITS_IN_BYTE) {
     this->fake = false;
 }
 
@@ -170,10 +338,13 @@ obitstream::obitstream() : std::ostream(nullptr), lastTell(0), curByte(0), pos(N
  * If bits remain to be written in curByte, add bit into byte and increment pos
  * Else if end of curByte (or some other write happened), then start a fresh
  * byte at position 0.
- * We write the byte out for each bit (backing up to overwrite as needed), rather
- * than waiting for 8 bits.  This is because the client might make
- * 3 writeBit calls and then start using << so we can't wait til full-byte
- * boundary to flush any partial-byte bits.
+ * We put the byte into the stream as soon as its first bit is written, and
+ * update it in place for each later 1 bit, rather than waiting for 8 bits.
+ * This is because the client might make 3 writeBit calls and then start
+ * using << so we can't wait til full-byte boundary to flush any partial-byte
+ * bits.  The byte is normally still in the stream's buffer, so updating it
+ * is just a store; only if the buffer has been written out in between do
+ * we have to back up with seekp to overwrite it.
  */
 void obitstream::writeBit(int bit) {
     if (bit != 0 && bit != 1) {
@@ -188,32 +359,159 @@ void obitstream::writeBit(int bit) {
         put(bit == 1 ? '1' : '0');
     } else {
         // if just filled curByte or if data written to stream after last writeBit()
-        if (lastTell != tellp() || pos == NUM_BITS_IN_BYTE) {
-            curByte = 0;   // zero out byte for next writes
-            pos = 0;       // start writing to first bit of new byte
-        }
-
-        if (bit) {
+        if (!hasPartialByte()) {
+            curByte = bit;   // start a new byte holding just this bit
+            pos = 0;
+            putByte();
+        } else if (bit) {
             // only need to change if bit needs to be 1 (byte starts already zeroed)
             SetNthBit(pos, curByte);
+            rewriteByte();
         }
+        pos++; // advance to next bit position for next write
+    }
+}
 
-        if (pos == 0 || bit) {   // only write if first bit in byte or changing 0 to 1
-            if (pos != 0) {
-                seekp(-1, std::ios::cur);   // back up to overwite if pos > 0
-            }
-            put(curByte);
+/* Member function obitstream::writeBits
+ * -------------------------------------
+ * Fills in the rest of curByte, then writes whole bytes, then starts one
+ * more byte with whatever bits are left over.
+ */
+void obitstream::writeBits(unsigned long long value, int n) {
+    if (n < 0 || n > 63) {
+        error("obitstream::writeBits: number of bits must be between 0 and 63; you passed "
+              + integerToString(n));
+    }
+    if (!is_open()) {
+        error("obitstream::writeBits: stream is not open");
+    }
+
+    if (this->fake) {
+        for (int i = 0; i < n; i++) {
+            writeBit((int) ((value >> i) & 1));
         }
+        return;
+    }
 
-        pos++; // advance to next bit position for next write
-        lastTell = tellp();
+    int count = 0;
+    if (n > 0 && hasPartialByte()) {
+        int take = std::min(NUM_BITS_IN_BYTE - pos, n);
+        int bits = (int) (value & ((1 << take) - 1));
+        if (bits) {
+            curByte |= bits << pos;
+            rewriteByte();
+        }
+        pos += take;
+        count = take;
+    }
+    while (count < n) {
+        int take = std::min(NUM_BITS_IN_BYTE, n - count);
+        curByte = (int) ((value >> count) & ((1 << take) - 1));
+        putByte();
+        pos = take;
+        count += take;
     }
 }
 
+/* Member function obitstream::writeBytes
+ * --------------------------------------
+ * Ends curByte, then writes directly to the stream buffer.
+ */
+void obitstream::writeBytes(const char* data, int length) {
+    if (!is_open()) {
+        error("obitstream::writeBytes: stream is not open");
+    }
+    pos = NUM_BITS_IN_BYTE;
+    if (length <= 0) {
+        return;
+    }
+    std::streambuf* sb = rdbuf();
+    if (!sb || !good() || sb->sputn(data, length) < length) {
+        setstate(std::ios::badbit);
+    }
+}
+
+/* Member function obitstream::flushBits
+ * -------------------------------------
+ * curByte is already in the stream, so all this needs to do is make sure
+ * the next bit starts a new byte.
+ */
+void obitstream::flushBits() {
+    pos = NUM_BITS_IN_BYTE;
+}
+
 void obitstream::setFake(bool fake) {
     this->fake = fake;
 }
 
+/* Member function obitstream::hasPartialByte
+ * ------------------------------------------
+ * Returns true if the next bit should go into curByte, that is, if
+ * there is room left in it and nothing else has written to or moved the
+ * stream since it was written.
+ */
+bool obitstream::hasPartialByte() {
+    if (pos >= NUM_BITS_IN_BYTE) {
+        return false;
+    }
+    std::streambuf* sb = rdbuf();
+    if (!sb || fail()) {
+        return false;
+    } else if (lastPtr) {
+        return sb == trackedBuf && *trackedGeneration == lastGeneration
+                && StreambufAccess::pptrOf(sb) == lastPtr;
+    } else {
+        return lastTell == tellp();
+    }
+}
+
+/* Member function obitstream::putByte
+ * -----------------------------------
+ * Appends curByte to the stream buffer.
+ */
+void obitstream::putByte() {
+    std::streambuf* sb = rdbuf();
+    if (!sb || !good() || sb->sputc((char) curByte) == EOF) {
+        setstate(std::ios::badbit);
+        return;
+    }
+    rememberPosition();
+}
+
+/* Member function obitstream::rememberPosition
+ * --------------------------------------------
+ * Records where in the stream curByte was written.  lastPtr is set only if
+ * curByte is still in a tracked stream buffer's put area, where rewriteByte
+ * can update it directly.
+ */
+void obitstream::rememberPosition() {
+    std::streambuf* sb = rdbuf();
+    lastPtr = nullptr;
+    if (sb && sb == trackedBuf) {
+        char* ptr = StreambufAccess::pptrOf(sb);
+        if (ptr && ptr > StreambufAccess::pbaseOf(sb)) {
+            lastPtr = ptr;
+            lastGeneration = *trackedGeneration;
+            return;
+        }
+    }
+    lastTell = tellp();
+}
+
+/* Member function obitstream::rewriteByte
+ * ---------------------------------------
+ * Replaces the last byte written with the updated curByte.
+ */
+void obitstream::rewriteByte() {
+    if (lastPtr) {
+        lastPtr[-1] = (char) curByte;
+    } else {
+        seekp(-1, std::ios::cur);   // back up to overwrite
+        put((char) curByte);
+        rememberPosition();
+    }
+}
+
 /* Member function obitstream::size
  * --------------------------------
  * Seek to file end and use tell to retrieve position.
@@ -225,10 +523,14 @@ long obitstream::size() {
         error("obitstream::size: stream is not open");
     }
     clear();                    // clear any error state
+    bool partial = hasPartialByte();
     streampos cur = tellp();    // save current streampos
     seekp(0, std::ios::end);    // seek to end
     streampos end = tellp();    // get offset
     seekp(cur);                 // seek back to original pos
+    if (partial) {
+        rememberPosition();     // keep writing bits into the same byte
+    }
     return long(end);
 }
 
@@ -241,6 +543,11 @@ bool obitstream::is_open() {
     return true;
 }
 
+void obitstream::trackBuffer(std::streambuf* buf, const unsigned int* generation) {
+    trackedBuf = buf;
+    trackedGeneration = generation;
+}
+
 /* Constructor ifbitstream::ifbitstream
  * ------------------------------------
  * Wires up the stream class so that it knows to read data
@@ -248,6 +555,7 @@ bool obitstream::is_open() {
  */
 ifbitstream::ifbitstream() {
     init(&fb);
+    trackBuffer(&fb, &fb.generation);
 }
 
 /* Constructor ifbitstream::ifbitstream
@@ -257,10 +565,12 @@ ifbitstream::ifbitstream() {
  */
 ifbitstream::ifbitstream(const char* filename) {
     init(&fb);
+    trackBuffer(&fb, &fb.generation);
     open(filename);
 }
 ifbitstream::ifbitstream(const std::string& filename) {
     init(&fb);
+    trackBuffer(&fb, &fb.generation);
     open(filename);
 }
 
@@ -270,6 +580,7 @@ ifbitstream::ifbitstream(const std::string& filename) {
  * to do so.
  */
 void ifbitstream::open(const char* filename) {
+    fb.generation++;
     if (!fb.open(filename, std::ios::in | std::ios::binary)) {
         setstate(std::ios::failbit);
     }
@@ -292,6 +603,7 @@ bool ifbitstream::is_open() {
  * Closes the file stream, if one is open.
  */
 void ifbitstream::close() {
+    fb.generation++;
     if (!fb.close()) {
         setstate(std::ios::failbit);
     }
@@ -304,6 +616,7 @@ void ifbitstream::close() {
  */
 ofbitstream::ofbitstream() {
     init(&fb);
+    trackBuffer(&fb, &fb.generation);
 }
 
 /* Constructor ofbitstream::ofbitstream
@@ -313,11 +626,13 @@ ofbitstream::ofbitstream() {
  */
 ofbitstream::ofbitstream(const char* filename) {
     init(&fb);
+    trackBuffer(&fb, &fb.generation);
     open(filename);
 }
 
 ofbitstream::ofbitstream(const std::string& filename) {
     init(&fb);
+    trackBuffer(&fb, &fb.generation);
     open(filename);
 }
 
@@ -337,6 +652,7 @@ void ofbitstream::open(const char* filename) {
               + "different filename.");
         setstate(std::ios::failbit);
     } else {
+        fb.generation++;
         if (!fb.open(filename, std::ios::out | std::ios::binary)) {
             setstate(std::ios::failbit);
         }
@@ -359,6 +675,7 @@ bool ofbitstream::is_open() {
  * Closes the given file.
  */
 void ofbitstream::close() {
+    fb.generation++;
     if (!fb.close()) {
         setstate(std::ios::failbit);
     }
@@ -371,6 +688,7 @@ void ofbitstream::close() {
  */
 istringbitstream::istringbitstream(const std::string& s) {
     init(&sb);
+    trackBuffer(&sb, &sb.generation);
     sb.str(s);
 }
 
@@ -381,6 +699,7 @@ istringbitstream::istringbitstream(const std::string& s) {
  */
 void istringbitstream::str(const std::string& s) {
     sb.str(s);
+    sb.generation++;   // the buffer has been replaced
 }
 
 /* Member function ostringbitstream::ostringbitstream
@@ -389,6 +708,7 @@ void istringbitstream::str(const std::string& s) {
  */
 ostringbitstream::ostringbitstream() {
     init(&sb);
+    trackBuffer(&sb, &sb.generation);
 }
 
 /* Member function ostringbitstream::str
@@ -18,7 +18,12 @@
  * obitstream class similarly has ofbitstream and ostringbitstream as
  * subclasses.
  *
+ * Bits are packed into each byte starting from its least significant bit.
+ *
  * @author Keith Schwarz, Eric Roberts, Marty Stepp
+ * @version 2018/10/13
+ * - readBit/writeBit no longer seek or tell on every bit
+ * - added readBits, writeBits, readBytes, writeBytes, flushBits
  * @version 2016/11/12
  * - made toPrintable non-static and visible
  */
@@ -46,6 +51,82 @@ const int PSEUDO_EOF = 256;
  */
 const int NOT_A_CHAR = 257;
 
+/*
+ * Class: bitstreambuf
+ * ---------------
+ * A stream buffer of the given type (such as std::filebuf) that counts the
+ * calls that may move or refill its buffer.  The bit stream classes use this
+ * count, together with the buffer's current read/write pointer, to tell
+ * cheaply whether anything but a bit operation has happened since their
+ * last one.  You will not need to use this class directly.
+ */
+template <typename BufferType>
+class bitstreambuf : public BufferType {
+public:
+    typedef typename BufferType::char_type char_type;
+    typedef typename BufferType::int_type int_type;
+    typedef typename BufferType::pos_type pos_type;
+    typedef typename BufferType::off_type off_type;
+
+    bitstreambuf() : generation(0) {}
+
+    /* Number of calls so far that may have moved or refilled the buffer. */
+    unsigned int generation;
+
+protected:
+    int_type overflow(int_type ch = BufferType::traits_type::eof()) {
+        generation++;
+        return BufferType::overflow(ch);
+    }
+
+    int_type pbackfail(int_type ch = BufferType::traits_type::eof()) {
+        generation++;
+        return BufferType::pbackfail(ch);
+    }
+
+    pos_type seekoff(off_type off, std::ios_base::seekdir dir,
+                     std::ios_base::openmode mode = std::ios_base::in | std::ios_base::out) {
+        generation++;
+        return BufferType::seekoff(off, dir, mode);
+    }
+
+    pos_type seekpos(pos_type pos,
+                     std::ios_base::openmode mode = std::ios_base::in | std::ios_base::out) {
+        generation++;
+        return BufferType::seekpos(pos, mode);
+    }
+
+    std::streambuf* setbuf(char_type* s, std::streamsize n) {
+        generation++;
+        return BufferType::setbuf(s, n);
+    }
+
+    int sync() {
+        generation++;
+        return BufferType::sync();
+    }
+
+    int_type uflow() {
+        generation++;
+        return BufferType::uflow();
+    }
+
+    int_type underflow() {
+        generation++;
+        return BufferType::underflow();
+    }
+
+    std::streamsize xsgetn(char_type* s, std::streamsize n) {
+        generation++;
+        return BufferType::xsgetn(s, n);
+    }
+
+    std::streamsize xsputn(const char_type* s, std::streamsize n) {
+        generation++;
+        return BufferType::xsputn(s, n);
+    }
+};
+
 /*
  * Class: ibitstream
  * ---------------
@@ -78,6 +159,29 @@ public:
      */
     int readBit();
 
+    /*
+     * Member function: readBits
+     * Usage: value = in.readBits(n);
+     * ------------------------------
+     * Reads the next n bits (0 to 63) from the ibitstream and returns them
+     * as a number, with the first bit read as its least significant bit;
+     * this is the same as n calls to readBit, but much faster.
+     * If the stream runs out before n bits are read, EOF (-1) is returned.
+     * Raises an error if this ibitstream has not been properly opened.
+     */
+    long long readBits(int n);
+
+    /*
+     * Member function: readBytes
+     * Usage: count = in.readBytes(buffer, length);
+     * --------------------------------------------
+     * Skips any bits remaining in the byte currently being read bit by bit,
+     * then reads up to length whole bytes into the given buffer, returning
+     * how many were read.
+     * Raises an error if this ibitstream has not been properly opened.
+     */
+    int readBytes(char* data, int length);
+
     /*
      * Member function: rewind
      * Usage: in.rewind();
@@ -112,8 +216,25 @@ public:
      */
     virtual bool is_open();
 
+protected:
+    /*
+     * Called by subclasses to say that the given stream buffer counts its
+     * buffer changes in the given variable, as bitstreambuf does.  readBit
+     * is much faster with such a buffer; with any other, it has to check
+     * the stream position on every read.
+     */
+    void trackBuffer(std::streambuf* buf, const unsigned int* generation);
+
 private:
+    bool hasPartialByte();
+    int nextByte();
+    void rememberPosition();
+
     std::streampos lastTell;
+    std::streambuf* trackedBuf;
+    const unsigned int* trackedGeneration;
+    unsigned int lastGeneration;
+    const char* lastPtr;
     int curByte;
     int pos;
     bool fake;
@@ -151,6 +272,40 @@ public:
      */
     void writeBit(int bit);
 
+    /*
+     * Member function: writeBits
+     * Usage: out.writeBits(value, n);
+     * -------------------------------
+     * Writes the low n bits (0 to 63) of the given value to the obitstream,
+     * least significant bit first; this is the same as n calls to writeBit,
+     * but much faster.
+     * Raises an error if this obitstream has not been properly opened.
+     */
+    void writeBits(unsigned long long value, int n);
+
+    /*
+     * Member function: writeBytes
+     * Usage: out.writeBytes(buffer, length);
+     * --------------------------------------
+     * Ends the byte currently being written bit by bit, as flushBits does,
+     * then writes the given whole bytes to the obitstream.
+     * Raises an error if this obitstream has not been properly opened.
+     */
+    void writeBytes(const char* data, int length);
+
+    /*
+     * Member function: flushBits
+     * Usage: out.flushBits();
+     * -----------------------
+     * Ends the byte currently being written bit by bit, so that the next bit
+     * written starts a new byte.  Every bit written is already in the stream,
+     * with any unused bits of its last byte set to 0, so there is no need to
+     * call this before closing the stream or using << or put; those already
+     * start a new byte.  As with any ostream, call flush to make sure the
+     * data has actually reached the underlying file.
+     */
+    void flushBits();
+
     /*
      * Member function: size
      * Usage: sz = in.size();
@@ -175,8 +330,26 @@ public:
      */
     virtual bool is_open();
 
+protected:
+    /*
+     * Called by subclasses to say that the given stream buffer counts its
+     * buffer changes in the given variable, as bitstreambuf does.  writeBit
+     * is much faster with such a buffer; with any other, it has to check
+     * the stream position on every write and seek back on every 1 bit.
+     */
+    void trackBuffer(std::streambuf* buf, const unsigned int* generation);
+
 private:
+    bool hasPartialByte();
+    void putByte();
+    void rememberPosition();
+    void rewriteByte();
+
     std::streampos lastTell;
+    std::streambuf* trackedBuf;
+    const unsigned int* trackedGeneration;
+    unsigned int lastGeneration;
+    char* lastPtr;
     int curByte;
     int pos;
     bool fake;
@@ -244,7 +417,7 @@ public:
 
 private:
     /* The actual file buffer which does reading and writing. */
-    std::filebuf fb;
+    bitstreambuf<std::filebuf> fb;
 };
 
 /*
@@ -315,7 +488,7 @@ public:
 
 private:
     /* The actual file buffer which does reading and writing. */
-    std::filebuf fb;
+    bitstreambuf<std::filebuf> fb;
 };
 
 /*
@@ -344,7 +517,7 @@ public:
     void str(const std::string& s);
 private:
     /* The actual string buffer that does character storage. */
-    std::stringbuf sb;
+    bitstreambuf<std::stringbuf> sb;
 };
 
 /*
@@ -375,7 +548,7 @@ public:
 
 private:
     /* The actual string buffer that does character storage. */
-    std::stringbuf sb;
+    bitstreambuf<std::stringbuf> sb;
 };
 
 /*
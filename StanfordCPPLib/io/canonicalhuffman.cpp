@@ -0,0 +1,517 @@
+/*
+ * File: canonicalhuffman.cpp
+ * --------------------------
+ * This file implements the CanonicalHuffmanCode class declared in
+ * canonicalhuffman.h.
+ *
+ * @author Marty Stepp
+ * @version 2018/10/19
+ * - decoding table is built by assignCodes rather than lazily by decode
+ * @version 2018/10/14
+ * - initial version
+ * @since 2018/10/14
+ */
+
+#include "canonicalhuffman.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <queue>
+#include <sstream>
+#include <utility>
+#include "error.h"
+#include "strlib.h"
+
+// codes are at most this many bits long, so that writeBits can write them;
+// no code built from int frequencies comes close
+static const int MAX_CODE_LENGTH = 63;
+
+// decode falls back to readSymbol for codes whose tree has more internal
+// nodes than this, as a decoding table for them would be huge
+static const int MAX_DECODE_STATES = 1024;
+
+// number of bits decode reads per table lookup
+static const int DECODE_BITS = 8;
+static const int DECODE_TABLE_WIDTH = 1 << DECODE_BITS;
+
+CanonicalHuffmanCode::CanonicalHuffmanCode() {
+    std::fill(lengths, lengths + SYMBOL_COUNT, 0);
+    assignCodes();
+}
+
+/*
+ * Implementation notes: constructor
+ * ---------------------------------
+ * Builds a Huffman tree in the usual way, by repeatedly merging the two
+ * lightest subtrees, but keeps only each node's parent; each symbol's code
+ * length is then its leaf's depth.  Ties are broken by node number so that
+ * the same frequencies always give the same code.
+ */
+CanonicalHuffmanCode::CanonicalHuffmanCode(const Map<int, int>& frequencies) {
+    std::fill(lengths, lengths + SYMBOL_COUNT, 0);
+
+    typedef std::pair<long long, int> WeightAndNode;
+    std::priority_queue<WeightAndNode, std::vector<WeightAndNode>, std::greater<WeightAndNode> > pq;
+    std::vector<int> parent;
+    std::vector<int> leafSymbol;
+    for (int symbol : frequencies) {
+        checkSymbol(symbol, "CanonicalHuffmanCode");
+        int freq = frequencies.get(symbol);
+        if (freq < 0) {
+            error("CanonicalHuffmanCode: negative frequency " + integerToString(freq)
+                  + " for symbol " + integerToString(symbol));
+        } else if (freq > 0) {
+            pq.push(WeightAndNode(freq, (int) parent.size()));
+            parent.push_back(-1);
+            leafSymbol.push_back(symbol);
+        }
+    }
+
+    int leafCount = (int) parent.size();
+    if (leafCount == 1) {
+        // a code of length 0 cannot be written, so give the only symbol "0"
+        lengths[leafSymbol[0]] = 1;
+    } else if (leafCount > 1) {
+        while (pq.size() > 1) {
+            WeightAndNode a = pq.top();
+            pq.pop();
+            WeightAndNode b = pq.top();
+            pq.pop();
+            int node = (int) parent.size();
+            parent.push_back(-1);
+            parent[a.second] = node;
+            parent[b.second] = node;
+            pq.push(WeightAndNode(a.first + b.first, node));
+        }
+
+        // parents always have higher node numbers than their children,
+        // so each node's depth is known by the time it is reached
+        std::vector<int> depth(parent.size(), 0);
+        for (int node = (int) parent.size() - 2; node >= 0; node--) {
+            depth[node] = depth[parent[node]] + 1;
+        }
+        for (int leaf = 0; leaf < leafCount; leaf++) {
+            if (depth[leaf] > MAX_CODE_LENGTH) {
+                error("CanonicalHuffmanCode: code would be longer than "
+                      + integerToString(MAX_CODE_LENGTH) + " bits");
+            }
+            lengths[leafSymbol[leaf]] = depth[leaf];
+        }
+    }
+    assignCodes();
+}
+
+void CanonicalHuffmanCode::compress(std::istream& input, obitstream& output) {
+    std::streampos start = input.tellg();
+    CanonicalHuffmanCode code(countFrequencies(input));
+    code.writeHeader(output);
+    input.clear();
+    input.seekg(start);
+    code.encode(input, output);
+}
+
+Map<int, int> CanonicalHuffmanCode::countFrequencies(std::istream& input) {
+    long long counts[SYMBOL_COUNT] = {0};
+    char buffer[4096];
+    while (input) {
+        input.read(buffer, sizeof(buffer));
+        std::streamsize count = input.gcount();
+        for (std::streamsize i = 0; i < count; i++) {
+            counts[(unsigned char) buffer[i]]++;
+        }
+    }
+    counts[PSEUDO_EOF] = 1;
+
+    Map<int, int> frequencies;
+    for (int symbol = 0; symbol < SYMBOL_COUNT; symbol++) {
+        if (counts[symbol] > 0) {
+            if (counts[symbol] > 0x7fffffff) {
+                error("CanonicalHuffmanCode::countFrequencies: input is too large");
+            }
+            frequencies.put(symbol, (int) counts[symbol]);
+        }
+    }
+    return frequencies;
+}
+
+void CanonicalHuffmanCode::decompress(ibitstream& input, std::ostream& output) {
+    CanonicalHuffmanCode code = readHeader(input);
+    code.decode(input, output);
+}
+
+CanonicalHuffmanCode CanonicalHuffmanCode::fromCodeLengths(const Map<int, int>& codeLengths) {
+    CanonicalHuffmanCode code;
+    for (int symbol : codeLengths) {
+        code.checkSymbol(symbol, "CanonicalHuffmanCode::fromCodeLengths");
+        int length = codeLengths.get(symbol);
+        if (length < 0 || length > MAX_CODE_LENGTH) {
+            error("CanonicalHuffmanCode::fromCodeLengths: invalid code length "
+                  + integerToString(length) + " for symbol " + integerToString(symbol));
+        }
+        code.lengths[symbol] = length;
+    }
+
+    // Kraft's inequality: the lengths fit in a prefix code if and only if
+    // the sum of 2^-length over all codes is at most 1
+    long double kraft = 0;
+    for (int symbol = 0; symbol < SYMBOL_COUNT; symbol++) {
+        if (code.lengths[symbol] > 0) {
+            kraft += std::ldexp((long double) 1, -code.lengths[symbol]);
+        }
+    }
+    if (kraft > 1) {
+        error("CanonicalHuffmanCode::fromCodeLengths: too many short codes to form a prefix code");
+    }
+    code.assignCodes();
+    return code;
+}
+
+CanonicalHuffmanCode CanonicalHuffmanCode::readHeader(ibitstream& input) {
+    unsigned char bytes[3];
+    if (input.readBytes((char*) bytes, 2) != 2) {
+        error("CanonicalHuffmanCode::readHeader: missing header");
+    }
+    int count = (bytes[0] << 8) | bytes[1];
+    if (count > SYMBOL_COUNT) {
+        error("CanonicalHuffmanCode::readHeader: bad symbol count " + integerToString(count));
+    }
+    Map<int, int> codeLengths;
+    for (int i = 0; i < count; i++) {
+        if (input.readBytes((char*) bytes, 3) != 3) {
+            error("CanonicalHuffmanCode::readHeader: header is cut off");
+        }
+        int symbol = (bytes[0] << 8) | bytes[1];
+        if (symbol >= SYMBOL_COUNT || codeLengths.containsKey(symbol)) {
+            error("CanonicalHuffmanCode::readHeader: bad symbol " + integerToString(symbol));
+        }
+        codeLengths.put(symbol, bytes[2]);
+    }
+    return fromCodeLengths(codeLengths);
+}
+
+bool CanonicalHuffmanCode::contains(int symbol) const {
+    return symbol >= 0 && symbol < SYMBOL_COUNT && lengths[symbol] > 0;
+}
+
+/*
+ * Implementation notes: decode
+ * ----------------------------
+ * Each lookup takes the current position in the code tree and the next
+ * byte of input, and gives the symbols completed within that byte and the
+ * tree position after it, so that a whole byte is decoded per step instead
+ * of a bit.  The decoded bytes are collected in a buffer and written to
+ * the output in blocks.
+ */
+void CanonicalHuffmanCode::decode(ibitstream& input, std::ostream& output) const {
+    if (size() == 0) {
+        error("CanonicalHuffmanCode::decode: code has no symbols");
+    }
+    if (decodeTable.empty()) {
+        // too big for a table; decode a bit at a time
+        while (true) {
+            int symbol = readSymbol(input);
+            if (symbol == EOF) {
+                error("CanonicalHuffmanCode::decode: input ended before PSEUDO_EOF");
+            } else if (symbol == PSEUDO_EOF) {
+                return;
+            }
+            output.put((char) symbol);
+        }
+    }
+
+    char buffer[4096];
+    int bufferCount = 0;
+    int state = 0;
+    while (true) {
+        long long bits = input.readBits(DECODE_BITS);
+        if (bits == EOF) {
+            error("CanonicalHuffmanCode::decode: input ended before PSEUDO_EOF");
+        }
+        const DecodeEntry& entry = decodeTable[state * DECODE_TABLE_WIDTH + (int) bits];
+        if (entry.invalid) {
+            error("CanonicalHuffmanCode::decode: input holds a code that is not in this code");
+        }
+        if (bufferCount + entry.symbolCount > (int) sizeof(buffer)) {
+            output.write(buffer, bufferCount);
+            bufferCount = 0;
+        }
+        for (int i = 0; i < entry.symbolCount; i++) {
+            buffer[bufferCount++] = decodeSymbols[entry.symbolsStart + i];
+        }
+        if (entry.foundEOF) {
+            break;
+        }
+        state = entry.nextState;
+    }
+    output.write(buffer, bufferCount);
+}
+
+/*
+ * Implementation notes: encode
+ * ----------------------------
+ * Codes are gathered into a 64-bit accumulator and handed to the output
+ * 32 bits at a time, rather than written one code (or bit) at a time.
+ */
+void CanonicalHuffmanCode::encode(std::istream& input, obitstream& output) const {
+    unsigned long long acc = 0;
+    int accBits = 0;
+    char buffer[4096];
+    bool done = false;
+    while (!done) {
+        input.read(buffer, sizeof(buffer));
+        int count = (int) input.gcount();
+        if (count == 0) {
+            done = true;
+        }
+        for (int i = 0; i <= count; i++) {
+            int symbol;
+            if (i < count) {
+                symbol = (unsigned char) buffer[i];
+            } else if (done) {
+                symbol = PSEUDO_EOF;
+            } else {
+                break;
+            }
+            int length = lengths[symbol];
+            if (length == 0) {
+                error("CanonicalHuffmanCode::encode: no code for symbol " + integerToString(symbol));
+            }
+            if (accBits + length > 63) {
+                output.writeBits(acc, accBits);
+                acc = 0;
+                accBits = 0;
+            }
+            acc |= codes[symbol] << accBits;
+            accBits += length;
+            if (accBits >= 32) {
+                output.writeBits(acc & 0xffffffffULL, 32);
+                acc >>= 32;
+                accBits -= 32;
+            }
+        }
+    }
+    output.writeBits(acc, accBits);
+    output.flushBits();
+}
+
+std::string CanonicalHuffmanCode::getCode(int symbol) const {
+    checkSymbol(symbol, "CanonicalHuffmanCode::getCode");
+    std::string bits;
+    for (int i = 0; i < lengths[symbol]; i++) {
+        bits += ((codes[symbol] >> i) & 1) ? '1' : '0';
+    }
+    return bits;
+}
+
+int CanonicalHuffmanCode::getCodeLength(int symbol) const {
+    checkSymbol(symbol, "CanonicalHuffmanCode::getCodeLength");
+    return lengths[symbol];
+}
+
+Map<int, int> CanonicalHuffmanCode::getCodeLengths() const {
+    Map<int, int> codeLengths;
+    for (int symbol = 0; symbol < SYMBOL_COUNT; symbol++) {
+        if (lengths[symbol] > 0) {
+            codeLengths.put(symbol, lengths[symbol]);
+        }
+    }
+    return codeLengths;
+}
+
+/*
+ * Implementation notes: readSymbol
+ * --------------------------------
+ * Uses the canonical property: after reading n bits as the number code,
+ * there is a symbol of length n with that code if and only if code is
+ * within the range of codes assigned to length n.
+ */
+int CanonicalHuffmanCode::readSymbol(ibitstream& input) const {
+    unsigned long long code = 0;
+    for (int length = 1; length <= maxLength; length++) {
+        int bit = input.readBit();
+        if (bit == EOF) {
+            return EOF;
+        }
+        code = (code << 1) | bit;
+        if (countOfLength[length] > 0 && code >= firstCode[length]
+                && code - firstCode[length] < (unsigned long long) countOfLength[length]) {
+            return sortedSymbols[firstIndex[length] + (int) (code - firstCode[length])];
+        }
+    }
+    error("CanonicalHuffmanCode::readSymbol: input holds a code that is not in this code");
+    return EOF;
+}
+
+int CanonicalHuffmanCode::size() const {
+    return (int) sortedSymbols.size();
+}
+
+std::string CanonicalHuffmanCode::toString() const {
+    std::ostringstream out;
+    out << *this;
+    return out.str();
+}
+
+void CanonicalHuffmanCode::writeHeader(obitstream& output) const {
+    std::string header;
+    header += (char) (size() >> 8);
+    header += (char) (size() & 0xff);
+    for (int symbol : sortedSymbols) {
+        header += (char) (symbol >> 8);
+        header += (char) (symbol & 0xff);
+        header += (char) lengths[symbol];
+    }
+    output.writeBytes(header.c_str(), (int) header.length());
+}
+
+void CanonicalHuffmanCode::writeSymbol(obitstream& output, int symbol) const {
+    checkSymbol(symbol, "CanonicalHuffmanCode::writeSymbol");
+    if (lengths[symbol] == 0) {
+        error("CanonicalHuffmanCode::writeSymbol: no code for symbol " + integerToString(symbol));
+    }
+    output.writeBits(codes[symbol], lengths[symbol]);
+}
+
+/* Private methods */
+
+/*
+ * Implementation notes: assignCodes
+ * ---------------------------------
+ * Gives the symbols consecutive codes in order of (length, symbol), adding
+ * a 0 bit to the end of the running code each time the length increases.
+ * Also records where each length's codes start, for readSymbol, and builds
+ * the decoding table.  Building it here rather than on first use keeps decode
+ * a read-only operation, safe to call on one code from several threads.
+ */
+void CanonicalHuffmanCode::assignCodes() {
+    sortedSymbols.clear();
+    maxLength = 0;
+    for (int symbol = 0; symbol < SYMBOL_COUNT; symbol++) {
+        codes[symbol] = 0;
+        if (lengths[symbol] > 0) {
+            sortedSymbols.push_back(symbol);
+            maxLength = std::max(maxLength, lengths[symbol]);
+        }
+    }
+    std::stable_sort(sortedSymbols.begin(), sortedSymbols.end(), [this](int a, int b) {
+        return lengths[a] < lengths[b];
+    });
+
+    std::fill(firstCode, firstCode + 64, 0);
+    std::fill(firstIndex, firstIndex + 64, 0);
+    std::fill(countOfLength, countOfLength + 64, 0);
+    unsigned long long code = 0;
+    int prevLength = 0;
+    for (int i = 0; i < (int) sortedSymbols.size(); i++) {
+        int symbol = sortedSymbols[i];
+        int length = lengths[symbol];
+        code <<= (length - prevLength);
+        prevLength = length;
+        if (countOfLength[length] == 0) {
+            firstCode[length] = code;
+            firstIndex[length] = i;
+        }
+        countOfLength[length]++;
+
+        // store the code reversed, so that its first bit is the lowest bit
+        unsigned long long reversed = 0;
+        for (int bit = 0; bit < length; bit++) {
+            reversed |= ((code >> (length - 1 - bit)) & 1) << bit;
+        }
+        codes[symbol] = reversed;
+        code++;
+    }
+
+    buildDecodeTable();
+}
+
+/*
+ * Implementation notes: buildDecodeTable
+ * --------------------------------------
+ * Rebuilds the code tree from the codes, numbering its internal nodes as
+ * decoding states with the root as state 0, then for each state and each
+ * possible byte follows the byte's bits through the tree from that state.
+ * Leaves empty if the code has no symbols or its tree has too many
+ * internal nodes.
+ */
+void CanonicalHuffmanCode::buildDecodeTable() {
+    decodeTable.clear();
+    decodeSymbols.clear();
+    if (sortedSymbols.empty()) {
+        return;
+    }
+
+    // child[2 * node + bit] is an internal node number, or -2 - symbol
+    // for a leaf, or -1 if there is no code that way
+    std::vector<int> child(2, -1);
+    for (int symbol : sortedSymbols) {
+        int node = 0;
+        for (int i = 0; i < lengths[symbol]; i++) {
+            int index = 2 * node + (int) ((codes[symbol] >> i) & 1);
+            if (i == lengths[symbol] - 1) {
+                child[index] = -2 - symbol;
+            } else {
+                if (child[index] == -1) {
+                    child[index] = (int) child.size() / 2;
+                    child.push_back(-1);
+                    child.push_back(-1);
+                }
+                node = child[index];
+            }
+        }
+    }
+    int stateCount = (int) child.size() / 2;
+    if (stateCount > MAX_DECODE_STATES) {
+        return;
+    }
+
+    decodeTable.resize(stateCount * DECODE_TABLE_WIDTH);
+    for (int state = 0; state < stateCount; state++) {
+        for (int bits = 0; bits < DECODE_TABLE_WIDTH; bits++) {
+            DecodeEntry& entry = decodeTable[state * DECODE_TABLE_WIDTH + bits];
+            entry.symbolsStart = (int) decodeSymbols.length();
+            entry.symbolCount = 0;
+            entry.foundEOF = false;
+            entry.invalid = false;
+            int node = state;
+            for (int i = 0; i < DECODE_BITS && !entry.foundEOF && !entry.invalid; i++) {
+                int next = child[2 * node + ((bits >> i) & 1)];
+                if (next == -1) {
+                    entry.invalid = true;
+                } else if (next >= 0) {
+                    node = next;
+                } else {
+                    int symbol = -2 - next;
+                    if (symbol == PSEUDO_EOF) {
+                        entry.foundEOF = true;
+                    } else {
+                        decodeSymbols += (char) symbol;
+                        entry.symbolCount++;
+                    }
+                    node = 0;
+                }
+            }
+            entry.nextState = (unsigned short) node;
+        }
+    }
+}
+
+void CanonicalHuffmanCode::checkSymbol(int symbol, const std::string& caller) const {
+    if (symbol < 0 || symbol >= SYMBOL_COUNT) {
+        error(caller + ": symbol " + integerToString(symbol) + " is out of range 0-"
+              + integerToString(SYMBOL_COUNT - 1));
+    }
+}
+
+std::ostream& operator <<(std::ostream& out, const CanonicalHuffmanCode& code) {
+    out << "{";
+    bool first = true;
+    for (int symbol = 0; symbol < CanonicalHuffmanCode::SYMBOL_COUNT; symbol++) {
+        if (code.contains(symbol)) {
+            out << (first ? "" : ", ") << toPrintable(symbol) << ":\"" << code.getCode(symbol) << "\"";
+            first = false;
+        }
+    }
+    out << "}";
+    return out;
+}
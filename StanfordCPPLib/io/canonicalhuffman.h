@@ -0,0 +1,265 @@
+/*
+ * File: canonicalhuffman.h
+ * ------------------------
+ * This file declares the CanonicalHuffmanCode class, a fast Huffman coder
+ * for compressing bytes through the bit streams in bitstream.h.
+ *
+ * A canonical Huffman code is a Huffman code in which the codes of each
+ * length are consecutive binary numbers, assigned in order of symbol.
+ * The whole code is therefore determined by the length of each symbol's
+ * code, which is all that needs to be stored in a compressed file's header.
+ *
+ * Rather than walking a tree of nodes one bit at a time, this class encodes
+ * using a table of codes, and decodes a whole byte of input per step using
+ * a precomputed table of what each byte decodes to from each tree position.
+ *
+ * @author Marty Stepp
+ * @version 2018/10/19
+ * - decoding table is built with the code, so decode can run on many threads
+ * @version 2018/10/14
+ * - initial version
+ * @since 2018/10/14
+ */
+
+#ifndef _canonicalhuffman_h
+#define _canonicalhuffman_h
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "bitstream.h"
+#include "map.h"
+
+/*
+ * Class: CanonicalHuffmanCode
+ * ---------------------------
+ * A canonical Huffman code for the byte values 0-255 plus PSEUDO_EOF.
+ *
+ * Usage example:
+ *
+ * <pre>
+ *     Map<int, int> freqs = CanonicalHuffmanCode::countFrequencies(input);
+ *     CanonicalHuffmanCode code(freqs);
+ *     code.writeHeader(output);
+ *     input.clear();
+ *     input.seekg(0);
+ *     code.encode(input, output);
+ *     ...
+ *     CanonicalHuffmanCode code2 = CanonicalHuffmanCode::readHeader(input2);
+ *     code2.decode(input2, output2);
+ * </pre>
+ */
+class CanonicalHuffmanCode {
+public:
+    /*
+     * Constant: SYMBOL_COUNT
+     * ----------------------
+     * The number of symbols that a code can contain: the 256 byte values
+     * 0-255 and PSEUDO_EOF.
+     */
+    static const int SYMBOL_COUNT = PSEUDO_EOF + 1;
+
+    /*
+     * Constructor: CanonicalHuffmanCode
+     * Usage: CanonicalHuffmanCode code;
+     *        CanonicalHuffmanCode code(frequencies);
+     * ----------------------------------------------
+     * Builds the optimal canonical Huffman code for symbols with the given
+     * frequencies, a map from each symbol (0-255 or PSEUDO_EOF) to the number
+     * of times it occurs.  Symbols that are not in the map or have frequency 0
+     * are given no code.  The default constructor makes a code with no symbols.
+     * Raises an error if a symbol or frequency is out of range.
+     */
+    CanonicalHuffmanCode();
+    CanonicalHuffmanCode(const Map<int, int>& frequencies);
+
+    /*
+     * Static method: compress
+     * Usage: CanonicalHuffmanCode::compress(input, output);
+     * -----------------------------------------------------
+     * Compresses all of the given input into the given output: a header
+     * followed by the encoded input, using the best code for that input.
+     * The input is read twice, so it must be a stream that can seek,
+     * such as a file or string stream.
+     */
+    static void compress(std::istream& input, obitstream& output);
+
+    /*
+     * Static method: countFrequencies
+     * Usage: Map<int, int> freqs = CanonicalHuffmanCode::countFrequencies(input);
+     * ----------------------------------------------------------------------------
+     * Reads the rest of the given input and returns a map from each byte value
+     * that occurs in it to the number of times it occurs, plus PSEUDO_EOF with
+     * a frequency of 1.
+     */
+    static Map<int, int> countFrequencies(std::istream& input);
+
+    /*
+     * Static method: decompress
+     * Usage: CanonicalHuffmanCode::decompress(input, output);
+     * -------------------------------------------------------
+     * Reverses compress: reads a header and encoded data from the given
+     * input and writes the original data to the given output.
+     */
+    static void decompress(ibitstream& input, std::ostream& output);
+
+    /*
+     * Static method: fromCodeLengths
+     * Usage: CanonicalHuffmanCode code = CanonicalHuffmanCode::fromCodeLengths(lengths);
+     * ----------------------------------------------------------------------------------
+     * Returns the canonical code in which each symbol in the given map has a
+     * code of the given length in bits.
+     * Raises an error if no prefix code can have those lengths.
+     */
+    static CanonicalHuffmanCode fromCodeLengths(const Map<int, int>& codeLengths);
+
+    /*
+     * Static method: readHeader
+     * Usage: CanonicalHuffmanCode code = CanonicalHuffmanCode::readHeader(input);
+     * ---------------------------------------------------------------------------
+     * Reads a code's lengths as written by writeHeader and returns the code.
+     * Raises an error if the header is missing or malformed.
+     */
+    static CanonicalHuffmanCode readHeader(ibitstream& input);
+
+    /*
+     * Method: contains
+     * Usage: if (code.contains(symbol)) ...
+     * -------------------------------------
+     * Returns true if the given symbol has a code.
+     */
+    bool contains(int symbol) const;
+
+    /*
+     * Method: decode
+     * Usage: code.decode(input, output);
+     * ----------------------------------
+     * Decodes symbols from the given input, writing each byte value to the
+     * given output, until it decodes PSEUDO_EOF.  The input must start at a
+     * byte boundary, as it does after readHeader.
+     * Raises an error if the input ends before PSEUDO_EOF or holds a code
+     * that is not in this code.
+     */
+    void decode(ibitstream& input, std::ostream& output) const;
+
+    /*
+     * Method: encode
+     * Usage: code.encode(input, output);
+     * ----------------------------------
+     * Writes the code for each remaining byte of the given input to the given
+     * output, then the code for PSEUDO_EOF, then pads the output to a whole
+     * byte.  Raises an error if the input holds a byte value with no code.
+     */
+    void encode(std::istream& input, obitstream& output) const;
+
+    /*
+     * Method: getCode
+     * Usage: string bits = code.getCode(symbol);
+     * ------------------------------------------
+     * Returns the code for the given symbol as a string of '0' and '1'
+     * characters, in the order they are written, or "" if it has none.
+     */
+    std::string getCode(int symbol) const;
+
+    /*
+     * Method: getCodeLength
+     * Usage: int length = code.getCodeLength(symbol);
+     * -----------------------------------------------
+     * Returns the length in bits of the given symbol's code, or 0 if it has none.
+     */
+    int getCodeLength(int symbol) const;
+
+    /*
+     * Method: getCodeLengths
+     * Usage: Map<int, int> lengths = code.getCodeLengths();
+     * -----------------------------------------------------
+     * Returns a map from each symbol that has a code to the length of its code.
+     */
+    Map<int, int> getCodeLengths() const;
+
+    /*
+     * Method: readSymbol
+     * Usage: int symbol = code.readSymbol(input);
+     * -------------------------------------------
+     * Reads the code for one symbol from the given input and returns that
+     * symbol, or EOF if the input ends first.  Unlike decode, this works at
+     * any bit position, and reads no further than the end of the code.
+     * Raises an error if the input holds a code that is not in this code.
+     */
+    int readSymbol(ibitstream& input) const;
+
+    /*
+     * Method: size
+     * Usage: int count = code.size();
+     * -------------------------------
+     * Returns the number of symbols that have codes.
+     */
+    int size() const;
+
+    /*
+     * Method: toString
+     * Usage: string str = code.toString();
+     * ------------------------------------
+     * Returns a printable string listing each symbol and its code.
+     */
+    std::string toString() const;
+
+    /*
+     * Method: writeHeader
+     * Usage: code.writeHeader(output);
+     * --------------------------------
+     * Writes this code's lengths to the given output so that readHeader can
+     * rebuild it, starting at and ending on a byte boundary.  The header
+     * takes 2 bytes plus 3 bytes per symbol.
+     */
+    void writeHeader(obitstream& output) const;
+
+    /*
+     * Method: writeSymbol
+     * Usage: code.writeSymbol(output, symbol);
+     * ----------------------------------------
+     * Writes the code for the given symbol to the given output.
+     * Raises an error if the symbol has no code.
+     */
+    void writeSymbol(obitstream& output, int symbol) const;
+
+private:
+    /*
+     * One entry of the decoding table: what reading one byte of input does
+     * from one position in the code tree.  The symbols decoded are stored
+     * in decodeSymbols starting at index symbolsStart.
+     */
+    struct DecodeEntry {
+        int symbolsStart;
+        unsigned short nextState;
+        unsigned char symbolCount;
+        bool foundEOF;
+        bool invalid;
+    };
+
+    void assignCodes();
+    void buildDecodeTable();
+    void checkSymbol(int symbol, const std::string& caller) const;
+
+    int lengths[SYMBOL_COUNT];                  // code length of each symbol, or 0
+    unsigned long long codes[SYMBOL_COUNT];     // code of each symbol, bit-reversed
+                                                // so writeBits writes it in order
+    unsigned long long firstCode[64];           // canonical code of the first
+    int firstIndex[64];                         // symbol of each length, and its
+    int countOfLength[64];                      // index in sortedSymbols
+    std::vector<int> sortedSymbols;             // by (length, symbol)
+    int maxLength;
+
+    // built along with the codes, so that a const code needs no locking
+    std::vector<DecodeEntry> decodeTable;   // 256 entries per state
+    std::string decodeSymbols;
+};
+
+/*
+ * Prints the given code to the given stream, in the format of toString.
+ */
+std::ostream& operator <<(std::ostream& out, const CanonicalHuffmanCode& code);
+
+#include "private/init.h"   // ensure that Stanford C++ lib is initialized
+
+#endif // _canonicalhuffman_h
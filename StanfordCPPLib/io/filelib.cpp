@@ -4,6 +4,17 @@
  * This file implements the filelib.h interface.  All platform dependencies
  * are managed through the platform interface.
  * 
+ * @version 2018/10/19
+ * - MappedFile sizes are size_t, so files of 2 GB or more can be opened
+ * @version 2018/10/15
+ * - readEntireStream and writeEntireFile are timed by TIMED_SCOPEs (see profile.h)
+ * - MappedFile signals an error for files of 2 GB or more instead of
+ *   wrapping their size
+ * @version 2018/10/03
+ * - added MappedFile
+ * - readEntireStream does one size-hinted read() (or large chunked reads)
+ *   rather than one get()/put() per character
+ * - readEntireFile(istream, lines) reads the stream in bulk and splits it
  * @version 2016/11/20
  * - small bug fix in readEntireStream method (failed for non-text files)
  * @version 2016/11/12
@@ -26,11 +37,13 @@
 #include "filelib.h"
 #include <algorithm>
 #include <cctype>
+#include <climits>
 #include <cstdio>
 #include <fstream>
 #include <iostream>
 #include <string>
 #include <vector>
+#include "profile.h"
 #include "simpio.h"
 #include "strlib.h"
 #include "vector.h"
@@ -42,6 +55,101 @@ static bool recursiveMatch(const std::string& str, int sx, const std::string& pa
 
 /* Implementations */
 
+MappedFile::MappedFile()
+        : _data(nullptr),
+          _size(0),
+          _handle(nullptr) {
+    // empty
+}
+
+MappedFile::MappedFile(const std::string& filename)
+        : _data(nullptr),
+          _size(0),
+          _handle(nullptr) {
+    open(filename);
+}
+
+MappedFile::MappedFile(MappedFile&& other)
+        : _data(nullptr),
+          _size(0),
+          _handle(nullptr) {
+    *this = std::move(other);
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+MappedFile& MappedFile::operator =(MappedFile&& other) {
+    if (this != &other) {
+        close();
+        bool buffered = other._handle == nullptr && other._data != nullptr;
+        _buffer = std::move(other._buffer);
+        _data = buffered ? _buffer.data() : other._data;
+        _size = other._size;
+        _handle = other._handle;
+        other._data = nullptr;
+        other._size = 0;
+        other._handle = nullptr;
+    }
+    return *this;
+}
+
+void MappedFile::close() {
+    if (_handle) {
+        platform::filelib_unmapFile(_data, _size, _handle);
+    }
+    _data = nullptr;
+    _size = 0;
+    _handle = nullptr;
+    _buffer.clear();
+}
+
+const char* MappedFile::data() const {
+    return _data;
+}
+
+bool MappedFile::isOpen() const {
+    return _data != nullptr;
+}
+
+StringSplitter MappedFile::lines() const {
+    return StringSplitter(_data ? _data : "", _size, '\n');
+}
+
+bool MappedFile::open(const std::string& filename) {
+    close();
+    std::string expanded = expandPathname(filename);
+    _data = platform::filelib_mapFile(expanded, _size, _handle);
+    if (!_data) {
+        // can't be mapped (empty file, pipe, unsupported OS, ...); read it
+        std::ifstream input(expanded.c_str(), std::ios::in | std::ios::binary);
+        if (input.fail()) {
+            return false;
+        }
+        readEntireStream(input, _buffer);
+        _data = _buffer.data();
+        _size = _buffer.size();
+        _handle = nullptr;
+    }
+    return true;
+}
+
+size_t MappedFile::size() const {
+    return _size;
+}
+
+std::string MappedFile::toString() const {
+    return std::string(_data ? _data : "", _size);
+}
+
+StringView MappedFile::view() const {
+    if (_size > (size_t) INT_MAX) {
+        error("MappedFile::view: file is too large for a StringView (2 GB or more)");
+    }
+    return StringView(_data ? _data : "", (int) _size);
+}
+
 void createDirectory(const std::string& path) {
     return platform::filelib_createDirectory(expandPathname(path));
 }
@@ -376,21 +484,21 @@ std::string promptUserForFile(const std::string& prompt,
 
 void readEntireFile(std::istream& is, Vector<std::string>& lines) {
     lines.clear();
-    while (true) {
-        std::string line;
-        getline(is, line);
-        if (is.fail()) break;
-        lines.add(line);
+    std::string text;
+    readEntireStream(is, text);
+    lines.ensureCapacity((int) std::count(text.begin(), text.end(), '\n') + 1);
+    for (StringView line : StringSplitter(text, '\n')) {
+        lines.add(line.toString());
     }
 }
 
 void readEntireFile(std::istream& is, std::vector<std::string>& lines) {
     lines.clear();
-    while (true) {
-        std::string line;
-        getline(is, line);
-        if (is.fail()) break;
-        lines.push_back(line);
+    std::string text;
+    readEntireStream(is, text);
+    lines.reserve(std::count(text.begin(), text.end(), '\n') + 1);
+    for (StringView line : StringSplitter(text, '\n')) {
+        lines.push_back(line.toString());
     }
 }
 
@@ -422,15 +530,35 @@ std::string readEntireStream(std::istream& input) {
 }
 
 void readEntireStream(std::istream& input, std::string& out) {
-    std::ostringstream output;
-    while (true) {
-        int ch = input.get();
-        if (input.fail()) {
-            break;
+    TIMED_SCOPE("filelib::readEntireStream");
+    static const int CHUNK_SIZE = 64 * 1024;
+    out.clear();
+    if (input.fail()) {
+        return;
+    }
+
+    // if the stream is seekable, find out how much is left and read it all
+    // with one read(); the stream may deliver less (e.g. text-mode newline
+    // translation on Windows), so trust gcount rather than the size hint
+    std::streampos start = input.tellg();
+    if (start != std::streampos(-1)) {
+        input.seekg(0, std::ios::end);
+        std::streampos end = input.tellg();
+        input.seekg(start);
+        if (end != std::streampos(-1) && end >= start && !input.fail()) {
+            out.resize((size_t) (end - start));
+            input.read(&out[0], (std::streamsize) out.size());
+            out.resize((size_t) input.gcount());
         }
-        output.put(ch);
     }
-    out = output.str();
+
+    // unseekable stream (or the size hint was short); read the rest in chunks
+    while (input) {
+        size_t length = out.size();
+        out.resize(length + CHUNK_SIZE);
+        input.read(&out[length], CHUNK_SIZE);
+        out.resize(length + (size_t) input.gcount());
+    }
 }
 
 void renameFile(const std::string& oldname, const std::string& newname) {
@@ -451,6 +579,7 @@ void setCurrentDirectory(const std::string& path) {
 bool writeEntireFile(const std::string& filename,
                      const std::string& text,
                      bool append) {
+    TIMED_SCOPE("filelib::writeEntireFile");
     std::ofstream output;
     if (append) {
         output.open(filename.c_str(), std::ios_base::out | std::ios_base::app);
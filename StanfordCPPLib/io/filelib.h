@@ -8,6 +8,13 @@
  * contain separators in any of the supported styles, which usually
  * makes it possible to use the same code on different platforms.
  * 
+ * @version 2018/10/19
+ * - MappedFile sizes are size_t, so files of 2 GB or more can be opened
+ * @version 2018/10/15
+ * - MappedFile signals an error for files of 2 GB or more
+ * @version 2018/10/03
+ * - added MappedFile for reading whole files without copying them
+ * - readEntireStream/readEntireFile read in bulk rather than per character/line
  * @version 2016/11/12
  * - added fileSize, readEntireStream
  * @version 2016/08/12
@@ -27,8 +34,104 @@
 #include <fstream>
 #include <string>
 #include <vector>
+#include "strlib.h"
 #include "vector.h"
 
+/*
+ * Class: MappedFile
+ * -----------------
+ * A read-only view of the entire contents of a file.
+ * Where the operating system supports it, the file is memory-mapped, so its
+ * bytes are not copied into the process at all; otherwise it is read into
+ * an internal buffer with a single bulk read.
+ * The file's bytes are available for as long as the MappedFile is alive.
+ * Files of 2 GB or more can be opened and read through data() and lines(),
+ * though each line must be smaller than that, since a StringView's length
+ * is an int.
+ *
+ *     MappedFile file("input.txt");
+ *     for (StringView line : file.lines()) {
+ *         ...
+ *     }
+ */
+class MappedFile {
+public:
+    /*
+     * Constructs a MappedFile that has no file open.
+     */
+    MappedFile();
+
+    /*
+     * Opens and maps the given file.
+     * If the file cannot be opened, isOpen() will return false.
+     */
+    MappedFile(const std::string& filename);
+
+    MappedFile(MappedFile&& other);
+    virtual ~MappedFile();
+
+    MappedFile& operator =(MappedFile&& other);
+
+    /*
+     * Unmaps the file, if one is open.
+     */
+    void close();
+
+    /*
+     * Returns a pointer to the first byte of the file's contents.
+     * The contents are not null-terminated; use size() to find the end.
+     */
+    const char* data() const;
+
+    /*
+     * Returns true if the file was successfully opened.
+     */
+    bool isOpen() const;
+
+    /*
+     * Returns a lazy iterator over the lines of the file, as StringViews
+     * into the mapped contents.  The lines are the same ones that
+     * readEntireFile would produce; they do not include the '\n'.
+     * The file is read in binary mode, so lines of a file with Windows-style
+     * line endings keep their trailing '\r'.
+     * This works for files of any size; reaching a line of 2 GB or more
+     * signals an error.
+     */
+    StringSplitter lines() const;
+
+    /*
+     * Opens and maps the given file, closing any previously open file.
+     * Returns true if the file was successfully opened.
+     */
+    bool open(const std::string& filename);
+
+    /*
+     * Returns the number of bytes in the file.
+     */
+    size_t size() const;
+
+    /*
+     * Returns the file's contents as a new string.
+     */
+    std::string toString() const;
+
+    /*
+     * Returns a view of the file's entire contents.
+     * Signals an error if the file is 2 GB or more, which is too long for a
+     * StringView; use data() and size(), or lines(), for such files.
+     */
+    StringView view() const;
+
+private:
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator =(const MappedFile&) = delete;
+
+    const char* _data;
+    size_t _size;
+    void* _handle;          // platform-specific mapping handle, if mapped
+    std::string _buffer;    // holds contents if the file could not be mapped
+};
+
 /*
  * Function: createDirectory
  * Usage: createDirectory(path);
@@ -433,6 +536,8 @@ namespace platform {
     bool filelib_isFile(const std::string& filename);
     bool filelib_isSymbolicLink(const std::string& filename);
     void filelib_listDirectory(const std::string& path, std::vector<std::string>& list);
+    const char* filelib_mapFile(const std::string& filename, size_t& size, void*& handle);
+    void filelib_unmapFile(const char* data, size_t size, void* handle);
     void filelib_setCurrentDirectory(const std::string& path);
 }
 
@@ -3,6 +3,12 @@
  * ----------------------
  * Implementation for the TokenScanner class.
  * 
+ * @version 2018/10/19
+ * - buffer lengths and positions are size_t and int64_t rather than int
+ * @version 2018/10/12
+ * - string input scanned directly from a buffer rather than an istringstream
+ * - added buffer input, nextTokenView, and tokenize
+ * - character-class table and operator trie
  * @version 2016/11/26
  * - added getInput method
  * - replaced occurrences of string with const string& for efficiency
@@ -14,6 +20,7 @@
 
 #include "tokenscanner.h"
 #include <cctype>
+#include <climits>
 #include <iostream>
 #include "error.h"
 #include "strlib.h"
@@ -34,36 +41,65 @@ TokenScanner::TokenScanner(const std::string& str) {
     setInput(str);
 }
 
+TokenScanner::TokenScanner(const char* data, size_t length) {
+    initScanner();
+    setInput(data, length);
+}
+
 TokenScanner::~TokenScanner() {
-    if (stringInputFlag) {
-        delete isp;
-    }
+    clearSavedTokens();
 }
 
+/*
+ * Implementation notes: addOperator
+ * ---------------------------------
+ * Operators are stored in a trie so that the scanner can find the longest
+ * operator starting at the current character in a single pass, rather than
+ * testing every operator in a list against every prefix.
+ */
 void TokenScanner::addOperator(const std::string& op) {
-    StringCell* cp = new StringCell;
-    cp->str = op;
-    cp->link = operators;
-    operators = cp;
+    int node = 0;
+    for (char ch : op) {
+        int child = findOperatorChild(node, ch);
+        if (child < 0) {
+            child = (int) operatorTrie.size();
+            operatorTrie.push_back(OperatorNode());
+            operatorTrie[child].isOperator = false;
+            operatorTrie[node].edges += ch;
+            operatorTrie[node].children.push_back(child);
+        }
+        node = child;
+    }
+    operatorTrie[node].isOperator = true;
 }
 
 void TokenScanner::addWordCharacters(const std::string& str) {
     wordChars += str;
+    for (char ch : str) {
+        charClasses[(unsigned char) ch] |= CHAR_WORD;
+    }
 }
 
 int TokenScanner::getChar() {
+    if (!isp) {
+        return bufferPos < bufferLength ? (unsigned char) bufferData[bufferPos++] : EOF;
+    }
     return isp->get();
 }
 
 std::string TokenScanner::getInput() const {
+    if (stringInputFlag && bufferData != buffer.c_str()) {
+        return std::string(bufferData, bufferLength);
+    }
     return buffer;
 }
 
-int TokenScanner::getPosition() const {
+int64_t TokenScanner::getPosition() const {
+    int64_t pos = isp ? (int64_t) std::streamoff(isp->tellg()) : (int64_t) bufferPos;
     if (!savedTokens) {
-        return int(isp->tellg());
+        return pos;
     } else {
-        return int(isp->tellg()) - savedTokens->str.length();
+        return pos - (int64_t) savedTokens->str.length();
     }
 }
 
@@ -125,25 +161,17 @@ std::string TokenScanner::getStringValue(const std::string& token) const {
 }
 
 TokenType TokenScanner::getTokenType(const std::string& token) const {
-    if (token.empty()) {
-        return TokenType(EOF);
-    }
-
-    char ch = token[0];
-    if (isspace(ch)) {
-        return SEPARATOR;
-    } else if (ch == '"' || (ch == '\'' && token.length() > 1)) {
-        return STRING;
-    } else if (isdigit(ch)) {
-        return NUMBER;
-    } else if (isWordCharacter(ch)) {
-        return WORD;
-    } else {
-        return OPERATOR;
-    }
+    return tokenTypeOf(token.c_str(), token.length());
 }
 
 bool TokenScanner::hasMoreTokens() {
+    if (!isp && !savedTokens) {
+        // peek at the next token without copying it
+        size_t pos = bufferPos;
+        Token token = scanBufferToken();
+        bufferPos = pos;
+        return !token.text.empty();
+    }
     std::string token = nextToken();
     saveToken(token);
     return !token.empty();
@@ -158,7 +186,7 @@ void TokenScanner::ignoreWhitespace() {
 }
 
 bool TokenScanner::isWordCharacter(char ch) const {
-    return isalnum(ch) || wordChars.find(ch) != std::string::npos;
+    return (charClasses[(unsigned char) ch] & CHAR_WORD) != 0;
 }
 
 std::string TokenScanner::nextToken() {
@@ -170,6 +198,11 @@ std::string TokenScanner::nextToken() {
         return token;
     }
 
+    if (!isp) {
+        Token token = scanBufferToken();
+        return std::string(token.text.data(), token.text.length());
+    }
+
     while (true) {
         if (ignoreWhitespaceFlag) {
             skipSpaces();
@@ -216,15 +249,24 @@ std::string TokenScanner::nextToken() {
             isp->unget();
             return scanWord();
         }
+        // read the longest operator starting with ch, then give back any
+        // characters past the end of it
         std::string op = std::string(1, ch);
-        while (isOperatorPrefix(op)) {
+        size_t longest = 1;
+        int node = findOperatorChild(0, (char) ch);
+        while (node >= 0) {
             ch = isp->get();
             if (ch == EOF) {
+                isp->clear();   // so that unget below can back up from the end
                 break;
             }
             op += ch;
+            node = findOperatorChild(node, (char) ch);
+            if (node >= 0 && operatorTrie[node].isOperator) {
+                longest = op.length();
+            }
         }
-        while (op.length() > 1 && !isOperator(op)) {
+        while (op.length() > longest) {
             isp->unget();
             op.erase(op.length() - 1, 1);
         }
@@ -232,6 +274,24 @@ std::string TokenScanner::nextToken() {
     }
 }
 
+TokenScanner::Token TokenScanner::nextTokenView() {
+    if (isp) {
+        error("TokenScanner::nextTokenView: requires string or buffer input");
+    }
+    if (savedTokens) {
+        // saved tokens are not in the buffer; keep a copy alive for the view
+        int64_t position = getPosition();
+        savedTokenTexts.push_back(nextToken());
+        const std::string& text = savedTokenTexts.back();
+        Token token;
+        token.text = StringView(text);
+        token.type = getTokenType(text);
+        token.position = position;
+        return token;
+    }
+    return scanBufferToken();
+}
+
 void TokenScanner::saveToken(const std::string& token) {
     StringCell* cp = new StringCell;
     cp->str = token;
@@ -249,18 +309,57 @@ void TokenScanner::scanStrings() {
 
 void TokenScanner::setInput(std::istream& infile) {
     stringInputFlag = false;
+    buffer.clear();
     isp = &infile;
-    savedTokens = nullptr;
+    bufferData = nullptr;
+    bufferLength = 0;
+    bufferPos = 0;
+    clearSavedTokens();
 }
 
 void TokenScanner::setInput(const std::string& str) {
-    stringInputFlag = true;
     buffer = str;
-    isp = new std::istringstream(buffer);
-    savedTokens = nullptr;
+    setInput(buffer.c_str(), buffer.length());
+}
+
+void TokenScanner::setInput(const char* data, size_t length) {
+    if (!data && length > 0) {
+        error("TokenScanner::setInput: null buffer");
+    }
+    if (data != buffer.c_str()) {
+        buffer.clear();
+    }
+    stringInputFlag = true;
+    isp = nullptr;
+    bufferData = data;
+    bufferLength = length;
+    bufferPos = 0;
+    clearSavedTokens();
+}
+
+size_t TokenScanner::tokenize(std::vector<Token>& tokens) {
+    if (isp) {
+        error("TokenScanner::tokenize: requires string or buffer input");
+    }
+    size_t count = 0;
+    while (true) {
+        Token token = nextTokenView();
+        if (token.text.empty()) {
+            break;
+        }
+        tokens.push_back(token);
+        count++;
+    }
+    return count;
 }
 
 void TokenScanner::ungetChar(int) {
+    if (!isp) {
+        if (bufferPos > 0) {
+            bufferPos--;
+        }
+        return;
+    }
     isp->unget();
 }
 
@@ -269,8 +368,8 @@ void TokenScanner::verifyToken(const std::string& expected) {
     if (token != expected) {
         std::string msg = "TokenScanner::verifyToken: Found \"" + token + "\""
                 + " when expecting \"" + expected + "\"";
-        if (!buffer.empty()) {
-            msg += "\ninput = \"" + buffer + "\"";
+        if (stringInputFlag && bufferLength > 0) {
+            msg += "\ninput = \"" + getInput() + "\"";
         }
         error(msg);
     }
@@ -278,38 +377,192 @@ void TokenScanner::verifyToken(const std::string& expected) {
 
 /* Private methods */
 
+void TokenScanner::clearSavedTokens() {
+    while (savedTokens) {
+        StringCell* cp = savedTokens;
+        savedTokens = cp->link;
+        delete cp;
+    }
+    savedTokenTexts.clear();
+}
+
+int TokenScanner::findOperatorChild(int node, char ch) const {
+    size_t index = operatorTrie[node].edges.find(ch);
+    return index == std::string::npos ? -1 : operatorTrie[node].children[index];
+}
+
+/*
+ * Implementation notes: initScanner
+ * ---------------------------------
+ * Builds the table of character classes, so that each character test made
+ * while scanning is a single array lookup, and the root of the operator trie.
+ */
 void TokenScanner::initScanner() {
     ignoreWhitespaceFlag = false;
     ignoreCommentsFlag = false;
     scanNumbersFlag = false;
     scanStringsFlag = false;
-    operators = nullptr;
+    isp = nullptr;
+    savedTokens = nullptr;
+    bufferData = nullptr;
+    bufferLength = 0;
+    bufferPos = 0;
+    for (int ch = 0; ch < 256; ch++) {
+        charClasses[ch] = (isalnum(ch) ? CHAR_WORD : 0)
+                | (isdigit(ch) ? CHAR_DIGIT : 0)
+                | (isspace(ch) ? CHAR_SPACE : 0);
+    }
+    operatorTrie.clear();
+    operatorTrie.push_back(OperatorNode());
+    operatorTrie[0].isOperator = false;
 }
 
 /*
- * Implementation notes: isOperator, isOperatorPrefix
- * --------------------------------------------------
- * These methods search the list of operators and return true if the
- * specified operator is either in the list or a prefix of an operator
- * in the list, respectively.  This code could be made considerably more
- * efficient by implementing operators as a trie.
+ * Implementation notes: scanBufferToken
+ * -------------------------------------
+ * Reads the next token from string or buffer input.  This follows the same
+ * rules as nextToken does for streams, but works on indexes into the buffer,
+ * so the token's text never has to be copied.
  */
-bool TokenScanner::isOperator(const std::string& op) {
-    for (StringCell *cp = operators; cp != nullptr; cp = cp->link) {
-        if (op == cp->str) {
-            return true;
+TokenScanner::Token TokenScanner::scanBufferToken() {
+    const char* data = bufferData;
+    size_t length = bufferLength;
+    size_t pos = bufferPos;
+    while (true) {
+        if (ignoreWhitespaceFlag) {
+            while (pos < length && (charClasses[(unsigned char) data[pos]] & CHAR_SPACE)) {
+                pos++;
+            }
+        }
+        if (pos >= length) {
+            break;
+        }
+        char ch = data[pos];
+        if (ch == '/' && ignoreCommentsFlag && pos + 1 < length) {
+            if (data[pos + 1] == '/') {
+                pos += 2;
+                while (pos < length) {
+                    char c = data[pos++];
+                    if (c == '\n' || c == '\r') {
+                        break;
+                    }
+                }
+                continue;
+            } else if (data[pos + 1] == '*') {
+                pos += 2;
+                int prev = EOF;
+                while (pos < length) {
+                    char c = data[pos++];
+                    if (prev == '*' && c == '/') {
+                        break;
+                    }
+                    prev = c;
+                }
+                continue;
+            }
         }
+
+        size_t start = pos;
+        unsigned char flags = charClasses[(unsigned char) ch];
+        if ((ch == '"' || ch == '\'') && scanStringsFlag) {
+            pos = scanBufferString(pos);
+        } else if ((flags & CHAR_DIGIT) && scanNumbersFlag) {
+            pos = scanBufferNumber(pos);
+        } else if (flags & CHAR_WORD) {
+            pos++;
+            while (pos < length && (charClasses[(unsigned char) data[pos]] & CHAR_WORD)) {
+                pos++;
+            }
+        } else {
+            // longest operator starting here, or else just this one character
+            size_t end = pos + 1;
+            int node = 0;
+            for (size_t i = pos; i < length; i++) {
+                node = findOperatorChild(node, data[i]);
+                if (node < 0) {
+                    break;
+                }
+                if (operatorTrie[node].isOperator) {
+                    end = i + 1;
+                }
+            }
+            pos = end;
+        }
+        if (pos - start > INT_MAX) {
+            // the token's text is a StringView, whose length is an int
+            error("TokenScanner::nextToken: token of 2 GB or more");
+        }
+        bufferPos = pos;
+        Token token;
+        token.text = StringView(data + start, (int) (pos - start));
+        token.type = tokenTypeOf(data + start, pos - start);
+        token.position = (int64_t) start;
+        return token;
     }
-    return false;
+
+    bufferPos = length;
+    Token token;
+    token.text = StringView(data ? data + length : "", 0);
+    token.type = TokenType(EOF);
+    token.position = (int64_t) length;
+    return token;
 }
 
-bool TokenScanner::isOperatorPrefix(const std::string& op) {
-    for (StringCell* cp = operators; cp != nullptr; cp = cp->link) {
-        if (startsWith(cp->str, op)) {
-            return true;
+/*
+ * Implementation notes: scanBufferNumber
+ * --------------------------------------
+ * Returns the index just past the number that starts at the given index.
+ * This accepts exactly what the state machine in scanNumber does: digits,
+ * then optionally a decimal point and digits, then optionally an exponent,
+ * which is only included if at least one digit follows the E and sign.
+ */
+size_t TokenScanner::scanBufferNumber(size_t pos) const {
+    const char* data = bufferData;
+    size_t length = bufferLength;
+    pos++;
+    while (pos < length && (charClasses[(unsigned char) data[pos]] & CHAR_DIGIT)) {
+        pos++;
+    }
+    if (pos < length && data[pos] == '.') {
+        pos++;
+        while (pos < length && (charClasses[(unsigned char) data[pos]] & CHAR_DIGIT)) {
+            pos++;
+        }
+    }
+    if (pos < length && (data[pos] == 'E' || data[pos] == 'e')) {
+        size_t exp = pos + 1;
+        if (exp < length && (data[exp] == '+' || data[exp] == '-')) {
+            exp++;
+        }
+        if (exp < length && (charClasses[(unsigned char) data[exp]] & CHAR_DIGIT)) {
+            while (exp < length && (charClasses[(unsigned char) data[exp]] & CHAR_DIGIT)) {
+                exp++;
+            }
+            pos = exp;
         }
     }
-    return false;
+    return pos;
+}
+
+/*
+ * Implementation notes: scanBufferString
+ * --------------------------------------
+ * Returns the index just past the closing delimiter of the quoted string
+ * that starts at the given index, or generates an error if it has none.
+ */
+size_t TokenScanner::scanBufferString(size_t pos) const {
+    char delim = bufferData[pos++];
+    bool escape = false;
+    while (true) {
+        if (pos >= bufferLength) {
+            error("TokenScanner::scanString: found unterminated string");
+        }
+        char ch = bufferData[pos++];
+        if (ch == delim && !escape) {
+            return pos;
+        }
+        escape = (ch == '\\') && !escape;
+    }
 }
 
 /*
@@ -363,8 +616,11 @@ std::string TokenScanner::scanNumber() {
             } else {
                 if (ch != EOF) {
                     isp->unget();
+                } else {
+                    isp->clear();
                 }
                 isp->unget();
+                token.erase(token.length() - 1);   // E was not part of the number
                 state = FINAL_STATE;
             }
             break;
@@ -374,9 +630,12 @@ std::string TokenScanner::scanNumber() {
             } else {
                 if (ch != EOF) {
                     isp->unget();
+                } else {
+                    isp->clear();
                 }
                 isp->unget();
                 isp->unget();
+                token.erase(token.length() - 2);   // nor were E and its sign
                 state = FINAL_STATE;
             }
             break;
@@ -459,18 +718,38 @@ void TokenScanner::skipSpaces() {
         if (ch == EOF) {
             return;
         }
-        if (!isspace(ch)) {
+        if (!(charClasses[(unsigned char) ch] & CHAR_SPACE)) {
             isp->unget();
             return;
         }
     }
 }
 
+TokenType TokenScanner::tokenTypeOf(const char* text, size_t length) const {
+    if (length == 0) {
+        return TokenType(EOF);
+    }
+
+    char ch = text[0];
+    unsigned char flags = charClasses[(unsigned char) ch];
+    if (flags & CHAR_SPACE) {
+        return SEPARATOR;
+    } else if (ch == '"' || (ch == '\'' && length > 1)) {
+        return STRING;
+    } else if (flags & CHAR_DIGIT) {
+        return NUMBER;
+    } else if (flags & CHAR_WORD) {
+        return WORD;
+    } else {
+        return OPERATOR;
+    }
+}
+
 std::ostream& operator <<(std::ostream& out, const TokenScanner& scanner) {
     out << "TokenScanner{";
     bool first = true;
-    if (!scanner.buffer.empty()) {
-        out << "input=\"" << scanner.buffer << "\"";
+    if (scanner.stringInputFlag && scanner.bufferLength > 0) {
+        out << "input=\"" << scanner.getInput() << "\"";
         first = false;
     }
     out << (first ? "" : ",") << "position=" << scanner.getPosition();
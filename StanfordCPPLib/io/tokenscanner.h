@@ -4,6 +4,11 @@
  * This file exports a <code>TokenScanner</code> class that divides
  * a string into individual logical units called <b><i>tokens</i></b>.
  *
+ * @version 2018/10/19
+ * - buffer lengths and token positions are size_t and int64_t, not int,
+ *   so that inputs of 2 GB or more can be scanned
+ * @version 2018/10/12
+ * - added buffer input, nextTokenView, and tokenize
  * @version 2016/11/26
  * - added getInput method
  * - replaced occurrences of string with const string& for efficiency
@@ -14,8 +19,13 @@
 #ifndef _tokenscanner_h
 #define _tokenscanner_h
 
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
+#include <list>
 #include <string>
+#include <vector>
+#include "strlib.h"
 #include "private/tokenpatch.h"
 
 /*
@@ -54,6 +64,20 @@ enum TokenType {SEPARATOR, WORD, NUMBER, STRING, OPERATOR};
  */
 class TokenScanner {
 public:
+    /*
+     * Type: Token
+     * -----------
+     * A token as returned by <code>nextTokenView</code> and <code>tokenize</code>:
+     * its text, its type, and the position in the input where it begins.
+     * The text refers directly into the scanner's input buffer rather than
+     * being copied, so it is only valid as long as that input is.
+     */
+    struct Token {
+        StringView text;
+        TokenType type;
+        int64_t position;
+    };
+
     /*
      * Constructor: TokenScanner
      * Usage: TokenScanner scanner;
@@ -68,6 +92,18 @@ public:
     TokenScanner(std::istream& infile);
     TokenScanner(const std::string& str);
 
+    /*
+     * Constructor: TokenScanner
+     * Usage: TokenScanner scanner(data, length);
+     * ------------------------------------------
+     * Initializes a scanner that reads tokens directly from the given
+     * buffer of characters, such as the contents of a <code>MappedFile</code>,
+     * without copying it.  The buffer must stay valid and unchanged for
+     * as long as the scanner uses it.  The buffer may be 2 GB or larger,
+     * though each token in it must be smaller than that.
+     */
+    TokenScanner(const char* data, size_t length);
+
     /*
      * Destructor: ~TokenScanner
      * -------------------------
@@ -117,14 +153,14 @@ public:
 
     /*
      * Method: getPosition
-     * Usage: int pos = scanner.getPosition();
-     * ---------------------------------------
+     * Usage: int64_t pos = scanner.getPosition();
+     * -------------------------------------------
      * Returns the current position of the scanner in the input stream.
      * If <code>saveToken</code> has been called, this position corresponds
      * to the beginning of the saved token.  If <code>saveToken</code> is
      * called more than once, <code>getPosition</code> returns -1.
      */
-    int getPosition() const;
+    int64_t getPosition() const;
 
     /*
      * Method: getStringValue
@@ -207,6 +243,17 @@ public:
      */
     std::string nextToken();
 
+    /*
+     * Method: nextTokenView
+     * Usage: TokenScanner::Token token = scanner.nextTokenView();
+     * -----------------------------------------------------------
+     * Returns the next token along with its type and position, without
+     * copying its text out of the input.  At the end of the input, returns
+     * a token with empty text.  Only available when the scanner's input
+     * is a string or buffer rather than a stream.
+     */
+    Token nextTokenView();
+
     /*
      * Method: saveToken
      * Usage: scanner.saveToken(token);
@@ -265,6 +312,18 @@ public:
      */
     void setInput(std::istream& infile);
     void setInput(const std::string& str);
+    void setInput(const char* data, size_t length);
+
+    /*
+     * Method: tokenize
+     * Usage: size_t count = scanner.tokenize(tokens);
+     * -----------------------------------------------
+     * Reads all of the remaining tokens in the input and appends them to
+     * the given vector, returning how many were added.  This is the fastest
+     * way to scan a large input.  Like <code>nextTokenView</code>, only
+     * available for string or buffer input.
+     */
+    size_t tokenize(std::vector<Token>& tokens);
 
     /*
      * Method: ungetChar
@@ -317,6 +376,28 @@ private:
         FINAL_STATE
     };
 
+    /*
+     * Bit flags stored in the character-class table for each character.
+     */
+    enum CharClass {
+        CHAR_WORD = 1,
+        CHAR_DIGIT = 2,
+        CHAR_SPACE = 4
+    };
+
+    /*
+     * Private type: OperatorNode
+     * --------------------------
+     * A node in the trie of defined operators.  edges[i] is the character
+     * leading to child node children[i]; nodes are stored in a vector and
+     * refer to each other by index, with the root at index 0.
+     */
+    struct OperatorNode {
+        std::string edges;
+        std::vector<int> children;
+        bool isOperator;
+    };
+
     std::string buffer;              /* The original argument string */
     std::istream* isp;               /* The input stream for tokens  */
     bool stringInputFlag;            /* Flag indicating string input */
@@ -326,16 +407,25 @@ private:
     bool scanStringsFlag;            /* Scanner parses strings       */
     std::string wordChars;           /* Additional word characters   */
     StringCell* savedTokens;         /* Stack of saved tokens        */
-    StringCell* operators;           /* List of multichar operators  */
+    const char* bufferData;          /* String/buffer input, if any  */
+    size_t bufferLength;             /* Length of buffer input       */
+    size_t bufferPos;                /* Current index in buffer      */
+    unsigned char charClasses[256];  /* CharClass flags per char     */
+    std::vector<OperatorNode> operatorTrie;   /* Multichar operators */
+    std::list<std::string> savedTokenTexts;   /* Backs views of saved tokens */
 
     /* Private method prototypes */
+    void clearSavedTokens();
+    int findOperatorChild(int node, char ch) const;
     void initScanner();
-    bool isOperator(const std::string& op);
-    bool isOperatorPrefix(const std::string& op);
     std::string scanNumber();
     std::string scanString();
     std::string scanWord();
     void skipSpaces();
+    Token scanBufferToken();
+    size_t scanBufferNumber(size_t pos) const;
+    size_t scanBufferString(size_t pos) const;
+    TokenType tokenTypeOf(const char* text, size_t length) const;
 
     friend std::ostream& operator <<(std::ostream& out, const TokenScanner& scanner);
 };
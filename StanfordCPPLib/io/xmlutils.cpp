@@ -6,6 +6,13 @@
  * See xmlutils.h for documentation of each function.
  * 
  * @author Marty Stepp
+ * @version 2018/10/19
+ * - XmlDocument::open reports read and parse errors with error()
+ * - load checks for a failed tellg before allocating its buffer
+ * @version 2018/10/15
+ * - added XmlDocument, its cache, and query
+ * - openXmlDocument no longer copies the file text twice and leaks a new
+ *   buffer and document on every call
  * @version 2016/10/22
  * - changed openXmlDocument to print error message rather than crash on file-not-found
  * @version 2016/10/14
@@ -15,10 +22,38 @@
  */
 
 #include "xmlutils.h"
+#include <sys/stat.h>
 #include <cstring>
-#include "filelib.h"
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <set>
+#include "error.h"
 #include "rapidxml.h"
 #include "strlib.h"
+#include "private/static.h"
+
+namespace xmlutils {
+/*
+ * A document in the cache, with the modification time and size that its
+ * file had when it was read; if either has changed, the file is read again.
+ * Times are only accurate to the second on some systems, so the size helps
+ * catch a file rewritten within the same second.
+ */
+struct CachedXmlDocument {
+    time_t modified;
+    long long size;
+    std::shared_ptr<const XmlDocument> document;
+};
+typedef std::map<std::string, CachedXmlDocument> XmlDocumentCache;
+typedef std::set<std::shared_ptr<const XmlDocument>> XmlDocumentSet;
+
+STATIC_VARIABLE_DECLARE_BLANK(std::mutex, cacheMutex)
+STATIC_VARIABLE_DECLARE_COLLECTION_EMPTY(XmlDocumentCache, documentCache)
+STATIC_VARIABLE_DECLARE_COLLECTION_EMPTY(XmlDocumentSet, openedDocuments)
+
+static std::vector<XmlPathStep> parsePath(const std::string& path);
+} // namespace xmlutils
 
 namespace xmlutils {
 int getAttributeInt(rapidxml::xml_node<>* node, const std::string& attrName, int defaultValue) {
@@ -45,11 +80,14 @@ std::string getAttribute(rapidxml::xml_node<>* node, const std::string& attrName
 }
 
 std::vector<rapidxml::xml_node<>*> getChildNodes(rapidxml::xml_node<>* node, const std::string& nodeName) {
+    XmlPathStep step = {nodeName, "", "", false};
     std::vector<rapidxml::xml_node<>*> v;
-    for (rapidxml::xml_node<>* childNode = node->first_node(nodeName.c_str());
+    for (rapidxml::xml_node<>* childNode = node->first_node();
          childNode != nullptr;
-         childNode = childNode->next_sibling(nodeName.c_str())) {
-        v.push_back(childNode);
+         childNode = childNode->next_sibling()) {
+        if (step.matches(childNode)) {
+            v.push_back(childNode);
+        }
     }
     return v;
 }
@@ -60,13 +98,245 @@ bool hasAttribute(rapidxml::xml_node<>* node, const std::string& attrName) {
 }
 
 rapidxml::xml_node<>* openXmlDocument(const std::string& filename, const std::string& documentNode) {
-    std::string xmlFileText = readEntireFile(filename);
-    char* buf = new char[xmlFileText.length() + 1024]();   // *** memory leak (but MUST be heap-allocated)
-    memset(buf, 0, xmlFileText.length() + 1024);
-    strcpy(buf, xmlFileText.c_str());
-    rapidxml::xml_document<char>* xmlDoc = new rapidxml::xml_document<char>;   // *** memory leak (but MUST be heap-allocated)
-    xmlDoc->parse<NULL>(buf);
-    rapidxml::xml_node<>* node = xmlDoc->first_node(documentNode.c_str());
-    return node;
+    std::shared_ptr<const XmlDocument> document = XmlDocument::open(filename);
+    if (!document) {
+        return nullptr;
+    }
+    // callers have no way to say when they are done with the node, so keep
+    // every document handed out here; an unchanged file is the same document
+    std::lock_guard<std::mutex> guard(STATIC_VARIABLE(cacheMutex));
+    STATIC_VARIABLE(openedDocuments).insert(document);
+    return document->getRootNode(documentNode);
+}
+
+XmlNodeRange query(rapidxml::xml_node<>* node, const std::string& path) {
+    return XmlNodeRange(node, std::make_shared<const std::vector<XmlPathStep>>(parsePath(path)));
+}
+
+XmlDocument::XmlDocument(const std::string& filename) {
+    std::string message = load(filename);
+    if (!message.empty()) {
+        error("XmlDocument: " + message);
+    }
+}
+
+void XmlDocument::clearCache() {
+    std::lock_guard<std::mutex> guard(STATIC_VARIABLE(cacheMutex));
+    STATIC_VARIABLE(documentCache).clear();
+}
+
+const std::string& XmlDocument::getFilename() const {
+    return filename;
+}
+
+rapidxml::xml_node<>* XmlDocument::getRootNode(const std::string& name) const {
+    XmlPathStep step = {name, "", "", false};
+    for (rapidxml::xml_node<>* node = document.first_node(); node; node = node->next_sibling()) {
+        if (step.matches(node)) {
+            return node;
+        }
+    }
+    return nullptr;
+}
+
+std::string XmlDocument::load(const std::string& filename) {
+    this->filename = filename;
+    std::ifstream input(filename.c_str(), std::ios::binary);
+    if (!input) {
+        return "cannot open file \"" + filename + "\"";
+    }
+
+    // read straight into the buffer that the parser works in, with room for
+    // the terminating '\0' it needs
+    input.seekg(0, std::ios::end);
+    std::streamoff length = input.tellg();
+    input.seekg(0, std::ios::beg);
+    if (length < 0) {
+        return "cannot read file \"" + filename + "\"";
+    }
+    text.reset(new char[(size_t) length + 1]);
+    if (length > 0 && !input.read(text.get(), length)) {
+        return "cannot read file \"" + filename + "\"";
+    }
+    text[(size_t) length] = '\0';
+
+    try {
+        document.parse<0>(text.get());
+    } catch (const rapidxml::parse_error& ex) {
+        return "cannot parse file \"" + filename + "\" (" + ex.what() + ")";
+    }
+    return "";
+}
+
+std::shared_ptr<const XmlDocument> XmlDocument::open(const std::string& filename) {
+    struct stat info;
+    if (stat(filename.c_str(), &info) != 0) {
+        return nullptr;
+    }
+    {
+        std::lock_guard<std::mutex> guard(STATIC_VARIABLE(cacheMutex));
+        XmlDocumentCache& cache = STATIC_VARIABLE(documentCache);
+        XmlDocumentCache::iterator it = cache.find(filename);
+        if (it != cache.end() && it->second.modified == info.st_mtime
+                && it->second.size == (long long) info.st_size) {
+            return it->second.document;
+        }
+    }
+
+    // parse outside the lock; if two threads both load the file, one of
+    // their documents simply replaces the other in the cache
+    std::shared_ptr<XmlDocument> document(new XmlDocument());
+    std::string message = document->load(filename);
+    if (!message.empty()) {
+        error("XmlDocument::open: " + message);
+    }
+    std::lock_guard<std::mutex> guard(STATIC_VARIABLE(cacheMutex));
+    CachedXmlDocument cached = {info.st_mtime, (long long) info.st_size, document};
+    STATIC_VARIABLE(documentCache)[filename] = cached;
+    return document;
+}
+
+XmlNodeRange XmlDocument::query(const std::string& path) const {
+    return xmlutils::query(&document, path);
+}
+
+bool XmlPathStep::matches(rapidxml::xml_node<>* node) const {
+    if (node->type() != rapidxml::node_element) {
+        return false;
+    }
+    if (name != "*" && (node->name_size() != name.length()
+                        || memcmp(node->name(), name.data(), name.length()) != 0)) {
+        return false;
+    }
+    if (!attribute.empty()) {
+        rapidxml::xml_attribute<>* attr = node->first_attribute(attribute.data(), attribute.length());
+        if (!attr) {
+            return false;
+        }
+        if (hasValue && (attr->value_size() != value.length()
+                         || memcmp(attr->value(), value.data(), value.length()) != 0)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+XmlNodeRange::XmlNodeRange(rapidxml::xml_node<>* context, std::shared_ptr<const std::vector<XmlPathStep>> steps)
+        : context(context),
+          steps(steps) {
+    // empty
+}
+
+XmlNodeRange::iterator XmlNodeRange::begin() const {
+    return iterator(context, steps);
+}
+
+XmlNodeRange::iterator XmlNodeRange::end() const {
+    return iterator();
+}
+
+rapidxml::xml_node<>* XmlNodeRange::first() const {
+    iterator it = begin();
+    return it == end() ? nullptr : *it;
+}
+
+bool XmlNodeRange::isEmpty() const {
+    return begin() == end();
+}
+
+int XmlNodeRange::size() const {
+    int count = 0;
+    for (iterator it = begin(); it != end(); ++it) {
+        count++;
+    }
+    return count;
+}
+
+XmlNodeRange::iterator::iterator(rapidxml::xml_node<>* context,
+                                 std::shared_ptr<const std::vector<XmlPathStep>> steps)
+        : steps(steps) {
+    if (context && !steps->empty()) {
+        path.reserve(steps->size());
+        seek(0, context->first_node());
+    }
+}
+
+XmlNodeRange::iterator& XmlNodeRange::iterator::operator ++() {
+    rapidxml::xml_node<>* next = path.back()->next_sibling();
+    path.pop_back();
+    seek((int) path.size(), next);
+    return *this;
+}
+
+void XmlNodeRange::iterator::seek(int step, rapidxml::xml_node<>* candidate) {
+    // a depth-first search, with path holding the nodes matched so far
+    while (true) {
+        while (candidate && !(*steps)[step].matches(candidate)) {
+            candidate = candidate->next_sibling();
+        }
+        if (candidate) {
+            path.push_back(candidate);
+            if (step + 1 == (int) steps->size()) {
+                return;   // matched every step
+            }
+            step++;
+            candidate = candidate->first_node();
+        } else if (step == 0) {
+            return;   // no more matches; path is empty
+        } else {
+            // no more matches under the previous step's node; try its next sibling
+            step--;
+            candidate = path.back()->next_sibling();
+            path.pop_back();
+        }
+    }
+}
+
+/*
+ * Splits a path such as "category/pattern[@type='warn']" into its steps.
+ */
+static std::vector<XmlPathStep> parsePath(const std::string& path) {
+    std::vector<XmlPathStep> steps;
+    size_t start = (!path.empty() && path[0] == '/') ? 1 : 0;   // a leading slash is allowed
+    bool valid = start < path.length();
+    while (valid && start <= path.length()) {
+        // find the end of this step; a quoted value may contain '/'
+        size_t end = start;
+        char quote = '\0';
+        while (end < path.length() && (quote || path[end] != '/')) {
+            if (quote && path[end] == quote) {
+                quote = '\0';
+            } else if (!quote && (path[end] == '\'' || path[end] == '"')) {
+                quote = path[end];
+            }
+            end++;
+        }
+        std::string text = path.substr(start, end - start);
+
+        XmlPathStep step = {text, "", "", false};
+        size_t bracket = text.find('[');
+        if (bracket != std::string::npos) {
+            step.name = text.substr(0, bracket);
+            valid = text.length() >= bracket + 4 && text[bracket + 1] == '@' && text[text.length() - 1] == ']';
+            std::string test = valid ? text.substr(bracket + 2, text.length() - bracket - 3) : "";
+            size_t equals = test.find('=');
+            step.attribute = test.substr(0, equals);
+            if (equals != std::string::npos) {
+                std::string value = test.substr(equals + 1);
+                valid = valid && value.length() >= 2 && (value[0] == '\'' || value[0] == '"')
+                        && value[value.length() - 1] == value[0];
+                step.value = valid ? value.substr(1, value.length() - 2) : "";
+                step.hasValue = true;
+            }
+            valid = valid && !step.attribute.empty();
+        }
+        valid = valid && !step.name.empty();
+        steps.push_back(step);
+        start = end + 1;
+    }
+    if (!valid) {
+        error("xmlutils::query: invalid path \"" + path + "\"");
+    }
+    return steps;
 }
 } // namespace xmlutils
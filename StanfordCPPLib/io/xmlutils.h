@@ -5,8 +5,31 @@
  * and extracting information from XML documents.
  * It is a thin wrapper around the third-party RapidXML library (rapidxml*.{h,cpp})
  * so that we don't have to use or remember its unusual templatey syntax.
- * 
+ *
+ * Documents can be loaded with openXmlDocument, which keeps every document
+ * for the life of the program, or as an XmlDocument, which owns its parsed
+ * nodes and frees them when the last reference to it goes away.
+ * XmlDocument::open keeps a cache of parsed documents, so a file that is
+ * loaded many times is read and parsed only once unless it changes.
+ *
+ *<pre>
+ *    std::shared_ptr<const xmlutils::XmlDocument> doc = xmlutils::XmlDocument::open("style.xml");
+ *    for (rapidxml::xml_node<>* pattern : doc->query("stylecheck/category/pattern[@regex]")) {
+ *        ...
+ *    }
+ *</pre>
+ *
  * @author Marty Stepp
+ * @version 2018/10/19
+ * - XmlDocument::open signals an error for a file that exists but can't be
+ *   read or parsed, rather than returning nullptr as for a missing file
+ * - query iterators share ownership of the parsed path with their range
+ * @version 2018/10/15
+ * - added XmlDocument, a cached document that owns its buffer and nodes
+ * - added query and XmlNodeRange for iterating over nodes matching a path
+ * - openXmlDocument uses XmlDocument's cache rather than leaking a new copy
+ *   of the file and document on every call
+ * - a node name of "*" matches any element, as the defaults always suggested
  * @version 2014/10/14
  * @since 2014/03/01
  */
@@ -14,17 +37,228 @@
 #ifndef _xmlutils_h
 #define _xmlutils_h
 
+#include <iterator>
+#include <memory>
 #include <string>
 #include <vector>
 #include "rapidxml.h"
 
 namespace xmlutils {
+    class XmlNodeRange;
+
     int getAttributeInt(rapidxml::xml_node<>* node, const std::string& attrName, int defaultValue = 0);
     bool getAttributeBool(rapidxml::xml_node<>* node, const std::string& attrName, bool defaultValue = false);
     std::string getAttribute(rapidxml::xml_node<>* node, const std::string& attrName, const std::string& defaultValue = "");
     std::vector<rapidxml::xml_node<>*> getChildNodes(rapidxml::xml_node<>* node, const std::string& nodeName = "*");
     bool hasAttribute(rapidxml::xml_node<>* node, const std::string& attrName);
     rapidxml::xml_node<>* openXmlDocument(const std::string& filename, const std::string& documentNode = "*");
+
+    /*
+     * Returns the element nodes found by following the given path down from
+     * the given node.  The path is a series of steps separated by slashes,
+     * such as "category/pattern"; each step names the child elements to go
+     * to next, or is "*" for all child elements, and may end with "[@attr]"
+     * to keep only elements that have the given attribute, or
+     * "[@attr='value']" to keep only those whose attribute has that value.
+     * The nodes are found one at a time as the returned range is iterated,
+     * in document order, without building a list of them.
+     * Signals an error if the path is not in this form.
+     */
+    XmlNodeRange query(rapidxml::xml_node<>* node, const std::string& path);
+
+/*
+ * Class: XmlDocument
+ * ------------------
+ * A parsed XML file.  The document parses the file's text in place, in a
+ * buffer that it owns, so node names and values point into that buffer,
+ * and both are freed along with the document.
+ */
+class XmlDocument {
+public:
+    /*
+     * Constructor: XmlDocument
+     * Usage: XmlDocument doc(filename);
+     * ---------------------------------
+     * Reads and parses the given XML file.
+     * Signals an error if the file cannot be read or is not valid XML.
+     */
+    explicit XmlDocument(const std::string& filename);
+
+    /*
+     * Method: clearCache
+     * Usage: XmlDocument::clearCache();
+     * ---------------------------------
+     * Empties the cache used by open.  Documents still in use elsewhere stay
+     * valid until their last reference goes away.
+     */
+    static void clearCache();
+
+    /*
+     * Method: getFilename
+     * Usage: string filename = doc.getFilename();
+     * -------------------------------------------
+     * Returns the name of the file this document was read from.
+     */
+    const std::string& getFilename() const;
+
+    /*
+     * Method: getRootNode
+     * Usage: rapidxml::xml_node<>* root = doc.getRootNode(name);
+     * ----------------------------------------------------------
+     * Returns the document's top-level element if it has the given name
+     * (or any name, if the name is "*" or omitted), otherwise nullptr.
+     */
+    rapidxml::xml_node<>* getRootNode(const std::string& name = "*") const;
+
+    /*
+     * Method: open
+     * Usage: std::shared_ptr<const XmlDocument> doc = XmlDocument::open(filename);
+     * ----------------------------------------------------------------------------
+     * Returns the parsed document for the given file.  It comes from a cache
+     * shared by the whole program if the file has not been modified since it
+     * was cached; otherwise the file is read, parsed, and cached.
+     * Returns nullptr if the file does not exist.
+     * Signals an error if it exists but cannot be read or is not valid XML.
+     * The document stays valid as long as the returned pointer, or a copy of
+     * it, exists, even if the cache later replaces it.
+     */
+    static std::shared_ptr<const XmlDocument> open(const std::string& filename);
+
+    /*
+     * Method: query
+     * Usage: for (rapidxml::xml_node<>* node : doc.query(path)) ...
+     * -------------------------------------------------------------
+     * Returns the element nodes matching the given path, as described for
+     * the query function; the path's first step matches the top-level
+     * element.
+     */
+    XmlNodeRange query(const std::string& path) const;
+
+/**********************************************************************/
+/* Note: Everything below this point in this class is logically part  */
+/* of the implementation and should not be of interest to clients.    */
+/**********************************************************************/
+private:
+    XmlDocument() = default;
+    XmlDocument(const XmlDocument&) = delete;
+    XmlDocument& operator =(const XmlDocument&) = delete;
+
+    // reads and parses the file; returns an error message, or "" if it worked
+    std::string load(const std::string& filename);
+
+    std::string filename;
+    std::unique_ptr<char[]> text;   // parsed in place; the nodes point into it
+    mutable rapidxml::xml_document<> document;
+};
+
+/*
+ * One step of a path given to query.
+ */
+struct XmlPathStep {
+    std::string name;        // "*" for any name
+    std::string attribute;   // empty if the step has no [@attr] test
+    std::string value;
+    bool hasValue;
+
+    bool matches(rapidxml::xml_node<>* node) const;
+};
+
+/*
+ * Class: XmlNodeRange
+ * -------------------
+ * The nodes that match a query, which are found one at a time as the range
+ * is iterated, with a range-based for loop or with begin and end.
+ * A range and its iterators refer to the nodes of their document, so the
+ * document must still exist while they are used; an iterator may outlive
+ * the range it came from.
+ */
+class XmlNodeRange {
+public:
+    class iterator : public std::iterator<std::forward_iterator_tag, rapidxml::xml_node<>*> {
+    public:
+        iterator() {}
+
+        rapidxml::xml_node<>* operator *() const {
+            return path.back();
+        }
+
+        iterator& operator ++();
+
+        iterator operator ++(int) {
+            iterator copy(*this);
+            ++(*this);
+            return copy;
+        }
+
+        bool operator ==(const iterator& other) const {
+            return path == other.path;
+        }
+
+        bool operator !=(const iterator& other) const {
+            return path != other.path;
+        }
+
+    private:
+        iterator(rapidxml::xml_node<>* context, std::shared_ptr<const std::vector<XmlPathStep>> steps);
+
+        // moves to the next match, starting with the given node and then its
+        // later siblings as candidates for the given step
+        void seek(int step, rapidxml::xml_node<>* candidate);
+
+        std::shared_ptr<const std::vector<XmlPathStep>> steps;   // kept alive past the range
+        std::vector<rapidxml::xml_node<>*> path;   // node matched by each step; empty at the end
+
+        friend class XmlNodeRange;
+    };
+
+    /*
+     * Method: begin
+     * Usage: XmlNodeRange::iterator it = range.begin();
+     * -------------------------------------------------
+     * Returns an iterator at the first matching node.
+     */
+    iterator begin() const;
+
+    /*
+     * Method: end
+     * Usage: XmlNodeRange::iterator it = range.end();
+     * -----------------------------------------------
+     * Returns an iterator past the last matching node.
+     */
+    iterator end() const;
+
+    /*
+     * Method: first
+     * Usage: rapidxml::xml_node<>* node = range.first();
+     * --------------------------------------------------
+     * Returns the first matching node, or nullptr if there is none.
+     */
+    rapidxml::xml_node<>* first() const;
+
+    /*
+     * Method: isEmpty
+     * Usage: if (range.isEmpty()) ...
+     * -------------------------------
+     * Returns true if no nodes match.
+     */
+    bool isEmpty() const;
+
+    /*
+     * Method: size
+     * Usage: int count = range.size();
+     * --------------------------------
+     * Returns the number of matching nodes, by visiting them all.
+     */
+    int size() const;
+
+private:
+    XmlNodeRange(rapidxml::xml_node<>* context, std::shared_ptr<const std::vector<XmlPathStep>> steps);
+
+    rapidxml::xml_node<>* context;
+    std::shared_ptr<const std::vector<XmlPathStep>> steps;   // shared by copies of the range
+
+    friend XmlNodeRange query(rapidxml::xml_node<>* node, const std::string& path);
+};
 } // namespace xmlutils
 
 #endif
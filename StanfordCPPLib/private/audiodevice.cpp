@@ -0,0 +1,104 @@
+/*
+ * File: audiodevice.cpp
+ * ---------------------
+ * This file implements the audiodevice.h interface using Qt's audio output,
+ * if the project was built with the Qt multimedia module (SPL_QT_MULTIMEDIA).
+ *
+ * @version 2018/10/19
+ * - builds without the Qt multimedia module, with no output device
+ * @version 2018/10/15
+ * - initial version
+ */
+
+#include "private/audiodevice.h"
+#ifdef SPL_QT_MULTIMEDIA
+#include <QAudioDeviceInfo>
+#include <QAudioFormat>
+#include <QAudioOutput>
+#include <QIODevice>
+#include "gthread.h"
+#endif // SPL_QT_MULTIMEDIA
+
+namespace stanfordcpplib {
+
+#ifdef SPL_QT_MULTIMEDIA
+
+/*
+ * A read-only QIODevice through which the audio output pulls samples from
+ * the ring buffer.  readData is called whenever the device needs more audio,
+ * so it must never wait: it takes whatever samples are ready, without locks
+ * or memory allocation, and fills the rest with silence.
+ */
+class AudioRingBufferDevice : public QIODevice {
+public:
+    explicit AudioRingBufferDevice(AudioRingBuffer* buffer)
+            : buffer(buffer) {
+        // empty
+    }
+
+    qint64 bytesAvailable() const Q_DECL_OVERRIDE {
+        // never runs dry; an empty buffer reads as silence
+        return buffer->capacity() * (qint64) sizeof(int16_t) + QIODevice::bytesAvailable();
+    }
+
+    bool isSequential() const Q_DECL_OVERRIDE {
+        return true;
+    }
+
+protected:
+    qint64 readData(char* data, qint64 maxSize) Q_DECL_OVERRIDE {
+        // whole stereo frames only, so that left and right never swap
+        int count = (int) (maxSize / (2 * sizeof(int16_t))) * 2;
+        int16_t* samples = reinterpret_cast<int16_t*>(data);
+        int n = buffer->read(samples, count);
+        memset(samples + n, 0, (count - n) * sizeof(int16_t));
+        return count * (qint64) sizeof(int16_t);
+    }
+
+    qint64 writeData(const char* /*data*/, qint64 /*maxSize*/) Q_DECL_OVERRIDE {
+        return -1;
+    }
+
+private:
+    AudioRingBuffer* buffer;
+};
+
+bool startAudioOutputDevice(AudioRingBuffer* buffer, int sampleRate) {
+    if (!GThread::qtGuiThreadExists()) {
+        return false;
+    }
+    bool started = false;
+    GThread::runOnQtGuiThread([buffer, sampleRate, &started]() {
+        QAudioFormat format;
+        format.setSampleRate(sampleRate);
+        format.setChannelCount(2);
+        format.setSampleSize(16);
+        format.setCodec("audio/pcm");
+        format.setByteOrder(QAudioFormat::LittleEndian);
+        format.setSampleType(QAudioFormat::SignedInt);
+        QAudioDeviceInfo info = QAudioDeviceInfo::defaultOutputDevice();
+        if (info.isNull() || !info.isFormatSupported(format)) {
+            return;
+        }
+
+        // never deleted; the output plays until the program exits
+        AudioRingBufferDevice* device = new AudioRingBufferDevice(buffer);
+        device->open(QIODevice::ReadOnly);
+        QAudioOutput* output = new QAudioOutput(info, format);
+        // about 50ms, which keeps the delay before a sound starts small
+        output->setBufferSize(sampleRate / 20 * 2 * (int) sizeof(int16_t));
+        output->start(device);
+        started = output->error() == QAudio::NoError;
+    });
+    return started;
+}
+
+#else // SPL_QT_MULTIMEDIA
+
+bool startAudioOutputDevice(AudioRingBuffer* /*buffer*/, int /*sampleRate*/) {
+    return false;   // no Qt multimedia module to play through
+}
+
+#endif // SPL_QT_MULTIMEDIA
+
+} // namespace stanfordcpplib
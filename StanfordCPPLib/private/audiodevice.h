@@ -0,0 +1,118 @@
+/*
+ * File: audiodevice.h
+ * -------------------
+ * This file defines the ring buffer through which the audio mixer in
+ * audio.cpp hands samples to the audio output device, and the function that
+ * starts the device.
+ * This is an internal part of the library and should not be used by clients.
+ *
+ * @version 2018/10/15
+ * - initial version
+ */
+
+#ifndef _audiodevice_h
+#define _audiodevice_h
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace stanfordcpplib {
+
+/*
+ * A fixed-size queue of samples with one thread writing and one other thread
+ * reading, that uses no locks, so that the reader can be the audio device's
+ * callback, which must never wait.
+ * The positions only ever increase; they are reduced mod the capacity (a
+ * power of 2) to index the buffer, and may wrap around 2^32 harmlessly.
+ */
+class AudioRingBuffer {
+public:
+    explicit AudioRingBuffer(int capacity)
+            : buffer((size_t) capacity),
+              mask((unsigned int) capacity - 1),
+              readPosition(0),
+              writePosition(0) {
+        // capacity must be a power of 2
+    }
+
+    int capacity() const {
+        return (int) buffer.size();
+    }
+
+    /*
+     * Copies up to count samples into dest, and returns how many were copied.
+     * Called only by the reading thread.
+     */
+    int read(int16_t* dest, int count) {
+        unsigned int start = readPosition.load(std::memory_order_relaxed);
+        unsigned int available = writePosition.load(std::memory_order_acquire) - start;
+        unsigned int n = std::min((unsigned int) count, available);
+        copyOut(dest, start, n);
+        readPosition.store(start + n, std::memory_order_release);
+        return (int) n;
+    }
+
+    /*
+     * Returns the number of samples that write could copy right now.
+     */
+    int space() const {
+        return (int) (buffer.size() - (writePosition.load(std::memory_order_relaxed)
+                                       - readPosition.load(std::memory_order_acquire)));
+    }
+
+    /*
+     * Copies up to count samples from src, and returns how many were copied.
+     * Called only by the writing thread.
+     */
+    int write(const int16_t* src, int count) {
+        unsigned int start = writePosition.load(std::memory_order_relaxed);
+        unsigned int used = start - readPosition.load(std::memory_order_acquire);
+        unsigned int available = (unsigned int) buffer.size() - used;
+        unsigned int n = std::min((unsigned int) count, available);
+        copyIn(src, start, n);
+        writePosition.store(start + n, std::memory_order_release);
+        return (int) n;
+    }
+
+private:
+    AudioRingBuffer(const AudioRingBuffer&) = delete;
+    AudioRingBuffer& operator =(const AudioRingBuffer&) = delete;
+
+    std::vector<int16_t> buffer;
+    unsigned int mask;
+    std::atomic<unsigned int> readPosition;
+    std::atomic<unsigned int> writePosition;
+
+    // copy n samples to or from the buffer starting at position, in two
+    // pieces if they wrap around the end of the buffer
+    void copyIn(const int16_t* src, unsigned int position, unsigned int n) {
+        unsigned int index = position & mask;
+        unsigned int first = std::min(n, (unsigned int) buffer.size() - index);
+        memcpy(&buffer[index], src, first * sizeof(int16_t));
+        memcpy(&buffer[0], src + first, (n - first) * sizeof(int16_t));
+    }
+
+    void copyOut(int16_t* dest, unsigned int position, unsigned int n) const {
+        unsigned int index = position & mask;
+        unsigned int first = std::min(n, (unsigned int) buffer.size() - index);
+        memcpy(dest, &buffer[index], first * sizeof(int16_t));
+        memcpy(dest + first, &buffer[0], (n - first) * sizeof(int16_t));
+    }
+};
+
+/*
+ * Starts playing interleaved 16-bit stereo samples at the given rate from
+ * the given ring buffer on the default audio output device, which reads
+ * from the buffer whenever it needs more samples and plays silence whenever
+ * the buffer is empty.  Returns false if there is no output device that supports
+ * that format, the Qt GUI thread is not running, or the library was built
+ * without the Qt multimedia module.
+ */
+bool startAudioOutputDevice(AudioRingBuffer* buffer, int sampleRate);
+
+} // namespace stanfordcpplib
+
+#endif // _audiodevice_h
@@ -5,6 +5,9 @@
  * represents a stream buffer that reads/writes to the Stanford graphical console
  * using a process pipe to a Java back-end process.
  *
+ * @version 2018/10/01
+ * - overflow passes each buffered chunk to the console in a single call
+ *   rather than splitting it into one call per line
  * @version 2016/10/04
  * - initial version
  */
@@ -54,18 +57,10 @@ public:
     }
 
     virtual int overflow(int ch, bool isStderr) {
-        std::string line = "";
-        for (char *cp = pbase(); cp < pptr(); cp++) {
-            if (*cp == '\n') {
-                myPutConsole(line, isStderr);
-                myEndLineConsole(isStderr);
-                line = "";
-            } else {
-                line += *cp;
-            }
-        }
-        if (line != "") {
-            myPutConsole(line, isStderr);
+        // hand the whole buffered chunk (embedded newlines and all) to the
+        // console at once; the console coalesces chunks before drawing them
+        if (pptr() > pbase()) {
+            myPutConsole(std::string(pbase(), pptr() - pbase()), isStderr);
         }
         setp(outBuffer, outBuffer + BUFFER_SIZE);
         if (ch != EOF) {
@@ -7,7 +7,9 @@
 // (see filelibwindows.cpp for Windows versions)
 #ifndef _WIN32
 #include <sys/types.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
+#include <fcntl.h>
 #include <sys/resource.h>
 #include <dirent.h>
 #include <errno.h>
@@ -170,6 +172,41 @@ std::string file_openFileDialog(const std::string& /*title*/,
     return "";
 }
 
+const char* filelib_mapFile(const std::string& filename, size_t& size, void*& handle) {
+    size = 0;
+    handle = nullptr;
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return nullptr;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0) {
+        ::close(fd);
+        return nullptr;
+    }
+    if ((uint64_t) st.st_size > SIZE_MAX) {
+        ::close(fd);
+        error("MappedFile: file is too large to fit in memory: " + filename);
+    }
+    void* addr = mmap(nullptr, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);   // the mapping stays valid after the descriptor is closed
+    if (addr == MAP_FAILED) {
+        return nullptr;
+    }
+#ifdef MADV_SEQUENTIAL
+    madvise(addr, (size_t) st.st_size, MADV_SEQUENTIAL);
+#endif
+    size = (size_t) st.st_size;
+    handle = addr;
+    return static_cast<const char*>(addr);
+}
+
+void filelib_unmapFile(const char* /*data*/, size_t size, void* handle) {
+    if (handle) {
+        munmap(handle, size);
+    }
+}
+
 void filelib_setCurrentDirectory(const std::string& path) {
     if (chdir(path.c_str()) != 0) {
         std::string msg = "setCurrentDirectory: ";
@@ -14,6 +14,7 @@
 #undef MOUSE_MOVED
 #undef HELP_KEY
 #include <cctype>
+#include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
@@ -132,6 +133,45 @@ void filelib_listDirectory(const std::string& path, std::vector<std::string> & l
     sort(list.begin(), list.end());
 }
 
+const char* filelib_mapFile(const std::string& filename, size_t& size, void*& handle) {
+    size = 0;
+    handle = nullptr;
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return nullptr;
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart <= 0) {
+        CloseHandle(file);
+        return nullptr;
+    }
+    if ((uint64_t) fileSize.QuadPart > SIZE_MAX) {
+        CloseHandle(file);
+        error("MappedFile: file is too large to fit in memory: " + filename);
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!mapping) {
+        return nullptr;
+    }
+    // the view keeps the mapping alive after its handle is closed
+    void* addr = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (!addr) {
+        return nullptr;
+    }
+    size = (size_t) fileSize.QuadPart;
+    handle = addr;
+    return static_cast<const char*>(addr);
+}
+
+void filelib_unmapFile(const char* /*data*/, size_t /*size*/, void* handle) {
+    if (handle) {
+        UnmapViewOfFile(handle);
+    }
+}
+
 std::string file_openFileDialog(const std::string& /*title*/,
                                 const std::string& /*mode*/,
                                 const std::string& /*path*/) {
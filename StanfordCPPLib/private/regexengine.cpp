@@ -0,0 +1,776 @@
+/*
+ * File: regexengine.cpp
+ * ---------------------
+ * This file implements the linear-time regular expression matcher declared
+ * in regexengine.h.
+ *
+ * A pattern is parsed into a tree of nodes and compiled into a program for
+ * a small virtual machine in the style of Thompson and Pike: each SPLIT
+ * instruction lists its preferred branch first, so following the branches
+ * in order visits paths in the same priority order as a backtracking
+ * matcher would try them.
+ *
+ * @version 2018/10/15
+ * - initial version
+ */
+
+#include "private/regexengine.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <utility>
+
+namespace stanfordcpplib {
+
+/*
+ * Limits that keep huge patterns and pathological DFAs from using up memory;
+ * patterns over them are left to std::regex.
+ */
+static const int MAX_PROGRAM_SIZE = 30000;
+static const int MAX_DFA_STATES = 512;
+static const int MAX_NESTING_DEPTH = 200;
+static const int MAX_REPEAT_COUNT = 1000;
+
+/*
+ * One piece of a parsed pattern.
+ */
+struct LinearRegex::Node {
+    enum Type {
+        EMPTY,
+        SET,            // one character from a set
+        CONCAT,         // children in sequence
+        ALTERNATE,      // one of the children, preferring earlier ones
+        REPEAT,         // children[0], min to max times (max -1 for no limit)
+        BEGIN,          // ^
+        END             // $
+    };
+
+    Type type;
+    int set;
+    int min;
+    int max;
+    bool greedy;
+    std::vector<Node> children;
+
+    explicit Node(Type type = EMPTY)
+            : type(type),
+              set(-1),
+              min(0),
+              max(0),
+              greedy(true) {
+        // empty
+    }
+
+    /*
+     * Returns true if this node can match without consuming any characters.
+     */
+    bool nullable() const {
+        switch (type) {
+        case SET:
+            return false;
+        case CONCAT:
+            for (const Node& child : children) {
+                if (!child.nullable()) {
+                    return false;
+                }
+            }
+            return true;
+        case ALTERNATE:
+            for (const Node& child : children) {
+                if (child.nullable()) {
+                    return true;
+                }
+            }
+            return false;
+        case REPEAT:
+            return min == 0 || children[0].nullable();
+        default:
+            return true;
+        }
+    }
+};
+
+/*
+ * A recursive-descent parser for the supported subset of ECMAScript regex
+ * syntax.  Each parse function returns false if the pattern uses anything
+ * outside of that subset.
+ */
+class LinearRegex::Parser {
+public:
+    Parser(const std::string& pattern, std::vector<std::bitset<256> >& sets)
+            : _pattern(pattern),
+              _pos(0),
+              _sets(sets) {
+        // empty
+    }
+
+    bool parse(Node& root) {
+        return parseAlternation(root, 0) && _pos == _pattern.length();
+    }
+
+private:
+    bool atEnd() const {
+        return _pos >= _pattern.length();
+    }
+
+    bool parseAlternation(Node& node, int depth) {
+        if (depth > MAX_NESTING_DEPTH) {
+            return false;
+        }
+        node = Node(Node::ALTERNATE);
+        while (true) {
+            Node branch;
+            if (!parseConcatenation(branch, depth)) {
+                return false;
+            }
+            node.children.push_back(std::move(branch));
+            if (atEnd() || _pattern[_pos] != '|') {
+                break;
+            }
+            _pos++;
+        }
+        if (node.children.size() == 1) {
+            Node only = std::move(node.children[0]);
+            node = std::move(only);
+        }
+        return true;
+    }
+
+    bool parseConcatenation(Node& node, int depth) {
+        node = Node(Node::CONCAT);
+        while (!atEnd() && _pattern[_pos] != '|' && _pattern[_pos] != ')') {
+            Node piece;
+            if (!parseRepeat(piece, depth)) {
+                return false;
+            }
+            node.children.push_back(std::move(piece));
+        }
+        return true;
+    }
+
+    bool parseRepeat(Node& node, int depth) {
+        if (!parseAtom(node, depth)) {
+            return false;
+        }
+        if (atEnd()) {
+            return true;
+        }
+        int min = 0;
+        int max = 0;
+        char ch = _pattern[_pos];
+        if (ch == '*') {
+            max = -1;
+            _pos++;
+        } else if (ch == '+') {
+            min = 1;
+            max = -1;
+            _pos++;
+        } else if (ch == '?') {
+            max = 1;
+            _pos++;
+        } else if (ch == '{') {
+            if (!parseBraces(min, max)) {
+                return false;
+            }
+        } else {
+            return true;
+        }
+        bool greedy = true;
+        if (!atEnd() && _pattern[_pos] == '?') {
+            greedy = false;
+            _pos++;
+        }
+        if (!atEnd() && strchr("*+?{", _pattern[_pos])) {
+            return false;   // a quantifier of a quantifier
+        }
+        if (node.type == Node::BEGIN || node.type == Node::END
+                || (max != 1 && node.nullable())) {
+            return false;
+        }
+        Node repeat(Node::REPEAT);
+        repeat.min = min;
+        repeat.max = max;
+        repeat.greedy = greedy;
+        repeat.children.push_back(std::move(node));
+        node = std::move(repeat);
+        return true;
+    }
+
+    bool parseBraces(int& min, int& max) {
+        size_t p = _pos + 1;
+        if (!readNumber(p, min)) {
+            return false;
+        }
+        max = min;
+        if (p < _pattern.length() && _pattern[p] == ',') {
+            p++;
+            if (p < _pattern.length() && _pattern[p] == '}') {
+                max = -1;
+            } else if (!readNumber(p, max)) {
+                return false;
+            }
+        }
+        if (p >= _pattern.length() || _pattern[p] != '}' || (max >= 0 && max < min)) {
+            return false;
+        }
+        _pos = p + 1;
+        return true;
+    }
+
+    bool readNumber(size_t& p, int& value) {
+        size_t start = p;
+        value = 0;
+        while (p < _pattern.length() && isdigit(_pattern[p])) {
+            value = value * 10 + (_pattern[p] - '0');
+            if (value > MAX_REPEAT_COUNT) {
+                return false;
+            }
+            p++;
+        }
+        return p > start;
+    }
+
+    bool parseAtom(Node& node, int depth) {
+        char ch = _pattern[_pos];
+        std::bitset<256> set;
+        if (ch == '(') {
+            _pos++;
+            if (!atEnd() && _pattern[_pos] == '?') {
+                if (_pos + 1 >= _pattern.length() || _pattern[_pos + 1] != ':') {
+                    return false;   // lookahead
+                }
+                _pos += 2;
+            }
+            if (!parseAlternation(node, depth + 1) || atEnd() || _pattern[_pos] != ')') {
+                return false;
+            }
+            _pos++;
+            return true;
+        } else if (ch == '^' || ch == '$') {
+            node = Node(ch == '^' ? Node::BEGIN : Node::END);
+            _pos++;
+            return true;
+        } else if (ch == '[') {
+            if (!parseClass(set)) {
+                return false;
+            }
+        } else if (ch == '.') {
+            set.set();
+            set.reset('\n');
+            set.reset('\r');
+            _pos++;
+        } else if (ch == '\\') {
+            _pos++;
+            int single;
+            if (!parseEscape(set, /* inClass */ false, single)) {
+                return false;
+            }
+        } else if (strchr("*+?{}]", ch)) {
+            return false;
+        } else {
+            set.set((unsigned char) ch);
+            _pos++;
+        }
+        node = Node(Node::SET);
+        node.set = (int) _sets.size();
+        _sets.push_back(set);
+        return true;
+    }
+
+    /*
+     * Parses the escape after a backslash into the given set.  Sets single
+     * to the escaped character, or to -1 for a class such as \d.
+     */
+    bool parseEscape(std::bitset<256>& set, bool inClass, int& single) {
+        if (atEnd()) {
+            return false;
+        }
+        char ch = _pattern[_pos++];
+        single = -1;
+        switch (ch) {
+        case 'd':
+        case 'D':
+        case 'w':
+        case 'W':
+        case 's':
+        case 'S': {
+            std::bitset<256> members;
+            for (int c = 0; c < 256; c++) {
+                if (tolower(ch) == 'd') {
+                    members[c] = isdigit(c) != 0;
+                } else if (tolower(ch) == 'w') {
+                    members[c] = isalnum(c) || c == '_';
+                } else {
+                    members[c] = isspace(c) != 0;
+                }
+            }
+            if (isupper(ch)) {
+                members.flip();
+            }
+            set |= members;
+            return true;
+        }
+        case 'n': single = '\n'; break;
+        case 'r': single = '\r'; break;
+        case 't': single = '\t'; break;
+        case 'f': single = '\f'; break;
+        case 'v': single = '\v'; break;
+        case '0':
+            if (!atEnd() && isdigit(_pattern[_pos])) {
+                return false;
+            }
+            single = 0;
+            break;
+        case 'b':
+            if (!inClass) {
+                return false;   // word boundary
+            }
+            single = '\b';
+            break;
+        case 'x':
+        case 'u':
+            if (!readHex(ch == 'x' ? 2 : 4, single) || single > 255) {
+                return false;
+            }
+            break;
+        default:
+            if (isalnum(ch)) {
+                // backreference, \B, or \cX, which libstdc++ reads as a plain X
+                return false;
+            }
+            single = (unsigned char) ch;
+            break;
+        }
+        set.set(single);
+        return true;
+    }
+
+    bool readHex(int digits, int& value) {
+        value = 0;
+        for (int i = 0; i < digits; i++) {
+            if (atEnd() || !isxdigit(_pattern[_pos])) {
+                return false;
+            }
+            char ch = (char) tolower(_pattern[_pos++]);
+            value = value * 16 + (isdigit(ch) ? ch - '0' : ch - 'a' + 10);
+        }
+        return true;
+    }
+
+    bool parseClass(std::bitset<256>& set) {
+        _pos++;   // [
+        bool negate = false;
+        if (!atEnd() && _pattern[_pos] == '^') {
+            negate = true;
+            _pos++;
+        }
+        bool first = true;
+        while (true) {
+            if (atEnd()) {
+                return false;
+            }
+            char ch = _pattern[_pos];
+            if (ch == ']') {
+                if (first) {
+                    return false;   // [] and []...] differ between dialects
+                }
+                _pos++;
+                break;
+            }
+            if (ch == '[' && _pos + 1 < _pattern.length() && strchr(":=.", _pattern[_pos + 1])) {
+                return false;   // [:alpha:] and friends
+            }
+            int low;
+            if (!parseClassAtom(set, low)) {
+                return false;
+            }
+            first = false;
+            if (_pos + 1 < _pattern.length() && _pattern[_pos] == '-' && _pattern[_pos + 1] != ']') {
+                _pos++;
+                std::bitset<256> unused;
+                int high;
+                if (!parseClassAtom(unused, high)
+                        || low < 0 || high < 0 || high < low || high >= 128) {
+                    return false;
+                }
+                for (int c = low; c <= high; c++) {
+                    set.set(c);
+                }
+            } else if (low >= 0) {
+                set.set(low);
+            }
+        }
+        if (negate) {
+            set.flip();
+        }
+        return true;
+    }
+
+    /*
+     * Parses one character or class escape inside [...].  A class escape is
+     * added to the set right away; a single character is returned in single
+     * (otherwise -1), since it may be the start of a range.
+     */
+    bool parseClassAtom(std::bitset<256>& set, int& single) {
+        if (_pattern[_pos] == '\\') {
+            _pos++;
+            std::bitset<256> escaped;
+            if (!parseEscape(escaped, /* inClass */ true, single)) {
+                return false;
+            }
+            if (single < 0) {
+                set |= escaped;
+            }
+        } else {
+            single = (unsigned char) _pattern[_pos++];
+        }
+        return true;
+    }
+
+    const std::string& _pattern;
+    size_t _pos;
+    std::vector<std::bitset<256> >& _sets;
+};
+
+LinearRegex::LinearRegex(const std::string& pattern)
+        : _supported(false),
+          _canSkip(false),
+          _dfaClosure(0),
+          _dfaStart(-1) {
+    Node root;
+    if (!Parser(pattern, _sets).parse(root) || !compile(root)) {
+        _program.clear();
+        _sets.clear();
+        return;
+    }
+    addInstruction(MATCH);
+    _dfaClosure = Closure((int) _program.size());
+
+    // see which characters a match that starts past the beginning of the
+    // text can begin with, so the Pike VM can skip over the rest
+    std::vector<int> pcs;
+    _dfaClosure.generation++;
+    follow(0, /* atStart */ false, /* atEnd */ false, /* keepEnd */ true, _dfaClosure, pcs);
+    _canSkip = true;
+    for (int pc : pcs) {
+        if (_program[pc].op == CHAR_SET) {
+            _firstChars |= _sets[_program[pc].arg];
+        } else {
+            _canSkip = false;   // could match without reading a character
+        }
+    }
+
+    pcs.clear();
+    _dfaClosure.generation++;
+    follow(0, /* atStart */ true, /* atEnd */ false, /* keepEnd */ true, _dfaClosure, pcs);
+    _dfaStart = addDfaState(pcs, _dfaClosure);
+    _supported = true;
+}
+
+bool LinearRegex::isSupported() const {
+    return _supported;
+}
+
+bool LinearRegex::compile(const Node& node) {
+    if ((int) _program.size() > MAX_PROGRAM_SIZE) {
+        return false;
+    }
+    switch (node.type) {
+    case Node::EMPTY:
+        return true;
+    case Node::SET:
+        addInstruction(CHAR_SET, 0, 0, node.set);
+        return true;
+    case Node::BEGIN:
+        addInstruction(ASSERT_BEGIN);
+        return true;
+    case Node::END:
+        addInstruction(ASSERT_END);
+        return true;
+    case Node::CONCAT:
+        for (const Node& child : node.children) {
+            if (!compile(child)) {
+                return false;
+            }
+        }
+        return true;
+    case Node::ALTERNATE: {
+        std::vector<int> jumps;
+        for (size_t i = 0; i + 1 < node.children.size(); i++) {
+            int split = addInstruction(SPLIT);
+            _program[split].x = split + 1;
+            if (!compile(node.children[i])) {
+                return false;
+            }
+            jumps.push_back(addInstruction(JUMP));
+            _program[split].y = (int) _program.size();
+        }
+        if (!compile(node.children.back())) {
+            return false;
+        }
+        for (int jump : jumps) {
+            _program[jump].x = (int) _program.size();
+        }
+        return true;
+    }
+    case Node::REPEAT: {
+        const Node& child = node.children[0];
+        for (int i = 0; i < node.min; i++) {
+            if (!compile(child)) {
+                return false;
+            }
+        }
+        // each optional copy is entered through a SPLIT whose other branch
+        // skips to the end, so x{0,2} is laid out as (x(x)?)?
+        std::vector<int> splits;
+        int optionalCount = node.max < 0 ? 1 : node.max - node.min;
+        for (int i = 0; i < optionalCount; i++) {
+            splits.push_back(addInstruction(SPLIT));
+            if (!compile(child)) {
+                return false;
+            }
+        }
+        if (node.max < 0 && !splits.empty()) {
+            addInstruction(JUMP, splits[0]);
+        }
+        int end = (int) _program.size();
+        for (int split : splits) {
+            _program[split].x = node.greedy ? split + 1 : end;
+            _program[split].y = node.greedy ? end : split + 1;
+        }
+        return (int) _program.size() <= MAX_PROGRAM_SIZE;
+    }
+    }
+    return false;
+}
+
+int LinearRegex::addInstruction(Opcode op, int x, int y, int arg) {
+    Instruction instruction;
+    instruction.op = op;
+    instruction.x = x;
+    instruction.y = y;
+    instruction.arg = arg;
+    _program.push_back(instruction);
+    return (int) _program.size() - 1;
+}
+
+/*
+ * Appends to out, in priority order, the instructions that can consume a
+ * character or end a match that are reachable from pc without consuming
+ * anything, skipping any already marked in the closure's current generation.
+ * ^ and $ are followed only where atStart or atEnd say they hold; if keepEnd
+ * is true, $ instructions are appended instead, to be decided later.
+ */
+void LinearRegex::follow(int pc, bool atStart, bool atEnd, bool keepEnd,
+                         Closure& closure, std::vector<int>& out) const {
+    std::vector<int>& stack = closure.stack;
+    stack.clear();
+    stack.push_back(pc);
+    while (!stack.empty()) {
+        pc = stack.back();
+        stack.pop_back();
+        if (closure.marks[pc] == closure.generation) {
+            continue;
+        }
+        closure.marks[pc] = closure.generation;
+        const Instruction& instruction = _program[pc];
+        switch (instruction.op) {
+        case JUMP:
+            stack.push_back(instruction.x);
+            break;
+        case SPLIT:
+            stack.push_back(instruction.y);   // x is on top, so it goes first
+            stack.push_back(instruction.x);
+            break;
+        case ASSERT_BEGIN:
+            if (atStart) {
+                stack.push_back(pc + 1);
+            }
+            break;
+        case ASSERT_END:
+            if (keepEnd) {
+                out.push_back(pc);
+            } else if (atEnd) {
+                stack.push_back(pc + 1);
+            }
+            break;
+        default:
+            out.push_back(pc);
+            break;
+        }
+    }
+}
+
+int LinearRegex::addDfaState(std::vector<int>& pcs, Closure& closure) const {
+    std::sort(pcs.begin(), pcs.end());
+    auto it = _dfaStateIds.find(pcs);
+    if (it != _dfaStateIds.end()) {
+        return it->second;
+    }
+    if ((int) _dfaStates.size() >= MAX_DFA_STATES) {
+        return -1;
+    }
+
+    DfaState state;
+    state.match = false;
+    state.matchAtEnd = false;
+    std::vector<int> atEnd;
+    closure.generation++;
+    for (int pc : pcs) {
+        if (_program[pc].op == MATCH) {
+            state.match = true;
+        } else if (_program[pc].op == ASSERT_END) {
+            follow(pc + 1, /* atStart */ false, /* atEnd */ true, /* keepEnd */ false, closure, atEnd);
+        }
+    }
+    state.matchAtEnd = state.match;
+    for (int pc : atEnd) {
+        state.matchAtEnd = state.matchAtEnd || _program[pc].op == MATCH;
+    }
+    std::fill(state.next, state.next + 256, -1);
+    state.pcs = pcs;
+    _dfaStates.push_back(state);
+    _dfaStateIds[pcs] = (int) _dfaStates.size() - 1;
+    return (int) _dfaStates.size() - 1;
+}
+
+int LinearRegex::dfaNext(int state, unsigned char ch, Closure& closure) const {
+    std::vector<int> pcs;
+    closure.generation++;
+    for (int pc : _dfaStates[state].pcs) {
+        const Instruction& instruction = _program[pc];
+        if (instruction.op == CHAR_SET && _sets[instruction.arg][ch]) {
+            follow(pc + 1, /* atStart */ false, /* atEnd */ false, /* keepEnd */ true, closure, pcs);
+        }
+    }
+    // a new match may also start after this character
+    follow(0, /* atStart */ false, /* atEnd */ false, /* keepEnd */ true, closure, pcs);
+    int next = addDfaState(pcs, closure);
+    if (next >= 0) {
+        _dfaStates[state].next[ch] = next;
+    }
+    return next;
+}
+
+bool LinearRegex::search(const std::string& s) const {
+    if (!s.empty()) {
+        std::unique_lock<std::mutex> lock(_dfaMutex, std::try_to_lock);
+        if (lock.owns_lock()) {
+            int state = _dfaStart;
+            for (size_t i = 0; i < s.length() && state >= 0; i++) {
+                if (_dfaStates[state].match) {
+                    return true;
+                }
+                unsigned char ch = (unsigned char) s[i];
+                int next = _dfaStates[state].next[ch];
+                state = next >= 0 ? next : dfaNext(state, ch, _dfaClosure);
+            }
+            if (state >= 0) {
+                return _dfaStates[state].matchAtEnd;
+            }
+            // too many DFA states; fall through to the Pike VM
+        }
+    }
+    PikeScratch scratch((int) _program.size());
+    int matchStart;
+    int matchEnd;
+    return find(s, 0, /* continuousNotNull */ false, scratch, matchStart, matchEnd);
+}
+
+/*
+ * Adds threads with the given start for everything reachable from pc.
+ */
+void LinearRegex::addThreads(std::vector<Thread>& threads, int pc, int start, int pos,
+                             int length, PikeScratch& scratch) const {
+    scratch.pcs.clear();
+    follow(pc, pos == 0, pos == length, /* keepEnd */ false, scratch.closure, scratch.pcs);
+    for (int next : scratch.pcs) {
+        threads.push_back(Thread{next, start});
+    }
+}
+
+/*
+ * Runs the Pike VM to find the first match at or after index from, the
+ * same one that std::regex_search would find.  If continuousNotNull is
+ * true, the match must start at from and must not be empty.
+ */
+bool LinearRegex::find(const std::string& s, int from, bool continuousNotNull,
+                       PikeScratch& scratch, int& matchStart, int& matchEnd) const {
+    int length = (int) s.length();
+    std::vector<Thread>& current = scratch.current;
+    std::vector<Thread>& next = scratch.next;
+    current.clear();
+    bool matched = false;
+    scratch.closure.generation++;
+    for (int pos = from; ; pos++) {
+        if (!matched && (!continuousNotNull || pos == from)) {
+            if (current.empty() && _canSkip && pos > 0 && !continuousNotNull) {
+                // nothing in progress; skip to where a match could start
+                while (pos < length && !_firstChars[(unsigned char) s[pos]]) {
+                    pos++;
+                }
+            }
+            addThreads(current, 0, pos, pos, length, scratch);
+        }
+        if (current.empty()) {
+            if (matched || continuousNotNull || pos >= length) {
+                break;
+            }
+            scratch.closure.generation++;
+            continue;
+        }
+
+        scratch.closure.generation++;
+        next.clear();
+        for (const Thread& thread : current) {
+            const Instruction& instruction = _program[thread.pc];
+            if (instruction.op == CHAR_SET) {
+                if (pos < length && _sets[instruction.arg][(unsigned char) s[pos]]) {
+                    addThreads(next, thread.pc + 1, thread.start, pos + 1, length, scratch);
+                }
+            } else if (!continuousNotNull || thread.start != pos) {
+                // MATCH; threads after this one have lower priority, so
+                // they are dropped, while those before it carry on
+                matched = true;
+                matchStart = thread.start;
+                matchEnd = pos;
+                break;
+            }
+        }
+        std::swap(current, next);
+        if (pos >= length) {
+            break;
+        }
+    }
+    return matched;
+}
+
+void LinearRegex::findAll(const std::string& s, std::vector<int>& matchStarts) const {
+    if (!search(s)) {
+        return;
+    }
+    PikeScratch scratch((int) _program.size());
+    int length = (int) s.length();
+    int matchStart;
+    int matchEnd;
+    bool found = find(s, 0, /* continuousNotNull */ false, scratch, matchStart, matchEnd);
+    while (found) {
+        matchStarts.push_back(matchStart);
+        int pos = matchEnd;
+        if (matchStart == matchEnd) {
+            // after an empty match, look for a non-empty one at the same
+            // place before moving on, as std::sregex_iterator does
+            if (pos == length) {
+                break;
+            }
+            found = find(s, pos, /* continuousNotNull */ true, scratch, matchStart, matchEnd);
+            if (found) {
+                continue;
+            }
+            pos++;
+        }
+        found = find(s, pos, /* continuousNotNull */ false, scratch, matchStart, matchEnd);
+    }
+}
+
+} // namespace stanfordcpplib
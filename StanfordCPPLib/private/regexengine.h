@@ -0,0 +1,161 @@
+/*
+ * File: regexengine.h
+ * -------------------
+ * This file defines a regular expression matcher that runs in time linear
+ * in the length of the text being searched, used by regexpr.cpp for the
+ * patterns it supports in place of std::regex, whose backtracking can take
+ * exponential time and is slow even on simple patterns.
+ * This is an internal part of the library and should not be used by clients.
+ *
+ * @version 2018/10/15
+ * - initial version
+ */
+
+#ifndef _regexengine_h
+#define _regexengine_h
+
+#include <bitset>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace stanfordcpplib {
+
+/*
+ * A compiled ECMAScript regular expression that is matched by simulating
+ * its automaton over the text rather than by backtracking.
+ * Searches that only ask whether there is a match run on a DFA that is
+ * built lazily, one state at a time, as the text needs it; searches that
+ * need to know where each match is run a Pike VM, which follows every
+ * possible path through the pattern at once, in priority order, so that it
+ * finds the same matches as std::regex's backtracking does.
+ *
+ * Supported: literals, ., [...] classes, \d \w \s and their negations,
+ * character escapes, groups (capturing or (?:...)), |, the greedy and lazy
+ * quantifiers * + ? {n} {n,} {n,m}, and the anchors ^ and $.
+ * Not supported: backreferences, lookahead, \b and \B, \cX, POSIX [[:classes:]],
+ * characters above \xff, and repeating a group that can match the empty
+ * string.  isSupported returns false for patterns using any of these, which
+ * callers should then match with std::regex instead.
+ *
+ * A LinearRegex may be used by several threads at once.
+ */
+class LinearRegex {
+public:
+    /*
+     * Compiles the given pattern.  Call isSupported to see if this worked.
+     * The pattern should already be known to be valid std::regex syntax.
+     */
+    explicit LinearRegex(const std::string& pattern);
+
+    /*
+     * Returns true if the pattern could be compiled.
+     */
+    bool isSupported() const;
+
+    /*
+     * Returns true if the pattern matches somewhere in the given text,
+     * as std::regex_search would.
+     */
+    bool search(const std::string& s) const;
+
+    /*
+     * Appends to matchStarts the index in the given text at which each match
+     * begins, finding the same matches as iterating a std::sregex_iterator.
+     */
+    void findAll(const std::string& s, std::vector<int>& matchStarts) const;
+
+private:
+    enum Opcode {
+        CHAR_SET,       // consumes one character in sets[arg]
+        SPLIT,          // goes to x, or failing that to y
+        JUMP,           // goes to x
+        ASSERT_BEGIN,   // continues only at the start of the text
+        ASSERT_END,     // continues only at the end of the text
+        MATCH
+    };
+
+    struct Instruction {
+        Opcode op;
+        int x;
+        int y;
+        int arg;
+    };
+
+    struct Node;
+    class Parser;
+
+    /*
+     * A thread of the Pike VM: where it is in the program, and where in
+     * the text its match began.
+     */
+    struct Thread {
+        int pc;
+        int start;
+    };
+
+    /*
+     * A DFA state: the set of instructions that the threads that have
+     * survived so far are waiting at, with its transitions filled in as
+     * they are first needed (-1 until then).
+     */
+    struct DfaState {
+        std::vector<int> pcs;
+        bool match;         // a match has ended here
+        bool matchAtEnd;    // a match ends here if this is the end of the text
+        int next[256];
+    };
+
+    /*
+     * Scratch space for following the empty transitions from an instruction.
+     */
+    struct Closure {
+        std::vector<int> marks;
+        int generation;
+        std::vector<int> stack;
+
+        explicit Closure(int size) : marks((size_t) size, 0), generation(0) {}
+    };
+
+    /*
+     * Scratch space for one run of the Pike VM.
+     */
+    struct PikeScratch {
+        Closure closure;
+        std::vector<Thread> current;
+        std::vector<Thread> next;
+        std::vector<int> pcs;
+
+        explicit PikeScratch(int size) : closure(size) {}
+    };
+
+    bool compile(const Node& node);
+    int addInstruction(Opcode op, int x = 0, int y = 0, int arg = 0);
+    void follow(int pc, bool atStart, bool atEnd, bool keepEnd, Closure& closure,
+                std::vector<int>& out) const;
+    int addDfaState(std::vector<int>& pcs, Closure& closure) const;
+    int dfaNext(int state, unsigned char ch, Closure& closure) const;
+    void addThreads(std::vector<Thread>& threads, int pc, int start, int pos,
+                    int length, PikeScratch& scratch) const;
+    bool find(const std::string& s, int from, bool continuousNotNull,
+              PikeScratch& scratch, int& matchStart, int& matchEnd) const;
+
+    std::vector<Instruction> _program;
+    std::vector<std::bitset<256> > _sets;
+    bool _supported;
+    bool _canSkip;                  // a match must start with a char in _firstChars
+    std::bitset<256> _firstChars;
+
+    // the lazily built DFA, shared by all threads; a thread that finds it in
+    // use by another runs the Pike VM instead of waiting
+    mutable std::mutex _dfaMutex;
+    mutable Closure _dfaClosure;
+    mutable std::vector<DfaState> _dfaStates;
+    mutable std::map<std::vector<int>, int> _dfaStateIds;
+    mutable int _dfaStart;
+};
+
+} // namespace stanfordcpplib
+
+#endif // _regexengine_h
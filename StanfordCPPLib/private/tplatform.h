@@ -14,13 +14,4 @@ void joinForPlatform(int id);
 int getCurrentThreadForPlatform();
 void yieldForPlatform();
 
-/* Functions for locks */
-
-int initLockForPlatform();
-void incLockRefCountForPlatform(int id);
-void decLockRefCountForPlatform(int id);
-void lockForPlatform(int id);
-void unlockForPlatform(int id);
-void waitForPlatform(int id);
-void signalForPlatform(int id);
-
+/* Locks are implemented directly by the Lock class in thread.cpp. */
@@ -22,7 +22,9 @@
 /* along with this program.  If not, see <http://www.gnu.org/licenses/>. */
 /*************************************************************************/
 
+#include <condition_variable>
 #include <iostream>
+#include <mutex>
 #include <string>
 #include <pthread.h>
 #include "error.h"
@@ -35,6 +37,10 @@ extern int sched_yield(void);
 #define pthread_yield sched_yield
 #endif
 
+/*
+ * Locks no longer live here; each Lock object holds its own mutex and
+ * condition variable (see thread.cpp).
+ */
 struct ThreadData {
     int id;
     pthread_t pid;
@@ -42,27 +48,19 @@ struct ThreadData {
     void (* fn)(void* arg);
     void* arg;
     int refCount;
-};
-
-struct LockData {
-    pthread_mutex_t mutex;
-    pthread_cond_t condition;
-    int depth;
-    int owner;
-    int refCount;
+    std::mutex mutex;                  // guards terminated
+    std::condition_variable finished;  // signaled when terminated is set
 };
 
 /* Constants */
 
 #define MAX_THREAD_ID int(unsigned(-1) >> 1)
-#define MAX_LOCK_ID    int(unsigned(-1) >> 1)
 
 /* Private function prototypes */
 
 static Map<int, ThreadData*>& getThreadDataMap();
-static Map<int, LockData*>& getLockDataMap();
+static std::mutex& getThreadDataMapMutex();
 static int getNextFreeThread();
-static int getNextFreeLock();
 static pthread_key_t& getThreadDataKey();
 static pthread_key_t* createThreadDataKey();
 static void* startThread(void* arg);
@@ -70,13 +68,18 @@ static void* startThread(void* arg);
 /* Functions */
 
 int forkForPlatform(void (* fn)(void*), void* arg) {
-    int id = getNextFreeThread();
     ThreadData* tdp = new ThreadData;
     tdp->terminated = false;
     tdp->refCount = 1;
     tdp->fn = fn;
     tdp->arg = arg;
-    getThreadDataMap().put(id, tdp);
+    {
+        // threads may be forked from several threads at once
+        std::lock_guard<std::mutex> guard(getThreadDataMapMutex());
+        tdp->id = getNextFreeThread();
+        getThreadDataMap().put(tdp->id, tdp);
+    }
+    int id = tdp->id;   // tdp may be gone once the thread is started
     pthread_attr_t attr;
     pthread_attr_init(&attr);
     pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
@@ -97,7 +100,18 @@ void decThreadRefCountForPlatform(int /*id*/) {
 }
 
 void joinForPlatform(int id) {
-    pthread_join(getThreadDataMap().get(id)->pid, nullptr);
+    // the thread is detached, so wait for startThread to say it is done
+    // rather than calling pthread_join
+    ThreadData* tdp = nullptr;
+    {
+        std::lock_guard<std::mutex> guard(getThreadDataMapMutex());
+        tdp = getThreadDataMap().get(id);
+    }
+    if (!tdp) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(tdp->mutex);
+    tdp->finished.wait(lock, [tdp]() { return tdp->terminated; });
 }
 
 int getCurrentThreadForPlatform() {
@@ -114,55 +128,6 @@ void yieldForPlatform() {
     pthread_yield();
 }
 
-int initLockForPlatform() {
-    int id = getNextFreeLock();
-    LockData* ldp = new LockData;
-    pthread_mutexattr_t attr;
-    pthread_mutexattr_init(&attr);
-    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
-    pthread_mutex_init(&ldp->mutex, &attr);
-    pthread_mutexattr_destroy(&attr);
-    pthread_cond_init(&ldp->condition, nullptr);
-    ldp->owner = -1;
-    ldp->depth = 0;
-    getLockDataMap().put(id, ldp);
-    return id;
-}
-
-void incLockRefCountForPlatform(int /*id*/) {
-    // Fill in
-}
-
-void decLockRefCountForPlatform(int /*id*/) {
-    // Fill in
-}
-
-void lockForPlatform(int id) {
-    LockData* ldp = getLockDataMap().get(id);
-    pthread_mutex_lock(&ldp->mutex);
-    if (ldp->depth++ == 0) {
-        ldp->owner = getCurrentThreadForPlatform();
-    }
-}
-
-void unlockForPlatform(int id) {
-    LockData* ldp = getLockDataMap().get(id);
-    if (--ldp->depth == 0) {
-        ldp->owner = -1;
-    }
-    pthread_mutex_unlock(&ldp->mutex);
-}
-
-void waitForPlatform(int id) {
-    LockData* ldp = getLockDataMap().get(id);
-    pthread_cond_wait(&ldp->condition, &ldp->mutex);
-}
-
-void signalForPlatform(int id) {
-    LockData* ldp = getLockDataMap().get(id);
-    pthread_cond_broadcast(&ldp->condition);
-}
-
 /* Static functions */
 
 static Map<int, ThreadData*>& getThreadDataMap() {
@@ -170,11 +135,14 @@ static Map<int, ThreadData*>& getThreadDataMap() {
     return *mp;
 }
 
-static Map<int, LockData*>& getLockDataMap() {
-    static Map<int,LockData*>* mp = new Map<int, LockData*>();
+static std::mutex& getThreadDataMapMutex() {
+    static std::mutex* mp = new std::mutex();
     return *mp;
 }
 
+/*
+ * Must be called with the thread data map mutex held.
+ */
 static int getNextFreeThread() {
     static int nextThread = 1;
     Map<int, ThreadData*>& map = getThreadDataMap();
@@ -187,18 +155,6 @@ static int getNextFreeThread() {
     return nextThread++;
 }
 
-static int getNextFreeLock() {
-    static int nextLock = 1;
-    Map<int, LockData*>& map = getLockDataMap();
-    while (map.containsKey(nextLock)) {
-        nextLock++;
-        if (nextLock == MAX_LOCK_ID) {
-            nextLock = 1;
-        }
-    }
-    return nextLock++;
-}
-
 static pthread_key_t& getThreadDataKey() {
     static pthread_key_t* pkp = createThreadDataKey();
     return *pkp;
@@ -219,5 +175,10 @@ static void* startThread(void* arg) {
         std::cerr << "Error: " << e.getMessage() << std::endl;
         std::exit(1);
     }
+    {
+        std::lock_guard<std::mutex> guard(tdp->mutex);
+        tdp->terminated = true;
+    }
+    tdp->finished.notify_all();
     return nullptr;
 }
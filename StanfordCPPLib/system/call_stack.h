@@ -3,6 +3,8 @@
  * License: BSD licence (http://www.opensource.org/licenses/bsd-license.php)
  *
  * @author Marty Stepp (made changes to F.Orderud version)
+ * @version 2018/10/15
+ * - added symbolize, which looks up line numbers without running addr2line
  * @version 2016/12/01
  * - bug fixes for call stack line number retrieval
  * - slight refactor of entry class
@@ -24,6 +26,33 @@ int addr2line_all(std::vector<void*> addrsVector, std::string& output);
 int addr2line_all(void** addrs, int length, std::string& output);
 std::string addr2line_clean(std::string line);
 
+/*
+ * Information about the code at an address, as found by symbolize.
+ */
+struct symbol_info {
+    symbol_info() : line(0), hasLineTable(false), isMainProgram(false) {
+        // empty
+    }
+
+    std::string function;   // demangled name of the function, or "" if unknown
+    std::string file;       // source file name without directories, or ""
+    int line;               // source line number, or 0 if unknown
+    bool hasLineTable;      // true if the binary's line numbers could be read
+    bool isMainProgram;     // true if in the executable rather than a library
+};
+
+/*
+ * Looks up the function, source file, and line number of the code at the
+ * given address by reading the symbol table and DWARF line table of the
+ * executable or shared library that contains it, in this process rather than
+ * by running addr2line.  Each binary is read once, when first needed, and
+ * each address's result is cached; it is safe to call from multiple threads.
+ * Returns true if the file and line were found; the function may be found
+ * even if they were not.
+ * Implemented on Linux; on other platforms, always returns false.
+ */
+bool symbolize(void* addr, symbol_info& info);
+
 /*
  * Function to get/set a fake call stack pointer for use in printing a stack trace.
  * Called on Windows only after a signal / SEH handler is invoked to get a stack pointer.
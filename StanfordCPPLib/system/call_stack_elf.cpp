@@ -0,0 +1,733 @@
+/*
+ * File: call_stack_elf.cpp
+ * ------------------------
+ * Linux implementation of stacktrace::symbolize, which finds the function,
+ * source file, and line number of a code address by reading the ELF symbol
+ * table and DWARF line number table (.debug_line) of the executable or
+ * shared library that contains it, rather than by running addr2line.
+ *
+ * Each binary is memory-mapped and its tables parsed only once, the first
+ * time an address in it is looked up; after that a lookup is two binary
+ * searches, and its result is cached by address.
+ *
+ * @author Marty Stepp
+ * @version 2018/10/15
+ * - initial version
+ * @since 2018/10/15
+ */
+
+#include "call_stack.h"
+
+#if defined(__GNUC__) && !defined(_WIN32) && !defined(__APPLE__)
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+#include <cxxabi.h>
+#include <elf.h>
+#include <fcntl.h>
+#include <link.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "private/static.h"
+
+namespace stacktrace {
+
+namespace {
+
+// DWARF constants used below (from the DWARF 5 standard, section 7)
+enum {
+    DW_LNS_copy               = 0x01,
+    DW_LNS_advance_pc         = 0x02,
+    DW_LNS_advance_line       = 0x03,
+    DW_LNS_set_file           = 0x04,
+    DW_LNS_const_add_pc       = 0x08,
+    DW_LNS_fixed_advance_pc   = 0x09,
+    DW_LNE_end_sequence       = 0x01,
+    DW_LNE_set_address        = 0x02,
+    DW_LNE_define_file        = 0x03,
+    DW_LNCT_path              = 0x01,
+    DW_FORM_block2            = 0x03,
+    DW_FORM_block4            = 0x04,
+    DW_FORM_data2             = 0x05,
+    DW_FORM_data4             = 0x06,
+    DW_FORM_data8             = 0x07,
+    DW_FORM_string            = 0x08,
+    DW_FORM_block             = 0x09,
+    DW_FORM_block1            = 0x0a,
+    DW_FORM_data1             = 0x0b,
+    DW_FORM_sdata             = 0x0d,
+    DW_FORM_strp              = 0x0e,
+    DW_FORM_udata             = 0x0f,
+    DW_FORM_strx              = 0x1a,
+    DW_FORM_data16            = 0x1e,
+    DW_FORM_line_strp         = 0x1f,
+    DW_FORM_strx1             = 0x25,
+    DW_FORM_strx2             = 0x26,
+    DW_FORM_strx3             = 0x27,
+    DW_FORM_strx4             = 0x28
+};
+
+/*
+ * Reads little-endian DWARF data from a range of memory.
+ * Reading past the end returns 0 and sets 'bad' rather than crashing,
+ * so that a corrupt file can't take the program down with it.
+ */
+class DwarfReader {
+public:
+    DwarfReader(const unsigned char* start, const unsigned char* end)
+            : pos(start),
+              end(end),
+              bad(false) {
+        // empty
+    }
+
+    bool atEnd() const {
+        return bad || pos >= end;
+    }
+
+    void seek(const unsigned char* newPos) {
+        if (newPos < pos || newPos > end) {
+            bad = true;
+            pos = end;
+        } else {
+            pos = newPos;
+        }
+    }
+
+    void skip(uint64_t bytes) {
+        if ((uint64_t) (end - pos) < bytes) {
+            bad = true;
+            pos = end;
+        } else {
+            pos += bytes;
+        }
+    }
+
+    const char* str() {
+        const unsigned char* start = pos;
+        while (pos < end && *pos) {
+            pos++;
+        }
+        if (pos >= end) {
+            bad = true;
+            return "";
+        }
+        pos++;   // skip '\0'
+        return (const char*) start;
+    }
+
+    uint64_t u(int bytes) {
+        if (bytes > 8 || end - pos < bytes) {
+            bad = true;
+            pos = end;
+            return 0;
+        }
+        uint64_t value = 0;
+        for (int i = 0; i < bytes; i++) {
+            value |= (uint64_t) pos[i] << (8 * i);
+        }
+        pos += bytes;
+        return value;
+    }
+
+    uint64_t uleb() {
+        uint64_t value = 0;
+        int shift = 0;
+        while (pos < end) {
+            unsigned char byte = *pos++;
+            if (shift < 64) {
+                value |= (uint64_t) (byte & 0x7f) << shift;
+            }
+            shift += 7;
+            if (!(byte & 0x80)) {
+                return value;
+            }
+        }
+        bad = true;
+        return value;
+    }
+
+    int64_t sleb() {
+        uint64_t value = 0;
+        int shift = 0;
+        unsigned char byte = 0;
+        do {
+            if (pos >= end) {
+                bad = true;
+                return 0;
+            }
+            byte = *pos++;
+            if (shift < 64) {
+                value |= (uint64_t) (byte & 0x7f) << shift;
+            }
+            shift += 7;
+        } while (byte & 0x80);
+        if (shift < 64 && (byte & 0x40)) {
+            value |= ~(uint64_t) 0 << shift;   // sign-extend
+        }
+        return (int64_t) value;
+    }
+
+    const unsigned char* pos;
+    const unsigned char* end;
+    bool bad;
+};
+
+/*
+ * The symbol and line tables of one executable or shared library.
+ */
+class ElfModule {
+public:
+    ElfModule(const std::string& path, bool isMainProgram);
+
+    bool findFunction(uint64_t address, std::string& function) const;
+    bool findLine(uint64_t address, std::string& file, int& line) const;
+    bool hasLineTable() const;
+    bool isMainProgram() const;
+
+private:
+    struct Section {
+        const unsigned char* data;
+        uint64_t size;
+    };
+
+    struct Symbol {
+        uint64_t address;
+        uint64_t size;
+        const char* name;   // points into the mapped file
+    };
+
+    struct LineRow {
+        uint64_t address;
+        int file;           // index into _fileNames, or -1
+        int line;
+        bool endSequence;   // first address past the end of a run of code
+    };
+
+    int addFileName(const char* path);
+    template <typename Ehdr, typename Shdr, typename Sym>
+    void readElf();
+    const char* readForm(DwarfReader& reader, uint64_t form, int offsetSize);
+    void readLineTable(const Section& debugLine);
+    void readLineUnit(DwarfReader& unit, int offsetSize);
+    bool readV5EntryTable(DwarfReader& unit, int offsetSize, std::vector<int>* files);
+
+    const unsigned char* _data;   // whole file, memory-mapped
+    uint64_t _size;
+    bool _isMainProgram;
+    bool _hasLineTable;
+    Section _debugStr;
+    Section _debugLineStr;
+    std::vector<Symbol> _symbols;             // sorted by address
+    std::vector<LineRow> _lineRows;           // sorted by address
+    std::vector<std::string> _fileNames;      // without directories
+    std::unordered_map<std::string, int> _fileIndexes;
+};
+
+ElfModule::ElfModule(const std::string& path, bool isMainProgram)
+        : _data(nullptr),
+          _size(0),
+          _isMainProgram(isMainProgram),
+          _hasLineTable(false) {
+    _debugStr.data = _debugLineStr.data = nullptr;
+    _debugStr.size = _debugLineStr.size = 0;
+
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+    struct stat info;
+    if (fstat(fd, &info) == 0 && info.st_size >= (off_t) EI_NIDENT) {
+        void* mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped != MAP_FAILED) {
+            _data = (const unsigned char*) mapped;
+            _size = info.st_size;
+        }
+    }
+    close(fd);   // the mapping stays valid
+    if (!_data || memcmp(_data, ELFMAG, SELFMAG) != 0) {
+        return;
+    }
+
+    // only files in this machine's byte order can be loaded, so only those
+    // need to be read
+    int byteOrder = _data[EI_DATA];
+    const uint16_t one = 1;
+    bool littleEndian = *(const unsigned char*) &one == 1;
+    if (byteOrder != (littleEndian ? ELFDATA2LSB : ELFDATA2MSB)) {
+        return;
+    }
+    if (_data[EI_CLASS] == ELFCLASS64) {
+        readElf<Elf64_Ehdr, Elf64_Shdr, Elf64_Sym>();
+    } else if (_data[EI_CLASS] == ELFCLASS32) {
+        readElf<Elf32_Ehdr, Elf32_Shdr, Elf32_Sym>();
+    }
+}
+
+int ElfModule::addFileName(const char* path) {
+    const char* slash = strrchr(path, '/');
+    std::string name = slash ? slash + 1 : path;
+    auto itr = _fileIndexes.find(name);
+    if (itr != _fileIndexes.end()) {
+        return itr->second;
+    }
+    int index = (int) _fileNames.size();
+    _fileNames.push_back(name);
+    _fileIndexes[name] = index;
+    return index;
+}
+
+bool ElfModule::findFunction(uint64_t address, std::string& function) const {
+    auto itr = std::upper_bound(_symbols.begin(), _symbols.end(), address,
+            [](uint64_t addr, const Symbol& sym) {
+        return addr < sym.address;
+    });
+    if (itr == _symbols.begin()) {
+        return false;
+    }
+    --itr;
+    if (itr->size > 0 && address >= itr->address + itr->size) {
+        return false;
+    }
+
+    int status = 0;
+    char* demangled = abi::__cxa_demangle(itr->name, /* buffer */ nullptr,
+                                          /* length pointer */ nullptr, &status);
+    if (status == 0 && demangled) {
+        function = demangled;
+    } else {
+        function = itr->name;
+    }
+    free(demangled);
+    return true;
+}
+
+bool ElfModule::findLine(uint64_t address, std::string& file, int& line) const {
+    auto itr = std::upper_bound(_lineRows.begin(), _lineRows.end(), address,
+            [](uint64_t addr, const LineRow& row) {
+        return addr < row.address;
+    });
+    if (itr == _lineRows.begin()) {
+        return false;
+    }
+    --itr;
+    if (itr->endSequence || itr->file < 0 || itr->line <= 0) {
+        return false;
+    }
+    file = _fileNames[itr->file];
+    line = itr->line;
+    return true;
+}
+
+bool ElfModule::hasLineTable() const {
+    return _hasLineTable;
+}
+
+bool ElfModule::isMainProgram() const {
+    return _isMainProgram;
+}
+
+template <typename Ehdr, typename Shdr, typename Sym>
+void ElfModule::readElf() {
+    if (_size < sizeof(Ehdr)) {
+        return;
+    }
+    const Ehdr* header = (const Ehdr*) _data;
+    if (header->e_shoff == 0 || header->e_shentsize != sizeof(Shdr)
+            || header->e_shoff + (uint64_t) header->e_shnum * sizeof(Shdr) > _size
+            || header->e_shstrndx >= header->e_shnum) {
+        return;
+    }
+    const Shdr* sections = (const Shdr*) (_data + header->e_shoff);
+    int sectionCount = header->e_shnum;
+
+    // returns a section's contents, or nothing if it is not in the file
+    // or is compressed (zlib is not available to inflate it)
+    auto contents = [this](const Shdr& shdr) {
+        Section section = {nullptr, 0};
+        if (shdr.sh_type != SHT_NOBITS && !(shdr.sh_flags & SHF_COMPRESSED)
+                && shdr.sh_offset + shdr.sh_size <= _size) {
+            section.data = _data + shdr.sh_offset;
+            section.size = shdr.sh_size;
+        }
+        return section;
+    };
+
+    Section names = contents(sections[header->e_shstrndx]);
+    Section debugLine = {nullptr, 0};
+    int symtab = -1;
+    int dynsym = -1;
+    for (int i = 0; i < sectionCount; i++) {
+        const Shdr& shdr = sections[i];
+        if (shdr.sh_type == SHT_SYMTAB) {
+            symtab = i;
+        } else if (shdr.sh_type == SHT_DYNSYM) {
+            dynsym = i;
+        }
+        if (!names.data || shdr.sh_name >= names.size) {
+            continue;
+        }
+        const char* name = (const char*) names.data + shdr.sh_name;
+        if (!memchr(name, '\0', names.size - shdr.sh_name)) {
+            continue;
+        }
+        if (strcmp(name, ".debug_line") == 0) {
+            debugLine = contents(shdr);
+        } else if (strcmp(name, ".debug_str") == 0) {
+            _debugStr = contents(shdr);
+        } else if (strcmp(name, ".debug_line_str") == 0) {
+            _debugLineStr = contents(shdr);
+        }
+    }
+
+    // function symbols; a stripped binary has only its exported ones, in .dynsym
+    int symbolSection = symtab >= 0 ? symtab : dynsym;
+    if (symbolSection >= 0 && (int) sections[symbolSection].sh_link < sectionCount) {
+        Section symbols = contents(sections[symbolSection]);
+        Section strings = contents(sections[sections[symbolSection].sh_link]);
+        int count = (int) (symbols.size / sizeof(Sym));
+        for (int i = 0; i < count && strings.data; i++) {
+            const Sym& sym = ((const Sym*) symbols.data)[i];
+            if ((sym.st_info & 0xf) == STT_FUNC && sym.st_shndx != SHN_UNDEF
+                    && sym.st_value != 0 && sym.st_name < strings.size) {
+                Symbol symbol;
+                symbol.address = sym.st_value;
+                symbol.size = sym.st_size;
+                symbol.name = (const char*) strings.data + sym.st_name;
+                _symbols.push_back(symbol);
+            }
+        }
+        std::sort(_symbols.begin(), _symbols.end(), [](const Symbol& a, const Symbol& b) {
+            return a.address < b.address;
+        });
+    }
+
+    if (debugLine.data) {
+        readLineTable(debugLine);
+    }
+}
+
+/*
+ * Reads an attribute of a DWARF 5 directory or file entry in the given form.
+ * Returns its value if it is a string we can find, otherwise skips over it
+ * and returns "".  Sets the reader's 'bad' flag for forms we don't know.
+ */
+const char* ElfModule::readForm(DwarfReader& reader, uint64_t form, int offsetSize) {
+    switch (form) {
+    case DW_FORM_string:
+        return reader.str();
+    case DW_FORM_line_strp:
+    case DW_FORM_strp: {
+        uint64_t offset = reader.u(offsetSize);
+        const Section& strings = form == DW_FORM_strp ? _debugStr : _debugLineStr;
+        if (strings.data && offset < strings.size
+                && memchr(strings.data + offset, '\0', strings.size - offset)) {
+            return (const char*) strings.data + offset;
+        }
+        return "";
+    }
+    case DW_FORM_data1:
+    case DW_FORM_strx1:
+        reader.skip(1);
+        return "";
+    case DW_FORM_data2:
+    case DW_FORM_strx2:
+        reader.skip(2);
+        return "";
+    case DW_FORM_strx3:
+        reader.skip(3);
+        return "";
+    case DW_FORM_data4:
+    case DW_FORM_strx4:
+        reader.skip(4);
+        return "";
+    case DW_FORM_data8:
+        reader.skip(8);
+        return "";
+    case DW_FORM_data16:
+        reader.skip(16);
+        return "";
+    case DW_FORM_udata:
+    case DW_FORM_strx:
+        reader.uleb();
+        return "";
+    case DW_FORM_sdata:
+        reader.sleb();
+        return "";
+    case DW_FORM_block:
+        reader.skip(reader.uleb());
+        return "";
+    case DW_FORM_block1:
+        reader.skip(reader.u(1));
+        return "";
+    case DW_FORM_block2:
+        reader.skip(reader.u(2));
+        return "";
+    case DW_FORM_block4:
+        reader.skip(reader.u(4));
+        return "";
+    default:
+        reader.bad = true;
+        return "";
+    }
+}
+
+void ElfModule::readLineTable(const Section& debugLine) {
+    DwarfReader reader(debugLine.data, debugLine.data + debugLine.size);
+    while (!reader.atEnd()) {
+        // each compilation unit has its own header and line number program
+        int offsetSize = 4;
+        uint64_t unitLength = reader.u(4);
+        if (unitLength == 0xffffffff) {
+            offsetSize = 8;   // 64-bit DWARF
+            unitLength = reader.u(8);
+        }
+        if (reader.bad || unitLength > (uint64_t) (reader.end - reader.pos)) {
+            break;
+        }
+        DwarfReader unit(reader.pos, reader.pos + unitLength);
+        reader.skip(unitLength);
+        readLineUnit(unit, offsetSize);
+    }
+
+    // sort all units' rows together; where one run of code ends at the
+    // address where another begins, the beginning comes last so it is found
+    std::stable_sort(_lineRows.begin(), _lineRows.end(), [](const LineRow& a, const LineRow& b) {
+        return a.address < b.address
+                || (a.address == b.address && a.endSequence && !b.endSequence);
+    });
+    _hasLineTable = true;
+}
+
+void ElfModule::readLineUnit(DwarfReader& unit, int offsetSize) {
+    int version = (int) unit.u(2);
+    if (version < 2 || version > 5) {
+        return;
+    }
+    if (version >= 5) {
+        unit.skip(2);   // address size, segment selector size
+    }
+    uint64_t headerLength = unit.u(offsetSize);
+    if (unit.bad || headerLength > (uint64_t) (unit.end - unit.pos)) {
+        return;
+    }
+    const unsigned char* program = unit.pos + headerLength;
+    int minInstructionLength = (int) unit.u(1);
+    if (version >= 4) {
+        unit.skip(1);   // maximum operations per instruction (for VLIW only)
+    }
+    unit.skip(1);   // default_is_stmt
+    int lineBase = (int8_t) unit.u(1);
+    int lineRange = (int) unit.u(1);
+    int opcodeBase = (int) unit.u(1);
+    if (lineRange == 0 || opcodeBase == 0) {
+        return;
+    }
+    std::vector<int> opcodeLengths;
+    for (int i = 1; i < opcodeBase; i++) {
+        opcodeLengths.push_back((int) unit.u(1));
+    }
+
+    // files[i] is the index in _fileNames of the unit's file number i;
+    // numbers start from 1 before DWARF 5 and from 0 since
+    std::vector<int> files;
+    if (version < 5) {
+        while (!unit.atEnd() && *unit.str()) {
+            // skip include directories
+        }
+        files.push_back(-1);
+        while (!unit.atEnd()) {
+            const char* name = unit.str();
+            if (!*name) {
+                break;
+            }
+            unit.uleb();   // directory index
+            unit.uleb();   // modification time
+            unit.uleb();   // file length
+            files.push_back(addFileName(name));
+        }
+    } else if (!readV5EntryTable(unit, offsetSize, /* files */ nullptr)
+               || !readV5EntryTable(unit, offsetSize, &files)) {
+        return;
+    }
+    unit.seek(program);
+
+    // run the line number program, a state machine that generates a row
+    // for each address at which the line changes
+    uint64_t address = 0;
+    int file = 1;
+    int line = 1;
+    auto emitRow = [this, &files, &address, &file, &line](bool endSequence) {
+        LineRow row;
+        row.address = address;
+        row.file = file >= 0 && file < (int) files.size() ? files[file] : -1;
+        row.line = line;
+        row.endSequence = endSequence;
+        _lineRows.push_back(row);
+    };
+    while (!unit.atEnd()) {
+        int opcode = (int) unit.u(1);
+        if (opcode >= opcodeBase) {
+            // special opcode: advance address and line together, then emit
+            int adjusted = opcode - opcodeBase;
+            address += (adjusted / lineRange) * minInstructionLength;
+            line += lineBase + adjusted % lineRange;
+            emitRow(false);
+        } else if (opcode == 0) {
+            // extended opcode
+            uint64_t length = unit.uleb();
+            if (length == 0 || length > (uint64_t) (unit.end - unit.pos)) {
+                break;
+            }
+            const unsigned char* next = unit.pos + length;
+            int extended = (int) unit.u(1);
+            if (extended == DW_LNE_end_sequence) {
+                emitRow(true);
+                address = 0;
+                file = 1;
+                line = 1;
+            } else if (extended == DW_LNE_set_address) {
+                address = unit.u((int) length - 1);
+            } else if (extended == DW_LNE_define_file) {
+                files.push_back(addFileName(unit.str()));
+            }
+            unit.seek(next);
+        } else if (opcode == DW_LNS_copy) {
+            emitRow(false);
+        } else if (opcode == DW_LNS_advance_pc) {
+            address += unit.uleb() * minInstructionLength;
+        } else if (opcode == DW_LNS_advance_line) {
+            line += (int) unit.sleb();
+        } else if (opcode == DW_LNS_set_file) {
+            file = (int) unit.uleb();
+        } else if (opcode == DW_LNS_const_add_pc) {
+            address += ((255 - opcodeBase) / lineRange) * minInstructionLength;
+        } else if (opcode == DW_LNS_fixed_advance_pc) {
+            address += unit.u(2);
+        } else {
+            // other standard opcodes only affect columns, flags, etc.;
+            // skip their arguments
+            for (int i = 0; i < opcodeLengths[opcode - 1]; i++) {
+                unit.uleb();
+            }
+        }
+    }
+}
+
+/*
+ * Reads a DWARF 5 directory or file name table, which describes its own
+ * format, storing the index of each file name into 'files' if it is non-null.
+ * Returns false if the table can't be read.
+ */
+bool ElfModule::readV5EntryTable(DwarfReader& unit, int offsetSize, std::vector<int>* files) {
+    int formatCount = (int) unit.u(1);
+    std::vector<uint64_t> contentTypes;
+    std::vector<uint64_t> forms;
+    for (int i = 0; i < formatCount; i++) {
+        contentTypes.push_back(unit.uleb());
+        forms.push_back(unit.uleb());
+    }
+    uint64_t count = unit.uleb();
+    for (uint64_t i = 0; i < count && !unit.atEnd(); i++) {
+        const char* path = "";
+        for (int j = 0; j < formatCount; j++) {
+            const char* value = readForm(unit, forms[j], offsetSize);
+            if (contentTypes[j] == DW_LNCT_path) {
+                path = value;
+            }
+        }
+        if (files) {
+            files->push_back(*path ? addFileName(path) : -1);
+        }
+    }
+    return !unit.bad;
+}
+
+/*
+ * Finds which loaded executable or shared library contains an address,
+ * using the dynamic loader's list of loaded objects.
+ */
+struct ModuleSearch {
+    uintptr_t address;
+    bool found;
+    bool isMainProgram;
+    std::string path;
+    uintptr_t loadBias;   // amount added to every address in the file
+};
+
+int findModuleCallback(struct dl_phdr_info* info, size_t /*size*/, void* data) {
+    ModuleSearch* search = (ModuleSearch*) data;
+    for (int i = 0; i < info->dlpi_phnum; i++) {
+        const ElfW(Phdr)& phdr = info->dlpi_phdr[i];
+        uintptr_t start = info->dlpi_addr + phdr.p_vaddr;
+        if (phdr.p_type == PT_LOAD && search->address >= start
+                && search->address < start + phdr.p_memsz) {
+            search->found = true;
+            search->loadBias = info->dlpi_addr;
+            // the program itself is listed first, with an empty name
+            search->isMainProgram = !info->dlpi_name || !info->dlpi_name[0];
+            search->path = search->isMainProgram ? "/proc/self/exe" : info->dlpi_name;
+            return 1;   // stop searching
+        }
+    }
+    return 0;
+}
+
+} // namespace
+
+STATIC_VARIABLE_DECLARE_BLANK(std::mutex, symbolizeMutex)
+STATIC_VARIABLE_DECLARE_MAP_EMPTY(std::unordered_map, void*, symbol_info, symbolCache)
+STATIC_VARIABLE_DECLARE_MAP_EMPTY(std::unordered_map, std::string, ElfModule*, elfModules)
+
+bool symbolize(void* addr, symbol_info& info) {
+    std::lock_guard<std::mutex> guard(STATIC_VARIABLE(symbolizeMutex));
+    auto& cache = STATIC_VARIABLE(symbolCache);
+    auto cached = cache.find(addr);
+    if (cached != cache.end()) {
+        info = cached->second;
+        return info.line > 0;
+    }
+
+    info = symbol_info();
+    ModuleSearch search;
+    search.address = (uintptr_t) addr;
+    search.found = false;
+    search.isMainProgram = false;
+    search.loadBias = 0;
+    dl_iterate_phdr(findModuleCallback, &search);
+    if (search.found) {
+        // modules are never unloaded from the cache; there are only a few
+        ElfModule*& module = STATIC_VARIABLE(elfModules)[search.path];
+        if (!module) {
+            module = new ElfModule(search.path, search.isMainProgram);
+        }
+        uint64_t fileAddress = search.address - search.loadBias;
+        module->findFunction(fileAddress, info.function);
+        module->findLine(fileAddress, info.file, info.line);
+        info.hasLineTable = module->hasLineTable();
+        info.isMainProgram = module->isMainProgram();
+    }
+    cache[addr] = info;
+    return info.line > 0;
+}
+
+} // namespace stacktrace
+
+#else
+
+namespace stacktrace {
+
+bool symbolize(void* /*addr*/, symbol_info& info) {
+    // not implemented on this platform; callers fall back to addr2line/atos
+    info = symbol_info();
+    info.isMainProgram = true;
+    return false;
+}
+
+} // namespace stacktrace
+
+#endif // __GNUC__ && !_WIN32 && !__APPLE__
@@ -4,6 +4,11 @@
  * Linux/gcc implementation of the call_stack class.
  *
  * @author Marty Stepp, based on code from Fredrik Orderud
+ * @version 2018/10/15
+ * - line numbers are looked up in-process by symbolize (call_stack_elf.cpp);
+ *   addr2line is run only if the program's line table can't be read
+ * - functions not exported to dladdr are named from the ELF symbol table
+ * - addr2line's "(inlined by)" lines no longer shift later entries' line numbers
  * @version 2017/10/18
  * - small bug fix for pointer comparison
  * @version 2017/09/02
@@ -245,7 +250,9 @@ call_stack::call_stack(const size_t /*num_discard = 0*/) {
     }
     int stack_depth = backtrace(trace, STATIC_VARIABLE(STACK_FRAMES_MAX));
 
-    // First pass: read linker symbol info and get address offsets.
+    // indexes in 'stack' of entries to look up with an external addr2line
+    std::vector<int> needAddr2line;
+
     for (int i = STATIC_VARIABLE(STACK_FRAMES_TO_SKIP); i < stack_depth; i++) {
         // DL* = programmer API to dynamic linking loader
 
@@ -267,21 +274,30 @@ call_stack::call_stack(const size_t /*num_discard = 0*/) {
         //           << " sname=" << (dlinfo.dli_sname ? dlinfo.dli_sname : "null")
         //           << " saddr=" << dlinfo.dli_saddr << std::endl;
 
-        const char* symname = dlinfo.dli_sname;
-
-        int   status;
-        char* demangled = abi::__cxa_demangle(symname, /* buffer */ nullptr,
-                                              /* length pointer */ nullptr, &status);
-        if (status == 0 && demangled) {
-            symname = demangled;
+        // look up the function and line in the binary's symbol and line tables;
+        // backtrace gives return addresses, which point just past each call,
+        // so look up the address before it, which is in the call instruction
+        symbol_info info;
+        bool foundLine = symbolize((void*) ((char*) trace[i] - 1), info);
+
+        // dladdr only knows exported functions, so prefer the symbol table's name
+        std::string function = info.function;
+        if (function.empty() && dlinfo.dli_sname) {
+            int   status;
+            char* demangled = abi::__cxa_demangle(dlinfo.dli_sname, /* buffer */ nullptr,
+                                                  /* length pointer */ nullptr, &status);
+            function = (status == 0 && demangled) ? demangled : dlinfo.dli_sname;
+            if (demangled) {
+                free(demangled);
+            }
         }
-        
+
         // store entry to stack
-        if (dlinfo.dli_fname && symname) {
+        if (dlinfo.dli_fname && !function.empty()) {
             entry e;
             e.file     = dlinfo.dli_fname;
-            e.line     = 0;   // unsupported; use lineStr instead (later)
-            e.function = symname;
+            e.line     = 0;   // unsupported; use lineStr instead
+            e.function = function;
             e.address  = trace[i];
 
             // The dli_fbase gives an overall offset into the file itself;
@@ -294,21 +310,22 @@ call_stack::call_stack(const size_t /*num_discard = 0*/) {
             } else {
                 e.address2 = dlinfo.dli_saddr;
             }
-            stack.push_back(e);
-        }
 
-        if (demangled) {
-            free(demangled);
+            if (foundLine) {
+                e.lineStr = info.file + ":" + integerToString(info.line);
+            } else if (info.isMainProgram && !info.hasLineTable) {
+                // e.g. compressed debug info, or a platform symbolize doesn't support
+                needAddr2line.push_back((int) stack.size());
+            }
+            stack.push_back(e);
         }
     }
 
-    if (stack_depth == 0 || stack.empty()) {
+    if (needAddr2line.empty()) {
         return;
     }
 
-    // Second pass: try to look up line numbers.
-    //
-    // let's also try to get the line numbers via an 'addr2line' external process
+    // Fallback: look up the remaining line numbers via an 'addr2line' external process
     // (for max compatibility with GCC and Clang, we look up the addresses 2 ways:
     // 1) by the raw void* given to us from backtrace(), and
     // 2) by the offsetted pointer where we subtract the addr of the exe file.
@@ -320,20 +337,29 @@ call_stack::call_stack(const size_t /*num_discard = 0*/) {
     // The failing one will emit a lot of short "??:?? 0" lines.
 
     std::vector<void*> addrsToLookup;
-    for (const entry& e : stack) {
-        addrsToLookup.push_back(e.address);
-        addrsToLookup.push_back(e.address2);
+    for (int index : needAddr2line) {
+        addrsToLookup.push_back(stack[index].address);
+        addrsToLookup.push_back(stack[index].address2);
     }
 
     std::string addr2lineOutput;
     addr2line_all(addrsToLookup, addr2lineOutput);
-    std::vector<std::string> addr2lineLines = stringSplit(addr2lineOutput, "\n");
+    std::vector<std::string> addr2lineLines;
+    for (const std::string& line : stringSplit(addr2lineOutput, "\n")) {
+        // with -i, addr2line adds a line for each function the code was inlined
+        // into; keep the outermost, which is the function actually on the stack
+        if (startsWith(trim(line), "(inlined by)") && !addr2lineLines.empty()) {
+            addr2lineLines.back() = line;
+        } else {
+            addr2lineLines.push_back(line);
+        }
+    }
     int numAddrLines = (int) addr2lineLines.size();
-    for (int i = 0, size = (int) stack.size(); i < size; i++) {
+    for (int i = 0, size = (int) needAddr2line.size(); i < size; i++) {
         std::string opt1 = (2 * i < numAddrLines ? addr2lineLines[2 * i] : std::string());
         std::string opt2 = (2 * i + 1 < numAddrLines ? addr2lineLines[2 * i + 1] : std::string());
         std::string best = opt1.length() > opt2.length() ? opt1 : opt2;
-        stack[i].lineStr = addr2line_clean(best);
+        stack[needAddr2line[i]].lineStr = addr2line_clean(best);
     }
 }
 
@@ -8,6 +8,8 @@
  * NOTE: THIS IMPLEMENTATION IS INCOMPLETE AND CURRENTLY DISABLED.
  *
  * @author Marty Stepp
+ * @version 2018/10/15
+ * - timeouts are measured with a monotonic clock
  * @version 2017/10/07
  * - initial version
  * @since 2017/10/07
@@ -15,6 +17,7 @@
 
 #ifdef PROCESS_H_ENABLED   // won't be enabled
 #include "process.h"
+#include <chrono>
 #include <csignal>
 #include <cstdio>
 #include <vector>
@@ -62,12 +65,9 @@ int Process::runAndCaptureOutput(const std::string& commandLine,
 }
 
 long Process::getCurrentTimeMillis() {
-    struct timeval tp;
-    if (gettimeofday(&tp, nullptr)) {
-        return -1;
-    }
-    long int ms = tp.tv_sec * 1000 + tp.tv_usec / 1000;
-    return ms;
+    // monotonic, since this is only used to measure timeouts
+    return (long) std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
 }
 
 Process::Process(const std::string& commandLine) :
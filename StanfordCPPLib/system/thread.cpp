@@ -46,8 +46,9 @@ static void forkWithVoid(void *arg);
 
 Thread forkThread(void (*fn)()) {
     Thread thread;
-    StartWithVoid startup = { fn };
-    thread.id = forkForPlatform(forkWithVoid, &startup);
+    StartWithVoid* startup = new StartWithVoid;
+    startup->fn = fn;
+    thread.id = forkForPlatform(forkWithVoid, startup);
     return thread;
 }
 
@@ -65,23 +66,55 @@ Thread getCurrentThread() {
     return thread;
 }
 
-Lock::Lock() {
-    id = initLockForPlatform();
+Lock::Lock()
+        : lockCount(0),
+          contentionCount(0) {
+    /* Empty */
 }
 
 Lock::~Lock() {
-    decLockRefCountForPlatform(id);
+    /* Empty */
 }
 
-void Lock::wait() {
-    waitForPlatform(id);
+long Lock::getContentionCount() const {
+    return contentionCount;
+}
+
+long Lock::getLockCount() const {
+    return lockCount;
+}
+
+void Lock::lock() {
+    // try first without waiting, to find out whether another thread has it
+    if (!mutex.try_lock()) {
+        contentionCount++;
+        mutex.lock();
+    }
+    lockCount++;
+}
+
+void Lock::resetCounts() {
+    lockCount = 0;
+    contentionCount = 0;
 }
 
 void Lock::signal() {
-    signalForPlatform(id);
+    condition.notify_all();
+}
+
+void Lock::unlock() {
+    mutex.unlock();
+}
+
+void Lock::wait() {
+    condition.wait(mutex);
 }
 
 static void forkWithVoid(void *arg) {
+    // the startup data is on the heap, since forkThread may return before
+    // the new thread gets here
     StartWithVoid* startup = (StartWithVoid*) arg;
-    startup->fn();
+    void (* fn)() = startup->fn;
+    delete startup;
+    fn();
 }
@@ -4,6 +4,11 @@
  * This file exports a simple, platform-independent thread abstraction,
  * along with simple tools for concurrency control.
  *
+ * @version 2018/10/15
+ * - Lock holds its own mutex and condition variable rather than looking them
+ *   up in a global map on every lock and unlock; Locks can no longer be copied
+ * - added Lock contention counters
+ * - see threadpool.h for running many small tasks on a pool of threads
  * @version 2017/10/24
  * - re-inserted into library (why was it removed?)
  */
@@ -11,6 +16,9 @@
 #ifndef _thread_h
 #define _thread_h
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
 #include <string>
 
 /* Forward definition */
@@ -168,12 +176,49 @@ public:
      */
     void signal();
 
+    /*
+     * Method: getContentionCount
+     * Usage: long count = lock.getContentionCount();
+     * ----------------------------------------------
+     * Returns the number of times a thread has tried to acquire this lock
+     * while another thread held it, and so had to wait for it.
+     * Comparing this to getLockCount shows how often threads get in each
+     * other's way.
+     */
+    long getContentionCount() const;
+
+    /*
+     * Method: getLockCount
+     * Usage: long count = lock.getLockCount();
+     * ----------------------------------------
+     * Returns the number of times this lock has been acquired.
+     */
+    long getLockCount() const;
+
+    /*
+     * Method: resetCounts
+     * Usage: lock.resetCounts();
+     * --------------------------
+     * Sets the counts returned by getContentionCount and getLockCount to 0.
+     */
+    void resetCounts();
+
 /**********************************************************************/
 /* Note: Everything below this point in this class is logically part  */
 /* of the implementation and should not be of interest to clients.    */
 /**********************************************************************/
 private:
-    long id;     /* id linking this lock to the platform-specific data */
+    Lock(const Lock&) = delete;
+    Lock& operator =(const Lock&) = delete;
+
+    void lock();
+    void unlock();
+
+    std::recursive_mutex mutex;
+    std::condition_variable_any condition;
+    std::atomic<long> lockCount;
+    std::atomic<long> contentionCount;
+
     friend class Lock_State;
 };
 
@@ -192,9 +237,6 @@ private:
  *</pre>
  */
 
-void lockForPlatform(int id);
-void unlockForPlatform(int id);
-
 class Lock_State {
 public:
     Lock_State(Lock& lock) {
@@ -204,11 +246,11 @@ public:
 
     bool advance() {
         if (finished) {
-            unlockForPlatform(lp->id);
+            lp->unlock();
             return false;
         } else {
             finished = true;
-            lockForPlatform(lp->id);
+            lp->lock();
             return true;
         }
     }
@@ -234,15 +276,21 @@ struct StartWithClientData {
 
 template <typename ClientType>
 static void forkWithClientData(void* arg) {
+    // the startup data is on the heap, since forkThread may return before
+    // the new thread gets here
     StartWithClientData<ClientType>* startup = (StartWithClientData<ClientType>*) arg;
-    startup->fn(*startup->dp);
+    StartWithClientData<ClientType> copy = *startup;
+    delete startup;
+    copy.fn(*copy.dp);
 }
 
 template <typename ClientType>
 Thread forkThread(void (*fn)(ClientType& data), ClientType& data) {
-    StartWithClientData<ClientType> startup = { fn, &data };
+    StartWithClientData<ClientType>* startup = new StartWithClientData<ClientType>;
+    startup->fn = fn;
+    startup->dp = &data;
     Thread thread;
-    thread.id = forkForPlatform(forkWithClientData<ClientType>, &startup);
+    thread.id = forkForPlatform(forkWithClientData<ClientType>, startup);
     return thread;
 }
 
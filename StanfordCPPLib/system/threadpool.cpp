@@ -0,0 +1,221 @@
+/*
+ * File: threadpool.cpp
+ * --------------------
+ * This file implements the ThreadPool and TaskGroup classes.
+ *
+ * @version 2018/10/15
+ * - initial version
+ * @since 2018/10/15
+ */
+
+#include "threadpool.h"
+#include "error.h"
+
+// the pool, if any, that the current thread belongs to, and its queue index
+static thread_local ThreadPool* currentPool = nullptr;
+static thread_local int currentQueue = -1;
+
+// true while the current thread runs a task it stole while waiting on a
+// TaskGroup; it then steals no more until that task is done, since each
+// stolen task runs nested on top of the wait and could otherwise pile up
+// until the stack overflows
+static thread_local bool runningStolenTaskInWait = false;
+
+ThreadPool::ThreadPool(int threadCount)
+        : queuedCount(0),
+          sleepingCount(0),
+          nextQueue(0),
+          stealCount(0),
+          stopping(false) {
+    if (threadCount < 0) {
+        error("ThreadPool::constructor: thread count cannot be negative");
+    } else if (threadCount == 0) {
+        threadCount = (int) std::thread::hardware_concurrency();
+        if (threadCount <= 0) {
+            threadCount = 1;
+        }
+    }
+    for (int i = 0; i < threadCount; i++) {
+        queues.push_back(std::unique_ptr<WorkQueue>(new WorkQueue));
+    }
+    for (int i = 0; i < threadCount; i++) {
+        threads.push_back(std::thread(&ThreadPool::workerLoop, this, i));
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> guard(sleepMutex);
+        stopping = true;
+    }
+    wakeUp.notify_all();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+ThreadPool& ThreadPool::getDefault() {
+    // never deleted, so that its threads are not joined during static
+    // destruction at program exit
+    static ThreadPool* pool = new ThreadPool();
+    return *pool;
+}
+
+long ThreadPool::getStealCount() const {
+    return stealCount;
+}
+
+int ThreadPool::getThreadCount() const {
+    return (int) threads.size();
+}
+
+void ThreadPool::enqueue(std::function<void ()> task) {
+    // a pool thread keeps its own tasks; others spread theirs around
+    int index = getCurrentQueue();
+    if (index < 0) {
+        index = (int) (nextQueue++ % queues.size());
+    }
+    WorkQueue& queue = *queues[index];
+    {
+        std::lock_guard<std::mutex> guard(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+    }
+    queuedCount++;
+
+    // A sleeping thread increments sleepingCount and then checks queuedCount;
+    // we increment queuedCount and then check sleepingCount.  So either it
+    // sees our task or we see it sleeping, and only in the latter case do
+    // we need to pay for locking and notifying.
+    if (sleepingCount > 0) {
+        std::lock_guard<std::mutex> guard(sleepMutex);
+        wakeUp.notify_one();
+    }
+}
+
+int ThreadPool::getCurrentQueue() const {
+    return currentPool == this ? currentQueue : -1;
+}
+
+bool ThreadPool::runQueuedTask(bool waiting) {
+    std::function<void ()> task;
+    bool stolen = false;
+    int index = getCurrentQueue();
+    if (index >= 0) {
+        // newest task from our own queue, whose data is most likely in cache
+        WorkQueue& queue = *queues[index];
+        std::lock_guard<std::mutex> guard(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        }
+    }
+    if (!task && !(waiting && runningStolenTaskInWait)) {
+        // oldest task from another queue, which is likely the biggest piece
+        // of work its owner has left
+        int n = (int) queues.size();
+        int first = index >= 0 ? index + 1 : (int) (nextQueue % n);
+        for (int i = 0; i < n && !task; i++) {
+            int victim = (first + i) % n;
+            if (victim == index) {
+                continue;
+            }
+            WorkQueue& queue = *queues[victim];
+            std::lock_guard<std::mutex> guard(queue.mutex);
+            if (!queue.tasks.empty()) {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+                stolen = true;
+                stealCount++;
+            }
+        }
+    }
+    if (!task) {
+        return false;
+    }
+    queuedCount--;
+    if (waiting && stolen) {
+        runningStolenTaskInWait = true;
+        task();
+        runningStolenTaskInWait = false;
+    } else {
+        task();
+    }
+    return true;
+}
+
+void ThreadPool::workerLoop(int index) {
+    currentPool = this;
+    currentQueue = index;
+    while (true) {
+        if (runQueuedTask(/* waiting */ false)) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        if (stopping && queuedCount <= 0) {
+            break;
+        }
+        sleepingCount++;
+        wakeUp.wait(lock, [this]() {
+            return stopping || queuedCount > 0;
+        });
+        sleepingCount--;
+    }
+}
+
+TaskGroup::TaskGroup(ThreadPool& pool)
+        : pool(pool),
+          state(std::make_shared<State>()) {
+    state->pendingCount = 0;
+}
+
+TaskGroup::~TaskGroup() {
+    waitForTasks();
+}
+
+void TaskGroup::run(std::function<void ()> task) {
+    state->pendingCount++;
+    std::shared_ptr<State> state = this->state;
+    pool.enqueue([state, task]() {
+        try {
+            task();
+        } catch (...) {
+            std::lock_guard<std::mutex> guard(state->mutex);
+            if (!state->exception) {
+                state->exception = std::current_exception();
+            }
+        }
+        if (--state->pendingCount == 0) {
+            std::lock_guard<std::mutex> guard(state->mutex);
+            state->finished.notify_all();
+        }
+    });
+}
+
+void TaskGroup::wait() {
+    waitForTasks();
+    std::exception_ptr exception;
+    {
+        std::lock_guard<std::mutex> guard(state->mutex);
+        exception = state->exception;
+        state->exception = nullptr;
+    }
+    if (exception) {
+        std::rethrow_exception(exception);
+    }
+}
+
+void TaskGroup::waitForTasks() {
+    while (state->pendingCount > 0) {
+        // A pool thread helps out rather than sitting idle, and sleeps only
+        // once there is nothing it may run.  Other threads just sleep; they
+        // have no queue of their own, so any task they ran would be stolen,
+        // and a task stolen in every nested wait could overflow the stack.
+        bool ran = pool.getCurrentQueue() >= 0 && pool.runQueuedTask(/* waiting */ true);
+        if (!ran) {
+            std::unique_lock<std::mutex> lock(state->mutex);
+            state->finished.wait(lock, [this]() {
+                return state->pendingCount == 0;
+            });
+        }
+    }
+}
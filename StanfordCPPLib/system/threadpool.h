@@ -0,0 +1,278 @@
+/*
+ * File: threadpool.h
+ * ------------------
+ * This file exports the ThreadPool and TaskGroup classes for running many
+ * small tasks in parallel without the cost of starting a new thread for each.
+ *
+ * @version 2018/10/19
+ * - parallelFor no longer overflows on ranges near INT_MIN or INT_MAX
+ * @version 2018/10/15
+ * - initial version
+ * @since 2018/10/15
+ */
+
+#ifndef _threadpool_h
+#define _threadpool_h
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+class TaskGroup;
+
+/*
+ * Class: ThreadPool
+ * -----------------
+ * A ThreadPool starts a fixed number of threads once, and then runs tasks
+ * given to it on those threads.  Handing a task to a pool costs about a
+ * microsecond, while forkThread creates a new operating system thread each
+ * time, which costs tens of microseconds or more.
+ *
+ * Each thread in the pool has its own queue of tasks.  Tasks submitted from
+ * inside a pool task go on that thread's own queue, and a thread that runs out
+ * of work takes ("steals") tasks from the other threads' queues, so the work
+ * stays spread out without all threads contending for one shared queue.
+ *
+ *<pre>
+ *    ThreadPool pool;
+ *    std::future<int> answer = pool.submit([]() { return computeAnswer(); });
+ *    pool.parallelFor(0, v.size(), [&](int i) { v[i] = f(v[i]); });
+ *    cout << answer.get() << endl;
+ *</pre>
+ *
+ * A task must not wait for a std::future of a task that has not started yet
+ * if every pool thread might be doing the same; wait on a TaskGroup instead,
+ * which runs queued tasks while it waits.
+ */
+class ThreadPool {
+public:
+    /*
+     * Constructor: ThreadPool
+     * Usage: ThreadPool pool;
+     *        ThreadPool pool(threadCount);
+     * ------------------------------------
+     * Starts a pool with the given number of threads.  If the count is 0 or
+     * omitted, starts one thread for each processor on this computer.
+     * Signals an error if the count is negative.
+     */
+    explicit ThreadPool(int threadCount = 0);
+
+    /*
+     * Destructor: ~ThreadPool
+     * -----------------------
+     * Finishes running every task already submitted, then stops the
+     * pool's threads.
+     */
+    virtual ~ThreadPool();
+
+    /*
+     * Method: getDefault
+     * Usage: ThreadPool& pool = ThreadPool::getDefault();
+     * ---------------------------------------------------
+     * Returns a pool shared by the whole program, with one thread per
+     * processor.  It is created the first time this is called.
+     */
+    static ThreadPool& getDefault();
+
+    /*
+     * Method: getStealCount
+     * Usage: long count = pool.getStealCount();
+     * -----------------------------------------
+     * Returns the number of tasks that were run by a thread other than the
+     * one whose queue they were placed on.
+     */
+    long getStealCount() const;
+
+    /*
+     * Method: getThreadCount
+     * Usage: int count = pool.getThreadCount();
+     * -----------------------------------------
+     * Returns the number of threads in this pool.
+     */
+    int getThreadCount() const;
+
+    /*
+     * Method: parallelFor
+     * Usage: pool.parallelFor(start, end, body);
+     *        pool.parallelFor(start, end, body, grainSize);
+     * -----------------------------------------------------
+     * Calls body(i) for every i from start up to but not including end,
+     * spread across the pool's threads, and returns once all calls are done.
+     * If the calling thread is one of the pool's own threads, it helps with
+     * the work.
+     * The range is split into chunks of grainSize indexes each; if grainSize
+     * is 0 or omitted, a size is chosen that gives each thread several chunks.
+     * Use a larger grain size if each call to body does very little work.
+     * If any call throws an exception, the first one is rethrown here after
+     * the other calls have finished.
+     */
+    template <typename Function>
+    void parallelFor(int start, int end, Function body, int grainSize = 0);
+
+    /*
+     * Method: submit
+     * Usage: std::future<T> result = pool.submit(func);
+     * -------------------------------------------------
+     * Queues the given function, which takes no parameters, to be run by one
+     * of the pool's threads, and returns a future through which its result
+     * (or the exception it throws) can be retrieved.
+     */
+    template <typename Function>
+    std::future<typename std::result_of<Function()>::type> submit(Function func);
+
+/**********************************************************************/
+/* Note: Everything below this point in this class is logically part  */
+/* of the implementation and should not be of interest to clients.    */
+/**********************************************************************/
+private:
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator =(const ThreadPool&) = delete;
+
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<std::function<void ()>> tasks;
+    };
+
+    std::vector<std::thread> threads;
+    std::vector<std::unique_ptr<WorkQueue>> queues;   // one per thread
+    std::atomic<int> queuedCount;     // tasks in all queues
+    std::atomic<int> sleepingCount;   // threads waiting for a task
+    std::atomic<unsigned int> nextQueue;
+    std::atomic<long> stealCount;
+    std::atomic<bool> stopping;
+    std::mutex sleepMutex;
+    std::condition_variable wakeUp;
+
+    void enqueue(std::function<void ()> task);
+    int getCurrentQueue() const;
+    bool runQueuedTask(bool waiting);
+    void workerLoop(int index);
+
+    friend class TaskGroup;
+};
+
+/*
+ * Class: TaskGroup
+ * ----------------
+ * A TaskGroup runs tasks on a ThreadPool and lets you wait for all of them
+ * to finish.  A pool thread that waits on a group runs queued tasks while it
+ * waits, so groups can be waited on from inside other pool tasks, as in a
+ * recursive divide-and-conquer algorithm.
+ *
+ *<pre>
+ *    TaskGroup group;
+ *    group.run([&]() { sortHalf(v, 0, mid); });
+ *    group.run([&]() { sortHalf(v, mid, n); });
+ *    group.wait();
+ *</pre>
+ */
+class TaskGroup {
+public:
+    /*
+     * Constructor: TaskGroup
+     * Usage: TaskGroup group;
+     *        TaskGroup group(pool);
+     * -----------------------------
+     * Creates an empty group whose tasks run on the given pool, or on
+     * ThreadPool::getDefault() if none is given.
+     */
+    explicit TaskGroup(ThreadPool& pool = ThreadPool::getDefault());
+
+    /*
+     * Destructor: ~TaskGroup
+     * ----------------------
+     * Waits for the group's tasks to finish.  Unlike wait, does not rethrow
+     * exceptions thrown by the tasks.
+     */
+    virtual ~TaskGroup();
+
+    /*
+     * Method: run
+     * Usage: group.run(task);
+     * -----------------------
+     * Queues the given function, which takes no parameters and returns
+     * nothing, to be run as part of this group.
+     */
+    void run(std::function<void ()> task);
+
+    /*
+     * Method: wait
+     * Usage: group.wait();
+     * --------------------
+     * Returns once every task run in this group so far has finished.
+     * If any task threw an exception, the first one is rethrown here.
+     */
+    void wait();
+
+/**********************************************************************/
+/* Note: Everything below this point in this class is logically part  */
+/* of the implementation and should not be of interest to clients.    */
+/**********************************************************************/
+private:
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator =(const TaskGroup&) = delete;
+
+    // shared with the queued tasks, so that a task finishing just as wait
+    // returns can still safely touch it
+    struct State {
+        std::atomic<int> pendingCount;
+        std::mutex mutex;
+        std::condition_variable finished;
+        std::exception_ptr exception;   // first exception thrown by a task
+    };
+
+    ThreadPool& pool;
+    std::shared_ptr<State> state;
+
+    void waitForTasks();
+};
+
+template <typename Function>
+void ThreadPool::parallelFor(int start, int end, Function body, int grainSize) {
+    if (end <= start) {
+        return;
+    }
+    // 64-bit arithmetic, since end - start or lo + grainSize can be more
+    // than INT_MAX
+    long long count = (long long) end - start;
+    if (grainSize <= 0) {
+        grainSize = (int) (count / (getThreadCount() * 8));
+        if (grainSize < 1) {
+            grainSize = 1;
+        }
+    }
+    TaskGroup group(*this);
+    for (long long chunk = start; chunk < end; chunk += grainSize) {
+        int lo = (int) chunk;
+        int hi = (end - chunk > grainSize) ? (int) (chunk + grainSize) : end;
+        group.run([&body, lo, hi]() {
+            for (int i = lo; i < hi; i++) {
+                body(i);
+            }
+        });
+    }
+    group.wait();
+}
+
+template <typename Function>
+std::future<typename std::result_of<Function()>::type> ThreadPool::submit(Function func) {
+    typedef typename std::result_of<Function()>::type ResultType;
+    // std::function needs a copyable target, and packaged_task is move-only
+    std::shared_ptr<std::packaged_task<ResultType ()>> task =
+            std::make_shared<std::packaged_task<ResultType ()>>(std::move(func));
+    std::future<ResultType> result = task->get_future();
+    enqueue([task]() { (*task)(); });
+    return result;
+}
+
+#include "private/init.h"   // ensure that Stanford C++ lib is initialized
+
+#endif // _threadpool_h
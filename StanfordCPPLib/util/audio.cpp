@@ -0,0 +1,492 @@
+/*
+ * File: audio.cpp
+ * ---------------
+ * This file implements the audio.h interface.
+ *
+ * @version 2018/10/15
+ * - initial version
+ * @since 2018/10/15
+ */
+
+#include "audio.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif // __SSE2__
+#include "error.h"
+#include "private/audiodevice.h"
+
+namespace audio {
+
+/*
+ * Implementation notes: mixing
+ * ----------------------------
+ * Each note or sound being played is a "voice": its samples and how far
+ * into them it has got.  The mixer adds all of the voices together into a
+ * block of BLOCK_FRAMES frames of floats and then converts the block to
+ * 16-bit samples; both loops work on 4 or 8 samples per instruction where
+ * SSE2 is available, which is every x86-64 processor.
+ *
+ * For the output device, a mixer thread keeps the ring buffer nearly full,
+ * and the device only copies samples out of it.  Waiting for a lock or for
+ * memory to be allocated could make the device miss its deadline and
+ * glitch, so the device never does either; the mixer thread may, since it
+ * runs up to a ring buffer's length (about 90ms) ahead of what is heard.
+ * New voices reach the mixer thread through a list guarded by a mutex,
+ * which it only try_locks, so a thread calling play never holds it up.
+ */
+static const int BLOCK_FRAMES = 256;
+static const int RING_BUFFER_SAMPLES = 8192;
+
+struct Voice {
+    std::shared_ptr<const Samples> samples;
+    float gain;
+    long long startFrame;   // starts at once if at or before the mixer's frame
+    size_t position;        // index of the next sample to mix
+};
+
+class Mixer {
+public:
+    Mixer() : frame(0) {}
+
+    void add(const Voice& voice) {
+        voices.push_back(voice);
+    }
+
+    int getVoiceCount() const {
+        return (int) voices.size();
+    }
+
+    /*
+     * Mixes the next BLOCK_FRAMES frames of all voices into out, which holds
+     * BLOCK_FRAMES * 2 samples, and drops voices that have finished.
+     */
+    void mixBlock(int16_t* out);
+
+private:
+    std::vector<Voice> voices;
+    long long frame;   // number of frames mixed so far
+    float block[BLOCK_FRAMES * 2];
+};
+
+/*
+ * The mixer thread that feeds the output device, created the first time
+ * something is played while not rendering.
+ */
+class OutputEngine {
+public:
+    OutputEngine();
+    void add(const Voice& voice);
+    int getActiveVoiceCount() const;
+
+private:
+    std::mutex pendingMutex;
+    std::condition_variable pendingAdded;
+    std::vector<Voice> pending;
+    std::atomic<int> activeVoiceCount;
+    stanfordcpplib::AudioRingBuffer ringBuffer;
+    bool deviceStarted;
+
+    void run();
+};
+
+/* Private function prototypes */
+
+static OutputEngine& getOutputEngine();
+static void mixInto(float* out, const float* in, int count, float gain);
+static void toInt16(const float* in, int16_t* out, int count);
+static void writeWav(const std::string& filename, const std::vector<int16_t>& samples);
+
+static struct RenderState {
+    std::mutex mutex;
+    bool rendering = false;
+    long long position = 0;   // frame at which the next voice starts
+    std::vector<Voice> voices;
+} renderState;
+
+void finishRendering(const std::string& filename) {
+    std::vector<Voice> voices;
+    long long endFrame;
+    {
+        std::lock_guard<std::mutex> guard(renderState.mutex);
+        if (!renderState.rendering) {
+            error("audio::finishRendering: startRendering was not called");
+        }
+        renderState.rendering = false;
+        voices.swap(renderState.voices);
+        endFrame = renderState.position;
+    }
+
+    Mixer mixer;
+    for (const Voice& voice : voices) {
+        endFrame = std::max(endFrame, voice.startFrame + (long long) voice.samples->size() / 2);
+        mixer.add(voice);
+    }
+    std::vector<int16_t> samples((size_t) ((endFrame + BLOCK_FRAMES - 1) / BLOCK_FRAMES * BLOCK_FRAMES * 2));
+    for (size_t i = 0; i < samples.size(); i += BLOCK_FRAMES * 2) {
+        mixer.mixBlock(&samples[i]);
+    }
+    samples.resize((size_t) endFrame * 2);
+    writeWav(filename, samples);
+}
+
+int getActiveVoiceCount() {
+    return getOutputEngine().getActiveVoiceCount();
+}
+
+bool isRendering() {
+    std::lock_guard<std::mutex> guard(renderState.mutex);
+    return renderState.rendering;
+}
+
+void play(std::shared_ptr<const Samples> samples, double gain) {
+    if (!samples || samples->size() < 2) {
+        return;
+    }
+    Voice voice = {samples, (float) gain, 0, 0};
+    {
+        std::lock_guard<std::mutex> guard(renderState.mutex);
+        if (renderState.rendering) {
+            voice.startFrame = renderState.position;
+            renderState.voices.push_back(voice);
+            return;
+        }
+    }
+    getOutputEngine().add(voice);
+}
+
+std::shared_ptr<const Samples> readWavFile(const std::string& filename) {
+    std::ifstream input(filename.c_str(), std::ios::binary);
+    if (!input) {
+        error("audio::readWavFile: cannot open file \"" + filename + "\"");
+    }
+    std::vector<unsigned char> bytes((std::istreambuf_iterator<char>(input)),
+                                     std::istreambuf_iterator<char>());
+    auto read16 = [&bytes](size_t i) {
+        return (uint32_t) bytes[i] | ((uint32_t) bytes[i + 1] << 8);
+    };
+    auto read32 = [&bytes, &read16](size_t i) {
+        return read16(i) | (read16(i + 2) << 16);
+    };
+    if (bytes.size() < 12 || memcmp(&bytes[0], "RIFF", 4) != 0 || memcmp(&bytes[8], "WAVE", 4) != 0) {
+        error("audio::readWavFile: \"" + filename + "\" is not a WAV file");
+    }
+
+    // find the format and data chunks; others, such as metadata, are skipped
+    int format = 0;
+    int channels = 0;
+    int rate = 0;
+    int blockAlign = 0;
+    int bits = 0;
+    size_t dataStart = 0;
+    size_t dataSize = 0;
+    for (size_t chunk = 12; chunk + 8 <= bytes.size(); ) {
+        size_t size = read32(chunk + 4);
+        size_t body = chunk + 8;
+        if (memcmp(&bytes[chunk], "fmt ", 4) == 0 && size >= 16 && body + size <= bytes.size()) {
+            format = (int) read16(body);
+            channels = (int) read16(body + 2);
+            rate = (int) read32(body + 4);
+            blockAlign = (int) read16(body + 12);
+            bits = (int) read16(body + 14);
+            if (format == 0xFFFE && size >= 26) {
+                // WAVE_FORMAT_EXTENSIBLE: the real format starts the sub-format GUID
+                format = (int) read16(body + 24);
+            }
+        } else if (memcmp(&bytes[chunk], "data", 4) == 0) {
+            dataStart = body;
+            dataSize = std::min(size, bytes.size() - body);
+        }
+        chunk = body + size + (size & 1);   // chunks are padded to even sizes
+    }
+
+    bool isInteger = format == 1 && (bits == 8 || bits == 16 || bits == 24 || bits == 32);
+    bool isFloat = format == 3 && bits == 32;
+    if (!(isInteger || isFloat) || channels < 1 || rate <= 0
+            || blockAlign < channels * bits / 8 || dataStart == 0) {
+        error("audio::readWavFile: \"" + filename + "\" is not in a supported WAV format");
+    }
+
+    // decode the first one or two channels
+    int bytesPerSample = bits / 8;
+    auto sampleAt = [&](size_t i) -> float {
+        if (isFloat) {
+            uint32_t word = read32(i);
+            float value;
+            memcpy(&value, &word, sizeof(value));
+            return value;
+        } else if (bits == 8) {
+            return (bytes[i] - 128) / 128.0f;   // 8-bit samples are unsigned
+        } else {
+            // shift the sample to the top of a 32-bit int to sign-extend it
+            uint32_t word = 0;
+            for (int b = 0; b < bytesPerSample; b++) {
+                word |= (uint32_t) bytes[i + b] << (32 - bits + 8 * b);
+            }
+            return (int32_t) word / 2147483648.0f;
+        }
+    };
+    size_t frames = dataSize / blockAlign;
+    Samples decoded(frames * 2);
+    for (size_t f = 0; f < frames; f++) {
+        size_t i = dataStart + f * blockAlign;
+        decoded[2 * f] = sampleAt(i);
+        decoded[2 * f + 1] = channels > 1 ? sampleAt(i + bytesPerSample) : decoded[2 * f];
+    }
+    if (rate == SAMPLE_RATE || frames < 2) {
+        return std::make_shared<Samples>(std::move(decoded));
+    }
+
+    // resample by interpolating linearly between neighboring frames
+    size_t outFrames = (size_t) ((double) frames * SAMPLE_RATE / rate);
+    std::shared_ptr<Samples> resampled = std::make_shared<Samples>(outFrames * 2);
+    double step = (double) rate / SAMPLE_RATE;
+    for (size_t f = 0; f < outFrames; f++) {
+        double source = f * step;
+        size_t i = std::min((size_t) source, frames - 2);
+        float t = (float) (source - i);
+        for (int c = 0; c < 2; c++) {
+            (*resampled)[2 * f + c] = decoded[2 * i + c] * (1 - t) + decoded[2 * i + 2 + c] * t;
+        }
+    }
+    return resampled;
+}
+
+void skip(double seconds) {
+    std::lock_guard<std::mutex> guard(renderState.mutex);
+    if (renderState.rendering && seconds > 0) {
+        renderState.position += (long long) std::llround(seconds * SAMPLE_RATE);
+    }
+}
+
+void startRendering() {
+    std::lock_guard<std::mutex> guard(renderState.mutex);
+    renderState.rendering = true;
+    renderState.position = 0;
+    renderState.voices.clear();
+}
+
+std::shared_ptr<const Samples> synthesizeTone(double frequency, double seconds) {
+    static const double PI = 3.14159265358979323846;
+    static const double HARMONICS[] = {1.0, 0.5, 0.25};
+    static const double ATTACK_SECONDS = 0.005;
+    static const double RELEASE_SECONDS = 0.02;
+
+    int frames = (int) std::llround(std::max(seconds, 0.0) * SAMPLE_RATE);
+    std::shared_ptr<Samples> samples = std::make_shared<Samples>((size_t) frames * 2);
+    if (frames == 0 || frequency <= 0) {
+        return samples;
+    }
+
+    // harmonics above half the sample rate would alias to other pitches
+    double total = 0;
+    int harmonics = 0;
+    while (harmonics < 3 && frequency * (harmonics + 1) < SAMPLE_RATE / 2) {
+        total += HARMONICS[harmonics++];
+    }
+    int attack = std::min((int) (ATTACK_SECONDS * SAMPLE_RATE), frames / 2);
+    int release = std::min((int) (RELEASE_SECONDS * SAMPLE_RATE), frames - attack);
+    double phaseStep = 2 * PI * frequency / SAMPLE_RATE;
+    for (int f = 0; f < frames; f++) {
+        double value = 0;
+        for (int h = 0; h < harmonics; h++) {
+            value += HARMONICS[h] * std::sin(phaseStep * (h + 1) * f);
+        }
+        double envelope = 1.0;
+        if (f < attack) {
+            envelope = (double) f / attack;
+        } else if (f >= frames - release) {
+            envelope = (double) (frames - f) / release;
+        }
+        float sample = (float) (value / total * envelope);
+        (*samples)[2 * f] = sample;
+        (*samples)[2 * f + 1] = sample;
+    }
+    return samples;
+}
+
+void writeWavFile(const std::string& filename, const Samples& samples) {
+    std::vector<int16_t> converted(samples.size());
+    if (!samples.empty()) {
+        toInt16(&samples[0], &converted[0], (int) samples.size());
+    }
+    writeWav(filename, converted);
+}
+
+void Mixer::mixBlock(int16_t* out) {
+    std::fill(block, block + BLOCK_FRAMES * 2, 0.0f);
+    for (size_t v = 0; v < voices.size(); ) {
+        Voice& voice = voices[v];
+        int offset = 0;   // frames into this block at which the voice starts
+        if (voice.startFrame > frame) {
+            if (voice.startFrame >= frame + BLOCK_FRAMES) {
+                v++;
+                continue;
+            }
+            offset = (int) (voice.startFrame - frame);
+        }
+        const Samples& samples = *voice.samples;
+        int count = (int) std::min(samples.size() - voice.position, (size_t) (BLOCK_FRAMES - offset) * 2);
+        mixInto(block + offset * 2, &samples[voice.position], count, voice.gain);
+        voice.position += count;
+        if (voice.position >= samples.size()) {
+            // voices are mixed in no particular order, so fill the gap from the end
+            voice = voices.back();
+            voices.pop_back();
+        } else {
+            v++;
+        }
+    }
+    toInt16(block, out, BLOCK_FRAMES * 2);
+    frame += BLOCK_FRAMES;
+}
+
+OutputEngine::OutputEngine()
+        : activeVoiceCount(0),
+          ringBuffer(RING_BUFFER_SAMPLES),
+          deviceStarted(false) {
+    deviceStarted = stanfordcpplib::startAudioOutputDevice(&ringBuffer, SAMPLE_RATE);
+    if (deviceStarted) {
+        std::thread(&OutputEngine::run, this).detach();
+    }
+}
+
+void OutputEngine::add(const Voice& voice) {
+    if (!deviceStarted) {
+        return;   // nowhere to play it
+    }
+    std::lock_guard<std::mutex> guard(pendingMutex);
+    pending.push_back(voice);
+    activeVoiceCount++;
+    pendingAdded.notify_one();
+}
+
+int OutputEngine::getActiveVoiceCount() const {
+    return activeVoiceCount;
+}
+
+void OutputEngine::run() {
+    Mixer mixer;
+    int16_t block[BLOCK_FRAMES * 2];
+    std::vector<Voice> added;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(pendingMutex, std::defer_lock);
+            if (mixer.getVoiceCount() == 0) {
+                // nothing to mix; the device plays silence until there is
+                lock.lock();
+                pendingAdded.wait(lock, [this]() { return !pending.empty(); });
+            } else {
+                lock.try_lock();
+            }
+            if (lock.owns_lock()) {
+                added.swap(pending);
+            }
+        }
+        for (const Voice& voice : added) {
+            mixer.add(voice);
+        }
+        added.clear();
+
+        while (mixer.getVoiceCount() > 0 && ringBuffer.space() >= BLOCK_FRAMES * 2) {
+            int before = mixer.getVoiceCount();
+            mixer.mixBlock(block);
+            ringBuffer.write(block, BLOCK_FRAMES * 2);
+            activeVoiceCount -= before - mixer.getVoiceCount();
+        }
+        // the ring buffer holds about 90ms; top it up a few times in that span
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+}
+
+static OutputEngine& getOutputEngine() {
+    // never deleted, since its thread runs until the program exits
+    static OutputEngine* engine = new OutputEngine();
+    return *engine;
+}
+
+/*
+ * Adds count samples from in, times gain, to out.
+ */
+static void mixInto(float* out, const float* in, int count, float gain) {
+    int i = 0;
+#ifdef __SSE2__
+    __m128 gains = _mm_set1_ps(gain);
+    for (; i + 4 <= count; i += 4) {
+        __m128 sum = _mm_add_ps(_mm_loadu_ps(out + i), _mm_mul_ps(_mm_loadu_ps(in + i), gains));
+        _mm_storeu_ps(out + i, sum);
+    }
+#endif // __SSE2__
+    for (; i < count; i++) {
+        out[i] += in[i] * gain;
+    }
+}
+
+/*
+ * Converts count samples from floats from -1.0 to 1.0 to 16-bit integers,
+ * clipping values outside that range.
+ */
+static void toInt16(const float* in, int16_t* out, int count) {
+    int i = 0;
+#ifdef __SSE2__
+    __m128 low = _mm_set1_ps(-1.0f);
+    __m128 high = _mm_set1_ps(1.0f);
+    __m128 scale = _mm_set1_ps(32767.0f);
+    for (; i + 8 <= count; i += 8) {
+        __m128 a = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(in + i), low), high);
+        __m128 b = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(in + i + 4), low), high);
+        __m128i packed = _mm_packs_epi32(_mm_cvtps_epi32(_mm_mul_ps(a, scale)),
+                                         _mm_cvtps_epi32(_mm_mul_ps(b, scale)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), packed);
+    }
+#endif // __SSE2__
+    for (; i < count; i++) {
+        float value = std::min(std::max(in[i], -1.0f), 1.0f);
+        out[i] = (int16_t) std::lrint(value * 32767.0f);
+    }
+}
+
+static void writeWav(const std::string& filename, const std::vector<int16_t>& samples) {
+    std::ofstream output(filename.c_str(), std::ios::binary);
+    if (!output) {
+        error("audio::writeWavFile: cannot write file \"" + filename + "\"");
+    }
+    auto write16 = [&output](uint32_t value) {
+        output.put((char) (value & 0xFF));
+        output.put((char) ((value >> 8) & 0xFF));
+    };
+    auto write32 = [&write16](uint32_t value) {
+        write16(value & 0xFFFF);
+        write16(value >> 16);
+    };
+    uint32_t dataSize = (uint32_t) (samples.size() * sizeof(int16_t));
+    output.write("RIFF", 4);
+    write32(36 + dataSize);
+    output.write("WAVEfmt ", 8);
+    write32(16);                               // format chunk size
+    write16(1);                                // integer PCM
+    write16(2);                                // channels
+    write32(SAMPLE_RATE);
+    write32(SAMPLE_RATE * 2 * sizeof(int16_t));  // bytes per second
+    write16(2 * sizeof(int16_t));              // bytes per frame
+    write16(16);                               // bits per sample
+    output.write("data", 4);
+    write32(dataSize);
+    for (int16_t sample : samples) {
+        write16((uint16_t) sample);
+    }
+    if (!output) {
+        error("audio::writeWavFile: cannot write file \"" + filename + "\"");
+    }
+}
+} // namespace audio
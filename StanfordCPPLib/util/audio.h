@@ -0,0 +1,148 @@
+/*
+ * File: audio.h
+ * -------------
+ * This file exports functions that control how the Note and Sound classes
+ * produce audio.
+ *
+ * Notes and sounds are mixed together in the library's own process into
+ * 16-bit stereo samples at SAMPLE_RATE frames per second, which are played
+ * on the computer's default audio output device.  Instead of playing them,
+ * the audio can be rendered into a WAV file, which is useful for testing on
+ * a computer without audio hardware:
+ *
+ *<pre>
+ *    audio::startRendering();
+ *    for (Note note : melody) {
+ *        note.play();      // returns immediately while rendering
+ *    }
+ *    audio::finishRendering("melody.wav");
+ *</pre>
+ *
+ * If there is no output device, or the library was built without the Qt
+ * multimedia module, notes and sounds are silent, but still take as long
+ * to play, and rendering still works.
+ *
+ * @version 2018/10/15
+ * - initial version
+ * @since 2018/10/15
+ */
+
+#ifndef _audio_h
+#define _audio_h
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace audio {
+/*
+ * Constant: SAMPLE_RATE
+ * ---------------------
+ * The number of sample frames per second in the mixed audio.
+ */
+const int SAMPLE_RATE = 44100;
+
+/*
+ * Type: Samples
+ * -------------
+ * A piece of audio, as interleaved left and right samples at SAMPLE_RATE
+ * frames per second, each from -1.0 to 1.0.
+ */
+typedef std::vector<float> Samples;
+
+/*
+ * Function: finishRendering
+ * Usage: audio::finishRendering(filename);
+ * ----------------------------------------
+ * Mixes everything played since startRendering was called and writes it to
+ * the given file as a 16-bit stereo WAV file, then goes back to playing
+ * audio on the output device.
+ * Signals an error if startRendering was not called or the file cannot be
+ * written.
+ */
+void finishRendering(const std::string& filename);
+
+/*
+ * Function: getActiveVoiceCount
+ * Usage: int count = audio::getActiveVoiceCount();
+ * ------------------------------------------------
+ * Returns the number of notes and sounds currently being mixed for the
+ * output device.
+ */
+int getActiveVoiceCount();
+
+/*
+ * Function: isRendering
+ * Usage: if (audio::isRendering()) ...
+ * ------------------------------------
+ * Returns true if audio is being rendered for a file rather than played.
+ */
+bool isRendering();
+
+/*
+ * Function: play
+ * Usage: audio::play(samples, gain);
+ * ----------------------------------
+ * Starts playing the given samples, scaled by the given gain, mixed with
+ * anything else that is playing, and returns immediately.
+ * While rendering, the samples start at the current render position.
+ * Note::play and Sound::play call this; it is exported for clients that
+ * want to generate their own audio.
+ */
+void play(std::shared_ptr<const Samples> samples, double gain = 1.0);
+
+/*
+ * Function: readWavFile
+ * Usage: std::shared_ptr<const Samples> samples = audio::readWavFile(filename);
+ * -----------------------------------------------------------------------------
+ * Reads the given WAV file, which may hold 8-, 16-, 24- or 32-bit integer or
+ * 32-bit floating-point PCM samples at any rate, and converts it to Samples.
+ * Mono files play on both channels.
+ * Signals an error if the file cannot be read or is not a WAV file in one
+ * of these formats.
+ */
+std::shared_ptr<const Samples> readWavFile(const std::string& filename);
+
+/*
+ * Function: skip
+ * Usage: audio::skip(seconds);
+ * ----------------------------
+ * While rendering, moves the render position ahead by the given number of
+ * seconds, so that audio played next starts that much later.  Otherwise,
+ * does nothing.  Note::play calls this with the note's duration.
+ */
+void skip(double seconds);
+
+/*
+ * Function: startRendering
+ * Usage: audio::startRendering();
+ * -------------------------------
+ * Starts collecting everything that is played, starting at time 0, rather
+ * than playing it on the output device, until finishRendering is called.
+ * Note::play does not wait for the note to finish while rendering.
+ */
+void startRendering();
+
+/*
+ * Function: synthesizeTone
+ * Usage: std::shared_ptr<const Samples> samples = audio::synthesizeTone(frequency, seconds);
+ * ------------------------------------------------------------------------------------------
+ * Returns a tone of the given frequency in Hz and duration in seconds,
+ * with a few harmonics, that fades in and out quickly enough to avoid
+ * clicks.
+ */
+std::shared_ptr<const Samples> synthesizeTone(double frequency, double seconds);
+
+/*
+ * Function: writeWavFile
+ * Usage: audio::writeWavFile(filename, samples);
+ * ----------------------------------------------
+ * Writes the given samples to the given file as a 16-bit stereo WAV file.
+ * Signals an error if the file cannot be written.
+ */
+void writeWavFile(const std::string& filename, const Samples& samples);
+} // namespace audio
+
+#include "private/init.h"   // ensure that Stanford C++ lib is initialized
+
+#endif // _audio_h
@@ -6,6 +6,13 @@
  * See diff.h for documentation of each function.
  * 
  * @author Marty Stepp
+ * @version 2018/10/19
+ * - a final run of changes that deletes expected lines keeps its added lines
+ * @version 2018/10/04
+ * - replaced greedy line matching with Myers' O(ND) diff algorithm using
+ *   linear-space divide-and-conquer, over lines interned to integer ids
+ * - all IGNORE_* normalizations are applied in one pass over the lines
+ * - diffPass no longer builds the diff text; it stops at the first mismatch
  * @version 2016/10/30
  * - fixed diff flags; added punctuation flag
  * @version 2016/10/22
@@ -17,186 +24,412 @@
 
 #include "diff.h"
 #include <algorithm>
-#include "map.h"
-#include "regexpr.h"
-#include "set.h"
+#include <cctype>
+#include <cstring>
+#include <vector>
+#include "hashmap.h"
 #include "stringutils.h"
 #include "strlib.h"
 #include "vector.h"
 
 namespace diff {
+
+/* edit actions, in the form expected by formatDiffs */
+static const int ACTION_DELETE = 1;
+static const int ACTION_ADD = 2;
+static const int ACTION_COMMON = 4;
+static const int ACTION_END = 8;
+
+/* characters removed by IGNORE_PUNCTUATION */
+static const char* PUNCTUATION_CHARS = ".,?!'\"()/#$%@^&*_[]{}|<>:;-";
+
+/* Prototypes */
+
+static void bisect(const int* a, int n, const int* b, int m, std::vector<int>& actions);
+static void diffLines(const int* a, int n, const int* b, int m, std::vector<int>& actions);
+static std::string formatDiffs(const std::vector<int>& actions,
+                               const Vector<std::string>& lines1Original,
+                               const Vector<std::string>& lines2Original,
+                               int flags);
+static void internLines(const Vector<std::string>& lines1, const Vector<std::string>& lines2,
+                        std::vector<int>& ids1, std::vector<int>& ids2);
+static bool normalize(const std::string& s1, const std::string& s2,
+                      const Vector<std::string>& lines1Original,
+                      const Vector<std::string>& lines2Original,
+                      Vector<std::string>& lines1, Vector<std::string>& lines2,
+                      int flags);
+static void normalizeLine(std::string& line, bool trimEnd, int flags);
+
+/* Implementations */
+
 std::string diff(std::string s1, std::string s2, int flags) {
-    Vector<std::string> lines1 = stringutils::explodeLines(s1);
-    Vector<std::string> lines2 = stringutils::explodeLines(s2);
-    Vector<std::string> lines1Original = lines1;
-    Vector<std::string> lines2Original = lines2;
+    Vector<std::string> lines1Original = stringutils::explodeLines(s1);
+    Vector<std::string> lines2Original = stringutils::explodeLines(s2);
+    Vector<std::string> lines1;
+    Vector<std::string> lines2;
+    if (normalize(s1, s2, lines1Original, lines2Original, lines1, lines2, flags)) {
+        return NO_DIFFS_MESSAGE;
+    }
 
-    if (flags & IGNORE_NUMBERS) {
-        s1 = regexReplace(s1, "[0-9]+", "###");
-        s2 = regexReplace(s2, "[0-9]+", "###");
-        lines1 = stringutils::explodeLines(s1);
-        lines2 = stringutils::explodeLines(s2);
+    std::vector<int> ids1;
+    std::vector<int> ids2;
+    internLines(lines1, lines2, ids1, ids2);
+
+    std::vector<int> actions;
+    actions.reserve(ids1.size() + ids2.size() + 1);
+    diffLines(ids1.data(), (int) ids1.size(), ids2.data(), (int) ids2.size(), actions);
+
+    // within each run of changes, list the deletions before the additions
+    for (size_t i = 0; i < actions.size(); ) {
+        size_t j = i;
+        while (j < actions.size() && actions[j] != ACTION_COMMON) {
+            j++;
+        }
+        std::sort(actions.begin() + i, actions.begin() + j);
+        i = j + 1;
     }
-    if (flags & IGNORE_NONNUMBERS) {
-        s1 = regexReplace(s1, "[^0-9\n]+", " ");
-        s2 = regexReplace(s2, "[^0-9\n]+", " ");
-        lines1 = stringutils::explodeLines(s1);
-        lines2 = stringutils::explodeLines(s2);
+
+    // extra lines after the end of the expected output are only reported if
+    // IGNORE_TRAILING is set, as the old greedy matcher did; a final run of
+    // changes that also deletes expected lines is always reported in full
+    if (!(flags & IGNORE_TRAILING)) {
+        size_t end = actions.size();
+        while (end > 0 && actions[end - 1] == ACTION_ADD) {
+            end--;
+        }
+        if (end == 0 || actions[end - 1] == ACTION_COMMON) {
+            actions.resize(end);
+        }
     }
-    if (flags & IGNORE_PUNCTUATION) {
-        std::string punct = "[.,?!'\"()\\/#$%@^&*_\\[\\]{}|<>:;-]+";
-        s1 = regexReplace(s1, punct, "");
-        s2 = regexReplace(s2, punct, "");
-        lines1 = stringutils::explodeLines(s1);
-        lines2 = stringutils::explodeLines(s2);
+
+    // and this marks our ending point
+    actions.push_back(ACTION_END);
+
+    return formatDiffs(actions, lines1Original, lines2Original, flags);
+}
+
+bool diffPass(const std::string& s1, const std::string& s2, int flags) {
+    Vector<std::string> lines1Original = stringutils::explodeLines(s1);
+    Vector<std::string> lines2Original = stringutils::explodeLines(s2);
+    Vector<std::string> lines1;
+    Vector<std::string> lines2;
+    if (normalize(s1, s2, lines1Original, lines2Original, lines1, lines2, flags)) {
+        return true;
     }
-    if (flags & IGNORE_AFTERDECIMAL) {
-        s1 = regexReplace(s1, "\\.[0-9]+", ".#");
-        s2 = regexReplace(s2, "\\.[0-9]+", ".#");
-        lines1 = stringutils::explodeLines(s1);
-        lines2 = stringutils::explodeLines(s2);
+
+    // skip the common prefix and suffix, stopping at the first mismatch;
+    // this is the same trimming that diffLines does before diffing
+    int n = lines1.size();
+    int m = lines2.size();
+    int prefix = 0;
+    while (prefix < n && prefix < m && lines1[prefix] == lines2[prefix]) {
+        prefix++;
     }
-    if (flags & IGNORE_CASE) {
-        s1 = stringutils::toLowerCase(s1);
-        s2 = stringutils::toLowerCase(s2);
-        lines1 = stringutils::explodeLines(s1);
-        lines2 = stringutils::explodeLines(s2);
+    int suffix = 0;
+    while (suffix < n - prefix && suffix < m - prefix
+           && lines1[n - 1 - suffix] == lines2[m - 1 - suffix]) {
+        suffix++;
     }
-    if (flags & IGNORE_CHARORDER) {
-        Vector<std::string> lines1Sorted;
-        for (std::string line : lines1) {
-            sort(line.begin(), line.end());
-            lines1Sorted.push_back(line);
-        }
-        lines1 = lines1Sorted;
-        s1 = stringutils::implode(lines1);
 
-        Vector<std::string> lines2Sorted;
-        for (std::string line : lines2) {
-            sort(line.begin(), line.end());
-            lines2Sorted.push_back(line);
+    if (prefix + suffix < n) {
+        if (flags & IGNORE_LEADING) {
+            // extra leading lines might be all that differs; needs a real diff
+            return isDiffMatch(diff(s1, s2, flags));
         }
-        lines2 = lines2Sorted;
-        s2 = stringutils::implode(lines2);
+        // some expected line was deleted or changed; that is always reported
+        return false;
+    } else if (prefix + suffix == m) {
+        return true;
+    } else if (suffix == 0 && !(flags & IGNORE_TRAILING)) {
+        return true;   // only extra lines past the end of the expected output
+    } else if (prefix == 0 && (flags & IGNORE_LEADING)) {
+        return true;   // only extra lines before the start of the expected output
+    } else {
+        return false;
+    }
+}
+
+bool isDiffMatch(const std::string& diffs) {
+    return trim(diffs) == NO_DIFFS_MESSAGE;
+}
+
+/*
+ * Applies all normalizations requested by the given flags to the lines of
+ * both texts, storing the results in lines1/lines2.
+ * Returns true if the normalized texts are equal (ignoring trailing
+ * whitespace at the end of the text), meaning that no diff is needed.
+ */
+static bool normalize(const std::string& s1, const std::string& s2,
+                      const Vector<std::string>& lines1Original,
+                      const Vector<std::string>& lines2Original,
+                      Vector<std::string>& lines1, Vector<std::string>& lines2,
+                      int flags) {
+    // explodeLines trims trailing whitespace from every line that was
+    // followed by a line break, so do the same after normalizing
+    lines1 = lines1Original;
+    lines2 = lines2Original;
+    bool lastLineBreak1 = s1.find_last_not_of('\r') != std::string::npos
+            && s1[s1.find_last_not_of('\r')] == '\n';
+    bool lastLineBreak2 = s2.find_last_not_of('\r') != std::string::npos
+            && s2[s2.find_last_not_of('\r')] == '\n';
+    for (int i = 0, size = lines1.size(); i < size; i++) {
+        normalizeLine(lines1[i], i < size - 1 || lastLineBreak1, flags);
+    }
+    for (int i = 0, size = lines2.size(); i < size; i++) {
+        normalizeLine(lines2[i], i < size - 1 || lastLineBreak2, flags);
     }
     if (flags & IGNORE_LINEORDER) {
-        sort(lines1.begin(), lines1.end());
-        sort(lines2.begin(), lines2.end());
-        s1 = stringutils::implode(lines1);
-        s2 = stringutils::implode(lines2);
+        std::sort(lines1.begin(), lines1.end());
+        std::sort(lines2.begin(), lines2.end());
     }
-    if (flags & IGNORE_WHITESPACE) {
-        for (int i = 0; i < lines1.size(); i++) {
-            lines1[i] = stringutils::stripWhitespace(lines1[i]);
+
+    bool equal = stringutils::trimR(stringutils::implode(lines1))
+            == stringutils::trimR(stringutils::implode(lines2));
+
+    if (!equal && (flags & IGNORE_WHITESPACE)) {
+        // whitespace is not considered when comparing the texts as a whole,
+        // only when comparing them line by line
+        for (std::string& line : lines1) {
+            line.erase(std::remove_if(line.begin(), line.end(), ::isspace), line.end());
+            toLowerCaseInPlace(line);
         }
-        for (int i = 0; i < lines2.size(); i++) {
-            lines2[i] = stringutils::stripWhitespace(lines2[i]);
+        for (std::string& line : lines2) {
+            line.erase(std::remove_if(line.begin(), line.end(), ::isspace), line.end());
+            toLowerCaseInPlace(line);
         }
     }
+    return equal;
+}
 
-    if (stringutils::trimR(s1) == stringutils::trimR(s2)) {
-        return NO_DIFFS_MESSAGE;
+/*
+ * Applies the character-level IGNORE_* normalizations to a single line,
+ * in place.  The steps are applied in the same order that they have always
+ * been applied to the entire text, so e.g. the '###' that IGNORE_NUMBERS
+ * leaves behind is then removed by IGNORE_PUNCTUATION.
+ */
+static void normalizeLine(std::string& line, bool trimEnd, int flags) {
+    if (flags & IGNORE_NUMBERS) {
+        // each run of digits -> ###
+        std::string result;
+        result.reserve(line.length() + 8);
+        for (size_t i = 0; i < line.length(); i++) {
+            if (isdigit(line[i])) {
+                result += "###";
+                while (i + 1 < line.length() && isdigit(line[i + 1])) {
+                    i++;
+                }
+            } else {
+                result += line[i];
+            }
+        }
+        line.swap(result);
     }
-
-    // build a reverse-index array using the line as key and line number as value
-    // don't store blank lines, so they won't be targets of the shortest distance
-    // search
-    Map<std::string, Set<int> > reverse1;
-    Map<std::string, Set<int> > reverse2;
-    for (int i = 0; i < lines1.size(); i++) {
-        std::string line = lines1[i];
-        if ((int) line.length() > 0) {
-            reverse1[line].add(i);
+    if (flags & IGNORE_NONNUMBERS) {
+        // each run of non-digits -> a single space
+        std::string result;
+        result.reserve(line.length());
+        for (size_t i = 0; i < line.length(); i++) {
+            if (isdigit(line[i])) {
+                result += line[i];
+            } else {
+                result += ' ';
+                while (i + 1 < line.length() && !isdigit(line[i + 1])) {
+                    i++;
+                }
+            }
         }
+        line.swap(result);
     }
-    for (int i = 0; i < lines2.size(); i++) {
-        std::string line = lines2[i];
-        if ((int) line.length() > 0) {
-            reverse2[line].add(i);
+    if (flags & IGNORE_PUNCTUATION) {
+        line.erase(std::remove_if(line.begin(), line.end(), [](char ch) {
+            return ch != '\0' && strchr(PUNCTUATION_CHARS, ch) != nullptr;
+        }), line.end());
+    }
+    if (flags & IGNORE_AFTERDECIMAL) {
+        // a '.' followed by digits -> .#
+        std::string result;
+        result.reserve(line.length());
+        for (size_t i = 0; i < line.length(); i++) {
+            result += line[i];
+            if (line[i] == '.' && i + 1 < line.length() && isdigit(line[i + 1])) {
+                result += '#';
+                while (i + 1 < line.length() && isdigit(line[i + 1])) {
+                    i++;
+                }
+            }
         }
+        line.swap(result);
+    }
+    if (flags & IGNORE_CASE) {
+        toLowerCaseInPlace(line);
+    }
+    if (flags & IGNORE_CHARORDER) {
+        std::sort(line.begin(), line.end());
+    }
+    if (trimEnd) {
+        trimEndInPlace(line);
     }
+}
 
-    // indexes of current lines within each file
-    // (start at beginning of each list)
-    int index1 = 0;
-    int index2 = 0;
-    Vector<int> actions;
-
-    // walk this loop until we reach the end of one of the lists of lines
-    while (index1 < lines1.size() && index2 < lines2.size()) {
-        // if we have a common line, save it and go to the next
-        if (lines1[index1] == lines2[index2]) {
-            actions += 4;
-            index1++;
-            index2++;
-            continue;
+/*
+ * Maps each distinct line to a small integer id so that the diff algorithm
+ * compares ints rather than strings.
+ */
+static void internLines(const Vector<std::string>& lines1, const Vector<std::string>& lines2,
+                        std::vector<int>& ids1, std::vector<int>& ids2) {
+    HashMap<std::string, int> ids;
+    ids1.reserve(lines1.size());
+    for (const std::string& line : lines1) {
+        if (!ids.containsKey(line)) {
+            ids.put(line, ids.size());
         }
-        // otherwise, find the shortest move (Manhattan-distance) from the
-        // current location
-        int best1 = lines1.size();
-        int best2 = lines2.size();
-        int s1 = index1;
-        int s2 = index2;
-        while ((s1 + s2 - index1 - index2) < (best1 + best2 - index1 - index2)) {
-            int d = -1;
-            if (lines2.size() > s2 && reverse1.containsKey(lines2[s2])) {
-                for (int lineNumber : reverse1[lines2[s2]]) {
-                    if (lineNumber >= s1) {
-                        d = lineNumber;
-                        break;
+        ids1.push_back(ids.get(line));
+    }
+    ids2.reserve(lines2.size());
+    for (const std::string& line : lines2) {
+        if (!ids.containsKey(line)) {
+            ids.put(line, ids.size());
+        }
+        ids2.push_back(ids.get(line));
+    }
+}
+
+/*
+ * Appends to 'actions' a minimal edit script that turns a[0..n) into b[0..m).
+ * Trims the common prefix and suffix, then splits the rest at the middle
+ * snake found by bisect.
+ */
+static void diffLines(const int* a, int n, const int* b, int m, std::vector<int>& actions) {
+    int prefix = 0;
+    while (prefix < n && prefix < m && a[prefix] == b[prefix]) {
+        prefix++;
+    }
+    int suffix = 0;
+    while (suffix < n - prefix && suffix < m - prefix
+           && a[n - 1 - suffix] == b[m - 1 - suffix]) {
+        suffix++;
+    }
+
+    actions.insert(actions.end(), prefix, ACTION_COMMON);
+    int n2 = n - prefix - suffix;
+    int m2 = m - prefix - suffix;
+    if (n2 == 0) {
+        actions.insert(actions.end(), m2, ACTION_ADD);
+    } else if (m2 == 0) {
+        actions.insert(actions.end(), n2, ACTION_DELETE);
+    } else {
+        bisect(a + prefix, n2, b + prefix, m2, actions);
+    }
+    actions.insert(actions.end(), suffix, ACTION_COMMON);
+}
+
+/*
+ * Finds the 'middle snake' of an optimal edit path between a and b by
+ * searching forward from the start and backward from the end at once,
+ * then diffs the two halves recursively.  Uses O(N + M) space per level.
+ * See E. Myers, "An O(ND) Difference Algorithm and Its Variations" (1986).
+ */
+static void bisect(const int* a, int n, const int* b, int m, std::vector<int>& actions) {
+    int maxD = (n + m + 1) / 2;
+    int vOffset = maxD;
+    int vLength = 2 * maxD + 2;
+    std::vector<int> v1(vLength, -1);
+    std::vector<int> v2(vLength, -1);
+    v1[vOffset + 1] = 0;
+    v2[vOffset + 1] = 0;
+    int delta = n - m;
+
+    // if the total number of lines is odd, the front path will collide
+    // with the reverse path; otherwise the reverse path collides
+    bool front = (delta % 2 != 0);
+
+    // offsets for start and end of k loops, to skip out-of-range diagonals
+    int k1start = 0;
+    int k1end = 0;
+    int k2start = 0;
+    int k2end = 0;
+    for (int d = 0; d < maxD; d++) {
+        // walk the front path one step
+        for (int k1 = -d + k1start; k1 <= d - k1end; k1 += 2) {
+            int k1Offset = vOffset + k1;
+            int x1;
+            if (k1 == -d || (k1 != d && v1[k1Offset - 1] < v1[k1Offset + 1])) {
+                x1 = v1[k1Offset + 1];
+            } else {
+                x1 = v1[k1Offset - 1] + 1;
+            }
+            int y1 = x1 - k1;
+            while (x1 < n && y1 < m && a[x1] == b[y1]) {
+                x1++;
+                y1++;
+            }
+            v1[k1Offset] = x1;
+            if (x1 > n) {
+                k1end += 2;   // ran off the right of the graph
+            } else if (y1 > m) {
+                k1start += 2;   // ran off the bottom of the graph
+            } else if (front) {
+                int k2Offset = vOffset + delta - k1;
+                if (k2Offset >= 0 && k2Offset < vLength && v2[k2Offset] != -1) {
+                    // mirror x2 onto top-left coordinate system
+                    int x2 = n - v2[k2Offset];
+                    if (x1 >= x2) {
+                        diffLines(a, x1, b, y1, actions);
+                        diffLines(a + x1, n - x1, b + y1, m - y1, actions);
+                        return;
                     }
                 }
             }
-            if (d >= s1 && (d + s2 - index1 - index2) < (best1 + best2 - index1 - index2)) {
-                best1 = d;
-                best2 = s2;
-            }
+        }
 
-            d = -1;
-            if (lines1.size() > s1 && reverse2.containsKey(lines1[s1])) {
-                for (int lineNumber : reverse2[lines1[s1]]) {
-                    if (lineNumber >= s2) {
-                        d = lineNumber;
-                        break;
+        // walk the reverse path one step
+        for (int k2 = -d + k2start; k2 <= d - k2end; k2 += 2) {
+            int k2Offset = vOffset + k2;
+            int x2;
+            if (k2 == -d || (k2 != d && v2[k2Offset - 1] < v2[k2Offset + 1])) {
+                x2 = v2[k2Offset + 1];
+            } else {
+                x2 = v2[k2Offset - 1] + 1;
+            }
+            int y2 = x2 - k2;
+            while (x2 < n && y2 < m && a[n - x2 - 1] == b[m - y2 - 1]) {
+                x2++;
+                y2++;
+            }
+            v2[k2Offset] = x2;
+            if (x2 > n) {
+                k2end += 2;   // ran off the left of the graph
+            } else if (y2 > m) {
+                k2start += 2;   // ran off the top of the graph
+            } else if (!front) {
+                int k1Offset = vOffset + delta - k2;
+                if (k1Offset >= 0 && k1Offset < vLength && v1[k1Offset] != -1) {
+                    int x1 = v1[k1Offset];
+                    int y1 = vOffset + x1 - k1Offset;
+                    // mirror x2 onto top-left coordinate system
+                    x2 = n - x2;
+                    if (x1 >= x2) {
+                        diffLines(a, x1, b, y1, actions);
+                        diffLines(a + x1, n - x1, b + y1, m - y1, actions);
+                        return;
                     }
                 }
             }
-            if (d >= s2 && (d + s1 - index1 - index2) < (best1 + best2 - index1 - index2)) {
-                best1 = s1;
-                best2 = d;
-            }
-
-            s1++;
-            s2++;
         }
-
-        while (index1 < best1) {
-            actions += 1;
-            index1++;
-        }  // deleted elements
-
-        while (index2 < best2) {
-            actions += 2;
-            index2++;
-        }  // added elements
-    }
-
-    // we've reached the end of one list, now walk to the end of the other
-    while (index1 < lines1.size()) {
-        actions += 1;
-        index1++;
-    }  // deleted elements
-
-    if (flags & IGNORE_TRAILING) {
-        while (index2 < lines2.size()) {
-            actions += 2;
-            index2++;
-        }  // added elements
     }
 
-    // and this marks our ending point
-    actions += 8;
+    // no commonality at all
+    actions.insert(actions.end(), n, ACTION_DELETE);
+    actions.insert(actions.end(), m, ACTION_ADD);
+}
 
+/*
+ * Turns a list of edit actions into the human-readable diff report.
+ */
+static std::string formatDiffs(const std::vector<int>& actions,
+                               const Vector<std::string>& lines1Original,
+                               const Vector<std::string>& lines2Original,
+                               int flags) {
     int op = 0;
     int x0 = 0;
     int x1 = 0;
@@ -205,11 +438,11 @@ std::string diff(std::string s1, std::string s2, int flags) {
     Vector<std::string> out;
 
     for (int action : actions) {
-        if (action == 1) {
+        if (action == ACTION_DELETE) {
             op |= action;
             x1++;
             continue;
-        } else if (action == 2) {
+        } else if (action == ACTION_ADD) {
             op |= action;
             y1++;
             continue;
@@ -266,13 +499,4 @@ std::string diff(std::string s1, std::string s2, int flags) {
     }
 }
 
-bool diffPass(const std::string& s1, const std::string& s2, int flags) {
-    std::string diffs = diff(s1, s2, flags);
-    bool result = trim(diffs) == NO_DIFFS_MESSAGE;
-    return result;
-}
-
-bool isDiffMatch(const std::string& diffs) {
-    return trim(diffs) == NO_DIFFS_MESSAGE;
-}
 } // namespace diff
@@ -4,6 +4,9 @@
  * This file implements the body of each member of the Note class.
  *
  * @author Marty Stepp
+ * @version 2018/10/15
+ * - implemented play using the in-process audio mixer in audio.h
+ * - added getFrequency
  * @version 2017/09/29
  * - updated to use composite hashCode function
  * @version 2016/10/14
@@ -14,11 +17,18 @@
  */
 
 #include "note.h"
+#include <chrono>
+#include <cmath>
 #include <sstream>
+#include <thread>
+#include "audio.h"
 #include "error.h"
 #include "gmath.h"
 #include "hashcode.h"
 
+// volume of a note, low enough that a chord of several notes does not clip
+static const double NOTE_GAIN = 0.3;
+
 // line e.g. "1.5 G 5 NATURAL false"
 Note::Note(std::string line) {
     std::istringstream input(line);
@@ -121,6 +131,18 @@ double Note::getDuration() const {
     return duration;
 }
 
+double Note::getFrequency() const {
+    // semitones above C for pitches A-G
+    static const int SEMITONES[] {9, 11, 0, 2, 4, 5, 7};
+    if (isRest()) {
+        return 0.0;
+    }
+    int semitone = SEMITONES[pitch] + (accidental == SHARP ? 1 : accidental == FLAT ? -1 : 0);
+    // MIDI note number; A 4, number 69, is 440 Hz
+    int number = 12 * (octave + 1) + semitone;
+    return 440.0 * std::pow(2.0, (number - 69) / 12.0);
+}
+
 int Note::getOctave() const {
     return octave;
 }
@@ -143,8 +165,14 @@ void Note::play() const {
         printf("%s\n", toString().c_str());
     }
 #endif // NOTE_DEBUG
-    // TODO
-    // stanfordcpplib::getPlatform()->note_play(toString());
+    if (!isRest()) {
+        audio::play(audio::synthesizeTone(getFrequency(), duration), NOTE_GAIN);
+    }
+    if (audio::isRendering()) {
+        audio::skip(duration);
+    } else {
+        std::this_thread::sleep_for(std::chrono::microseconds((long long) (duration * 1e6)));
+    }
 }
 
 void Note::setAccidental(Note::Accidental accidental) {
@@ -4,6 +4,9 @@
  * This file defines a class named Note that can play musical notes.
  *
  * @author Marty Stepp
+ * @version 2018/10/15
+ * - play synthesizes the note in-process and waits for its duration
+ * - added getFrequency
  * @version 2016/09/26
  * - initial version
  * @since 2016/09/26
@@ -89,6 +92,14 @@ public:
      */
     double getDuration() const;
 
+    /**
+     * Returns the frequency in Hz of this Note's pitch, or 0.0 for a rest.
+     * Octave 4 is the octave that starts at middle C, so A 4 NATURAL is
+     * 440 Hz; each octave doubles the frequency.
+     * @return this Note's frequency in Hz.
+     */
+    double getFrequency() const;
+
     /**
      * Returns this Note's octave.
      * The octave value is meaningless for a rest; this method will return
@@ -118,9 +129,14 @@ public:
     bool isRest() const;
 
     /**
-     * Plays this note through the underlying audio system.
+     * Plays this note through the underlying audio system, and returns once
+     * its duration has passed, so that notes played one after another form
+     * a melody.  A rest plays nothing for its duration.
+     * While audio is being rendered to a file (see audio.h), the note is
+     * added to the file right after the previous one and play returns
+     * immediately.
      * Also may print a message to the system console for debugging.
-     * If the audio system is muted or paused, the note may not play.
+     * If there is no audio output device, the note does not play.
      */
     void play() const;
 
@@ -0,0 +1,332 @@
+/*
+ * File: profile.cpp
+ * -----------------
+ * This file implements the profile.h interface.
+ *
+ * @version 2018/10/15
+ * - initial version
+ * @since 2018/10/15
+ */
+
+#include "profile.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "private/static.h"
+
+namespace profile {
+namespace internal {
+std::atomic<bool> enabled(false);
+}
+
+/*
+ * Implementation notes: histograms
+ * --------------------------------
+ * Times are counted in buckets whose width grows with the time: times under
+ * 16ns get a bucket each, and above that each power of 2 is split into 8
+ * buckets, so a bucket is at most 1/8 as wide as the times in it.
+ *
+ * Each thread has its own histogram for each scope, written only by that
+ * thread.  The counters are atomics only so that dump can read them while
+ * the thread is running; the thread updates them with plain loads and stores,
+ * not with more expensive atomic read-modify-write operations.
+ */
+static const int SUB_BUCKET_BITS = 3;
+static const int LINEAR_BUCKETS = 16;
+static const int BUCKET_COUNT = LINEAR_BUCKETS + (64 - 4) * (1 << SUB_BUCKET_BITS);
+static const int MAX_SCOPES = 256;
+
+struct Histogram {
+    std::atomic<uint64_t> buckets[BUCKET_COUNT];
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> totalNanos;
+    std::atomic<uint64_t> maxNanos;
+};
+
+struct ThreadProfile {
+    std::atomic<Histogram*> histograms[MAX_SCOPES];
+};
+
+/* Private function prototypes */
+
+static void add(std::atomic<uint64_t>& counter, uint64_t amount);
+static int bucketFor(uint64_t nanos);
+static uint64_t bucketMiddle(int bucket);
+static void dumpAtExitJson();
+static void dumpAtExitText();
+static std::string formatNanos(uint64_t nanos);
+static ThreadProfile* getThreadProfile();
+static int highestBit(uint64_t n);
+
+struct ScopeSummary {
+    std::string name;
+    uint64_t count;
+    uint64_t totalNanos;
+    uint64_t maxNanos;
+    uint64_t p50Nanos;
+    uint64_t p99Nanos;
+};
+static std::vector<ScopeSummary> summarize();
+
+static thread_local ThreadProfile* threadProfile = nullptr;
+
+STATIC_VARIABLE_DECLARE_BLANK(std::mutex, registryMutex)
+STATIC_VARIABLE_DECLARE_COLLECTION_EMPTY(std::vector<std::string>, scopeNames)
+STATIC_VARIABLE_DECLARE_COLLECTION_EMPTY(std::vector<ThreadProfile*>, threadProfiles)
+
+void dump(std::ostream& out) {
+    std::vector<ScopeSummary> summaries = summarize();
+    std::ostringstream table;
+    table << std::left << std::setw(36) << "scope" << std::right
+          << std::setw(12) << "count" << std::setw(12) << "p50"
+          << std::setw(12) << "p99" << std::setw(12) << "max"
+          << std::setw(12) << "total" << std::endl;
+    for (const ScopeSummary& summary : summaries) {
+        table << std::left << std::setw(36) << summary.name << std::right
+              << std::setw(12) << summary.count
+              << std::setw(12) << formatNanos(summary.p50Nanos)
+              << std::setw(12) << formatNanos(summary.p99Nanos)
+              << std::setw(12) << formatNanos(summary.maxNanos)
+              << std::setw(12) << formatNanos(summary.totalNanos) << std::endl;
+    }
+    out << table.str() << std::flush;
+}
+
+void dumpAtExit(bool json) {
+    // Statics are destroyed in the reverse order of their construction and
+    // of atexit registration, so the registry must exist before the handler
+    // is registered, or it would be gone by the time the handler runs.
+    STATIC_VARIABLE(registryMutex);
+    STATIC_VARIABLE(scopeNames);
+    STATIC_VARIABLE(threadProfiles);
+    atexit(json ? dumpAtExitJson : dumpAtExitText);
+}
+
+void dumpJson(std::ostream& out) {
+    std::vector<ScopeSummary> summaries = summarize();
+    std::ostringstream json;
+    json << "{\"scopes\": [";
+    for (int i = 0; i < (int) summaries.size(); i++) {
+        const ScopeSummary& summary = summaries[i];
+        json << (i == 0 ? "" : ", ") << "{\"name\": \"";
+        for (char ch : summary.name) {
+            if (ch == '"' || ch == '\\') {
+                json << '\\';
+            }
+            json << ch;
+        }
+        json << "\", \"count\": " << summary.count
+             << ", \"p50Ns\": " << summary.p50Nanos
+             << ", \"p99Ns\": " << summary.p99Nanos
+             << ", \"maxNs\": " << summary.maxNanos
+             << ", \"totalNs\": " << summary.totalNanos << "}";
+    }
+    json << "]}";
+    out << json.str() << std::endl;
+}
+
+bool isEnabled() {
+    return internal::enabled;
+}
+
+void reset() {
+    std::lock_guard<std::mutex> guard(STATIC_VARIABLE(registryMutex));
+    for (ThreadProfile* profile : STATIC_VARIABLE(threadProfiles)) {
+        for (int id = 0; id < MAX_SCOPES; id++) {
+            Histogram* histogram = profile->histograms[id];
+            if (!histogram) {
+                continue;
+            }
+            for (int b = 0; b < BUCKET_COUNT; b++) {
+                histogram->buckets[b] = 0;
+            }
+            histogram->count = 0;
+            histogram->totalNanos = 0;
+            histogram->maxNanos = 0;
+        }
+    }
+}
+
+void setEnabled(bool enabled) {
+    internal::enabled = enabled;
+}
+
+namespace internal {
+int registerScope(const char* name) {
+    std::lock_guard<std::mutex> guard(STATIC_VARIABLE(registryMutex));
+    std::vector<std::string>& names = STATIC_VARIABLE(scopeNames);
+    for (int id = 0; id < (int) names.size(); id++) {
+        if (names[id] == name) {
+            return id;
+        }
+    }
+    if ((int) names.size() >= MAX_SCOPES) {
+        return -1;
+    }
+    names.push_back(name);
+    return (int) names.size() - 1;
+}
+
+void record(int id, long long nanos) {
+    if (nanos < 0) {
+        nanos = 0;
+    }
+    ThreadProfile* profile = threadProfile ? threadProfile : getThreadProfile();
+    Histogram* histogram = profile->histograms[id].load(std::memory_order_relaxed);
+    if (!histogram) {
+        histogram = new Histogram();
+        profile->histograms[id].store(histogram, std::memory_order_release);
+    }
+    add(histogram->buckets[bucketFor((uint64_t) nanos)], 1);
+    add(histogram->count, 1);
+    add(histogram->totalNanos, (uint64_t) nanos);
+    if ((uint64_t) nanos > histogram->maxNanos.load(std::memory_order_relaxed)) {
+        histogram->maxNanos.store((uint64_t) nanos, std::memory_order_relaxed);
+    }
+}
+} // namespace internal
+
+/*
+ * Adds to a counter that only the calling thread writes.
+ */
+static void add(std::atomic<uint64_t>& counter, uint64_t amount) {
+    counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+static int bucketFor(uint64_t nanos) {
+    if (nanos < (uint64_t) LINEAR_BUCKETS) {
+        return (int) nanos;
+    }
+    int exponent = highestBit(nanos);   // at least 4
+    int subBucket = (int) (nanos >> (exponent - SUB_BUCKET_BITS)) & ((1 << SUB_BUCKET_BITS) - 1);
+    return LINEAR_BUCKETS + ((exponent - 4) << SUB_BUCKET_BITS) + subBucket;
+}
+
+/*
+ * Returns the time in the middle of the given bucket's range.
+ */
+static uint64_t bucketMiddle(int bucket) {
+    if (bucket < LINEAR_BUCKETS) {
+        return (uint64_t) bucket;
+    }
+    int exponent = ((bucket - LINEAR_BUCKETS) >> SUB_BUCKET_BITS) + 4;
+    int subBucket = (bucket - LINEAR_BUCKETS) & ((1 << SUB_BUCKET_BITS) - 1);
+    uint64_t width = 1ULL << (exponent - SUB_BUCKET_BITS);
+    uint64_t low = ((uint64_t) ((1 << SUB_BUCKET_BITS) + subBucket)) << (exponent - SUB_BUCKET_BITS);
+    return low + width / 2;
+}
+
+static void dumpAtExitJson() {
+    dumpJson(std::cerr);
+}
+
+static void dumpAtExitText() {
+    dump(std::cerr);
+}
+
+static std::string formatNanos(uint64_t nanos) {
+    std::ostringstream out;
+    out << std::setprecision(3);
+    if (nanos < 1000) {
+        out << nanos << " ns";
+    } else if (nanos < 1000000) {
+        out << nanos / 1e3 << " us";
+    } else if (nanos < 1000000000) {
+        out << nanos / 1e6 << " ms";
+    } else {
+        out << nanos / 1e9 << " s";
+    }
+    return out.str();
+}
+
+static ThreadProfile* getThreadProfile() {
+    // kept after the thread exits, so that its times are still in the dump
+    threadProfile = new ThreadProfile();
+    std::lock_guard<std::mutex> guard(STATIC_VARIABLE(registryMutex));
+    STATIC_VARIABLE(threadProfiles).push_back(threadProfile);
+    return threadProfile;
+}
+
+static int highestBit(uint64_t n) {
+#ifdef __GNUC__
+    return 63 - __builtin_clzll(n);
+#else
+    int bit = 0;
+    while (n >>= 1) {
+        bit++;
+    }
+    return bit;
+#endif // __GNUC__
+}
+
+/*
+ * Combines each scope's histograms from all threads.
+ */
+static std::vector<ScopeSummary> summarize() {
+    std::lock_guard<std::mutex> guard(STATIC_VARIABLE(registryMutex));
+    std::vector<ScopeSummary> summaries;
+    std::vector<uint64_t> buckets(BUCKET_COUNT);
+    const std::vector<std::string>& names = STATIC_VARIABLE(scopeNames);
+    for (int id = 0; id < (int) names.size(); id++) {
+        ScopeSummary summary = {names[id], 0, 0, 0, 0, 0};
+        std::fill(buckets.begin(), buckets.end(), 0);
+        for (ThreadProfile* profile : STATIC_VARIABLE(threadProfiles)) {
+            Histogram* histogram = profile->histograms[id].load(std::memory_order_acquire);
+            if (!histogram) {
+                continue;
+            }
+            for (int b = 0; b < BUCKET_COUNT; b++) {
+                buckets[b] += histogram->buckets[b].load(std::memory_order_relaxed);
+            }
+            summary.count += histogram->count.load(std::memory_order_relaxed);
+            summary.totalNanos += histogram->totalNanos.load(std::memory_order_relaxed);
+            summary.maxNanos = std::max(summary.maxNanos,
+                                        histogram->maxNanos.load(std::memory_order_relaxed));
+        }
+        if (summary.count == 0) {
+            continue;
+        }
+
+        // the counts may be read mid-update, so go by the buckets' own total
+        uint64_t total = 0;
+        for (uint64_t count : buckets) {
+            total += count;
+        }
+        uint64_t seen = 0;
+        bool foundP50 = false;
+        for (int b = 0; b < BUCKET_COUNT; b++) {
+            seen += buckets[b];
+            if (!foundP50 && seen * 100 >= total * 50) {
+                summary.p50Nanos = std::min(bucketMiddle(b), summary.maxNanos);
+                foundP50 = true;
+            }
+            if (seen * 100 >= total * 99) {
+                summary.p99Nanos = std::min(bucketMiddle(b), summary.maxNanos);
+                break;
+            }
+        }
+        summaries.push_back(summary);
+    }
+    return summaries;
+}
+
+/*
+ * Turns on measuring at startup if the SPL_PROFILE environment variable
+ * is set to "text" (or anything else) or "json", and prints the results
+ * in that format at exit.
+ */
+static struct ProfileEnvironment {
+    ProfileEnvironment() {
+        const char* env = getenv("SPL_PROFILE");
+        if (env && env[0]) {
+            setEnabled(true);
+            dumpAtExit(std::string(env) == "json");
+        }
+    }
+} profileEnvironment;
+} // namespace profile
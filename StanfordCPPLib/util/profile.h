@@ -0,0 +1,139 @@
+/*
+ * File: profile.h
+ * ---------------
+ * This file exports the TIMED_SCOPE macro and functions for measuring how
+ * long pieces of code take, with very little overhead, and printing a
+ * summary of the measurements.
+ *
+ *<pre>
+ *    void sortEverything() {
+ *        TIMED_SCOPE("sortEverything");
+ *        ...
+ *    }
+ *</pre>
+ *
+ * Measuring is off until profile::setEnabled(true) is called, or the program
+ * is run with the SPL_PROFILE environment variable set to "text" or "json",
+ * which also prints a summary to cerr when the program exits.
+ * While measuring is off, a TIMED_SCOPE costs one check of a flag, so the
+ * library leaves TIMED_SCOPEs in some of its own frequently used code, such
+ * as growing a Vector or HashMap.
+ *
+ * Each thread records into its own histograms, without locks, so measuring
+ * does not slow down or serialize multithreaded code.
+ *
+ * @version 2018/10/15
+ * - initial version
+ * @since 2018/10/15
+ */
+
+#ifndef _profile_h
+#define _profile_h
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+
+/*
+ * Macro: TIMED_SCOPE
+ * Usage: TIMED_SCOPE("name");
+ * ---------------------------
+ * Measures the time from this statement to the end of the enclosing block
+ * and records it under the given name, which must be a string literal.
+ * Several TIMED_SCOPEs may share a name; their times are combined.
+ */
+#define TIMED_SCOPE(name) \
+    static const int SPL_PROFILE_CONCAT(_timedScopeId, __LINE__) = \
+            ::profile::internal::registerScope(name); \
+    ::profile::internal::ScopeTimer SPL_PROFILE_CONCAT(_timedScope, __LINE__)( \
+            SPL_PROFILE_CONCAT(_timedScopeId, __LINE__))
+
+#define SPL_PROFILE_CONCAT(a, b) SPL_PROFILE_CONCAT_INNER(a, b)
+#define SPL_PROFILE_CONCAT_INNER(a, b) a ## b
+
+namespace profile {
+/*
+ * Prints a table of every named scope recorded so far, with the number of
+ * times it ran and its median (p50), 99th percentile (p99), maximum, and
+ * total time, combined across all threads.
+ * Percentiles are accurate to within about 6%.
+ */
+void dump(std::ostream& out = std::cerr);
+
+/*
+ * Requests that dump or dumpJson be called to print to cerr when the
+ * program exits.
+ */
+void dumpAtExit(bool json = false);
+
+/*
+ * Prints the same information as dump, as a JSON object of the form
+ * {"scopes": [{"name": ..., "count": ..., "p50Ns": ..., "p99Ns": ...,
+ * "maxNs": ..., "totalNs": ...}, ...]}.
+ */
+void dumpJson(std::ostream& out);
+
+/*
+ * Returns true if TIMED_SCOPEs are currently measuring.
+ */
+bool isEnabled();
+
+/*
+ * Discards everything recorded so far.
+ */
+void reset();
+
+/*
+ * Turns measuring by TIMED_SCOPEs on or off.
+ */
+void setEnabled(bool enabled);
+
+namespace internal {
+extern std::atomic<bool> enabled;
+
+/*
+ * Returns the id under which times for the given name are recorded,
+ * or -1 if too many different names have been used.
+ */
+int registerScope(const char* name);
+
+/*
+ * Records one time for the given scope id, for the calling thread.
+ */
+void record(int id, long long nanos);
+
+/*
+ * Records the time from its construction to its destruction, if measuring
+ * was on when it was constructed.
+ */
+class ScopeTimer {
+public:
+    explicit ScopeTimer(int id) {
+        if (id >= 0 && enabled.load(std::memory_order_relaxed)) {
+            this->id = id;
+            start = std::chrono::steady_clock::now();
+        } else {
+            this->id = -1;
+        }
+    }
+
+    ~ScopeTimer() {
+        if (id >= 0) {
+            record(id, (long long) std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - start).count());
+        }
+    }
+
+private:
+    ScopeTimer(const ScopeTimer&) = delete;
+    ScopeTimer& operator =(const ScopeTimer&) = delete;
+
+    int id;
+    std::chrono::steady_clock::time_point start;
+};
+} // namespace internal
+} // namespace profile
+
+#include "private/init.h"   // ensure that Stanford C++ lib is initialized
+
+#endif // _profile_h
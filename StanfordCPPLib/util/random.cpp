@@ -3,6 +3,12 @@
  * ----------------
  * This file implements the random.h interface.
  * 
+ * @version 2018/10/19
+ * - a new thread's engine is split from a master engine, in constant time
+ * @version 2018/10/15
+ * - replaced rand()/srand() with per-thread RandomEngines
+ * - made the autograder feeds thread-safe, and cheap to check when empty
+ * - added randomFill
  * @version 2017/10/05
  * - added randomFeedClear
  * @version 2017/09/28
@@ -19,45 +25,170 @@
  */
 
 #include "random.h"
+#include <atomic>
+#include <chrono>
 #include <cstdlib>
-#include <cmath>
-#include <ctime>
 #include <iostream>
 #include <iomanip>
+#include <mutex>
 #include <queue>
 #include <sstream>
+#include "vector.h"
 #include "private/static.h"
 
-/* Private function prototype */
+/* Private function prototypes */
 
-static void initRandomSeed();
+static void reseedThreadEngine();
+
+/*
+ * Every thread has its own engine.  Seeding works as a hierarchy: one master
+ * engine, seeded from setRandomSeed, RANDOM_SEED, or the clock, is split
+ * to make each thread's engine, so that each thread starts from the master
+ * seed jumped ahead a different number of times.  seedGeneration goes up
+ * whenever the master seed changes, so each thread can notice with one
+ * atomic read and reseed its engine.
+ * These are plain statics rather than STATIC_VARIABLEs because they are read
+ * on every call; atomics and thread_locals with constant initial values are
+ * safe to use during static initialization anyway.
+ */
+static std::atomic<unsigned int> seedGeneration(1);
+static thread_local unsigned int threadSeedGeneration = 0;
+static thread_local RandomEngine threadEngine;
+
+STATIC_VARIABLE_DECLARE_BLANK(std::mutex, seedMutex)
+STATIC_VARIABLE_DECLARE_BLANK(RandomEngine, masterEngine)   // the next thread's engine
+STATIC_VARIABLE_DECLARE(bool, masterSeedSet, false)
 
 /* internal buffer of fixed random numbers to return; used by autograders */
 STATIC_VARIABLE_DECLARE_COLLECTION_EMPTY(std::queue<bool>, fixedBools)
 STATIC_VARIABLE_DECLARE_COLLECTION_EMPTY(std::queue<int>, fixedInts)
 STATIC_VARIABLE_DECLARE_COLLECTION_EMPTY(std::queue<double>, fixedReals)
+STATIC_VARIABLE_DECLARE_BLANK(std::mutex, fixedMutex)
+
+// total size of the queues above, so that the usual case of nothing fed
+// costs one atomic read rather than a lock
+static std::atomic<int> fixedCount(0);
 
 namespace autograder {
 void randomFeedBool(bool value) {
+    std::lock_guard<std::mutex> guard(STATIC_VARIABLE(fixedMutex));
     STATIC_VARIABLE(fixedBools).push(value);
+    fixedCount++;
 }
 
 void randomFeedClear() {
+    std::lock_guard<std::mutex> guard(STATIC_VARIABLE(fixedMutex));
     STATIC_VARIABLE(fixedBools) = std::queue<bool>();
     STATIC_VARIABLE(fixedInts) = std::queue<int>();
     STATIC_VARIABLE(fixedReals) = std::queue<double>();
+    fixedCount = 0;
 }
 
 void randomFeedInteger(int value) {
+    std::lock_guard<std::mutex> guard(STATIC_VARIABLE(fixedMutex));
     STATIC_VARIABLE(fixedInts).push(value);
+    fixedCount++;
 }
 
 void randomFeedReal(double value) {
+    std::lock_guard<std::mutex> guard(STATIC_VARIABLE(fixedMutex));
     STATIC_VARIABLE(fixedReals).push(value);
+    fixedCount++;
+}
 }
+
+/*
+ * Removes the next value from the given fed queue and stores it into value.
+ * Returns false, leaving value unchanged, if the queue is empty.
+ * Callers check fixedCount first to skip this in the usual case.
+ */
+template <typename T>
+static bool popFixed(std::queue<T>& queue, T& value) {
+    std::lock_guard<std::mutex> guard(STATIC_VARIABLE(fixedMutex));
+    if (queue.empty()) {
+        return false;
+    }
+    value = queue.front();
+    queue.pop();
+    fixedCount--;
+    return true;
 }
 /* end 'fixed' internal stuff */
 
+/*
+ * Implementation notes: RandomEngine
+ * ----------------------------------
+ * The seed is spread over the 256 bits of state by the SplitMix64
+ * generator, as recommended by the authors of xoshiro256**; this also
+ * guarantees that the state is not all zero, which xoshiro cannot leave.
+ */
+RandomEngine::RandomEngine(uint64_t seed) {
+    this->seed(seed);
+}
+
+void RandomEngine::jump() {
+    static const uint64_t JUMP[] = {
+        0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+        0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL
+    };
+    uint64_t s[4] = {0, 0, 0, 0};
+    for (uint64_t bits : JUMP) {
+        for (int bit = 0; bit < 64; bit++) {
+            if (bits & (1ULL << bit)) {
+                for (int i = 0; i < 4; i++) {
+                    s[i] ^= state[i];
+                }
+            }
+            next();
+        }
+    }
+    for (int i = 0; i < 4; i++) {
+        state[i] = s[i];
+    }
+}
+
+bool RandomEngine::nextBool() {
+    return (next() >> 63) != 0;
+}
+
+bool RandomEngine::nextChance(double p) {
+    return nextReal(0, 1) < p;
+}
+
+double RandomEngine::nextReal(double low, double high) {
+    // the top 53 bits fill a double's mantissa exactly
+    double d = (next() >> 11) * (1.0 / 9007199254740992.0);
+    return low + d * (high - low);
+}
+
+void RandomEngine::seed(uint64_t seed) {
+    for (int i = 0; i < 4; i++) {
+        seed += 0x9e3779b97f4a7c15ULL;
+        uint64_t z = seed;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        state[i] = z ^ (z >> 31);
+    }
+}
+
+RandomEngine RandomEngine::split() {
+    RandomEngine copy = *this;
+    jump();
+    return copy;
+}
+
+// used within this file instead of getRandomEngine so that it is inlined
+static inline RandomEngine& threadRandomEngine() {
+    if (threadSeedGeneration != seedGeneration.load(std::memory_order_acquire)) {
+        reseedThreadEngine();
+    }
+    return threadEngine;
+}
+
+RandomEngine& getRandomEngine() {
+    return threadRandomEngine();
+}
+
 bool randomBool() {
     return randomChance(0.5);
 }
@@ -65,27 +196,27 @@ bool randomBool() {
 /*
  * Implementation notes: randomChance
  * ----------------------------------
- * The code for randomChance calls randomReal(0, 1) and then checks
- * whether the result is less than the requested probability.
+ * As before, a fed real number r is used as if it were the random number
+ * in [0 .. 1) that is compared against p.
  */
 bool randomChance(double p) {
-    if (!STATIC_VARIABLE(fixedBools).empty()) {
-        bool top = STATIC_VARIABLE(fixedBools).front();
-        STATIC_VARIABLE(fixedBools).pop();
-        return top;
+    bool fixedBool;
+    if (fixedCount > 0 && popFixed(STATIC_VARIABLE(fixedBools), fixedBool)) {
+        return fixedBool;
+    }
+    double fixedReal;
+    if (fixedCount > 0 && popFixed(STATIC_VARIABLE(fixedReals), fixedReal)) {
+        return fixedReal < p;
     }
-    initRandomSeed();
-    return randomReal(0, 1) < p;
+    return threadRandomEngine().nextChance(p);
 }
 
 int randomColor() {
-    if (!STATIC_VARIABLE(fixedInts).empty()) {
-        int top = STATIC_VARIABLE(fixedInts).front();
-        STATIC_VARIABLE(fixedInts).pop();
-        return top & 0x00ffffff;
+    int fixedInt;
+    if (fixedCount > 0 && popFixed(STATIC_VARIABLE(fixedInts), fixedInt)) {
+        return fixedInt & 0x00ffffff;
     }
-    initRandomSeed();
-    return rand() & 0x00ffffff;
+    return (int) (threadRandomEngine().next() >> 40);
 }
 
 // see convertRGBToColor in gcolor.h (repeated here to avoid Qt dependency)
@@ -99,31 +230,52 @@ std::string randomColorString() {
     return os.str();
 }
 
+void randomFill(Vector<int>& v, int low, int high) {
+    int n = v.size();
+    if (n == 0) {
+        return;
+    }
+    if (fixedCount > 0) {
+        for (int i = 0; i < n; i++) {
+            v[i] = randomInteger(low, high);
+        }
+        return;
+    }
+    RandomEngine& engine = threadRandomEngine();
+    int* data = &v[0];
+    for (int i = 0; i < n; i++) {
+        data[i] = engine.nextInteger(low, high);
+    }
+}
+
+void randomFill(Vector<double>& v, double low, double high) {
+    int n = v.size();
+    if (n == 0) {
+        return;
+    }
+    if (fixedCount > 0) {
+        for (int i = 0; i < n; i++) {
+            v[i] = randomReal(low, high);
+        }
+        return;
+    }
+    RandomEngine& engine = threadRandomEngine();
+    double* data = &v[0];
+    for (int i = 0; i < n; i++) {
+        data[i] = engine.nextReal(low, high);
+    }
+}
+
 /*
  * Implementation notes: randomInteger
  * -----------------------------------
- * The code for randomInteger produces the number in four steps:
- *
- * 1. Generate a random real number d in the range [0 .. 1).
- * 2. Scale the number to the range [0 .. N) where N is the number of values.
- * 3. Translate the number so that the range starts at the appropriate value.
- * 4. Convert the result to the next lower integer.
- *
- * The implementation is complicated by the fact that both the expression
- *
- *     RAND_MAX + 1
- *
- * and the expression for the number of values
- *
- *     high - low + 1
- *
- * can overflow the integer range.  These calculations must therefore be
- * performed using doubles instead of ints.
+ * See RandomEngine::nextInteger in random.h.  The old approach of scaling
+ * a random double made some values slightly more likely than others
+ * whenever the range size did not evenly divide RAND_MAX + 1.
  */
 int randomInteger(int low, int high) {
-    if (!STATIC_VARIABLE(fixedInts).empty()) {
-        int top = STATIC_VARIABLE(fixedInts).front();
-        STATIC_VARIABLE(fixedInts).pop();
+    int top;
+    if (fixedCount > 0 && popFixed(STATIC_VARIABLE(fixedInts), top)) {
         if (top < low || top > high) {
             // make sure the value is in the given range
             // (assumes that low/high don't overflow int range)
@@ -132,53 +284,54 @@ int randomInteger(int low, int high) {
         }
         return top;
     }
-    initRandomSeed();
-    double d = rand() / (double(RAND_MAX) + 1);
-    double s = d * (double(high) - low + 1);
-    return int(floor(low + s));
+    return threadRandomEngine().nextInteger(low, high);
 }
 
-/*
- * Implementation notes: randomReal
- * --------------------------------
- * The code for randomReal is similar to that for randomInteger,
- * without the final conversion step.
- */
 double randomReal(double low, double high) {
-    if (!STATIC_VARIABLE(fixedReals).empty()) {
-        double top = STATIC_VARIABLE(fixedReals).front();
-        STATIC_VARIABLE(fixedReals).pop();
+    double top;
+    if (fixedCount > 0 && popFixed(STATIC_VARIABLE(fixedReals), top)) {
         return top;
     }
-    initRandomSeed();
-    double d = rand() / (double(RAND_MAX) + 1);
-    double s = d * (high - low);
-    return low + s;
+    return threadRandomEngine().nextReal(low, high);
 }
 
 /*
  * Implementation notes: setRandomSeed
  * -----------------------------------
- * The setRandomSeed function simply forwards its argument to srand.
- * The call to initRandomSeed is required to set the initialized flag.
+ * Changes the master seed and then reseeds the calling thread's engine
+ * right away, so that it gets the first sequence for the new seed.
  */
 void setRandomSeed(int seed) {
-    initRandomSeed();
-    srand(seed);
+    {
+        std::lock_guard<std::mutex> guard(STATIC_VARIABLE(seedMutex));
+        STATIC_VARIABLE(masterEngine).seed((uint64_t) (unsigned int) seed);
+        STATIC_VARIABLE(masterSeedSet) = true;
+        seedGeneration++;
+    }
+    reseedThreadEngine();
 }
 
 /*
- * Implementation notes: initRandomSeed
- * ------------------------------------
- * The initRandomSeed function declares a static variable that keeps track
- * of whether the seed has been initialized.  The first time initRandomSeed
- * is called, initialized is false, so the seed is set to the current time.
+ * Implementation notes: reseedThreadEngine
+ * ----------------------------------------
+ * Gives the calling thread a copy of the master engine and jumps the master
+ * ahead, so that each thread seeded gets the master seed's sequence jumped
+ * once more than the thread before it and no two threads' sequences
+ * overlap.  The first time this is called, the master engine is seeded from
+ * the RANDOM_SEED environment variable or the clock.
  */
-static void initRandomSeed() {
-    static bool _initialized = false;
-    if (!_initialized) {
-        srand(int(time(nullptr)));
-        rand();   // BUGFIX: throwaway call to get randomness going
-        _initialized = true;
+static void reseedThreadEngine() {
+    std::lock_guard<std::mutex> guard(STATIC_VARIABLE(seedMutex));
+    if (!STATIC_VARIABLE(masterSeedSet)) {
+        const char* env = getenv("RANDOM_SEED");
+        if (env) {
+            STATIC_VARIABLE(masterEngine).seed((uint64_t) (unsigned int) atoi(env));
+        } else {
+            STATIC_VARIABLE(masterEngine).seed((uint64_t)
+                    std::chrono::high_resolution_clock::now().time_since_epoch().count());
+        }
+        STATIC_VARIABLE(masterSeedSet) = true;
     }
+    threadEngine = STATIC_VARIABLE(masterEngine).split();
+    threadSeedGeneration = seedGeneration;
 }
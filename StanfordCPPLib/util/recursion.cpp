@@ -1,8 +1,63 @@
 #include "recursion.h"
+#include <unordered_map>
 #include "exceptions.h"
 #include "call_stack.h"
 
+#ifndef _WIN32
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <stdlib.h>
+#endif // _WIN32
+
+thread_local int RecursionScope::_depth = 0;
+
+#ifndef _WIN32
+namespace {
+/*
+ * Returns the name of the function containing the given return address,
+ * or "" if that function should not be counted.
+ * Each address is looked up once per thread and then cached.
+ */
+const std::string& getFunctionForRecursion(void* returnAddress) {
+    // one cache per thread, so that no locking is needed
+    static thread_local std::unordered_map<void*, std::string> cache;
+    auto itr = cache.find(returnAddress);
+    if (itr != cache.end()) {
+        return itr->second;
+    }
+
+    // a return address points just past the call, so look up the call itself
+    stacktrace::symbol_info info;
+    stacktrace::symbolize((void*) ((char*) returnAddress - 1), info);
+    std::string function = info.function;
+    Dl_info dlinfo;
+    if (function.empty() && dladdr(returnAddress, &dlinfo) && dlinfo.dli_sname) {
+        int status;
+        char* demangled = abi::__cxa_demangle(dlinfo.dli_sname, /* buffer */ nullptr,
+                                              /* length pointer */ nullptr, &status);
+        function = (status == 0 && demangled) ? demangled : dlinfo.dli_sname;
+        if (demangled) {
+            free(demangled);
+        }
+    }
+
+    if (exceptions::shouldFilterOutFromStackTrace(function)
+            || function.find("recursionIndent(") != std::string::npos
+            || function.find("getRecursionIndentLevel(") != std::string::npos) {
+        function = "";
+    }
+    return cache[returnAddress] = function;
+}
+} // namespace
+#endif // _WIN32
+
 int getRecursionIndentLevel() {
+    if (RecursionScope::getDepth() > 0) {
+        return RecursionScope::getDepth();
+    }
+
+#ifdef _WIN32
     // constructing the following object jumps into fancy code in call_stack_gcc/windows.cpp
     // to rebuild the stack trace; implementation differs for each operating system
     stacktrace::call_stack trace;
@@ -26,11 +81,38 @@ int getRecursionIndentLevel() {
         }
     }
     return currentFunctionCount;
+#else
+    // only the raw return addresses are needed to count calls, not the
+    // file and line numbers that a full stacktrace::call_stack looks up
+    const int MAX_FRAMES = 64;
+    void* trace[MAX_FRAMES];
+    int frames = backtrace(trace, MAX_FRAMES);
+
+    const std::string* currentFunction = nullptr;
+    int currentFunctionCount = 0;
+    for (int i = 0; i < frames; i++) {
+        const std::string& function = getFunctionForRecursion(trace[i]);
+        if (function.empty()) {
+            continue;
+        } else if (!currentFunction) {
+            currentFunction = &function;
+            currentFunctionCount = 1;
+        } else if (function == *currentFunction) {
+            currentFunctionCount++;
+        } else {
+            break;
+        }
+    }
+    return currentFunctionCount;
+#endif // _WIN32
 }
 
 std::string recursionIndent(const std::string& indenter) {
     int indent = getRecursionIndentLevel();
-    std::string result = "";
+    std::string result;
+    if (indent > 1) {
+        result.reserve(indenter.length() * (indent - 1));
+    }
     for (int i = 0; i < indent - 1; i++) {
         result += indenter;
     }
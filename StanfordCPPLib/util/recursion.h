@@ -6,6 +6,9 @@
  * to the level of recursion you are currently nested in.
  *
  * @author Marty Stepp
+ * @version 2018/10/15
+ * - added RecursionScope for constant-time depth tracking
+ * - getRecursionIndentLevel no longer builds a full stack trace with line numbers
  * @version 2016/10/30
  * - initial version (extracted from exceptions.h)
  */
@@ -15,13 +18,61 @@
 
 #include <string>
 
+/*
+ * Class: RecursionScope
+ * ---------------------
+ * Declaring a RecursionScope at the top of a recursive function makes
+ * getRecursionIndentLevel and recursionIndent take constant time.
+ * While any RecursionScope exists on the current thread, they return the
+ * number that exist, which is how many calls deep you are, rather than
+ * examining the call stack.
+ *
+ * Usage example:
+ *
+ * <pre>
+ *     int fib(int n) {
+ *         RecursionScope scope;
+ *         cout << recursionIndent() << "fib(" << n << ")" << endl;
+ *         ...
+ *     }
+ * </pre>
+ */
+class RecursionScope {
+public:
+    RecursionScope() {
+        _depth++;
+    }
+
+    ~RecursionScope() {
+        _depth--;
+    }
+
+    /*
+     * Returns the number of RecursionScope objects that currently exist
+     * on the calling thread.
+     */
+    static int getDepth() {
+        return _depth;
+    }
+
+private:
+    RecursionScope(const RecursionScope&) = delete;
+    RecursionScope& operator =(const RecursionScope&) = delete;
+
+    static thread_local int _depth;
+};
+
 /*
  * Returns number of calls deep we are in the current recursive function.
  * For example, if f() calls f() calls f(), this function returns 3.
  *
- * NOTE: Doesn't usually work when used with 'static' functions, because their names
- * are not exported or revealed to the internal stack trace grabber.
- * So if you want to use this function, make your function non-static.
+ * If the function declares a RecursionScope, this just returns the number of
+ * RecursionScopes.  Otherwise it counts the calls on the stack, which is
+ * slower and sees only about the top 60 calls.
+ *
+ * NOTE: Without a RecursionScope, on some platforms this doesn't usually work
+ * with 'static' functions, because their names are not exported or revealed
+ * to the internal stack trace grabber.
  */
 int getRecursionIndentLevel();
 
@@ -30,9 +81,8 @@ int getRecursionIndentLevel();
  * at their corresponding level of nesting.
  * Indents by 4 spaces per level but can be overridden by passing 'indenter' param.
  *
- * NOTE: Doesn't usually work when used with static functions, because their names
- * are not exported or revealed to the internal stack trace grabber.
- * So if you want to use this function, make your function non-static.
+ * NOTE: See getRecursionIndentLevel about using a RecursionScope to make this
+ * faster, and about static functions.
  */
 std::string recursionIndent(const std::string& indenter = "    ");
 
@@ -5,6 +5,13 @@
  * See regexpr.h for documentation of each function.
  *
  * @author Marty Stepp
+ * @version 2018/10/15
+ * - regexMatch, regexMatchCount, and regexMatchCountWithLines use the
+ *   linear-time matcher in private/regexengine.h for the patterns it supports
+ * @version 2018/10/05
+ * - compiled regexes are kept in a thread-safe LRU cache rather than being
+ *   recompiled on every call
+ * - regexMatchCountWithLines looks up line numbers in a newline index
  * @version 2015/07/05
  * - removed static global Platform variable, replaced by getPlatform as needed
  * @version 2014/10/14
@@ -15,20 +22,119 @@
  */
 
 #include "regexpr.h"
+#include <algorithm>
+#include <atomic>
 #include <iterator>
+#include <list>
+#include <memory>
+#include <mutex>
 #include <regex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 #include "error.h"
 #include "stringutils.h"
+#include "private/regexengine.h"
+
+namespace {
+
+std::atomic<bool> linearMatchingEnabled(true);
+
+/*
+ * A compiled pattern: the std::regex, plus the linear-time matcher if the
+ * pattern is one that it supports.
+ */
+struct CompiledRegex {
+    std::regex regex;
+    stanfordcpplib::LinearRegex linear;
+    bool ecmaScript;
+
+    CompiledRegex(const std::string& regexp, std::regex::flag_type flags)
+            : regex(regexp, flags),   // throws std::regex_error on bad syntax
+              linear(regexp),
+              ecmaScript(flags == std::regex::ECMAScript) {
+        // empty
+    }
+
+    bool useLinear() const {
+        return ecmaScript && linear.isSupported() && linearMatchingEnabled;
+    }
+};
+
+/*
+ * A small least-recently-used cache of compiled regexes, keyed by the pattern
+ * text and its syntax flags.  Compiling a std::regex is far more expensive
+ * than most searches with it, and callers such as stylecheck use the same
+ * few dozen patterns over and over.
+ * Entries are handed out as shared_ptrs, so a regex that gets evicted while
+ * another thread is still matching with it stays alive until that finishes.
+ */
+class RegexCache {
+public:
+    typedef std::shared_ptr<const CompiledRegex> RegexPtr;
+
+    static RegexCache& instance() {
+        static RegexCache cache;
+        return cache;
+    }
+
+    RegexPtr get(const std::string& regexp,
+                 std::regex::flag_type flags = std::regex::ECMAScript) {
+        std::string key = std::to_string((long) flags) + ":" + regexp;
+        {
+            std::lock_guard<std::mutex> guard(_mutex);
+            auto it = _index.find(key);
+            if (it != _index.end()) {
+                // move to front of LRU list
+                _entries.splice(_entries.begin(), _entries, it->second);
+                return it->second->second;
+            }
+        }
+
+        // compile outside the lock; may throw std::regex_error on bad syntax
+        RegexPtr reg = std::make_shared<const CompiledRegex>(regexp, flags);
+
+        std::lock_guard<std::mutex> guard(_mutex);
+        auto it = _index.find(key);
+        if (it != _index.end()) {
+            // another thread compiled it meanwhile
+            return it->second->second;
+        }
+        _entries.push_front(std::make_pair(key, reg));
+        _index[key] = _entries.begin();
+        if ((int) _entries.size() > CAPACITY) {
+            _index.erase(_entries.back().first);
+            _entries.pop_back();
+        }
+        return reg;
+    }
+
+private:
+    static const int CAPACITY = 256;
+
+    std::list<std::pair<std::string, RegexPtr> > _entries;   // most recent first
+    std::unordered_map<std::string, std::list<std::pair<std::string, RegexPtr> >::iterator> _index;
+    std::mutex _mutex;
+};
+
+} // namespace
 
 bool regexMatch(const std::string& s, const std::string& regexp) {
-    std::regex reg(regexp);
-    std::smatch match;
-    return std::regex_search(s, match, reg);
+    RegexCache::RegexPtr reg = RegexCache::instance().get(regexp);
+    if (reg->useLinear()) {
+        return reg->linear.search(s);
+    }
+    return std::regex_search(s, reg->regex);
 }
 
 int regexMatchCount(const std::string& s, const std::string& regexp) {
-    std::regex reg(regexp);
-    auto it1 = std::sregex_iterator(s.begin(), s.end(), reg);
+    RegexCache::RegexPtr reg = RegexCache::instance().get(regexp);
+    if (reg->useLinear()) {
+        std::vector<int> matchStarts;
+        reg->linear.findAll(s, matchStarts);
+        return (int) matchStarts.size();
+    }
+    auto it1 = std::sregex_iterator(s.begin(), s.end(), reg->regex);
     auto it2 = std::sregex_iterator();
     return std::distance(it1, it2);
 }
@@ -52,31 +158,46 @@ void regexMatchCountWithLines(const std::string& s, const std::string& regexp,
                              Vector<int>& linesOut) {
     linesOut.clear();
 
-    // keep a running index and line#, and each time we find a regex match,
-    // "walk" forward to its index.  when we see a \n, increment line number
-    int currentIndex = 0;
-    int currentLine = 1;
+    // index the start of each line once, then binary-search it for each match
+    std::vector<int> newlines;
+    for (int i = 0, len = (int) s.length(); i < len; i++) {
+        if (s[i] == '\n') {
+            newlines.push_back(i);
+        }
+    }
 
     // get all regex matches by character position/index
-    std::regex reg(regexp);
-    for (std::sregex_iterator itr = std::sregex_iterator(s.begin(), s.end(), reg),
-            end = std::sregex_iterator();
-            itr != end;
-            ++itr) {
-        std::smatch match = *itr;
-        int matchIndex = (int) match.position();
-        while (currentIndex < (int) s.length() && currentIndex < matchIndex) {
-            if (s[currentIndex] == '\n') {
-                currentLine++;
-            }
-            currentIndex++;
+    RegexCache::RegexPtr reg = RegexCache::instance().get(regexp);
+    std::vector<int> matchStarts;
+    if (reg->useLinear()) {
+        reg->linear.findAll(s, matchStarts);
+    } else {
+        for (std::sregex_iterator itr = std::sregex_iterator(s.begin(), s.end(), reg->regex),
+                end = std::sregex_iterator();
+                itr != end;
+                ++itr) {
+            matchStarts.push_back((int) itr->position());
         }
-        linesOut.add(currentLine);
     }
+    for (int matchIndex : matchStarts) {
+        // line number = 1 + number of newlines before the match
+        int line = 1 + (int) (std::lower_bound(newlines.begin(), newlines.end(), matchIndex)
+                              - newlines.begin());
+        linesOut.add(line);
+    }
+}
+
+void setRegexLinearMatchingEnabled(bool enabled) {
+    linearMatchingEnabled = enabled;
+}
+
+bool isRegexLinearMatchingEnabled() {
+    return linearMatchingEnabled;
 }
 
 std::string regexReplace(const std::string& s, const std::string& regexp, const std::string& replacement, int limit) {
-    std::regex reg(regexp);
+    RegexCache::RegexPtr regPtr = RegexCache::instance().get(regexp);
+    const std::regex& reg = regPtr->regex;
     std::string result;
     if (limit == 1) {
         // replace single occurrence
@@ -12,6 +12,8 @@
  * Using Java's is a compromise for now.
  *
  * @author Marty Stepp
+ * @version 2018/10/15
+ * - added setRegexLinearMatchingEnabled, isRegexLinearMatchingEnabled
  * @version 2014/10/14
  * - removed regexMatchCountWithLines for simplicity
  * @since 2014/03/01
@@ -50,6 +52,21 @@ int regexMatchCountWithLines(const std::string& s, const std::string& regexp,
 void regexMatchCountWithLines(const std::string& s, const std::string& regexp,
                               Vector<int>& linesOut);
 
+/*
+ * Sets whether regexMatch, regexMatchCount, and regexMatchCountWithLines may
+ * use the library's own linear-time matcher for the patterns it supports
+ * (the default), rather than always using std::regex, whose backtracking can
+ * take exponential time on patterns such as "(a|aa)*b".  Both find the same
+ * matches; turning this off is mainly useful for comparing the two.
+ */
+void setRegexLinearMatchingEnabled(bool enabled);
+
+/*
+ * Returns whether the linear-time matcher may be used
+ * (see setRegexLinearMatchingEnabled).
+ */
+bool isRegexLinearMatchingEnabled();
+
 /*
  * Replaces occurrences of the given regular expression in s with the given
  * replacement text, and returns the resulting string.
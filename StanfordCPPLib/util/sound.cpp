@@ -3,6 +3,8 @@
  * ---------------
  * Implementation of the Sound class.
  * 
+ * @version 2018/10/15
+ * - implemented using the in-process audio mixer in audio.h
  * @version 2015/07/05
  * - removed static global Platform variable, replaced by getPlatform as needed
  * @version 2014/10/08
@@ -11,19 +13,22 @@
  */
 
 #include "sound.h"
+#include "filelib.h"
 
-Sound::Sound(std::string /*filename*/) {
-    // TODO
-    // stanfordcpplib::getPlatform()->sound_constructor(this, filename);
+Sound::Sound(std::string filename) {
+    if (filename.empty()) {
+        return;
+    }
+    if (!fileExists(filename) && fileExists("sounds/" + filename)) {
+        filename = "sounds/" + filename;
+    }
+    samples = audio::readWavFile(filename);
 }
 
 Sound::~Sound() {
-    // TODO
-    // stanfordcpplib::getPlatform()->sound_delete(this);
+    // a sound that is still playing keeps its own reference to the samples
 }
 
 void Sound::play() {
-    // TODO
-    // stanfordcpplib::getPlatform()->sound_play(this);
+    audio::play(samples);
 }
-
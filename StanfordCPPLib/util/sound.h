@@ -2,12 +2,18 @@
  * File: sound.h
  * -------------
  * This file defines a class that represents a sound.
+ *
+ * @version 2018/10/15
+ * - implemented reading and playing WAV files with the in-process audio
+ *   mixer in audio.h
  */
 
 #ifndef _sound_h
 #define _sound_h
 
+#include <memory>
 #include <string>
+#include "audio.h"
 
 /*
  * Class: Sound
@@ -16,6 +22,9 @@
  * constructor and must be a file in either the current directory or a
  * subdirectory named <code>sounds</code>.
  *
+ * <p>The file must be a WAV file; see audio::readWavFile for the formats
+ * that can be read.
+ *
  * <p>The following code, for example, plays the sound file
  * <code>ringtone.wav</code>:
  *
@@ -34,9 +43,9 @@ public:
      * Creates a <code>Sound</code> object.  The default constructor
      * creates an empty sound that cannot be played.  The second form
      * initializes the sound by reading in the contents of the specified
-     * file.
+     * file, and signals an error if it cannot be read.
      */
-    Sound(std::string filename);
+    Sound(std::string filename = "");
 
     /*
      * Destructor: ~Sound
@@ -50,9 +59,17 @@ public:
      * Usage: sound.play();
      * --------------------
      * Starts playing the sound.  This call returns immediately without waiting
-     * for the sound to finish.
+     * for the sound to finish.  The same sound may be played again while it
+     * is still playing; the two are mixed together.
      */
     void play();
+
+/**********************************************************************/
+/* Note: Everything below this point in this class is logically part  */
+/* of the implementation and should not be of interest to clients.    */
+/**********************************************************************/
+private:
+    std::shared_ptr<const audio::Samples> samples;   // null if empty
 };
 
 #include "private/init.h"   // ensure that Stanford C++ lib is initialized
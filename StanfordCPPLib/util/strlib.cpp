@@ -3,6 +3,13 @@
  * ----------------
  * This file implements the strlib.h interface.
  * 
+ * @version 2018/10/19
+ * - StringSplitter can split a buffer of 2 GB or more
+ * @version 2018/10/02
+ * - added StringView, stringSplitView and StringSplitter
+ * - stringSplit no longer erases from the front of a copy (was O(N^2))
+ * - stringJoin, stringReplaceInPlace, htmlEncode/Decode and urlEncode/Decode
+ *   now build their output in a single pass into a pre-sized string
  * @version 2018/09/02
  * - added padLeft, padRight
  * @version 2017/10/24
@@ -37,7 +44,9 @@
  */
 
 #include "strlib.h"
+#include <algorithm>
 #include <cctype>
+#include <climits>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
@@ -104,20 +113,57 @@ bool equalsIgnoreCase(const std::string& s1, const std::string& s2) {
 }
 
 std::string htmlDecode(const std::string& s) {
-    std::string result = s;
-    stringReplaceInPlace(result, "&lt;", "<");
-    stringReplaceInPlace(result, "&gt;", ">");
-    stringReplaceInPlace(result, "&quot;", "\"");
-    stringReplaceInPlace(result, "&amp;", "&");
+    std::string result;
+    result.reserve(s.length());
+    for (size_t i = 0, len = s.length(); i < len; i++) {
+        if (s[i] == '&') {
+            if (s.compare(i, 4, "&lt;") == 0) {
+                result += '<';
+                i += 3;
+                continue;
+            } else if (s.compare(i, 4, "&gt;") == 0) {
+                result += '>';
+                i += 3;
+                continue;
+            } else if (s.compare(i, 6, "&quot;") == 0) {
+                result += '"';
+                i += 5;
+                continue;
+            } else if (s.compare(i, 5, "&amp;") == 0) {
+                result += '&';
+                i += 4;
+                continue;
+            }
+        }
+        result += s[i];
+    }
     return result;
 }
 
 std::string htmlEncode(const std::string& s) {
-    std::string result = s;
-    stringReplaceInPlace(result, "&", "&amp;");
-    stringReplaceInPlace(result, "<", "&lt;");
-    stringReplaceInPlace(result, ">", "&gt;");
-    stringReplaceInPlace(result, "\"", "&quot;");
+    // size the result exactly so that it is allocated only once
+    size_t length = s.length();
+    for (char ch : s) {
+        switch (ch) {
+        case '&':  length += 4; break;   // &amp;
+        case '<':                        // &lt;
+        case '>':  length += 3; break;   // &gt;
+        case '"':  length += 5; break;   // &quot;
+        default:   break;
+        }
+    }
+
+    std::string result;
+    result.reserve(length);
+    for (char ch : s) {
+        switch (ch) {
+        case '&':  result += "&amp;"; break;
+        case '<':  result += "&lt;"; break;
+        case '>':  result += "&gt;"; break;
+        case '"':  result += "&quot;"; break;
+        default:   result += ch; break;
+        }
+    }
     return result;
 }
 
@@ -286,15 +332,19 @@ std::string stringJoin(const std::vector<std::string>& v, char delimiter) {
 std::string stringJoin(const std::vector<std::string>& v, const std::string& delimiter) {
     if (v.empty()) {
         return "";
-    } else {
-        std::ostringstream out;
-        out << v[0];
-        for (int i = 1; i < (int) v.size(); i++) {
-            out << delimiter;
-            out << v[i];
-        }
-        return out.str();
     }
+    size_t length = delimiter.length() * (v.size() - 1);
+    for (const std::string& s : v) {
+        length += s.length();
+    }
+    std::string result;
+    result.reserve(length);
+    result += v[0];
+    for (int i = 1; i < (int) v.size(); i++) {
+        result += delimiter;
+        result += v[i];
+    }
+    return result;
 }
 
 int stringLastIndexOf(const std::string& s, char ch, int startIndex) {
@@ -342,44 +392,111 @@ int stringReplaceInPlace(std::string& str, char old, char replacement, int limit
 }
 
 int stringReplaceInPlace(std::string& str, const std::string& old, const std::string& replacement, int limit) {
-    int count = 0;
-    size_t startIndex = 0;
+    if (old.empty()) {
+        return 0;
+    }
+    size_t olen = old.length();
     size_t rlen = replacement.length();
-    while (limit <= 0 || count < limit) {
-        size_t index = str.find(old, startIndex);
-        if (index == std::string::npos) {
-            break;
+
+    if (olen == rlen) {
+        // same length; overwrite the occurrences without moving anything
+        int count = 0;
+        size_t index = 0;
+        while ((limit <= 0 || count < limit)
+               && (index = str.find(old, index)) != std::string::npos) {
+            str.replace(index, olen, replacement);
+            index += rlen;
+            count++;
         }
-        str.replace(index, old.length(), replacement);
-        startIndex = index + rlen;
+        return count;
+    }
+
+    // otherwise, count the occurrences and then copy into an exactly-sized
+    // new string, rather than shifting the rest of 'str' on each replacement
+    int count = 0;
+    size_t index = 0;
+    while ((limit <= 0 || count < limit)
+           && (index = str.find(old, index)) != std::string::npos) {
+        index += olen;
         count++;
     }
+    if (count == 0) {
+        return 0;
+    }
+
+    std::string result;
+    result.reserve(str.length() + count * rlen - count * olen);
+    size_t start = 0;
+    for (int i = 0; i < count; i++) {
+        index = str.find(old, start);
+        result.append(str, start, index - start);
+        result += replacement;
+        start = index + olen;
+    }
+    result.append(str, start, std::string::npos);
+    str.swap(result);
     return count;
 }
 
 std::vector<std::string> stringSplit(const std::string& str, char delimiter, int limit) {
-    std::string delim = charToString(delimiter);
-    return stringSplit(str, delim, limit);
+    std::vector<std::string> result;
+    std::vector<StringView> views = stringSplitView(str, delimiter, limit);
+    result.reserve(views.size());
+    for (const StringView& view : views) {
+        result.push_back(view.toString());
+    }
+    return result;
 }
 
 std::vector<std::string> stringSplit(const std::string& str, const std::string& delimiter, int limit) {
-    std::string str2 = str;
     std::vector<std::string> result;
+    std::vector<StringView> views = stringSplitView(str, delimiter, limit);
+    result.reserve(views.size());
+    for (const StringView& view : views) {
+        result.push_back(view.toString());
+    }
+    return result;
+}
+
+/*
+ * Returns the index of the first occurrence of 'delimiter' in 'str' at or
+ * after index 'start', or -1 if there is none.
+ */
+static int stringViewIndexOf(const StringView& str, const StringView& delimiter, int start) {
+    if (delimiter.length() == 1) {
+        const void* found = memchr(str.data() + start, delimiter[0], str.length() - start);
+        return found ? (int) ((const char*) found - str.data()) : -1;
+    }
+    const char* found = std::search(str.begin() + start, str.end(), delimiter.begin(), delimiter.end());
+    return found == str.end() ? -1 : (int) (found - str.data());
+}
+
+std::vector<StringView> stringSplitView(const StringView& str, char delimiter, int limit) {
+    return stringSplitView(str, StringView(&delimiter, 1), limit);
+}
+
+std::vector<StringView> stringSplitView(const StringView& str, const StringView& delimiter, int limit) {
+    std::vector<StringView> result;
+    if (delimiter.empty()) {
+        if (!str.empty()) {
+            result.push_back(str);
+        }
+        return result;
+    }
     int count = 0;
-    size_t index = 0;
+    int start = 0;
     while (limit < 0 || count < limit) {
-        index = str2.find(delimiter);
-        if (index == std::string::npos) {
+        int index = stringViewIndexOf(str, delimiter, start);
+        if (index < 0) {
             break;
         }
-        result.push_back(str2.substr(0, index));
-        str2.erase(str2.begin(), str2.begin() + index + delimiter.length());
+        result.push_back(StringView(str.data() + start, index - start));
+        start = index + delimiter.length();
         count++;
     }
-    if ((int) str2.length() > 0) {
-        result.push_back(str2);
+    if (start < str.length()) {
+        result.push_back(StringView(str.data() + start, str.length() - start));
     }
-
     return result;
 }
 
@@ -528,13 +645,14 @@ void trimStartInPlace(std::string& str) {
 }
 
 std::string urlDecode(const std::string& str) {
-    std::ostringstream unescaped;
+    std::string unescaped;
+    unescaped.reserve(str.length());
     for (std::string::const_iterator i = str.begin(), n = str.end(); i != n; ++i) {
         std::string::value_type c = (*i);
         if (isalnum(c) || c == '-' || c == '_' || c == '.' || c == '~' || c == '*') {
-            unescaped << c;
+            unescaped += c;
         } else if (c == '+')  {
-            unescaped << ' ';
+            unescaped += ' ';
         } else if (c == '%') {
             // throw error if string is invalid and doesn't have 2 char after,
             // or if it has non-hex chars here (courtesy GitHub @scinart)
@@ -548,7 +666,7 @@ std::string urlDecode(const std::string& str) {
             int hex1 = (isdigit(ch1) ? (ch1 - '0') : (toupper(ch1) - 'A' + 10));
             int hex2 = (isdigit(ch2) ? (ch2 - '0') : (toupper(ch2) - 'A' + 10));
             int decodedChar = (hex1 << 4) + hex2;
-            unescaped << (char) decodedChar;
+            unescaped += (char) decodedChar;
             i += 2;
         } else {
             std::ostringstream msg;
@@ -558,7 +676,7 @@ std::string urlDecode(const std::string& str) {
         }
     }
 
-    return unescaped.str();
+    return unescaped;
 }
 
 void urlDecodeInPlace(std::string& str) {
@@ -566,22 +684,25 @@ void urlDecodeInPlace(std::string& str) {
 }
 
 std::string urlEncode(const std::string& str) {
-    std::ostringstream escaped;
-    escaped.fill('0');
-    escaped << std::hex << std::uppercase;
+    static const char HEX_DIGITS[] = "0123456789ABCDEF";
+    std::string escaped;
+    escaped.reserve(str.length() * 3 / 2 + 16);
 
     for (std::string::const_iterator i = str.begin(), n = str.end(); i != n; ++i) {
         std::string::value_type c = (*i);
         if (isalnum(c) || c == '-' || c == '_' || c == '.' || c == '~' || c == '*') {
-            escaped << c;
+            escaped += c;
         } else if (c == ' ')  {
-            escaped << '+';
+            escaped += '+';
         } else {
-            escaped << '%' << std::setw(2) << ((int) c) << std::setw(0);
+            unsigned char uc = (unsigned char) c;
+            escaped += '%';
+            escaped += HEX_DIGITS[uc >> 4];
+            escaped += HEX_DIGITS[uc & 0x0F];
         }
     }
 
-    return escaped.str();
+    return escaped;
 }
 
 void urlEncodeInPlace(std::string& str) {
@@ -589,6 +710,72 @@ void urlEncodeInPlace(std::string& str) {
 }
 
 
+bool operator ==(const StringView& v1, const StringView& v2) {
+    return v1.length() == v2.length()
+            && std::equal(v1.begin(), v1.end(), v2.begin());
+}
+
+bool operator !=(const StringView& v1, const StringView& v2) {
+    return !(v1 == v2);
+}
+
+bool operator <(const StringView& v1, const StringView& v2) {
+    return std::lexicographical_compare(v1.begin(), v1.end(), v2.begin(), v2.end());
+}
+
+std::ostream& operator <<(std::ostream& out, const StringView& v) {
+    return out.write(v.data(), v.length());
+}
+
+StringSplitter::StringSplitter(const StringView& str, char delimiter)
+        : _data(str.data()),
+          _length((size_t) str.length()),
+          _delimiter(1, delimiter),
+          _position(0) {
+    // empty
+}
+
+StringSplitter::StringSplitter(const StringView& str, const StringView& delimiter)
+        : _data(str.data()),
+          _length((size_t) str.length()),
+          _delimiter(delimiter.toString()),
+          _position(0) {
+    // empty
+}
+
+StringSplitter::StringSplitter(const char* data, size_t length, char delimiter)
+        : _data(data),
+          _length(length),
+          _delimiter(1, delimiter),
+          _position(0) {
+    // empty
+}
+
+bool StringSplitter::hasNext() const {
+    // matches stringSplit: no piece is produced for a trailing delimiter
+    return _position < _length;
+}
+
+StringView StringSplitter::next() {
+    if (!hasNext()) {
+        error("StringSplitter::next: no more pieces to return");
+    }
+    const char* start = _data + _position;
+    const char* end = _data + _length;
+    const char* found = end;
+    if (_delimiter.length() == 1) {
+        const void* match = memchr(start, _delimiter[0], (size_t) (end - start));
+        found = match ? (const char*) match : end;
+    } else if (!_delimiter.empty()) {
+        found = std::search(start, end, _delimiter.begin(), _delimiter.end());
+    }
+    if (found - start > INT_MAX) {
+        error("StringSplitter::next: piece is too long for a StringView (2 GB or more)");
+    }
+    _position = found == end ? _length : (size_t) (found - _data) + _delimiter.length();
+    return StringView(start, (int) (found - start));
+}
+
 /*
  * Implementation notes: readQuotedString and writeQuotedString
  * ------------------------------------------------------------
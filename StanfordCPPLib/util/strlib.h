@@ -4,6 +4,12 @@
  * This file exports several useful string functions that are not
  * included in the C++ string library.
  * 
+ * @version 2018/10/19
+ * - StringSplitter can split a buffer of 2 GB or more
+ * @version 2018/10/02
+ * - added StringView, stringSplitView and StringSplitter for splitting
+ *   without copying the pieces
+ * - stringSplit/Join/Replace and html/url encoding are now single-pass
  * @version 2018/09/02
  * - added padLeft, padRight
  * @version 2016/11/09
@@ -36,9 +42,62 @@
 
 #include <iostream>
 #include <sstream>
+#include <cstring>
+#include <iterator>
 #include <string>
 #include <vector>
 
+/*
+ * Class: StringView
+ * -----------------
+ * A lightweight, read-only reference to a range of characters that live
+ * inside some other string.  Copying a StringView never copies characters.
+ * This plays the role of C++17's std::string_view for this library.
+ *
+ * A StringView does not own its characters, so it must not outlive the
+ * string it refers to (and that string must not be modified meanwhile).
+ */
+class StringView {
+public:
+    StringView() : _data(""), _length(0) {}
+    StringView(const char* data, int length) : _data(data), _length(length) {}
+    StringView(const char* s) : _data(s), _length((int) strlen(s)) {}
+    StringView(const std::string& s) : _data(s.data()), _length((int) s.length()) {}
+
+    const char* begin() const { return _data; }
+    const char* data() const { return _data; }
+    bool empty() const { return _length == 0; }
+    const char* end() const { return _data + _length; }
+    int length() const { return _length; }
+    int size() const { return _length; }
+
+    /*
+     * Returns a view of the given range of this view's characters.
+     * A length of -1 means "through the end".
+     */
+    StringView substr(int start, int length = -1) const {
+        if (start > _length) start = _length;
+        if (length < 0 || start + length > _length) length = _length - start;
+        return StringView(_data + start, length);
+    }
+
+    /*
+     * Returns a new std::string containing a copy of this view's characters.
+     */
+    std::string toString() const { return std::string(_data, _length); }
+
+    char operator [](int index) const { return _data[index]; }
+
+private:
+    const char* _data;
+    int _length;
+};
+
+bool operator ==(const StringView& v1, const StringView& v2);
+bool operator !=(const StringView& v1, const StringView& v2);
+bool operator <(const StringView& v1, const StringView& v2);
+std::ostream& operator <<(std::ostream& out, const StringView& v);
+
 /*
  * Returns the string "true" if b is true, or "false" if b is false.
  */
@@ -299,6 +358,97 @@ int stringReplaceInPlace(std::string& str, const std::string& old, const std::st
 std::vector<std::string> stringSplit(const std::string& str, char delimiter, int limit = -1);
 std::vector<std::string> stringSplit(const std::string& str, const std::string& delimiter, int limit = -1);
 
+/*
+ * Like stringSplit, but returns StringViews that refer to the pieces
+ * in place inside 'str' rather than copying each piece into a new string.
+ * The views are only valid as long as 'str' is alive and unmodified.
+ */
+std::vector<StringView> stringSplitView(const StringView& str, char delimiter, int limit = -1);
+std::vector<StringView> stringSplitView(const StringView& str, const StringView& delimiter, int limit = -1);
+
+/*
+ * Class: StringSplitter
+ * ---------------------
+ * Lazily splits a string by a delimiter, one piece at a time, producing the
+ * same pieces as stringSplit but as StringViews and without building a
+ * vector.  Useful for walking very large strings.
+ *
+ *     StringSplitter splitter(text, "\n");
+ *     while (splitter.hasNext()) {
+ *         StringView line = splitter.next();
+ *         ...
+ *     }
+ *
+ * or equivalently:
+ *
+ *     for (StringView line : StringSplitter(text, "\n")) { ... }
+ *
+ * As with StringView, the splitter must not outlive the string it splits.
+ * A splitter can also walk a buffer of 2 GB or more, such as a large
+ * MappedFile, given its data and length, as long as each piece is smaller
+ * than 2 GB; reaching a longer piece signals an error.
+ */
+class StringSplitter {
+public:
+    StringSplitter(const StringView& str, char delimiter);
+    StringSplitter(const StringView& str, const StringView& delimiter);
+    StringSplitter(const char* data, size_t length, char delimiter);
+
+    /*
+     * Returns true if there are more pieces to be returned by next().
+     */
+    bool hasNext() const;
+
+    /*
+     * Returns the next piece of the string.
+     * Throws an error if there are no more pieces.
+     */
+    StringView next();
+
+    /* Private section */
+
+    /**********************************************************************/
+    /* Note: Everything below this point in the class is logically part   */
+    /* of the implementation and should not be of interest to clients.    */
+    /**********************************************************************/
+
+    class iterator : public std::iterator<std::input_iterator_tag, StringView> {
+    public:
+        iterator() : _splitter(nullptr) {}
+        iterator(StringSplitter* splitter) : _splitter(splitter) {
+            ++(*this);
+        }
+
+        iterator& operator ++() {
+            if (_splitter && _splitter->hasNext()) {
+                _current = _splitter->next();
+            } else {
+                _splitter = nullptr;
+            }
+            return *this;
+        }
+
+        const StringView& operator *() const { return _current; }
+        const StringView* operator ->() const { return &_current; }
+
+        bool operator ==(const iterator& rhs) const { return _splitter == rhs._splitter; }
+        bool operator !=(const iterator& rhs) const { return _splitter != rhs._splitter; }
+
+    private:
+        StringSplitter* _splitter;
+        StringView _current;
+    };
+
+    iterator begin() { return iterator(this); }
+    iterator end() { return iterator(); }
+
+private:
+    const char* _data;
+    size_t _length;
+    std::string _delimiter;
+    size_t _position;
+};
+
 /*
  * If str is "true", returns the bool value true.
  * If str is "false", returns the bool value false.
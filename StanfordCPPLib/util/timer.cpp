@@ -5,12 +5,12 @@
  */
 
 #include "timer.h"
-#include <sys/time.h>
+#include <chrono>
 #include "error.h"
 
 Timer::Timer(bool autostart) {
-    m_startMS = 0;
-    m_stopMS = 0;
+    m_startNanos = 0;
+    m_stopNanos = 0;
     m_isStarted = false;
     if (autostart) {
         start();
@@ -18,7 +18,19 @@ Timer::Timer(bool autostart) {
 }
 
 long Timer::elapsed() const {
-    return m_stopMS - m_startMS;
+    return (long) (elapsedNanos() / 1000000);
+}
+
+long long Timer::elapsedMicros() const {
+    return elapsedNanos() / 1000;
+}
+
+long long Timer::elapsedNanos() const {
+    if (m_isStarted) {
+        return currentTimeNanos() - m_startNanos;
+    } else {
+        return m_stopNanos - m_startNanos;
+    }
 }
 
 bool Timer::isStarted() const {
@@ -26,22 +38,27 @@ bool Timer::isStarted() const {
 }
 
 void Timer::start() {
-    m_startMS = currentTimeMS();
+    m_startNanos = currentTimeNanos();
     m_isStarted = true;
 }
 
 long Timer::stop() {
-    m_stopMS = currentTimeMS();
+    m_stopNanos = currentTimeNanos();
     if (!m_isStarted) {
         // error("Timer is not started");
-        m_startMS = m_stopMS;
+        m_startNanos = m_stopNanos;
     }
     m_isStarted = false;
     return elapsed();
 }
 
 long Timer::currentTimeMS() {
-    timeval time;
-    gettimeofday(&time, nullptr);
-    return (time.tv_sec * 1000000 + time.tv_usec) / 1000;
+    // wall-clock time, since callers may compare it to timestamps
+    return (long) std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+long long Timer::currentTimeNanos() {
+    return (long long) std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
 }
@@ -3,6 +3,13 @@
  * -------------
  * This file exports a Timer class that is useful for measuring the elapsed
  * time of a program in milliseconds over a given interval.
+ * See also profile.h for measuring many short intervals.
+ *
+ * @version 2018/10/15
+ * - Timer uses a monotonic clock with nanosecond resolution, so it is not
+ *   affected by changes to the system time
+ * - added elapsedMicros, elapsedNanos, currentTimeNanos
+ * - elapsed returns the time so far while the timer is still running
  */
 
 #ifndef _timer_h
@@ -18,11 +25,25 @@ public:
 
     /*
      * Returns the number of milliseconds that have elapsed since this timer
-     * was started.
+     * was started, up to when it was stopped if it has been stopped.
      * Returns 0 if the timer was never started.
      */
     long elapsed() const;
 
+    /*
+     * Returns the number of microseconds that have elapsed since this timer
+     * was started, as with elapsed.
+     */
+    long long elapsedMicros() const;
+
+    /*
+     * Returns the number of nanoseconds that have elapsed since this timer
+     * was started, as with elapsed.
+     * The actual resolution depends on the system, but is typically well
+     * under a microsecond.
+     */
+    long long elapsedNanos() const;
+
     /*
      * Returns true if the timer has been started.
      */
@@ -47,10 +68,18 @@ public:
      */
     static long currentTimeMS();
 
+    /*
+     * A static utility function for getting the current time in nanoseconds
+     * from a monotonic clock, which never jumps or runs backward.
+     * The time is measured from an arbitrary starting point, so it is only
+     * useful for subtracting from another call's result.
+     */
+    static long long currentTimeNanos();
+
 private:
     /* instance variables */
-    long m_startMS;
-    long m_stopMS;
+    long long m_startNanos;
+    long long m_stopNanos;
     bool m_isStarted;
 };
 
@@ -0,0 +1,42 @@
+/*
+ * Test file for verifying the Stanford C++ lib functionality.
+ * Measures how many voices the mixer can mix in real time, by rendering
+ * them to a WAV file without an audio device.  The tests of rendering and
+ * of WAV files are in the autograder project's audioTests.cpp.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include "audio.h"
+#include "vector.h"
+using namespace std;
+
+static void testAudioMixSpeed(int voices, double seconds);
+
+int mainAudio() {
+    testAudioMixSpeed(64, 10.0);
+    testAudioMixSpeed(512, 10.0);
+    return 0;
+}
+
+static void testAudioMixSpeed(int voices, double seconds) {
+    // a few different tones, so that the voices do not all read the same memory
+    Vector<shared_ptr<const audio::Samples>> tones;
+    for (int i = 0; i < 16; i++) {
+        tones.add(audio::synthesizeTone(220 * pow(2.0, i / 12.0), seconds));
+    }
+    audio::startRendering();
+    for (int i = 0; i < voices; i++) {
+        audio::play(tones[i % tones.size()], 1.0 / voices);
+    }
+    auto start = chrono::steady_clock::now();
+    audio::finishRendering("audio-speed.wav");
+    double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << fixed << setprecision(1) << voices << " voices, " << seconds
+         << " s of audio mixed in " << elapsed * 1000 << " ms: about "
+         << setprecision(0) << voices * seconds / elapsed
+         << " voices in real time on one core" << endl;
+}
@@ -0,0 +1,217 @@
+/*
+ * Test file for verifying the Stanford C++ lib bitstream functionality.
+ * Writes and reads variable-length codes, like those of a Huffman coder,
+ * with writeBit/readBit and writeBits/readBits, and prints the throughput
+ * of each.  The "untracked" streams wrap a plain stringbuf or filebuf, so
+ * they take the path that checks the stream position on every bit, which is
+ * the way every bit stream used to work.  The tests that every way produces
+ * the same bytes and reads back the same codes are in the autograder
+ * project's bitstreamTests.cpp.
+ */
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "bitstream.h"
+#include "filelib.h"
+using namespace std;
+
+class UntrackedOstringbitstream : public obitstream {
+public:
+    UntrackedOstringbitstream() {
+        init(&sb);
+    }
+
+    string str() const {
+        return sb.str();
+    }
+
+private:
+    stringbuf sb;
+};
+
+class UntrackedIstringbitstream : public ibitstream {
+public:
+    UntrackedIstringbitstream(const string& s) : sb(s) {
+        init(&sb);
+    }
+
+private:
+    stringbuf sb;
+};
+
+class UntrackedOfbitstream : public obitstream {
+public:
+    UntrackedOfbitstream(const string& filename) {
+        init(&fb);
+        fb.open(filename, ios::out | ios::binary);
+    }
+
+    void close() {
+        fb.close();
+    }
+
+private:
+    filebuf fb;
+};
+
+class UntrackedIfbitstream : public ibitstream {
+public:
+    UntrackedIfbitstream(const string& filename) {
+        init(&fb);
+        fb.open(filename, ios::in | ios::binary);
+    }
+
+private:
+    filebuf fb;
+};
+
+struct Code {
+    unsigned int bits;
+    int length;
+};
+
+// codes of 1-20 bits; about 'bytes' bytes of them in all
+static vector<Code> randomCodes(int bytes) {
+    mt19937 rng(20181019);
+    vector<Code> codes;
+    long totalBits = 0;
+    while (totalBits < 8L * bytes) {
+        Code code;
+        code.length = 1 + rng() % 20;
+        code.bits = rng() & ((1u << code.length) - 1);
+        codes.push_back(code);
+        totalBits += code.length;
+    }
+    return codes;
+}
+
+template <typename Function>
+static double timeMs(Function function) {
+    auto start = chrono::steady_clock::now();
+    function();
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+static void writeBitByBit(obitstream& out, const vector<Code>& codes) {
+    for (const Code& code : codes) {
+        for (int i = 0; i < code.length; i++) {
+            out.writeBit((code.bits >> i) & 1);
+        }
+    }
+}
+
+// returns the codes' bits summed, so that the reads can't be optimized away
+static unsigned int readBitByBit(ibitstream& in, const vector<Code>& codes) {
+    unsigned int sum = 0;
+    for (const Code& code : codes) {
+        for (int i = 0; i < code.length; i++) {
+            sum += (unsigned int) in.readBit() << i;
+        }
+    }
+    return sum;
+}
+
+static void writeCodes(obitstream& out, const vector<Code>& codes) {
+    for (const Code& code : codes) {
+        out.writeBits(code.bits, code.length);
+    }
+}
+
+// returns the codes' bits summed, so that the reads can't be optimized away
+static unsigned int readCodes(ibitstream& in, const vector<Code>& codes) {
+    unsigned int sum = 0;
+    for (const Code& code : codes) {
+        sum += (unsigned int) in.readBits(code.length);
+    }
+    return sum;
+}
+
+static void printRate(const string& name, int bytes, double ms) {
+    cout << name << ": " << bytes / 1000.0 / ms << " MB/s" << endl;
+}
+
+static void testBitstreamSpeed() {
+    cout << fixed << setprecision(1);
+
+    // the position-checking path is slow, especially on files
+    const int smallBytes = 200000;
+    vector<Code> codes = randomCodes(smallBytes);
+    UntrackedOstringbitstream untrackedOut;
+    ostringbitstream trackedOut;
+    double untrackedWriteMs = timeMs([&]() { writeBitByBit(untrackedOut, codes); });
+    double trackedWriteMs = timeMs([&]() { writeBitByBit(trackedOut, codes); });
+    string bytes = untrackedOut.str();
+    UntrackedIstringbitstream untrackedIn(bytes);
+    istringbitstream trackedIn(bytes);
+    volatile unsigned int sink = 0;
+    double untrackedReadMs = timeMs([&]() { sink = readBitByBit(untrackedIn, codes); });
+    double trackedReadMs = timeMs([&]() { sink = readBitByBit(trackedIn, codes); });
+
+    string fileName = getTempDirectory() + "/bitstream-test.dat";
+    UntrackedOfbitstream untrackedFileOut(fileName);
+    double untrackedFileWriteMs = timeMs([&]() {
+        writeBitByBit(untrackedFileOut, codes);
+        untrackedFileOut.close();
+    });
+    ofbitstream fileOut(fileName);
+    double fileWriteMs = timeMs([&]() {
+        writeBitByBit(fileOut, codes);
+        fileOut.close();
+    });
+    UntrackedIfbitstream untrackedFileIn(fileName);
+    ifbitstream fileIn(fileName);
+    double untrackedFileReadMs = timeMs([&]() { sink = readBitByBit(untrackedFileIn, codes); });
+    double fileReadMs = timeMs([&]() { sink = readBitByBit(fileIn, codes); });
+    fileIn.close();
+
+    cout << "on " << bytes.length() / 1000 << " KB of 1-20 bit codes:" << endl;
+    printRate("  writeBit, untracked string stream", (int) bytes.length(), untrackedWriteMs);
+    printRate("  writeBit, string stream", (int) bytes.length(), trackedWriteMs);
+    printRate("  readBit, untracked string stream", (int) bytes.length(), untrackedReadMs);
+    printRate("  readBit, string stream", (int) bytes.length(), trackedReadMs);
+    printRate("  writeBit, untracked file stream", (int) bytes.length(), untrackedFileWriteMs);
+    printRate("  writeBit, file stream", (int) bytes.length(), fileWriteMs);
+    printRate("  readBit, untracked file stream", (int) bytes.length(), untrackedFileReadMs);
+    printRate("  readBit, file stream", (int) bytes.length(), fileReadMs);
+
+    const int largeBytes = 8000000;
+    codes = randomCodes(largeBytes);
+    ostringbitstream bitOut;
+    ostringbitstream codeOut;
+    double writeBitMs = timeMs([&]() { writeBitByBit(bitOut, codes); });
+    double writeBitsMs = timeMs([&]() { writeCodes(codeOut, codes); });
+    bytes = bitOut.str();
+    istringbitstream bitIn(bytes);
+    istringbitstream codeIn(bytes);
+    double readBitMs = timeMs([&]() { sink = readBitByBit(bitIn, codes); });
+    double readBitsMs = timeMs([&]() { sink = readCodes(codeIn, codes); });
+
+    ofbitstream codeFileOut(fileName);
+    double fileWriteBitsMs = timeMs([&]() {
+        writeCodes(codeFileOut, codes);
+        codeFileOut.close();
+    });
+    ifbitstream codeFileIn(fileName);
+    double fileReadBitsMs = timeMs([&]() { sink = readCodes(codeFileIn, codes); });
+    codeFileIn.close();
+    deleteFile(fileName);
+
+    cout << "on " << bytes.length() / 1000 << " KB of 1-20 bit codes:" << endl;
+    printRate("  writeBit", (int) bytes.length(), writeBitMs);
+    printRate("  writeBits", (int) bytes.length(), writeBitsMs);
+    printRate("  readBit", (int) bytes.length(), readBitMs);
+    printRate("  readBits", (int) bytes.length(), readBitsMs);
+    printRate("  writeBits, file stream", (int) bytes.length(), fileWriteBitsMs);
+    printRate("  readBits, file stream", (int) bytes.length(), fileReadBitsMs);
+    (void) sink;
+}
+
+int mainBitstream() {
+    testBitstreamSpeed();
+    return 0;
+}
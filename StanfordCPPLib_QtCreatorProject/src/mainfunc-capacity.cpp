@@ -0,0 +1,44 @@
+/*
+ * Test file for verifying the Stanford C++ lib functionality.
+ * Times loading collections with and without reserving room first.
+ * The reserve and shrinkToFit tests are in the autograder project's
+ * collection tests.
+ */
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include "hashset.h"
+#include "queue.h"
+#include "vector.h"
+using namespace std;
+
+// times adding n elements to an empty collection, with or without reserve
+template <typename CollectionType>
+static double timeLoad(int n, bool reserve) {
+    auto start = chrono::steady_clock::now();
+    CollectionType collection;
+    if (reserve) {
+        collection.reserve(n);
+    }
+    for (int i = 0; i < n; i++) {
+        collection.add(i);
+    }
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+static void testCapacitySpeed() {
+    const int N = 2000000;
+    cout << fixed << setprecision(1);
+    cout << "Vector<int> of 2M: " << timeLoad<Vector<int>>(N, false) << " ms growing, "
+         << timeLoad<Vector<int>>(N, true) << " ms reserved" << endl;
+    cout << "Queue<int> of 2M: " << timeLoad<Queue<int>>(N, false) << " ms growing, "
+         << timeLoad<Queue<int>>(N, true) << " ms reserved" << endl;
+    cout << "HashSet<int> of 2M: " << timeLoad<HashSet<int>>(N, false) << " ms growing, "
+         << timeLoad<HashSet<int>>(N, true) << " ms reserved" << endl;
+}
+
+int mainCapacity() {
+    testCapacitySpeed();
+    return 0;
+}
@@ -0,0 +1,184 @@
+/*
+ * Test file for verifying the Stanford C++ lib canonicalhuffman functionality.
+ * Compresses and decompresses generated text with CanonicalHuffmanCode,
+ * including with one code decoding on several threads at once, and compares
+ * its throughput with a coder that writes each code bit by bit from a string
+ * and decodes by walking a tree of nodes, the way Huffman coders are usually
+ * written.  The correctness tests are in the autograder project's
+ * huffmanTests.cpp.
+ */
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bitstream.h"
+#include "canonicalhuffman.h"
+using namespace std;
+
+template <typename Function>
+static double timeMs(Function function) {
+    auto start = chrono::steady_clock::now();
+    function();
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+// about 'bytes' bytes of words, chosen with a skewed distribution like English
+static string sampleText(int bytes) {
+    static const vector<string> words {
+        "the", "of", "and", "to", "a", "in", "is", "that", "for", "it", "as",
+        "with", "was", "on", "be", "by", "this", "are", "from", "or", "Huffman",
+        "code", "tree", "bits", "compression", "frequency", "symbol", "node,",
+        "file.", "stream", "encode", "decode", "table", "length", "priority"
+    };
+    mt19937 rng(20181019);
+    geometric_distribution<int> choose(0.15);
+    string text;
+    while ((int) text.length() < bytes) {
+        text += words[choose(rng) % words.size()];
+        text += rng() % 12 == 0 ? '\n' : ' ';
+    }
+    return text;
+}
+
+struct TreeNode {
+    int symbol;       // or -1 for an internal node
+    TreeNode* zero;
+    TreeNode* one;
+
+    TreeNode() : symbol(-1), zero(nullptr), one(nullptr) {}
+    ~TreeNode() {
+        delete zero;
+        delete one;
+    }
+};
+
+// builds the tree of nodes for the given code, from its code strings
+static TreeNode* buildTree(const CanonicalHuffmanCode& code) {
+    TreeNode* root = new TreeNode();
+    for (int symbol = 0; symbol < CanonicalHuffmanCode::SYMBOL_COUNT; symbol++) {
+        string bits = code.getCode(symbol);
+        TreeNode* node = root;
+        for (char bit : bits) {
+            TreeNode*& next = bit == '0' ? node->zero : node->one;
+            if (!next) {
+                next = new TreeNode();
+            }
+            node = next;
+        }
+        if (!bits.empty()) {
+            node->symbol = symbol;
+        }
+    }
+    return root;
+}
+
+static void treeEncode(const string& text, const CanonicalHuffmanCode& code, obitstream& output) {
+    vector<string> codes(CanonicalHuffmanCode::SYMBOL_COUNT);
+    for (int symbol = 0; symbol < CanonicalHuffmanCode::SYMBOL_COUNT; symbol++) {
+        codes[symbol] = code.getCode(symbol);
+    }
+    for (char ch : text) {
+        for (char bit : codes[(unsigned char) ch]) {
+            output.writeBit(bit - '0');
+        }
+    }
+    for (char bit : codes[PSEUDO_EOF]) {
+        output.writeBit(bit - '0');
+    }
+}
+
+static string treeDecode(ibitstream& input, const TreeNode* root) {
+    ostringstream output;
+    const TreeNode* node = root;
+    while (true) {
+        int bit = input.readBit();
+        if (bit == EOF) {
+            break;
+        }
+        node = bit == 0 ? node->zero : node->one;
+        if (node->symbol == PSEUDO_EOF) {
+            break;
+        } else if (node->symbol >= 0) {
+            output.put((char) node->symbol);
+            node = root;
+        }
+    }
+    return output.str();
+}
+
+static void printRate(const string& name, int bytes, double ms) {
+    cout << name << ": " << bytes / 1000.0 / ms << " MB/s" << endl;
+}
+
+static void testHuffman() {
+    cout << fixed << setprecision(1);
+    string text = sampleText(4000000);
+    istringstream input(text);
+    Map<int, int> frequencies = CanonicalHuffmanCode::countFrequencies(input);
+    CanonicalHuffmanCode code(frequencies);
+
+    // the whole compressed file, header included
+    ostringbitstream compressed;
+    istringstream compressInput(text);
+    double compressMs = timeMs([&]() { CanonicalHuffmanCode::compress(compressInput, compressed); });
+    istringbitstream decompressInput(compressed.str());
+    ostringstream decompressed;
+    double decompressMs = timeMs([&]() { CanonicalHuffmanCode::decompress(decompressInput, decompressed); });
+
+    // just the encoded text, to compare with the tree coder
+    ostringbitstream encoded;
+    istringstream encodeInput(text);
+    double encodeMs = timeMs([&]() { code.encode(encodeInput, encoded); });
+    istringbitstream decodeInput(encoded.str());
+    ostringstream decoded;
+    double decodeMs = timeMs([&]() { code.decode(decodeInput, decoded); });
+
+    TreeNode* root = buildTree(code);
+    ostringbitstream treeEncoded;
+    double treeEncodeMs = timeMs([&]() { treeEncode(text, code, treeEncoded); });
+    istringbitstream treeDecodeInput(treeEncoded.str());
+    string treeDecoded;
+    double treeDecodeMs = timeMs([&]() { treeDecoded = treeDecode(treeDecodeInput, root); });
+    delete root;
+
+    // one code, which has not decoded anything yet, shared by several threads
+    CanonicalHuffmanCode sharedCode = CanonicalHuffmanCode::fromCodeLengths(code.getCodeLengths());
+    const int threadCount = 4;
+    vector<string> results(threadCount);
+    string bits = encoded.str();
+    double threadsMs = timeMs([&]() {
+        vector<thread> threads;
+        for (int i = 0; i < threadCount; i++) {
+            threads.push_back(thread([&, i]() {
+                istringbitstream threadInput(bits);
+                ostringstream threadOutput;
+                sharedCode.decode(threadInput, threadOutput);
+                results[i] = threadOutput.str();
+            }));
+        }
+        for (thread& t : threads) {
+            t.join();
+        }
+    });
+
+    cout << text.length() / 1000 << " KB of text, " << compressed.str().length() / 1000
+         << " KB compressed:" << endl;
+    printRate("  compress", (int) text.length(), compressMs);
+    printRate("  decompress", (int) text.length(), decompressMs);
+    printRate("  encode", (int) text.length(), encodeMs);
+    printRate("  decode", (int) text.length(), decodeMs);
+    printRate("  encode, code strings and writeBit", (int) text.length(), treeEncodeMs);
+    printRate("  decode, tree of nodes and readBit", (int) text.length(), treeDecodeMs);
+    printRate("  decode on " + to_string(threadCount) + " threads at once",
+              threadCount * (int) text.length(), threadsMs);
+}
+
+int mainHuffman() {
+    testHuffman();
+    return 0;
+}
@@ -0,0 +1,79 @@
+/*
+ * Test file for verifying the Stanford C++ lib functionality.
+ * Measures the overhead of TIMED_SCOPE and Timer, and prints the profile
+ * of some collection operations that the library times itself.
+ */
+
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include "hashmap.h"
+#include "profile.h"
+#include "timer.h"
+#include "vector.h"
+using namespace std;
+
+static int testProfileWork(int i);
+
+int mainProfile() {
+    const int N = 10000000;
+    volatile int sink = 0;
+
+    Timer timer(true);
+    long long smallest = 1000000000;
+    for (int i = 0; i < 1000; i++) {
+        long long t0 = Timer::currentTimeNanos();
+        long long t1 = Timer::currentTimeNanos();
+        while (t1 == t0) {
+            t1 = Timer::currentTimeNanos();
+        }
+        smallest = min(smallest, t1 - t0);
+    }
+    cout << "smallest Timer tick: " << smallest << " ns" << endl;
+
+    profile::setEnabled(false);
+    timer.start();
+    for (int i = 0; i < N; i++) {
+        sink = testProfileWork(i);
+    }
+    cout << "TIMED_SCOPE while disabled: " << timer.elapsedNanos() * 1.0 / N << " ns/call" << endl;
+
+    profile::setEnabled(true);
+    timer.start();
+    for (int i = 0; i < N; i++) {
+        sink = testProfileWork(i);
+    }
+    cout << "TIMED_SCOPE while enabled:  " << timer.elapsedNanos() * 1.0 / N << " ns/call" << endl;
+
+    // the library's own scopes, from several threads at once
+    vector<thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.push_back(thread([]() {
+            for (int round = 0; round < 20; round++) {
+                Vector<int> v;
+                HashMap<int, int> map;
+                for (int i = 0; i < 100000; i++) {
+                    v.add(i);
+                    map.put(i, i);
+                }
+            }
+        }));
+    }
+    for (thread& thread : threads) {
+        thread.join();
+    }
+    timer.stop();
+    cout << "total time " << timer.elapsed() << " ms" << endl << endl;
+
+    profile::dump(cout);
+    ostringstream json;
+    profile::dumpJson(json);
+    cout << endl << json.str().substr(0, 200) << "..." << endl;
+    (void) sink;
+    return 0;
+}
+
+static int testProfileWork(int i) {
+    TIMED_SCOPE("testProfileWork");
+    return i * 2;
+}
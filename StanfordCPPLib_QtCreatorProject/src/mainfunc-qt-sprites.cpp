@@ -0,0 +1,161 @@
+/*
+ * Test file for verifying the Stanford C++ lib functionality.
+ * Measures how many sprites can be moved per frame, with and without
+ * batching the changes into one repaint per frame, and how long it takes
+ * to draw large scenes of simple shapes.
+ */
+
+#include <iostream>
+#include <QImage>
+#include <QPainter>
+#include "gobjects.h"
+#include "gwindow.h"
+#include "random.h"
+#include "timer.h"
+using namespace std;
+
+void testQtDrawScene(const std::string& name, GCompound* scene);
+void testQtSpritesPerFrame(GWindow* window, Vector<GObject*>& sprites, bool batched);
+
+int mainQtDrawBenchmark() {
+    const int COUNT = 100000;
+    const std::string COLORS[] = {"red", "green", "blue"};
+
+    // same-colored rects and lines, drawn in bulk
+    GCompound* rects = new GCompound();
+    GCompound* lines = new GCompound();
+    for (int i = 0; i < COUNT; i++) {
+        rects->add(new GRect(randomInteger(0, 780), randomInteger(0, 580), 10, 10));
+        lines->add(new GLine(randomInteger(0, 800), randomInteger(0, 600),
+                             randomInteger(0, 800), randomInteger(0, 600)));
+    }
+
+    // rects in a few colors, grouped by color
+    GCompound* grouped = new GCompound();
+    for (int i = 0; i < COUNT; i++) {
+        GRect* rect = new GRect(randomInteger(0, 780), randomInteger(0, 580), 10, 10);
+        rect->setColor(COLORS[i * 3 / COUNT]);
+        grouped->add(rect);
+    }
+
+    // the worst case: every shape differs from the one before it
+    GCompound* mixed = new GCompound();
+    for (int i = 0; i < COUNT; i++) {
+        GObject* obj;
+        if (i % 2 == 0) {
+            obj = new GRect(randomInteger(0, 780), randomInteger(0, 580), 10, 10);
+        } else {
+            obj = new GOval(randomInteger(0, 780), randomInteger(0, 580), 10, 10);
+        }
+        obj->setColor(COLORS[i % 3]);
+        mixed->add(obj);
+    }
+
+    testQtDrawScene("rects", rects);
+    testQtDrawScene("lines", lines);
+    testQtDrawScene("grouped", grouped);
+    testQtDrawScene("mixed", mixed);
+    for (GCompound* scene : {rects, lines, grouped, mixed}) {
+        // GCompound doesn't delete its contents
+        for (int i = 0; i < scene->getElementCount(); i++) {
+            delete scene->getElement(i);
+        }
+        scene->removeAll();
+        delete scene;
+    }
+    return 0;
+}
+
+void testQtDrawScene(const std::string& name, GCompound* scene) {
+    const int FRAMES = 10;
+    QImage image(800, 600, QImage::Format_ARGB32);
+    Timer timer;
+    timer.start();
+    for (int frame = 0; frame < FRAMES; frame++) {
+        image.fill(Qt::white);
+        QPainter painter(&image);
+        scene->draw(&painter);
+    }
+    timer.stop();
+    cout << name << ": " << scene->getElementCount() << " objects, "
+         << ((double) timer.elapsed() / FRAMES) << " ms/frame" << endl;
+}
+
+int mainQtSprites() {
+    GWindow* window = new GWindow(800, 600);
+    window->setTitle("QtGui Sprites Benchmark");
+    window->center();
+
+    for (int count : {100, 1000, 10000}) {
+        Vector<GObject*> sprites;
+        for (int i = 0; i < count; i++) {
+            GOval* sprite = new GOval(randomInteger(0, 780), randomInteger(0, 580), 20, 20);
+            sprite->setFilled(true);
+            sprite->setFillColor("blue");
+            sprites.add(sprite);
+        }
+        {
+            GBatchUpdate batch(window);
+            for (GObject* sprite : sprites) {
+                window->add(sprite);
+            }
+        }
+
+        testQtSpritesPerFrame(window, sprites, /* batched */ false);
+        testQtSpritesPerFrame(window, sprites, /* batched */ true);
+        window->clearCanvasObjects();
+        for (GObject* sprite : sprites) {
+            delete sprite;
+        }
+    }
+
+    // the same animation, paced at 60 frames per second by the window
+    Vector<GObject*> sprites;
+    for (int i = 0; i < 1000; i++) {
+        GRect* sprite = new GRect(randomInteger(0, 780), randomInteger(0, 580), 10, 10);
+        sprite->setFilled(true);
+        sprites.add(sprite);
+        window->add(sprite);
+    }
+    int frames = 0;
+    window->animate([&sprites, &frames](double elapsedMS) {
+        double distance = elapsedMS / 10;   // 100 pixels per second
+        for (GObject* sprite : sprites) {
+            sprite->move(distance, 0);
+            if (sprite->getX() > 800) {
+                sprite->setX(0);   // wrap around to the left edge
+            }
+        }
+        return ++frames < 300;
+    });
+    cout << "animate: " << frames << " frames" << endl;
+    return 0;
+}
+
+void testQtSpritesPerFrame(GWindow* window, Vector<GObject*>& sprites, bool batched) {
+    const int FRAMES = 20;
+    Timer timer;
+    timer.start();
+    for (int frame = 0; frame < FRAMES; frame++) {
+        double dx = frame % 2 == 0 ? 5 : -5;
+        if (batched) {
+            window->beginUpdate();
+        }
+        for (GObject* sprite : sprites) {
+            sprite->move(dx, 0);
+        }
+        if (batched) {
+            window->endUpdate();
+        }
+    }
+    timer.stop();
+    double msPerFrame = (double) timer.elapsed() / FRAMES;
+    cout << (batched ? "batched:   " : "unbatched: ")
+         << sprites.size() << " sprites, "
+         << msPerFrame << " ms/frame";
+    if (msPerFrame > 0) {
+        cout << ", ~" << (int) (sprites.size() * (1000.0 / 60) / msPerFrame)
+             << " sprites/frame at 60 fps";
+    }
+    cout << endl;
+}
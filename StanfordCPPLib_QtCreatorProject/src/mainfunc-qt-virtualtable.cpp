@@ -0,0 +1,128 @@
+/*
+ * Test file for verifying the Stanford C++ lib functionality.
+ * Shows a 1,000,000 x 20 table in a GVirtualTable and measures memory use,
+ * scrolling, and sorting, compared to filling a much smaller GTable.
+ */
+
+#include <fstream>
+#include <iostream>
+#include <QScrollBar>
+#include <QTableView>
+#include "ginteractors.h"
+#include "gthread.h"
+#include "random.h"
+#include "strlib.h"
+#include "timer.h"
+using namespace std;
+
+void testQtGTableFill(int rows, int cols);
+void testQtVirtualTableScroll(GVirtualTable* table);
+string testQtVirtualTableMemory();
+
+int mainQtVirtualTable() {
+    const int ROWS = 1000000;
+    const int COLS = 20;
+
+    GWindow* window = new GWindow(900, 600);
+    window->setTitle("QtGui Virtual Table");
+    window->setResizable(true);
+    window->center();
+
+    testQtGTableFill(10000, COLS);
+
+    // cell text is made up from the row and column, so no data is stored
+    string memoryBefore = testQtVirtualTableMemory();
+    Timer timer;
+    timer.start();
+    GVirtualTable* table = new GVirtualTable(ROWS, COLS, [](int row, int column) {
+        return integerToString((row * 7919 + column * 104729) % 1000003);
+    });
+    table->setColumnHeaderStyle(GTable::COLUMN_HEADER_EXCEL);
+    window->addToRegion(table, "Center");
+    timer.stop();
+    cout << "GVirtualTable " << ROWS << "x" << COLS << ": created in "
+         << timer.elapsed() << " ms; memory " << memoryBefore
+         << " -> " << testQtVirtualTableMemory() << endl;
+
+    table->setTableListener([table](GEvent event) {
+        if (event.getType() == TABLE_SELECTED) {
+            cout << "selected row " << event.getRow() << ", column " << event.getColumn()
+                 << " = " << table->get(event.getRow(), event.getColumn()) << endl;
+        }
+    });
+
+    testQtVirtualTableScroll(table);
+
+    timer.start();
+    table->sortByColumn(3);
+    timer.stop();
+    cout << "sort by column D: " << timer.elapsed() << " ms" << endl;
+    testQtVirtualTableScroll(table);
+
+    timer.start();
+    table->setRowFilter([](int row) {
+        return row % 3 == 0;
+    });
+    timer.stop();
+    cout << "filter: " << timer.elapsed() << " ms, "
+         << table->getDisplayedRowCount() << " rows shown" << endl;
+
+    // a batch of changes is redrawn once, at the end
+    timer.start();
+    table->beginUpdate();
+    for (int row = 0; row < 1000; row++) {
+        table->refreshRows(row, row);
+    }
+    table->endUpdate();
+    timer.stop();
+    cout << "1000 refreshes in one batch: " << timer.elapsed() << " ms" << endl;
+
+    table->removeRowFilter();
+    table->unsort();
+    table->select(ROWS / 2, 0);
+    return 0;
+}
+
+void testQtGTableFill(int rows, int cols) {
+    string memoryBefore = testQtVirtualTableMemory();
+    Timer timer;
+    timer.start();
+    GTable* table = new GTable(rows, cols);
+    for (int row = 0; row < rows; row++) {
+        for (int col = 0; col < cols; col++) {
+            table->set(row, col, integerToString(row * cols + col));
+        }
+    }
+    timer.stop();
+    cout << "GTable " << rows << "x" << cols << ": filled in " << timer.elapsed()
+         << " ms; memory " << memoryBefore << " -> " << testQtVirtualTableMemory() << endl;
+}
+
+void testQtVirtualTableScroll(GVirtualTable* table) {
+    // jump to random places and wait for each screenful to be drawn
+    const int JUMPS = 100;
+    QTableView* view = static_cast<QTableView*>(table->getWidget());
+    Timer timer;
+    timer.start();
+    for (int i = 0; i < JUMPS; i++) {
+        int position = randomInteger(0, view->verticalScrollBar()->maximum());
+        GThread::runOnQtGuiThread([view, position]() {
+            view->verticalScrollBar()->setValue(position);
+            view->viewport()->repaint();
+        });
+    }
+    timer.stop();
+    cout << "scroll: " << ((double) timer.elapsed() / JUMPS) << " ms per screenful" << endl;
+}
+
+string testQtVirtualTableMemory() {
+    // resident memory size, where the OS makes it available
+    ifstream input("/proc/self/status");
+    string line;
+    while (getline(input, line)) {
+        if (startsWith(line, "VmRSS:")) {
+            return trim(line.substr(6));
+        }
+    }
+    return "(unknown)";
+}
@@ -0,0 +1,57 @@
+/*
+ * Test file for verifying the Stanford C++ lib functionality.
+ * Measures the speed of the random number functions.  The statistical
+ * tests are in the autograder project's randomTests.cpp.
+ */
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include "random.h"
+#include "vector.h"
+using namespace std;
+
+static double nanosPer(chrono::steady_clock::time_point start, int count);
+static void testRandomThroughput();
+
+int mainRandom() {
+    testRandomThroughput();
+    return 0;
+}
+
+static double nanosPer(chrono::steady_clock::time_point start, int count) {
+    return chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / count;
+}
+
+static void testRandomThroughput() {
+    const int N = 20000000;
+    volatile int sink = 0;
+
+    cout << fixed << setprecision(2);
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < N; i++) {
+        sink = randomInteger(1, 100);
+    }
+    cout << "randomInteger(1, 100):           " << nanosPer(start, N) << " ns" << endl;
+
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < N; i++) {
+        sink = randomReal(0, 1) < 0.5;
+    }
+    cout << "randomReal(0, 1):                " << nanosPer(start, N) << " ns" << endl;
+
+    RandomEngine& engine = getRandomEngine();
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < N; i++) {
+        sink = engine.nextInteger(1, 100);
+    }
+    cout << "RandomEngine::nextInteger:       " << nanosPer(start, N) << " ns" << endl;
+
+    Vector<int> v(N);
+    start = chrono::steady_clock::now();
+    randomFill(v, 1, 100);
+    cout << "randomFill, per element:         " << nanosPer(start, N) << " ns" << endl;
+    cout << setprecision(6);
+    cout.unsetf(ios::fixed);
+    (void) sink;
+}
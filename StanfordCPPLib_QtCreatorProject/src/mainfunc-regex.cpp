@@ -0,0 +1,98 @@
+/*
+ * Test file for verifying the Stanford C++ lib regexpr functionality.
+ * Times the linear-time matcher and std::regex on the kind of work that the
+ * autograder's style checker does.  The tests that the two find the same
+ * matches are in the autograder project's regexTests.cpp.
+ */
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include "regexpr.h"
+#include "vector.h"
+using namespace std;
+
+// builds a student-like source file of about the given size
+static string sampleSource(int bytes) {
+    const string chunk =
+            "/*\n * Prints the cells of the grid.\n */\n"
+            "void printGrid(const Grid<int>& grid, int rows, int cols) {\n"
+            "    for (int r = 0; r < grid.numRows(); r++) {\n"
+            "        for (int c = 0; c < grid.numCols(); c++) {\n"
+            "            if (grid[r][c] == 1) {   // a living cell\n"
+            "                cout << \"X\";\n"
+            "            } else if (isAlive == true) {\n"
+            "                cout << \"-\";\n"
+            "            }\n"
+            "        }\n"
+            "        cout << endl;\n"
+            "    }\n"
+            "}\n\n";
+    string s;
+    while ((int) s.length() < bytes) {
+        s += chunk;
+    }
+    return s;
+}
+
+static double timeStyleCheck(const Vector<string>& patterns, const string& source,
+                             bool linear, int& totalCount) {
+    setRegexLinearMatchingEnabled(linear);
+    auto start = chrono::steady_clock::now();
+    totalCount = 0;
+    for (const string& pattern : patterns) {
+        Vector<int> lines;
+        regexMatchCountWithLines(source, pattern, lines);
+        totalCount += lines.size();
+    }
+    setRegexLinearMatchingEnabled(true);
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+static void testRegexSpeed() {
+    // rules from stylecheck-mainfunc-cpp.xml, with (:SPACES:) and (:IDENT:)
+    // expanded as stylecheck.cpp does
+    const string spaces = "(?:[ \\t]{0,999})";
+    const string ident = "(?:[a-zA-Z_$][a-zA-Z0-9_$]{0,255})";
+    const Vector<string> patterns {
+        "Grid" + spaces + "<" + spaces + "(?:int|double|string)" + spaces + ">",
+        "num(?:Rows|Cols)" + spaces + "\\(" + spaces + "\\)" + spaces + "[+]" + spaces + "2",
+        "\\[[^\\]]+\\]" + spaces + "=" + spaces + "(?:true|false|0|1|'X'|'-')" + spaces + ";",
+        "(?:printf)|(?:scanf)",
+        ".{101,}\\n",
+        ".*;.*;.*;",
+        "\\r?\\n" + spaces + "\\r?\\n",
+        "\\n" + ident + "[^()\\n]*" + ident + spaces + "\\([^\\)]*\\)[ \\t\\n]{0,255}\\{",
+        "[!=]=" + spaces + "(true|false)",
+        "else" + spaces + "if",
+        "(\\/\\/.*)|(\\/\\*([^*]|([*][^\\/])\\r?\\n?)*\\*\\/)"
+    };
+    string source = sampleSource(50000);
+    int linearCount;
+    int stdCount;
+    regexMatchCount("", patterns[0]);   // warm up the cache
+    for (const string& pattern : patterns) {
+        regexMatch("", pattern);
+    }
+    double linearMs = timeStyleCheck(patterns, source, true, linearCount);
+    double stdMs = timeStyleCheck(patterns, source, false, stdCount);
+    cout << fixed << setprecision(1);
+    cout << patterns.size() << " style rules over " << source.length() / 1000 << " KB, "
+         << linearCount << " vs. " << stdCount << " matches: " << linearMs << " ms linear, " << stdMs << " ms std::regex ("
+         << stdMs / linearMs << "x)" << endl;
+
+    // exponential for a backtracking matcher
+    string text(24, 'a');
+    setRegexLinearMatchingEnabled(true);
+    auto start = chrono::steady_clock::now();
+    bool found = regexMatch(text, "(a|aa)*b");
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    cout << "(a|aa)*b on 24 a's: " << ms << " ms linear, "
+         << (found ? "found" : "not found") << endl;
+}
+
+int mainRegex() {
+    testRegexSpeed();
+    return 0;
+}
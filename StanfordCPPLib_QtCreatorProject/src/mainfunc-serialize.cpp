@@ -0,0 +1,63 @@
+/*
+ * Test file for verifying the Stanford C++ lib functionality.
+ * Compares the speed of serialize and deserialize with printing and
+ * reading the same collections as text.  The correctness tests are in the
+ * autograder project's serializeTests.cpp.
+ */
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include "grid.h"
+#include "hashmap.h"
+#include "serialize.h"
+#include "vector.h"
+using namespace std;
+
+// times writing and reading a collection as text and as binary data
+template <typename CollectionType>
+static void testSerializeSpeed(const string& name, const CollectionType& collection) {
+    auto start = chrono::steady_clock::now();
+    stringstream text;
+    text << collection;
+    CollectionType fromText;
+    text >> fromText;
+    double textMillis = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    start = chrono::steady_clock::now();
+    stringstream binary;
+    serialize(binary, collection);
+    CollectionType fromBinary;
+    deserialize(binary, fromBinary);
+    double binaryMillis = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    cout << fixed << setprecision(1) << name << ": text " << textMillis << " ms ("
+         << text.str().length() / 1024 << " KB), binary " << binaryMillis << " ms ("
+         << binary.str().length() / 1024 << " KB), " << textMillis / binaryMillis
+         << "x faster" << endl;
+}
+
+int mainSerialize() {
+    Vector<int> ints;
+    for (int i = 0; i < 5000000; i++) {
+        ints.add((int) ((long long) i * 7919 % 1000003) - 500000);
+    }
+    testSerializeSpeed("Vector<int> of 5M", ints);
+
+    Grid<double> grid(1000, 1000);
+    for (int r = 0; r < grid.numRows(); r++) {
+        for (int c = 0; c < grid.numCols(); c++) {
+            grid[r][c] = r * 0.5 + c;
+        }
+    }
+    testSerializeSpeed("Grid<double> of 1M", grid);
+
+    HashMap<string, int> words;
+    for (int i = 0; i < 500000; i++) {
+        words["word" + to_string(i)] = i;
+    }
+    testSerializeSpeed("HashMap<string, int> of 500K", words);
+    return 0;
+}
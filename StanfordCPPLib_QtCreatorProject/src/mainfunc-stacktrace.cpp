@@ -0,0 +1,39 @@
+/*
+ * Test file for verifying the Stanford C++ lib functionality.
+ * Prints a stack trace and measures how many stack traces with line numbers
+ * can be captured per second.
+ */
+
+#include <algorithm>
+#include <iostream>
+#include "call_stack.h"
+#include "timer.h"
+using namespace std;
+
+int testStackTraceRecurse(int depth, bool print);
+
+int mainStackTrace() {
+    testStackTraceRecurse(3, /* print */ true);
+
+    const int TRACES = 2000;
+    Timer timer;
+    timer.start();
+    for (int i = 0; i < TRACES; i++) {
+        testStackTraceRecurse(5, /* print */ false);
+    }
+    timer.stop();
+    cout << TRACES << " traces in " << timer.elapsed() << " ms = "
+         << (int) (TRACES * 1000.0 / std::max(1L, timer.elapsed())) << " traces/sec" << endl;
+    return 0;
+}
+
+int testStackTraceRecurse(int depth, bool print) {
+    if (depth > 0) {
+        return testStackTraceRecurse(depth - 1, print) + 1;
+    }
+    stacktrace::call_stack trace;
+    if (print) {
+        cout << trace.to_string();
+    }
+    return (int) trace.stack.size();
+}
@@ -0,0 +1,84 @@
+/*
+ * Test file for verifying the Stanford C++ lib functionality.
+ * Compares the speed of functional::stream pipelines with that of the eager
+ * filter/map/reduce functions.  The tests that they give the same results
+ * are in the autograder project's streamTests.cpp.
+ */
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include "functional.h"
+#include "vector.h"
+using namespace std;
+
+static bool isEven(int n) {
+    return n % 2 == 0;
+}
+
+static long long squared(int n) {
+    return (long long) n * n % 1000;
+}
+
+static long long add(long long a, long long b) {
+    return a + b;
+}
+
+static double millisSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+static void testStreamSpeed(int size);
+
+int mainStream() {
+    testStreamSpeed(1000000);
+    testStreamSpeed(20000000);
+    return 0;
+}
+
+static void testStreamSpeed(int size) {
+    Vector<int> v;
+    v.ensureCapacity(size);
+    for (int i = 0; i < size; i++) {
+        v.add(i);
+    }
+    const int RUNS = 5;
+    cout << "size " << size << " (average of " << RUNS << " runs):" << endl;
+    cout << fixed << setprecision(2);
+
+    volatile long long sink = 0;
+    auto start = chrono::steady_clock::now();
+    for (int run = 0; run < RUNS; run++) {
+        Vector<long long> squares;
+        functional::map(functional::filter(v, isEven), squared, squares);
+        sink = functional::reduce(squares, add, 0LL);
+    }
+    cout << "  eager filter/map/reduce:  " << millisSince(start) / RUNS << " ms" << endl;
+
+    start = chrono::steady_clock::now();
+    for (int run = 0; run < RUNS; run++) {
+        sink = functional::stream(v).filter(isEven).map(squared).reduce(0LL, add);
+    }
+    cout << "  stream, function pointers: " << millisSince(start) / RUNS << " ms" << endl;
+
+    start = chrono::steady_clock::now();
+    for (int run = 0; run < RUNS; run++) {
+        sink = functional::stream(v)
+                .filter([](int n) { return n % 2 == 0; })
+                .map([](int n) { return (long long) n * n % 1000; })
+                .reduce(0LL, [](long long a, long long b) { return a + b; });
+    }
+    cout << "  stream, lambdas:           " << millisSince(start) / RUNS << " ms" << endl;
+
+    start = chrono::steady_clock::now();
+    for (int run = 0; run < RUNS; run++) {
+        sink = functional::stream(v)
+                .filter([](int n) { return n % 2 == 0; })
+                .map([](int n) { return (long long) n * n % 1000; })
+                .parallel()
+                .reduce(0LL, [](long long a, long long b) { return a + b; });
+    }
+    cout << "  parallel stream, lambdas:  " << millisSince(start) / RUNS << " ms ("
+         << ThreadPool::getDefault().getThreadCount() << " threads)" << endl;
+    (void) sink;
+}
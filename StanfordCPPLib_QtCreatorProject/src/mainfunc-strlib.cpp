@@ -0,0 +1,152 @@
+/*
+ * Test file for verifying the Stanford C++ lib strlib functionality.
+ * Times stringSplit, stringSplitView, StringSplitter, stringJoin,
+ * stringReplace, and the HTML and URL encoders against simple reference
+ * versions, which are the way these functions used to be written, on large
+ * inputs.  The correctness tests are in the autograder project's
+ * stringTests.cpp.
+ */
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "strlib.h"
+using namespace std;
+
+// the old stringSplit, which erased each piece from the front of a copy
+static vector<string> oldStringSplit(const string& str, const string& delimiter) {
+    string str2 = str;
+    vector<string> result;
+    while (true) {
+        size_t index = str2.find(delimiter);
+        if (index == string::npos) {
+            break;
+        }
+        result.push_back(str2.substr(0, index));
+        str2.erase(str2.begin(), str2.begin() + index + delimiter.length());
+    }
+    if (!str2.empty()) {
+        result.push_back(str2);
+    }
+    return result;
+}
+
+// the old stringJoin, which went through an ostringstream
+static string oldStringJoin(const vector<string>& v, const string& delimiter) {
+    if (v.empty()) {
+        return "";
+    }
+    ostringstream out;
+    out << v[0];
+    for (int i = 1; i < (int) v.size(); i++) {
+        out << delimiter << v[i];
+    }
+    return out.str();
+}
+
+// the old stringReplaceInPlace, which replaced one occurrence at a time
+static void oldStringReplaceInPlace(string& str, const string& old, const string& replacement) {
+    size_t startIndex = 0;
+    while (true) {
+        size_t index = str.find(old, startIndex);
+        if (index == string::npos) {
+            break;
+        }
+        str.replace(index, old.length(), replacement);
+        startIndex = index + replacement.length();
+    }
+}
+
+// the old htmlEncode, which made one pass per entity
+static string oldHtmlEncode(const string& s) {
+    string result = s;
+    oldStringReplaceInPlace(result, "&", "&amp;");
+    oldStringReplaceInPlace(result, "<", "&lt;");
+    oldStringReplaceInPlace(result, ">", "&gt;");
+    oldStringReplaceInPlace(result, "\"", "&quot;");
+    return result;
+}
+
+// the old urlEncode, which went through an ostringstream (but writing bytes
+// above 0x7f as two hex digits, as urlEncode does now)
+static string oldUrlEncode(const string& value) {
+    ostringstream escaped;
+    escaped.fill('0');
+    escaped << hex << uppercase;
+    for (char c : value) {
+        if (isalnum(c) || c == '-' || c == '_' || c == '.' || c == '~' || c == '*') {
+            escaped << c;
+        } else if (c == ' ') {
+            escaped << '+';
+        } else {
+            escaped << '%' << setw(2) << ((int) (unsigned char) c) << setw(0);
+        }
+    }
+    return escaped.str();
+}
+
+template <typename Function>
+static double timeMs(Function function) {
+    auto start = chrono::steady_clock::now();
+    function();
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+static void testStrlibSpeed() {
+    // 1 MB of comma-separated fields, like a large CSV file
+    string csv;
+    for (int i = 0; csv.length() < 1000000; i++) {
+        csv += "field" + to_string(i) + ",";
+    }
+    vector<string> pieces;
+    size_t count = 0;
+    cout << fixed << setprecision(1);
+
+    double oldMs = timeMs([&]() { pieces = oldStringSplit(csv, ","); });
+    double newMs = timeMs([&]() { pieces = stringSplit(csv, ","); });
+    double viewMs = timeMs([&]() { count = stringSplitView(csv, ',').size(); });
+    double splitterMs = timeMs([&]() {
+        count = 0;
+        for (StringView piece : StringSplitter(csv, ',')) {
+            count += piece.length() > 0;
+        }
+    });
+    cout << "stringSplit of 1 MB into " << pieces.size() << " pieces: "
+         << oldMs << " ms old, " << newMs << " ms new, " << viewMs << " ms view, "
+         << splitterMs << " ms StringSplitter" << endl;
+
+    string joined;
+    oldMs = timeMs([&]() { joined = oldStringJoin(pieces, ", "); });
+    newMs = timeMs([&]() { joined = stringJoin(pieces, ", "); });
+    cout << "stringJoin of " << pieces.size() << " pieces: "
+         << oldMs << " ms old, " << newMs << " ms new" << endl;
+
+    string oldReplaced = csv;
+    string newReplaced = csv;
+    oldMs = timeMs([&]() { oldStringReplaceInPlace(oldReplaced, ",", ", "); });
+    newMs = timeMs([&]() { stringReplaceInPlace(newReplaced, ",", ", "); });
+    cout << "stringReplaceInPlace \",\" -> \", \" on 1 MB: "
+         << oldMs << " ms old, " << newMs << " ms new" << endl;
+
+    string markup;
+    while (markup.length() < 1000000) {
+        markup += "<td class=\"cell\">a & b</td>";
+    }
+    string oldEncoded;
+    string newEncoded;
+    oldMs = timeMs([&]() { oldEncoded = oldHtmlEncode(markup); });
+    newMs = timeMs([&]() { newEncoded = htmlEncode(markup); });
+    cout << "htmlEncode of 1 MB: " << oldMs << " ms old, " << newMs << " ms new" << endl;
+
+    oldMs = timeMs([&]() { oldEncoded = oldUrlEncode(markup); });
+    newMs = timeMs([&]() { newEncoded = urlEncode(markup); });
+    cout << "urlEncode of 1 MB: " << oldMs << " ms old, " << newMs << " ms new" << endl;
+}
+
+int mainStrlib() {
+    testStrlibSpeed();
+    return 0;
+}
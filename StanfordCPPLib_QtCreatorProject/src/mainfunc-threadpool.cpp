@@ -0,0 +1,105 @@
+/*
+ * Test file for verifying the Stanford C++ lib functionality.
+ * Measures the cost of starting and joining tasks with forkThread, a
+ * ThreadPool, a TaskGroup, and parallelFor, and counts Lock contention.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+#include "thread.h"
+#include "threadpool.h"
+using namespace std;
+
+static double microsSince(chrono::steady_clock::time_point start);
+static void testThreadPoolIncrement(Lock& lock);
+static long testThreadPoolFib(ThreadPool& pool, int n);
+
+static long testThreadPoolCounter = 0;
+
+int mainThreadPool() {
+    const int THREADS = 200;
+    const int TASKS = 100000;
+
+    // a new operating system thread per task
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < THREADS; i++) {
+        Thread thread = forkThread([]() { /* empty */ });
+        joinThread(thread);
+    }
+    cout << "forkThread + joinThread:    " << microsSince(start) / THREADS << " us/task" << endl;
+
+    ThreadPool pool;
+    cout << "pool has " << pool.getThreadCount() << " threads" << endl;
+
+    start = chrono::steady_clock::now();
+    vector<future<int>> futures;
+    futures.reserve(TASKS);
+    for (int i = 0; i < TASKS; i++) {
+        futures.push_back(pool.submit([i]() { return i; }));
+    }
+    long sum = 0;
+    for (future<int>& f : futures) {
+        sum += f.get();
+    }
+    cout << "ThreadPool submit + get:    " << microsSince(start) / TASKS << " us/task"
+         << " (sum " << sum << ")" << endl;
+
+    start = chrono::steady_clock::now();
+    {
+        TaskGroup group(pool);
+        for (int i = 0; i < TASKS; i++) {
+            group.run([]() { /* empty */ });
+        }
+        group.wait();
+    }
+    cout << "TaskGroup run + wait:       " << microsSince(start) / TASKS << " us/task" << endl;
+
+    // recursive fork/join, which exercises work stealing
+    long before = pool.getStealCount();
+    start = chrono::steady_clock::now();
+    long fib = 0;
+    TaskGroup top(pool);
+    top.run([&fib, &pool]() { fib = testThreadPoolFib(pool, 25); });
+    top.wait();
+    cout << "recursive TaskGroup fib(25) = " << fib << " in " << microsSince(start) / 1000
+         << " ms, " << (pool.getStealCount() - before) << " steals" << endl;
+
+    vector<double> v(10000000, 1.0);
+    start = chrono::steady_clock::now();
+    pool.parallelFor(0, (int) v.size(), [&v](int i) { v[i] = v[i] * 2 + i; });
+    cout << "parallelFor over " << v.size() << " elements: "
+         << microsSince(start) / 1000 << " ms" << endl;
+
+    // every task fights over one lock
+    Lock lock;
+    start = chrono::steady_clock::now();
+    pool.parallelFor(0, 1000000, [&lock](int) { testThreadPoolIncrement(lock); }, 1000);
+    cout << "1000000 synchronized increments: " << microsSince(start) / 1000 << " ms, counter "
+         << testThreadPoolCounter << ", " << lock.getContentionCount() << " of "
+         << lock.getLockCount() << " lock acquisitions contended" << endl;
+    return 0;
+}
+
+static double microsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+}
+
+static void testThreadPoolIncrement(Lock& lock) {
+    synchronized (lock) {
+        testThreadPoolCounter++;
+    }
+}
+
+static long testThreadPoolFib(ThreadPool& pool, int n) {
+    if (n < 2) {
+        return n;
+    }
+    long a = 0;
+    long b = 0;
+    TaskGroup group(pool);
+    group.run([&a, &pool, n]() { a = testThreadPoolFib(pool, n - 1); });
+    b = testThreadPoolFib(pool, n - 2);
+    group.wait();
+    return a + b;
+}
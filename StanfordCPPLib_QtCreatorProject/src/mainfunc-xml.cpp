@@ -0,0 +1,59 @@
+/*
+ * Test file for verifying the Stanford C++ lib functionality.
+ * Compares the speed of loading a document repeatedly with and without
+ * XmlDocument's cache.  The tests of path queries and of the cache are in
+ * the autograder project's xmlTests.cpp.
+ */
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include "xmlutils.h"
+using namespace std;
+
+static const char* XML_FILENAME = "xml-test.xml";
+
+static void writeTestFile(int categories, int patterns) {
+    ofstream out(XML_FILENAME);
+    out << "<stylecheck omitonpass=\"true\">" << endl;
+    out << "    <pattern regex=\"top\" />" << endl;
+    for (int c = 0; c < categories; c++) {
+        out << "    <category name=\"c" << c << "\">" << endl;
+        for (int p = 0; p < patterns; p++) {
+            out << "        <pattern regex=\"p" << p << "/x\" type=\""
+                << (p % 2 ? "warn" : "fail") << "\" />" << endl;
+        }
+        out << "        <note>text</note>" << endl;
+        out << "    </category>" << endl;
+    }
+    out << "</stylecheck>" << endl;
+}
+
+static void testXmlSpeed() {
+    writeTestFile(20, 25);
+    const int RUNS = 2000;
+    int total = 0;
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < RUNS; i++) {
+        xmlutils::XmlDocument doc(XML_FILENAME);
+        total += (int) xmlutils::getChildNodes(doc.getRootNode("stylecheck"), "category").size();
+    }
+    double parseMicros = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count() / RUNS;
+
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < RUNS; i++) {
+        shared_ptr<const xmlutils::XmlDocument> doc = xmlutils::XmlDocument::open(XML_FILENAME);
+        total += doc->query("stylecheck/category").size();
+    }
+    double cachedMicros = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count() / RUNS;
+    cout << "load 500-pattern document: parse every time " << parseMicros
+         << " us, cached " << cachedMicros << " us (" << total << ")" << endl;
+}
+
+int mainXml() {
+    testXmlSpeed();
+    remove(XML_FILENAME);
+    return 0;
+}
@@ -9,6 +9,38 @@ int main() {
 //    return mainQt2dGraphics();
 //    extern int mainQtLayout();
 //    return mainQtLayout();
+//    extern int mainQtSprites();
+//    return mainQtSprites();
+//    extern int mainQtDrawBenchmark();
+//    return mainQtDrawBenchmark();
+//    extern int mainQtVirtualTable();
+//    return mainQtVirtualTable();
+//    extern int mainStackTrace();
+//    return mainStackTrace();
+//    extern int mainThreadPool();
+//    return mainThreadPool();
+//    extern int mainRandom();
+//    return mainRandom();
+//    extern int mainProfile();
+//    return mainProfile();
+//    extern int mainStream();
+//    return mainStream();
+//    extern int mainAudio();
+//    return mainAudio();
+//    extern int mainXml();
+//    return mainXml();
+//    extern int mainSerialize();
+//    return mainSerialize();
+//    extern int mainCapacity();
+//    return mainCapacity();
+//    extern int mainRegex();
+//    return mainRegex();
+//    extern int mainStrlib();
+//    return mainStrlib();
+//    extern int mainBitstream();
+//    return mainBitstream();
+//    extern int mainHuffman();
+//    return mainHuffman();
     extern int mainQtWidgets();
     return mainQtWidgets();
 }
@@ -6,6 +6,10 @@
  * See autograder.h for documentation of each member.
  * 
  * @author Marty Stepp
+ * @version 2018/10/08
+ * - optional on-disk cache of test results (setTestResultCache)
+ * @version 2018/10/05
+ * - optionally run test cases in parallel worker processes (setTestWorkerCount)
  * @version 2018/08/27
  * - refactored to use AutograderUnitTestGui cpp class
  * @version 2017/10/05
@@ -93,6 +97,11 @@ AutograderFlags::AutograderFlags() {
     inputPanelFilename = INPUT_PANE_FILENAME;
     showLateDays = true;
     graphicalUI = false;
+    testWorkerCount = 0;
+    testWorkerCpuLimitSeconds = 0;
+    testWorkerMemoryLimitMB = 0;
+    testWorkerOutputLimitBytes = MAX_STUDENT_OUTPUT;
+    testResultCacheDirectory = "";
     callbackStart = nullptr;
     callbackEnd = nullptr;
     currentTestShouldRun = true;
@@ -211,6 +220,8 @@ void setCurrentTestShouldRun(bool shouldRun) {
 }
 
 void setFailDetails(AutograderTest& test, const autograder::UnitTestDetails& deets) {
+    recordTestWorkerFailDetails(deets);
+    recordTestResultCacheFailDetails(deets);
     if (STATIC_VARIABLE(FLAGS).graphicalUI) {
         MartyGraphicalTestResultPrinter::setFailDetails(test, deets);
     } else {
@@ -219,6 +230,8 @@ void setFailDetails(AutograderTest& test, const autograder::UnitTestDetails& dee
 }
 
 void setFailDetails(const autograder::UnitTestDetails& deets) {
+    recordTestWorkerFailDetails(deets);
+    recordTestResultCacheFailDetails(deets);
     if (STATIC_VARIABLE(FLAGS).graphicalUI) {
         MartyGraphicalTestResultPrinter::setFailDetails(deets);
     } else {
@@ -277,6 +290,24 @@ void setTestShouldRun(const std::string& testFullName, bool shouldRun) {
     }
 }
 
+void setTestResultCache(const std::string& directory) {
+    STATIC_VARIABLE(FLAGS).testResultCacheDirectory = directory;
+}
+
+void setTestResultCacheSourceFiles(const Vector<std::string>& filenames) {
+    STATIC_VARIABLE(FLAGS).testResultCacheSourceFiles = filenames;
+}
+
+void setTestWorkerCount(int count) {
+    STATIC_VARIABLE(FLAGS).testWorkerCount = count;
+}
+
+void setTestWorkerLimits(int cpuLimitSeconds, int memoryLimitMB, int outputLimitBytes) {
+    STATIC_VARIABLE(FLAGS).testWorkerCpuLimitSeconds = cpuLimitSeconds;
+    STATIC_VARIABLE(FLAGS).testWorkerMemoryLimitMB = memoryLimitMB;
+    STATIC_VARIABLE(FLAGS).testWorkerOutputLimitBytes = outputLimitBytes;
+}
+
 static std::string formatDate(const std::string& dateStr) {
     // date = "13/Oct/2014 10:31:15"
     int day;
@@ -479,10 +510,35 @@ int mainRunAutograderTestCases() {
             }
             listeners.Append(printer);
         }
+
+        // saves results of tests that weren't in the result cache (if any)
+        listeners.Append(new autograder::TestResultCacheRecorder());
     }
     
+    resetTestResultCacheStats();
+
+    // optionally run the tests in parallel worker processes first;
+    // RUN_ALL_TESTS below then just reports their recorded results
+    bool ranInWorkers = false;
+    if (!STATIC_VARIABLE(FLAGS).graphicalUI) {
+        ranInWorkers = runTestsInWorkerProcesses(
+                    STATIC_VARIABLE(FLAGS).testWorkerCount,
+                    STATIC_VARIABLE(FLAGS).testWorkerCpuLimitSeconds,
+                    STATIC_VARIABLE(FLAGS).testWorkerMemoryLimitMB,
+                    STATIC_VARIABLE(FLAGS).testWorkerOutputLimitBytes);
+    }
+
     int result = RUN_ALL_TESTS();   // run Google Test framework now
 
+    if (ranInWorkers) {
+        std::cout << getTestWorkerReport() << std::endl;
+        clearTestWorkerResults();
+    }
+    if (!STATIC_VARIABLE(FLAGS).testResultCacheDirectory.empty()
+            && !STATIC_VARIABLE(FLAGS).graphicalUI) {
+        std::cout << getTestResultCacheReport() << std::endl;
+    }
+
     // un-lock-down
     setConsoleSettingsLocked(false);
     ioutils::setConsoleEchoUserInput(false);
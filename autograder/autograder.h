@@ -5,6 +5,12 @@
  * autograder programs for grading student assignments.
  * 
  * @author Marty Stepp
+ * @version 2018/10/19
+ * - test result cache identifies student code by the executable by default
+ * @version 2018/10/08
+ * - added setTestResultCache and setTestResultCacheSourceFiles
+ * @version 2018/10/05
+ * - added setTestWorkerCount and setTestWorkerLimits for parallel test runs
  * @version 2016/12/01
  * - removed most "current test case" logic and replaced with testcase-specific logic
  * @version 2016/08/01
@@ -89,6 +95,12 @@ public:
     bool showInputPanel;
     bool showLateDays;
     bool graphicalUI;
+    int testWorkerCount;
+    int testWorkerCpuLimitSeconds;
+    int testWorkerMemoryLimitMB;
+    int testWorkerOutputLimitBytes;
+    std::string testResultCacheDirectory;
+    Vector<std::string> testResultCacheSourceFiles;
     Vector<std::string> styleCheckFiles;
     Map<std::string, std::string> styleCheckFileMap;
     void(* callbackStart)();
@@ -250,6 +262,48 @@ void setTestNameWidth(int width);
  */
 void setTestShouldRun(const std::string& testFullName, bool shouldRun);
 
+/*
+ * Sets a directory in which to cache the result of each test, so that a
+ * regrade skips any test whose student code and test code have not changed
+ * and reports its cached result instead. The directory is created if needed
+ * and may be shared by several graders running at once.
+ * Pass "" (the default) to turn caching off.
+ * Tests should be deterministic to be cached.  Input and expected output
+ * files are part of the key when a test's source file names them in a
+ * string literal; other files a test reads must be passed to
+ * setTestResultCacheSourceFiles.  Tests that time out or crash are rerun.
+ */
+void setTestResultCache(const std::string& directory);
+
+/*
+ * Sets the files whose contents identify a student's submission for the
+ * test result cache.  List every source file the build compiles, including
+ * helper .cpp files that nothing #includes; a change to a file left out
+ * would go unnoticed.  By default the test program's executable is used,
+ * so rebuilding after any change to student or test code starts afresh.
+ */
+void setTestResultCacheSourceFiles(const Vector<std::string>& filenames);
+
+/*
+ * Sets how many worker processes to use to run test cases in parallel.
+ * Each test then runs in its own forked process, isolated from the others,
+ * and the suite finishes in roughly (total time / count).
+ * Defaults to 0, meaning tests run one at a time in this process.
+ * Tests that use graphics cannot run in worker processes.
+ * Only supported for the text UI on Linux/Mac; ignored elsewhere.
+ */
+void setTestWorkerCount(int count);
+
+/*
+ * Sets per-test resource limits used when tests run in worker processes
+ * (see setTestWorkerCount): CPU seconds, address space in MB, and bytes
+ * of stdout/stderr output. A limit <= 0 means no limit.
+ * The memory limit covers the whole process, including thread stacks,
+ * so it should be generous (hundreds of MB).
+ * Output defaults to MAX_STUDENT_OUTPUT bytes; the others default to no limit.
+ */
+void setTestWorkerLimits(int cpuLimitSeconds, int memoryLimitMB, int outputLimitBytes = MAX_STUDENT_OUTPUT);
+
 /*
  * Sets whether the autograder should display the contents of the lateDays.txt
  * file to see whether the student turned in their assignment on time.
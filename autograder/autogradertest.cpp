@@ -5,6 +5,10 @@
  * See autogradertest.h for declarations and documentation.
  *
  * @author Marty Stepp
+ * @version 2018/10/19
+ * - added addTestSourceLocation, getTestSourceFile/Line
+ * @version 2018/10/08
+ * - added getSourceFile/Line
  * @version 2016/10/04
  * - slight refactor of static variables
  * @version 2014/11/24
@@ -38,6 +42,29 @@ void AutograderTest::addTestToList(const std::string& categoryName, const std::s
     allTests()[categoryName].push_back(testName);
 }
 
+static std::map<std::string, std::pair<std::string, int> >& allTestSourceLocations() {
+    static std::map<std::string, std::pair<std::string, int> > locations;   // static OK
+    return locations;
+}
+
+::testing::TestInfo* AutograderTest::addTestSourceLocation(::testing::TestInfo* info,
+                                                           const std::string& sourceFile,
+                                                           int sourceLine) {
+    std::string key = std::string(info->test_case_name()) + "." + info->name();
+    allTestSourceLocations()[key] = std::make_pair(sourceFile, sourceLine);
+    return info;
+}
+
+std::string AutograderTest::getTestSourceFile(const std::string& categoryName, const std::string& testName) {
+    auto it = allTestSourceLocations().find(categoryName + "." + testName);
+    return it == allTestSourceLocations().end() ? "" : it->second.first;
+}
+
+int AutograderTest::getTestSourceLine(const std::string& categoryName, const std::string& testName) {
+    auto it = allTestSourceLocations().find(categoryName + "." + testName);
+    return it == allTestSourceLocations().end() ? 0 : it->second.second;
+}
+
 const std::vector<std::string>& AutograderTest::getAllCategories() {
     return allCategories();
 }
@@ -46,6 +73,13 @@ const std::vector<std::string>& AutograderTest::getAllTests(const std::string& c
     return allTests()[categoryName];
 }
 
+AutograderTest::AutograderTest()
+        : timeoutMS(TIMEOUT_MS_DEFAULT),
+          runInThread(RUN_EACH_TEST_IN_THREAD_DEFAULT),
+          sourceLine(0) {
+    // empty
+}
+
 int AutograderTest::getDefaultTimeout() {
     return TIMEOUT_MS_DEFAULT;
 }
@@ -78,6 +112,14 @@ std::string AutograderTest::getFullName() const {
     return this->category.empty() ? this->name : (this->category + "_" + this->name);
 }
 
+std::string AutograderTest::getSourceFile() const {
+    return this->sourceFile;
+}
+
+int AutograderTest::getSourceLine() const {
+    return this->sourceLine;
+}
+
 bool AutograderTest::shouldRun() {
     if (autograder::isGraphicalUI()) {
         return stanfordcpplib::autograder::AutograderUnitTestGui::instance()->isChecked(this->getFullName());
@@ -6,6 +6,10 @@
  * test names.
  * 
  * @author Marty Stepp
+ * @version 2018/10/19
+ * - source file/line of each test can be looked up by name before it runs
+ * @version 2018/10/08
+ * - added source file/line of each test (used by the test result cache)
  * @version 2014/11/24
  * @since 2014/11/24
  */
@@ -42,12 +46,25 @@ public:
     static const std::vector<std::string>& getAllCategories();
     static const std::vector<std::string>& getAllTests(const std::string& categoryName = "");
 
+    /*
+     * Records where the test with the given category and name was defined,
+     * so that it can be looked up before any instance of the test exists.
+     * Called by the TIMED_TEST macros; returns the given test info.
+     */
+    static ::testing::TestInfo* addTestSourceLocation(::testing::TestInfo* info,
+                                                      const std::string& sourceFile,
+                                                      int sourceLine);
+    static std::string getTestSourceFile(const std::string& categoryName, const std::string& testName);
+    static int getTestSourceLine(const std::string& categoryName, const std::string& testName);
+
     /*
      * get/set the default timeout values
      */
     static int getDefaultTimeout();
     static void setDefaultTimeout(int timeoutMS);
 
+    AutograderTest();
+
     virtual int getTestTimeout() const;
     virtual void setTestTimeout(int ms);
     
@@ -55,6 +72,13 @@ public:
     virtual std::string getCategory() const;
     virtual std::string getFullName() const;   // "CategoryName_TestName"
 
+    /*
+     * The source file and line number where this test was defined,
+     * or "" and 0 if unknown. Set by the TIMED_TEST macros.
+     */
+    virtual std::string getSourceFile() const;
+    virtual int getSourceLine() const;
+
     /*
      * Whether this test case should run.
      * Will be true unless unchecked in GUI test case list.
@@ -78,6 +102,8 @@ protected:
     std::string category;   // test's category
     int timeoutMS;          // test's timeout in milliseconds (0 for none)
     bool runInThread;       // whether to run test in its own thread
+    std::string sourceFile; // file in which test is defined
+    int sourceLine;         // line on which test is defined
 };
 
 } // namespace autograder
@@ -5,6 +5,12 @@
  * of the Google Test C++ unit testing framework.
  * 
  * @author Marty Stepp
+ * @version 2018/10/19
+ * - register each test's source location when the test is registered
+ * @version 2018/10/08
+ * - record each test's source location; skip tests with cached results
+ * @version 2018/10/05
+ * - replay results of tests already run by worker processes
  * @version 2018/01/23
  * - fixed bug with first run test case name not being set properly
  * @version 2016/08/02
@@ -25,6 +31,7 @@
 #include "autograder.h"
 #include "autogradertest.h"
 #include "gtest.h"
+#include "testresultcache.h"
 #include "threading.h"
 
 /*
@@ -37,6 +44,8 @@
         GTEST_TEST_CLASS_NAME_(test_case_name, test_name)() { \
             this->name = #test_name; \
             this->category = #test_case_name; \
+            this->sourceFile = __FILE__; \
+            this->sourceLine = __LINE__; \
         } \
         std::string getCategoryName() { return this->category; } \
         std::string getTestName() { return this->name; } \
@@ -50,12 +59,14 @@
 \
     ::testing::TestInfo* const GTEST_TEST_CLASS_NAME_(test_case_name, test_name) \
       ::test_info_ = \
-        ::testing::internal::MakeAndRegisterTestInfo( \
-            #test_case_name, #test_name, nullptr, nullptr, \
-            (parent_id), \
-            parent_class::SetUpTestCase, \
-            parent_class::TearDownTestCase, \
-            new ::testing::internal::TestFactoryImpl<GTEST_TEST_CLASS_NAME_(test_case_name, test_name)>); \
+        autograder::AutograderTest::addTestSourceLocation( \
+            ::testing::internal::MakeAndRegisterTestInfo( \
+                #test_case_name, #test_name, nullptr, nullptr, \
+                (parent_id), \
+                parent_class::SetUpTestCase, \
+                parent_class::TearDownTestCase, \
+                new ::testing::internal::TestFactoryImpl<GTEST_TEST_CLASS_NAME_(test_case_name, test_name)>), \
+            __FILE__, __LINE__); \
     void GTEST_TEST_CLASS_NAME_(test_case_name, test_name)::TestBody() { \
         autograder::setCurrentTestShouldRun(shouldRun()); \
         autograder::setTestShouldRun(this->getTestFullName(), shouldRun()); \
@@ -63,6 +74,9 @@
             return; \
         } \
         autograder::setCurrentTestCaseName(this->getTestFullName()); \
+        if (autograder::replayCachedTestResult(this) || replayTestWorkerResult(this)) { \
+            return; \
+        } \
         if (timeoutMS > 0) { \
             setTestTimeout(timeoutMS); \
             runTestWithTimeout(this); \
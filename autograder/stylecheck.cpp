@@ -6,6 +6,14 @@
  * See sylecheck.h for documentation of each function.
  * 
  * @author Marty Stepp
+ * @version 2018/10/19
+ * - rules use the library's linear-time matcher when it supports them
+ * @version 2018/10/15
+ * - rule XML is loaded as an owned, cached XmlDocument instead of leaking a copy
+ * - literal prefilter consumes whole \x, \u, \c, and backreference escapes
+ * @version 2018/10/10
+ * - rules are parsed and compiled once per XML file (StyleCheckRuleSet)
+ * - literal prefilter skips regexes that cannot match; parallel multi-file check
  * @version 2018/08/27
  * - refactored to use AutograderUnitTestGui cpp class
  * @version 2016/12/01
@@ -27,16 +35,22 @@
  */
 
 #include "stylecheck.h"
+#include <algorithm>
+#include <atomic>
 #include <cstring>
+#include <queue>
+#include <thread>
 #include "autograder.h"
 #include "autograderunittestgui.h"
 #include "filelib.h"
 #include "gtest-marty.h"
+#include "map.h"
 #include "rapidxml.h"
 #include "regexpr.h"
 #include "stringutils.h"
 #include "strlib.h"
 #include "xmlutils.h"
+#include "private/regexengine.h"
 #include "private/static.h"
 
 namespace stylecheck {
@@ -44,47 +58,410 @@ namespace stylecheck {
 STATIC_CONST_VARIABLE_DECLARE(int, DEFAULT_MIN_COUNT, 0)
 STATIC_CONST_VARIABLE_DECLARE(int, DEFAULT_MAX_COUNT, 999999999)
 STATIC_VARIABLE_DECLARE(bool, styleChecksMerged, false)
+STATIC_VARIABLE_DECLARE_MAP_EMPTY(Map, std::string, StyleCheckRuleSet*, ruleSetCache)
 
-static bool processPatternNode(const std::string& codeFileName,
-                               rapidxml::xml_node<>* patternNode,
-                               std::string categoryName,
-                               const std::string& codeFileText,
-                               bool omitOnPass) {
-    std::ostringstream out;
-    std::string patternRegex = xmlutils::getAttribute(patternNode, "regex");
+/*
+ * Replaces the shorthand tokens allowed in style check regexes with real regex syntax.
+ */
+static std::string expandPatternRegex(std::string patternRegex) {
     patternRegex = stringReplace(patternRegex, "(:IDENTIFIER:)", "(?:[a-zA-Z_$][a-zA-Z0-9_$]{0,255})");
     patternRegex = stringReplace(patternRegex, "(:IDENT:)", "(?:[a-zA-Z_$][a-zA-Z0-9_$]{0,255})");
     patternRegex = stringReplace(patternRegex, "(:SPACES:)", "(?:[ \\t]{0,999})");
     patternRegex = stringReplace(patternRegex, "(:SPACE:)", "(?:[ \\t])");
     patternRegex = stringReplace(patternRegex, "(:TEMPLATE:)", "(?:&lt;[ \t]{0,255}[a-zA-Z_$][a-zA-Z0-9_$]{0,255}[ \t]{0,255}&gt;)");
+    return patternRegex;
+}
+
+/*
+ * Returns the index just past the escape sequence whose backslash is at
+ * index i of the given regex, taking in all of an escape such as \xHH,
+ * \uHHHH, \cX, or a backreference like \12.
+ */
+static size_t skipRegexEscape(const std::string& regex, size_t i) {
+    size_t end = i + 2;
+    if (i + 1 < regex.length()) {
+        char ch = regex[i + 1];
+        if (ch == 'x') {
+            end = i + 4;
+        } else if (ch == 'u') {
+            end = i + 6;
+        } else if (ch == 'c') {
+            end = i + 3;
+        } else if (isdigit(ch)) {
+            while (end < regex.length() && isdigit(regex[end])) {
+                end++;
+            }
+        }
+    }
+    return std::min(end, regex.length());
+}
 
-    std::string patternDescription = xmlutils::getAttribute(patternNode, "description", patternRegex);
-    int patternMinCount = xmlutils::getAttributeInt(patternNode, "mincount", STATIC_VARIABLE(DEFAULT_MIN_COUNT));
-    int patternMaxCount = xmlutils::getAttributeInt(patternNode, "maxcount", STATIC_VARIABLE(DEFAULT_MAX_COUNT));
+/*
+ * Returns the index just past the group or character class starting at
+ * index i of the given regex, or regex.length() if it is unterminated.
+ */
+static size_t skipRegexGroup(const std::string& regex, size_t i) {
+    int depth = 0;
+    bool inClass = false;
+    for (; i < regex.length(); i++) {
+        char ch = regex[i];
+        if (ch == '\\') {
+            i = skipRegexEscape(regex, i) - 1;
+        } else if (inClass) {
+            if (ch == ']') {
+                inClass = false;
+                if (depth == 0) {
+                    return i + 1;
+                }
+            }
+        } else if (ch == '[') {
+            inClass = true;
+            if (i + 1 < regex.length() && regex[i + 1] == '^') {
+                i++;
+            }
+            if (i + 1 < regex.length() && regex[i + 1] == ']') {
+                i++;   // leading ']' is a literal member of the class
+            }
+        } else if (ch == '(') {
+            depth++;
+        } else if (ch == ')') {
+            depth--;
+            if (depth == 0) {
+                return i + 1;
+            }
+        }
+    }
+    return regex.length();
+}
+
+/*
+ * Returns the longest piece of literal text that every match of the given
+ * regex must contain, or "" if none can be determined.
+ * Only looks at top-level literal characters (not inside groups or classes)
+ * and gives up if the regex has top-level alternation; this is conservative
+ * but covers the typical style rule such as "goto" or "while (true)".
+ */
+static std::string requiredLiteral(const std::string& regex) {
+    std::string best;
+    std::string run;
+    size_t i = 0;
+    while (i < regex.length()) {
+        char ch = regex[i];
+        bool isLiteral = false;
+        char literalChar = ch;
+        if (ch == '|') {
+            return "";   // top-level alternation; no single required literal
+        } else if (ch == '(' || ch == '[') {
+            i = skipRegexGroup(regex, i);
+        } else if (ch == '\\') {
+            if (i + 1 < regex.length() && !isalnum(regex[i + 1])) {
+                isLiteral = true;   // escaped punctuation like \( or \.
+                literalChar = regex[i + 1];
+            }
+            i = skipRegexEscape(regex, i);
+        } else {
+            isLiteral = (ch != '.' && ch != '^' && ch != '$');
+            i++;
+        }
+
+        // a quantifier that allows zero occurrences makes the token optional;
+        // any quantifier ends the literal run after this token
+        bool optional = false;
+        bool quantified = false;
+        if (i < regex.length()) {
+            char q = regex[i];
+            if (q == '*' || q == '?') {
+                optional = quantified = true;
+                i++;
+            } else if (q == '+') {
+                quantified = true;
+                i++;
+            } else if (q == '{') {
+                size_t close = regex.find('}', i);
+                if (close != std::string::npos) {
+                    std::string minText = regex.substr(i + 1, close - i - 1);
+                    optional = minText.empty() || minText[0] == '0' || minText[0] == ',';
+                    quantified = true;
+                    i = close + 1;
+                }
+            }
+            if (quantified && i < regex.length() && regex[i] == '?') {
+                i++;   // lazy quantifier
+            }
+        }
+
+        if (isLiteral && !optional) {
+            run += literalChar;
+        }
+        if (!isLiteral || optional || quantified) {
+            if (run.length() > best.length()) {
+                best = run;
+            }
+            run.clear();
+        }
+    }
+    return run.length() > best.length() ? run : best;
+}
+
+static StyleCheckRule parseRule(rapidxml::xml_node<>* patternNode, const std::string& categoryName) {
+    StyleCheckRule rule;
+    rule.categoryName = categoryName;
+    rule.regexText = expandPatternRegex(xmlutils::getAttribute(patternNode, "regex"));
+    rule.regex = std::regex(rule.regexText);
+    rule.linear = std::make_shared<stanfordcpplib::LinearRegex>(rule.regexText);
+    rule.literal = requiredLiteral(rule.regexText);
+    rule.description = xmlutils::getAttribute(patternNode, "description", rule.regexText);
+    rule.minCount = xmlutils::getAttributeInt(patternNode, "mincount", STATIC_VARIABLE(DEFAULT_MIN_COUNT));
+    rule.maxCount = xmlutils::getAttributeInt(patternNode, "maxcount", STATIC_VARIABLE(DEFAULT_MAX_COUNT));
     int patternCount = xmlutils::getAttributeInt(patternNode, "count", -1);
     if (patternCount != -1) {
-        patternMinCount = patternMaxCount = patternCount;
+        rule.minCount = rule.maxCount = patternCount;
     }
-    bool patternList = xmlutils::getAttributeBool(patternNode, "list", true);
-    bool showCounts = xmlutils::getAttributeBool(patternNode, "showcounts", true);
-    
-    stanfordcpplib::autograder::AutograderUnitTestGui::TestResult failResult =
-            stanfordcpplib::autograder::AutograderUnitTestGui::TEST_RESULT_WARN;   // default
+    rule.list = xmlutils::getAttributeBool(patternNode, "list", true);
+    rule.showCounts = xmlutils::getAttributeBool(patternNode, "showcounts", true);
+    rule.failIsWarning = true;   // default
     if (xmlutils::hasAttribute(patternNode, "failtype")) {
-        std::string failTypeStr = trim(xmlutils::getAttribute(patternNode, "failtype"));
-        failResult = failTypeStr == "warn" ? stanfordcpplib::autograder::AutograderUnitTestGui::TEST_RESULT_WARN
-                                           : stanfordcpplib::autograder::AutograderUnitTestGui::TEST_RESULT_FAIL;
+        rule.failIsWarning = trim(xmlutils::getAttribute(patternNode, "failtype")) == "warn";
+    }
+    return rule;
+}
+
+const StyleCheckRuleSet* StyleCheckRuleSet::forFile(const std::string& styleXmlFileName) {
+    Map<std::string, StyleCheckRuleSet*>& cache = STATIC_VARIABLE(ruleSetCache);
+    if (!cache.containsKey(styleXmlFileName)) {
+        StyleCheckRuleSet* ruleSet = nullptr;
+        if (fileExists(styleXmlFileName)) {
+            ruleSet = new StyleCheckRuleSet(styleXmlFileName);
+            if (!ruleSet->isLoaded()) {
+                delete ruleSet;
+                ruleSet = nullptr;
+            }
+        }
+        cache[styleXmlFileName] = ruleSet;
+    }
+    return cache[styleXmlFileName];
+}
+
+/*
+ * <stylecheck type="text" filename="life.cpp" omitonpass="true">
+ *     <pattern regex="(\/\/.*)|(\/\*([^*]|([*][^\/])\r?\n?)*\*\/)" mincount="18" description="comments" list="false" />
+ *      ...
+ * </stylecheck>
+ */
+StyleCheckRuleSet::StyleCheckRuleSet(const std::string& styleXmlFileName)
+        : _loaded(false),
+          _omitOnPass(true) {
+    std::shared_ptr<const xmlutils::XmlDocument> document = xmlutils::XmlDocument::open(styleXmlFileName);
+    rapidxml::xml_node<>* styleCheckNode = document ? document->getRootNode("stylecheck") : nullptr;
+    if (!styleCheckNode) {
+        // file is missing or is not a stylecheck document; a malformed file
+        // already signaled an error from XmlDocument::open
+        return;
+    }
+    _omitOnPass = xmlutils::getAttributeBool(styleCheckNode, "omitonpass", true);
+
+    // pattern nodes embedded directly within the document element, then within 'category' nodes
+    for (rapidxml::xml_node<>* patternNode : xmlutils::query(styleCheckNode, "pattern")) {
+        _rules.add(parseRule(patternNode, /* categoryName */ ""));
+    }
+    for (rapidxml::xml_node<>* categoryNode : xmlutils::query(styleCheckNode, "category")) {
+        std::string categoryName = xmlutils::getAttribute(categoryNode, "name");
+        for (rapidxml::xml_node<>* patternNode : xmlutils::query(categoryNode, "pattern")) {
+            _rules.add(parseRule(patternNode, categoryName));
+        }
+    }
+    buildLiteralMatcher();
+    _loaded = true;
+}
+
+void StyleCheckRuleSet::buildLiteralMatcher() {
+    // assign each distinct literal an index
+    Map<std::string, int> literalIndexes;
+    for (const StyleCheckRule& rule : _rules) {
+        if (rule.literal.empty()) {
+            _ruleLiteralIndex.add(-1);
+        } else {
+            if (!literalIndexes.containsKey(rule.literal)) {
+                literalIndexes[rule.literal] = _literals.size();
+                _literals.add(rule.literal);
+            }
+            _ruleLiteralIndex.add(literalIndexes[rule.literal]);
+        }
+    }
+
+    // build the trie; -1 marks a missing edge
+    _transitions.assign(256, -1);
+    _stateOutputs.assign(1, std::vector<int>());
+    for (int lit = 0; lit < _literals.size(); lit++) {
+        int state = 0;
+        for (char ch : _literals[lit]) {
+            int& next = _transitions[state * 256 + (unsigned char) ch];
+            if (next < 0) {
+                next = (int) _stateOutputs.size();
+                _stateOutputs.push_back(std::vector<int>());
+                _transitions.resize(_transitions.size() + 256, -1);
+            }
+            state = _transitions[state * 256 + (unsigned char) ch];
+        }
+        _stateOutputs[state].push_back(lit);
+    }
+
+    // breadth-first pass to fill in failure transitions and merge outputs
+    std::vector<int> fail(_stateOutputs.size(), 0);
+    std::queue<int> queue;
+    for (int c = 0; c < 256; c++) {
+        int& next = _transitions[c];
+        if (next < 0) {
+            next = 0;
+        } else {
+            queue.push(next);
+        }
+    }
+    while (!queue.empty()) {
+        int state = queue.front();
+        queue.pop();
+        const std::vector<int>& failOutputs = _stateOutputs[fail[state]];
+        _stateOutputs[state].insert(_stateOutputs[state].end(), failOutputs.begin(), failOutputs.end());
+        for (int c = 0; c < 256; c++) {
+            int next = _transitions[state * 256 + c];
+            int failNext = _transitions[fail[state] * 256 + c];
+            if (next < 0) {
+                _transitions[state * 256 + c] = failNext;
+            } else {
+                fail[next] = failNext;
+                queue.push(next);
+            }
+        }
+    }
+}
+
+const StyleCheckRule& StyleCheckRuleSet::getRule(int index) const {
+    return _rules[index];
+}
+
+bool StyleCheckRuleSet::isLoaded() const {
+    return _loaded;
+}
+
+bool StyleCheckRuleSet::omitOnPass() const {
+    return _omitOnPass;
+}
+
+int StyleCheckRuleSet::size() const {
+    return _rules.size();
+}
+
+Vector<StyleCheckResult> StyleCheckRuleSet::scan(const std::string& codeFileText) const {
+    Vector<StyleCheckResult> results(_rules.size());
+
+    // one pass to find which literals occur anywhere in the text
+    std::vector<bool> literalFound(_literals.size(), false);
+    int foundCount = 0;
+    int state = 0;
+    for (size_t i = 0; i < codeFileText.length() && foundCount < _literals.size(); i++) {
+        state = _transitions[state * 256 + (unsigned char) codeFileText[i]];
+        for (int lit : _stateOutputs[state]) {
+            if (!literalFound[lit]) {
+                literalFound[lit] = true;
+                foundCount++;
+            }
+        }
     }
 
-    // see if student's code text matches the regex
+    std::vector<int> newlines;
+    bool newlinesIndexed = false;
+    bool linearEnabled = isRegexLinearMatchingEnabled();
+    std::vector<int> matchStarts;
+    for (int r = 0; r < _rules.size(); r++) {
+        int lit = _ruleLiteralIndex[r];
+        if (lit >= 0 && !literalFound[lit]) {
+            continue;   // regex can't match without its literal
+        }
+        const StyleCheckRule& rule = _rules[r];
+        if (rule.list && !newlinesIndexed) {
+            for (size_t i = 0; i < codeFileText.length(); i++) {
+                if (codeFileText[i] == '\n') {
+                    newlines.push_back((int) i);
+                }
+            }
+            newlinesIndexed = true;
+        }
+        matchStarts.clear();
+        if (linearEnabled && rule.linear->isSupported()) {
+            rule.linear->findAll(codeFileText, matchStarts);
+        } else {
+            for (std::sregex_iterator itr(codeFileText.begin(), codeFileText.end(), rule.regex), end;
+                    itr != end;
+                    ++itr) {
+                matchStarts.push_back((int) itr->position());
+            }
+        }
+        StyleCheckResult& result = results[r];
+        result.matchCount = (int) matchStarts.size();
+        if (rule.list) {
+            for (int matchIndex : matchStarts) {
+                // line number = 1 + number of newlines before the match
+                result.lines.add(1 + (int) (std::lower_bound(newlines.begin(), newlines.end(), matchIndex)
+                                             - newlines.begin()));
+            }
+        }
+    }
+    return results;
+}
+
+Vector<Vector<StyleCheckResult> > StyleCheckRuleSet::scanFiles(const Vector<std::string>& codeFileNames,
+                                                               int threadCount) const {
+    Vector<Vector<StyleCheckResult> > results(codeFileNames.size());
+    if (threadCount <= 0) {
+        threadCount = std::max(1, (int) std::thread::hardware_concurrency());
+    }
+    threadCount = std::min(threadCount, codeFileNames.size());
+
+    // each thread repeatedly claims the next unscanned file
+    std::atomic<int> nextFile(0);
+    auto scanRemainingFiles = [&]() {
+        for (int i = nextFile++; i < codeFileNames.size(); i = nextFile++) {
+            std::string codeFileText;
+            if (readEntireFile(codeFileNames[i], codeFileText)) {
+                results[i] = scan(codeFileText);
+            }
+        }
+    };
+    std::vector<std::thread> threads;
+    for (int t = 1; t < threadCount; t++) {
+        threads.push_back(std::thread(scanRemainingFiles));
+    }
+    scanRemainingFiles();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    return results;
+}
+
+static bool reportRule(const std::string& codeFileName,
+                       const StyleCheckRule& rule,
+                       const StyleCheckResult& result,
+                       bool omitOnPass) {
+    std::ostringstream out;
+    std::string patternDescription = rule.description;
+    int patternMinCount = rule.minCount;
+    int patternMaxCount = rule.maxCount;
+    int matchCount = result.matchCount;
+    std::string categoryName = rule.categoryName;
+
+    stanfordcpplib::autograder::AutograderUnitTestGui::TestResult failResult = rule.failIsWarning
+            ? stanfordcpplib::autograder::AutograderUnitTestGui::TEST_RESULT_WARN
+            : stanfordcpplib::autograder::AutograderUnitTestGui::TEST_RESULT_FAIL;
+
+    // concatenate the match lines into a string like "1, 4, 7, 7, 19"
     std::string linesStr;
-    int matchCount;
-    if (patternList) {
-        matchCount = regexMatchCountWithLines(codeFileText, patternRegex, linesStr);
-    } else {
-        matchCount = regexMatchCount(codeFileText, patternRegex);
+    for (int i = 0; i < result.lines.size(); i++) {
+        if (i > 0) {
+            linesStr += ", ";
+        }
+        linesStr += integerToString(result.lines[i]);
     }
-    
+
     std::string rangeStr = "";
     if (patternMinCount == patternMaxCount) {
         rangeStr = "should occur exactly " + integerToString(patternMinCount) + " times";
@@ -144,7 +521,7 @@ static bool processPatternNode(const std::string& codeFileName,
                         testFullName, deets);
             out.str("");
         } else {
-            if (showCounts) {
+            if (rule.showCounts) {
                 out << "         " << rangeStr << std::endl;
                 out << "         actually occurs " << matchCount << " time(s)";
                 if ((int) linesStr.length() > 0) {
@@ -167,26 +544,14 @@ bool isStyleCheckMergedWithUnitTests() {
 }
 
 /*
- * <stylecheck type="text" filename="life.cpp" omitonpass="true">
- *     <pattern regex="(\/\/.*)|(\/\*([^*]|([*][^\/])\r?\n?)*\*\/)" mincount="18" description="comments" list="false" />
- *      ...
- * </stylecheck>
+ * Prints the header and then the result of each rule for one code file.
  */
-void styleCheck(const std::string& codeFileName, const std::string& styleXmlFileName, bool printWarning) {
-    if (!fileExists(codeFileName)) {
-        std::cerr << "Warning: file not found: " << codeFileName << std::endl;
-        std::cerr << "Cannot perform style check. Aborting. " << std::endl;
-        return;
-    }
-
-    std::string codeFileText = readEntireFile(codeFileName);
-    rapidxml::xml_node<>* styleCheckNode = xmlutils::openXmlDocument(styleXmlFileName, "stylecheck");
-    if (!styleCheckNode) {
-        // file was not found or could not be parsed
-        return;
-    }
-
-    bool omitOnPass = xmlutils::getAttributeBool(styleCheckNode, "omitonpass", true);
+static void reportStyleCheck(const std::string& codeFileName,
+                             const std::string& styleXmlFileName,
+                             const StyleCheckRuleSet& ruleSet,
+                             const Vector<StyleCheckResult>& results,
+                             bool printWarning) {
+    bool omitOnPass = ruleSet.omitOnPass();
 
     std::ostringstream out;
     out << "STYLE CHECK for " << codeFileName << " based on rules in "
@@ -214,45 +579,72 @@ void styleCheck(const std::string& codeFileName, const std::string& styleXmlFile
     }
     autograder::showOutput(out, /* graphical */ false, /* console */ true);
 
-    if (!fileExists(codeFileName)) {
-        out << "*** ERROR: Student code file \"" << codeFileName
-            << "\" not found in build folder. Exiting." << std::endl;
-        autograder::showOutput(out);
-        return;
+    int testCount = 0;
+    int passCount = 0;
+    for (int i = 0; i < ruleSet.size(); i++) {
+        const StyleCheckRule& rule = ruleSet.getRule(i);
+        testCount++;
+        if (reportRule(codeFileName, rule, results[i], omitOnPass)) {
+            passCount++;
+        }
+        if (!rule.categoryName.empty() && !STATIC_VARIABLE(styleChecksMerged)) {
+            autograder::setTestCounts(passCount, testCount, /* isStyleCheck */ true);
+        }
     }
+
+    out << "    STYLE CHECK: passed " << passCount << " of " << testCount << " checks." << std::endl;
+    autograder::showOutput(out, /* graphical */ false, /* console */ true);
+}
+
+/*
+ * Prints an error and returns nullptr if the given XML file can't be used.
+ */
+static const StyleCheckRuleSet* loadRuleSet(const std::string& styleXmlFileName) {
     if (!fileExists(styleXmlFileName)) {
+        std::ostringstream out;
         out << "*** ERROR: XML style checklist file \"" << styleXmlFileName
             << "\" not found in build folder. Exiting." << std::endl;
         autograder::showOutput(out);
-        return;
+        return nullptr;
     }
+    return StyleCheckRuleSet::forFile(styleXmlFileName);
+}
 
-    // loop over each pattern node
-    // handle each pattern node embedded directly within the document element of 'stylecheck'
-    int testCount = 0;
-    int passCount = 0;
-    for (rapidxml::xml_node<>* patternNode : xmlutils::getChildNodes(styleCheckNode, "pattern")) {
-        testCount++;
-        if (processPatternNode(codeFileName, patternNode, /* categoryName */ "", codeFileText, omitOnPass)) {
-            passCount++;
-        }
+static void warnFileNotFound(const std::string& codeFileName) {
+    std::cerr << "Warning: file not found: " << codeFileName << std::endl;
+    std::cerr << "Cannot perform style check. Aborting. " << std::endl;
+}
+
+void styleCheck(const std::string& codeFileName, const std::string& styleXmlFileName, bool printWarning) {
+    if (!fileExists(codeFileName)) {
+        warnFileNotFound(codeFileName);
+        return;
+    }
+    const StyleCheckRuleSet* ruleSet = loadRuleSet(styleXmlFileName);
+    if (!ruleSet) {
+        // file was not found or could not be parsed
+        return;
     }
+    std::string codeFileText = readEntireFile(codeFileName);
+    reportStyleCheck(codeFileName, styleXmlFileName, *ruleSet, ruleSet->scan(codeFileText), printWarning);
+}
 
-    // handle each pattern node embedded within a 'category' node
-    for (rapidxml::xml_node<>* categoryNode : xmlutils::getChildNodes(styleCheckNode, "category")) {
-        std::string categoryName = xmlutils::getAttribute(categoryNode, "name");
-        for (rapidxml::xml_node<>* patternNode : xmlutils::getChildNodes(categoryNode, "pattern")) {
-            testCount++;
-            if (processPatternNode(codeFileName, patternNode, categoryName, codeFileText, omitOnPass)) {
-                passCount++;
-            }
-            if (!STATIC_VARIABLE(styleChecksMerged)) {
-                autograder::setTestCounts(passCount, testCount, /* isStyleCheck */ true);
-            }
+void styleCheck(const Vector<std::string>& codeFileNames, const std::string& styleXmlFileName, bool printWarning) {
+    const StyleCheckRuleSet* ruleSet = loadRuleSet(styleXmlFileName);
+    if (!ruleSet) {
+        return;
+    }
+    Vector<Vector<StyleCheckResult> > results = ruleSet->scanFiles(codeFileNames);
+    for (int i = 0; i < codeFileNames.size(); i++) {
+        if (!fileExists(codeFileNames[i])) {
+            warnFileNotFound(codeFileNames[i]);
+            continue;
+        }
+        reportStyleCheck(codeFileNames[i], styleXmlFileName, *ruleSet, results[i], printWarning);
+        printWarning = false;
+        if (!autograder::isGraphicalUI()) {
+            std::cout << AUTOGRADER_OUTPUT_SEPARATOR << std::endl;
         }
     }
-
-    out << "    STYLE CHECK: passed " << passCount << " of " << testCount << " checks." << std::endl;
-    autograder::showOutput(out, /* graphical */ false, /* console */ true);
 }
 } // namespace stylecheck
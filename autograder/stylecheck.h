@@ -5,6 +5,11 @@
  * checking on C++ code.
  * 
  * @author Marty Stepp
+ * @version 2018/10/19
+ * - rules are matched with the library's linear-time matcher when it supports them
+ * @version 2018/10/10
+ * - added StyleCheckRuleSet, compiled once per XML file and scanned in one pass
+ * - added styleCheck overload to check many files in parallel
  * @version 2016/10/08
  * - added setStyleCheckMergedWithUnitTests;
  *   ability to merge style checks with regular unit tests
@@ -16,12 +21,115 @@
 #ifndef _stylecheck_h
 #define _stylecheck_h
 
+#include <memory>
+#include <regex>
 #include <string>
+#include <vector>
+#include "vector.h"
+
+namespace stanfordcpplib {
+class LinearRegex;
+}
 
 namespace stylecheck {
+
+/*
+ * One <pattern> rule from a style check XML file, with its regex compiled.
+ */
+struct StyleCheckRule {
+    std::string categoryName;   // enclosing <category> name, or ""
+    std::string description;
+    std::string regexText;      // with (:IDENTIFIER:) etc. already expanded
+    std::regex regex;
+    std::shared_ptr<const stanfordcpplib::LinearRegex> linear;   // used instead of regex if supported
+    std::string literal;        // text every match must contain, or "" if unknown
+    int minCount;
+    int maxCount;
+    bool list;                  // whether to report line numbers of matches
+    bool showCounts;
+    bool failIsWarning;         // failtype="warn" (the default) vs. "fail"
+};
+
+/*
+ * How many times one rule matched a file, and on which lines
+ * (lines are only filled in for rules whose 'list' flag is set).
+ */
+struct StyleCheckResult {
+    int matchCount;
+    Vector<int> lines;
+
+    StyleCheckResult() : matchCount(0) {}
+};
+
+/*
+ * All of the rules in one style check XML file, parsed and compiled once.
+ * Scanning a file first runs a single Aho-Corasick pass over its text to
+ * find which rules' required literals occur; rules whose literal is absent
+ * cannot match and are skipped without running their regex.
+ * Rules run on the library's linear-time matcher (see regexpr.h) when it
+ * supports their regex, as regexMatchCountWithLines does.
+ * A rule set is immutable once built, so one set can scan many files at
+ * once from different threads.
+ */
+class StyleCheckRuleSet {
+public:
+    /*
+     * Returns the rule set for the given XML file, loading it the first
+     * time it is requested and reusing it afterward.
+     * Returns nullptr if the file is missing or has no <stylecheck> element.
+     */
+    static const StyleCheckRuleSet* forFile(const std::string& styleXmlFileName);
+
+    /*
+     * Parses and compiles the rules in the given XML file;
+     * call isLoaded to see whether this succeeded.
+     */
+    StyleCheckRuleSet(const std::string& styleXmlFileName);
+
+    const StyleCheckRule& getRule(int index) const;
+    bool isLoaded() const;
+    bool omitOnPass() const;
+    int size() const;
+
+    /*
+     * Checks the given code text against every rule, returning one result
+     * per rule in rule order.
+     */
+    Vector<StyleCheckResult> scan(const std::string& codeFileText) const;
+
+    /*
+     * Reads and scans each of the given files, using up to threadCount
+     * threads at once (0 for one per processor core).
+     * Returns one vector of results per file, in file order; a file that
+     * cannot be read gets an empty vector.
+     */
+    Vector<Vector<StyleCheckResult> > scanFiles(const Vector<std::string>& codeFileNames,
+                                                int threadCount = 0) const;
+
+private:
+    void buildLiteralMatcher();
+
+    Vector<StyleCheckRule> _rules;
+    bool _loaded;
+    bool _omitOnPass;
+
+    // Aho-Corasick automaton over rule literals; a full transition table
+    // (256 entries per state) so scanning does one lookup per character
+    std::vector<int> _transitions;
+    std::vector<std::vector<int> > _stateOutputs;   // literal indexes ending at each state
+    Vector<std::string> _literals;                  // distinct literals
+    Vector<int> _ruleLiteralIndex;                  // literal index for each rule, or -1
+};
+
 bool isStyleCheckMergedWithUnitTests();
 void setStyleCheckMergedWithUnitTests(bool merged = true);
 void styleCheck(const std::string& codeFileName, const std::string& styleXmlFileName = "stylecheck.xml", bool printWarning = true);
+
+/*
+ * Checks each of the given files against the same rules, scanning them in
+ * parallel and then reporting results one file at a time, in order.
+ */
+void styleCheck(const Vector<std::string>& codeFileNames, const std::string& styleXmlFileName = "stylecheck.xml", bool printWarning = true);
 } // namespace stylecheck
 
 #endif // _stylecheck_h
@@ -0,0 +1,128 @@
+/*
+ * File: testresultcache.h
+ * -----------------------
+ * This file contains declarations of code to record the outcome of each test
+ * case as a sequence of events, and to cache those outcomes on disk so that
+ * a regrade can skip tests whose student code and test code are unchanged.
+ *
+ * @author Marty Stepp
+ * @version 2018/10/19
+ * - added hasCachedTestResult
+ * @version 2018/10/15
+ * - key includes the test's whole file, local headers, and named data files
+ * - timed out and crashed tests are not cached
+ * @version 2018/10/08
+ * - initial version
+ * @since 2018/10/08
+ */
+
+#ifndef _testresultcache_h
+#define _testresultcache_h
+
+#include <string>
+#include "autogradertest.h"
+#include "gtest.h"
+#include "unittestdetails.h"
+#include "vector.h"
+
+namespace autograder {
+
+/*
+ * One thing that happened while a test ran that affects how its result is
+ * reported, such as a call to setFailDetails or a failed assertion.
+ * Replaying a test's events in order reproduces its reported result.
+ */
+struct TestResultEvent {
+    static const char DETAILS;   // setFailDetails was called
+    static const char PART;      // a gtest assertion failed
+    static const char TIMEOUT;   // test's own timeout, in ms
+    static const char END;       // test ran to completion
+
+    char kind;                   // one of the constants above
+    UnitTestDetails details;     // for DETAILS
+    int partType;                // for PART: a ::testing::TestPartResult::Type
+    std::string file;
+    int line;
+    std::string message;
+    int timeoutMS;               // for TIMEOUT
+
+    TestResultEvent();
+};
+
+/*
+ * Converts the given event to/from a compact string form: a kind character
+ * followed by length-prefixed fields ("<length>:<bytes>").
+ * decodeTestResultEvent reads the event starting at index pos of the given
+ * string and advances pos past it; it returns false (leaving pos alone)
+ * if the string does not yet contain the whole event.
+ */
+std::string encodeTestResultEvent(const TestResultEvent& event);
+bool decodeTestResultEvent(const std::string& in, size_t& pos, TestResultEvent& event);
+
+/*
+ * Reports the given recorded events to the given (currently running) test,
+ * as though they had just happened.
+ */
+void replayTestResultEvents(AutograderTest& test, const Vector<TestResultEvent>& events);
+
+/*
+ * A gtest listener that records the events of each test that was not found
+ * in the result cache and saves them to the cache when the test ends.
+ * Does nothing if no cache directory has been set.
+ */
+class TestResultCacheRecorder : public ::testing::EmptyTestEventListener {
+public:
+    virtual void OnTestPartResult(const ::testing::TestPartResult& test_part_result);
+    virtual void OnTestEnd(const ::testing::TestInfo& test_info);
+};
+
+/*
+ * Returns a one-line summary of cache hits and misses since the last call
+ * to resetTestResultCacheStats.
+ */
+std::string getTestResultCacheReport();
+
+/*
+ * Called internally by setFailDetails; records the given details if the
+ * current test's result is going to be saved to the cache.
+ */
+void recordTestResultCacheFailDetails(const UnitTestDetails& deets);
+
+/*
+ * Called internally by the parallel test runner before it starts a worker
+ * process for a test.  Returns true if the result cache has an entry for
+ * the test with the given category and name, which replayCachedTestResult
+ * will report when the test's turn comes, so there is no need to run it.
+ */
+bool hasCachedTestResult(const std::string& category, const std::string& name);
+
+/*
+ * Called internally by the TIMED_TEST macros.
+ * Looks up the given test in the result cache, if one is set.
+ * The cache key is a hash of the student's code (the files passed to
+ * setTestResultCacheSourceFiles, or else the executable), the test's full
+ * name, and the whole source file that defines the test (which includes
+ * any stdin and random feed values it passes in), along with the local
+ * headers that file includes and any files named in its string literals,
+ * such as expected output files.  Nothing is cached if any of these files
+ * can't be read.
+ * On a hit, reports the cached result to the test and returns true;
+ * otherwise arranges for the result to be saved and returns false.
+ */
+bool replayCachedTestResult(AutograderTest* test);
+
+/*
+ * Called internally when a test times out, crashes, or is halted; keeps the
+ * current test's result out of the cache, since the next run of the same
+ * code may well finish normally.
+ */
+void discardTestResultCacheEntry();
+
+/*
+ * Sets the cache hit/miss counts back to 0.
+ */
+void resetTestResultCacheStats();
+
+} // namespace autograder
+
+#endif // _testresultcache_h
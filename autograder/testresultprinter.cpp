@@ -6,6 +6,8 @@
  * See testresultprinter.h for declarations and documentation.
  *
  * @author Marty Stepp
+ * @version 2018/10/05
+ * - text printer stays quiet inside test worker processes
  * @version 2018/08/27
  * - refactored to use AutograderUnitTestGui cpp class
  * @version 2018/01/23
@@ -25,6 +27,7 @@
 #include "autograder.h"
 #include "autograderunittestgui.h"
 #include "stringutils.h"
+#include "threading.h"
 #include "private/static.h"
 
 static std::string UNIT_TEST_TYPE_NAMES[11] = {
@@ -78,6 +81,9 @@ int MartyTestResultPrinter::getTestNameWidth() const {
 }
 
 void MartyTestResultPrinter::OnTestStart(const ::testing::TestInfo& test_info) {
+    if (isTestWorkerProcess()) {
+        return;   // parent process prints this test's results
+    }
     testInProgress = true;
     testCount++;
     std::string testFullName = test_info.full_name();
@@ -88,6 +94,9 @@ void MartyTestResultPrinter::OnTestStart(const ::testing::TestInfo& test_info) {
 }
 
 void MartyTestResultPrinter::OnTestPartResult(const ::testing::TestPartResult& test_part_result) {
+    if (isTestWorkerProcess()) {
+        return;   // parent process prints this test's results
+    }
     if (test_part_result.failed()) {
         failCountThisTest++;
         if (failCountThisTest == 1) {
@@ -110,6 +119,9 @@ void MartyTestResultPrinter::OnTestPartResult(const ::testing::TestPartResult& t
 }
 
 void MartyTestResultPrinter::OnTestEnd(const ::testing::TestInfo& test_info) {
+    if (isTestWorkerProcess()) {
+        return;   // parent process prints this test's results
+    }
     if (autograder::getFlags().testTimers[test_info.full_name()].isStarted()) {
         autograder::getFlags().testTimers[test_info.full_name()].stop();
     }
@@ -128,6 +140,9 @@ void MartyTestResultPrinter::OnTestEnd(const ::testing::TestInfo& test_info) {
 }
 
 void MartyTestResultPrinter::OnTestProgramEnd(const ::testing::UnitTest& unit_test) {
+    if (isTestWorkerProcess()) {
+        return;   // parent process prints the summary
+    }
     std::cout << "====================================================================" << std::endl;
     int testCount = unit_test.total_test_count();
     int failCount = unit_test.failed_test_count();
@@ -5,6 +5,15 @@
  * with a timeout, possibly in a separate thread depending on the platform.
  *
  * @author Marty Stepp
+ * @version 2018/10/19
+ * - each worker runs in its own process group; a timeout kills the whole group
+ * - no worker process is started for a test with a cached result
+ * - worker processes run only the tests selected by --gtest_filter
+ * - worker processes fail fast on calls that need the Qt GUI thread
+ * @version 2018/10/08
+ * - worker results use the shared TestResultEvent record format
+ * @version 2018/10/05
+ * - added process-based parallel test runner with per-test resource limits
  * @version 2018/08/27
  * - refactored to use AutograderUnitTestGui cpp class
  * @version 2018/01/23
@@ -23,11 +32,72 @@
 #include "autogradertest.h"
 #include "autograderunittestgui.h"
 #include "exceptions.h"
+#include "gthread.h"
+#include "strlib.h"
+#include "testresultcache.h"
 #include "private/static.h"
 
 STATIC_CONST_VARIABLE_DECLARE(std::string, TIMEOUT_ERROR_MESSAGE, "test timed out! possible infinite loop")
 // STATIC_CONST_VARIABLE_DECLARE(std::string, EXCEPTION_ERROR_MESSAGE, "test threw an exception!")
 
+/*
+ * Everything the parent learned about one test run in a worker process.
+ * The worker streams its events over a pipe in encodeTestResultEvent form.
+ */
+struct TestWorkerResult {
+    Vector<autograder::TestResultEvent> events;
+    std::string output;
+    long elapsedMS;
+    bool cacheable;   // false if the worker timed out, crashed, or was halted
+
+    TestWorkerResult() : elapsedMS(0), cacheable(true) {}
+};
+
+STATIC_VARIABLE_DECLARE_MAP_EMPTY(Map, std::string, TestWorkerResult, TEST_WORKER_RESULTS)
+STATIC_VARIABLE_DECLARE(int, TEST_WORKER_RESULT_FD, -1)
+STATIC_VARIABLE_DECLARE_BLANK(std::string, TEST_WORKER_REPORT)
+
+static void writeTestWorkerRecord(const autograder::TestResultEvent& event);
+
+void clearTestWorkerResults() {
+    STATIC_VARIABLE(TEST_WORKER_RESULTS).clear();
+}
+
+std::string getTestWorkerReport() {
+    return STATIC_VARIABLE(TEST_WORKER_REPORT);
+}
+
+bool isTestWorkerProcess() {
+    return STATIC_VARIABLE(TEST_WORKER_RESULT_FD) >= 0;
+}
+
+void recordTestWorkerFailDetails(const autograder::UnitTestDetails& deets) {
+    if (isTestWorkerProcess()) {
+        autograder::TestResultEvent event;
+        event.kind = autograder::TestResultEvent::DETAILS;
+        event.details = deets;
+        writeTestWorkerRecord(event);
+    }
+}
+
+bool replayTestWorkerResult(autograder::AutograderTest* test) {
+    std::string key = test->getCategory() + "." + test->getName();
+    if (isTestWorkerProcess() || !STATIC_VARIABLE(TEST_WORKER_RESULTS).containsKey(key)) {
+        return false;
+    }
+
+    const TestWorkerResult& result = STATIC_VARIABLE(TEST_WORKER_RESULTS)[key];
+    if (!result.cacheable) {
+        autograder::discardTestResultCacheEntry();
+    }
+    if (!result.output.empty()) {
+        std::cout << result.output;
+        std::cout.flush();
+    }
+    autograder::replayTestResultEvents(*test, result.events);
+    return true;
+}
+
 #ifdef _WIN32
 #include <windows.h>
 #include <tchar.h>
@@ -77,6 +147,7 @@ void runTestWithTimeout(autograder::AutograderTest* test) {
             autograder::setFailDetails(autograder::UnitTestDetails(
                 autograder::UnitTestType::TEST_FAIL,
                 STATIC_VARIABLE(TIMEOUT_ERROR_MESSAGE)));
+            autograder::discardTestResultCacheEntry();
             error(STATIC_VARIABLE(TIMEOUT_ERROR_MESSAGE));
         }
     } else {
@@ -85,6 +156,18 @@ void runTestWithTimeout(autograder::AutograderTest* test) {
     }
 }
 
+/*
+ * Worker processes need fork(), which Windows lacks; tests always run serially.
+ */
+static void writeTestWorkerRecord(const autograder::TestResultEvent& /*event*/) {
+    // empty
+}
+
+bool runTestsInWorkerProcesses(int /*workerCount*/, int /*cpuLimitSeconds*/,
+                               int /*memoryLimitMB*/, int /*outputLimitBytes*/) {
+    return false;
+}
+
 #else // not _WIN32
 #ifdef __APPLE__
 #include <errno.h>
@@ -145,8 +228,19 @@ int pthread_timedjoin_np(pthread_t td, void** res, struct timespec* ts) {
     return args.joined ? 0 : ETIMEDOUT;
 }
 #endif // __APPLE__
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
 #include <pthread.h>
+#include <sys/resource.h>
 #include <sys/time.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <sstream>
 
 void my_unexpected() {
     std::cout << "my_unexpected was called! STACK:" << std::endl;
@@ -173,8 +267,11 @@ static void failWithException(autograder::AutograderTest* test, std::string kind
     autograder::setFailDetails(*test, autograder::UnitTestDetails(
         autograder::UnitTestType::TEST_EXCEPTION,
         errorMessage));
-    stanfordcpplib::autograder::AutograderUnitTestGui::instance()->setTestResult(
-                test->getFullName(), stanfordcpplib::autograder::AutograderUnitTestGui::TEST_RESULT_FAIL);
+    if (!isTestWorkerProcess()) {
+        // a worker has no GUI thread; its parent records the result
+        stanfordcpplib::autograder::AutograderUnitTestGui::instance()->setTestResult(
+                    test->getFullName(), stanfordcpplib::autograder::AutograderUnitTestGui::TEST_RESULT_FAIL);
+    }
     pthread_exit((void*) nullptr);
 }
 
@@ -250,6 +347,14 @@ void runTestWithTimeout(autograder::AutograderTest* test) {
     bool runInThread = stanfordcpplib::autograder::AutograderUnitTestGui::instance()->runTestsInSeparateThreads();
     test->setShouldRunInOwnThread(runInThread);
 
+    if (isTestWorkerProcess()) {
+        // let the parent know how long to wait for this test before killing it
+        autograder::TestResultEvent event;
+        event.kind = autograder::TestResultEvent::TIMEOUT;
+        event.timeoutMS = test->getTestTimeout();
+        writeTestWorkerRecord(event);
+    }
+
     if (test->shouldRunInOwnThread()) {
         // create a new pthread and run the test in that thread
         pthread_t thread;
@@ -273,6 +378,7 @@ void runTestWithTimeout(autograder::AutograderTest* test) {
             autograder::setFailDetails(*test, autograder::UnitTestDetails(
                 autograder::UnitTestType::TEST_FAIL,
                 STATIC_VARIABLE(TIMEOUT_ERROR_MESSAGE)));
+            autograder::discardTestResultCacheEntry();
             error(STATIC_VARIABLE(TIMEOUT_ERROR_MESSAGE));
         } else if (joinResult != 0) {
             // something went wrong, e.g. exception thrown
@@ -284,4 +390,540 @@ void runTestWithTimeout(autograder::AutograderTest* test) {
     }
 }
 
+/*
+ * Writes all of the given bytes to the given file descriptor,
+ * retrying after short writes and signal interruptions.
+ */
+static bool writeFully(int fd, const char* data, size_t length) {
+    while (length > 0) {
+        ssize_t written = write(fd, data, length);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        length -= (size_t) written;
+    }
+    return true;
+}
+
+static void writeTestWorkerRecord(const autograder::TestResultEvent& event) {
+    int fd = STATIC_VARIABLE(TEST_WORKER_RESULT_FD);
+    if (fd >= 0) {
+        std::string record = autograder::encodeTestResultEvent(event);
+        writeFully(fd, record.c_str(), record.length());
+    }
+}
+
+/*
+ * A stream buffer that writes to a raw file descriptor.
+ * Used to point cout/cerr at the output pipe in a worker process,
+ * since the console's usual stream buffer talks to the Qt GUI thread,
+ * which does not exist in a forked child.
+ */
+class FdOutputStreambuf : public std::streambuf {
+public:
+    FdOutputStreambuf(int fd) : _fd(fd) {
+        setp(_buffer, _buffer + BUFFER_SIZE);
+    }
+
+    ~FdOutputStreambuf() {
+        sync();
+    }
+
+protected:
+    virtual int_type overflow(int_type ch) {
+        if (sync() != 0) {
+            return traits_type::eof();
+        }
+        if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+            *pptr() = traits_type::to_char_type(ch);
+            pbump(1);
+        }
+        return traits_type::not_eof(ch);
+    }
+
+    virtual int sync() {
+        size_t length = (size_t) (pptr() - pbase());
+        bool ok = writeFully(_fd, pbase(), length);
+        setp(_buffer, _buffer + BUFFER_SIZE);
+        return ok ? 0 : -1;
+    }
+
+private:
+    static const int BUFFER_SIZE = 4096;
+    int _fd;
+    char _buffer[BUFFER_SIZE];
+};
+
+/*
+ * A gtest listener installed only in worker processes;
+ * forwards each failed assertion to the parent as soon as it happens,
+ * so that failures before a later crash are not lost.
+ */
+class TestWorkerRecorder : public ::testing::EmptyTestEventListener {
+public:
+    virtual void OnTestPartResult(const ::testing::TestPartResult& part) {
+        if (part.failed()) {
+            autograder::TestResultEvent event;
+            event.kind = autograder::TestResultEvent::PART;
+            event.partType = (int) part.type();
+            event.file = part.file_name() ? part.file_name() : "";
+            event.line = part.line_number();
+            event.message = part.message();
+            writeTestWorkerRecord(event);
+        }
+    }
+};
+
+/*
+ * Parent-side bookkeeping for one running worker process.
+ */
+struct TestWorker {
+    pid_t pid;
+    int outputFd;
+    int resultFd;
+    std::string testName;    // "Category.TestName", as gtest names it
+    long startMS;
+    long deadlineMS;
+    std::string resultBuffer;
+    size_t resultPos;
+    bool finished;           // child sent an END event
+    bool timedOut;
+    bool outputExceeded;
+    long cpuMS;              // user + system CPU time, once the worker is reaped
+    TestWorkerResult result;
+};
+
+static void setResourceLimit(int resource, rlim_t limit) {
+    struct rlimit rl;
+    rl.rlim_cur = limit;
+    rl.rlim_max = limit;
+    setrlimit(resource, &rl);
+}
+
+/*
+ * Body of a forked worker process: runs exactly one test and exits.
+ * Never returns.
+ *
+ * The parent is multithreaded when it forks (the Qt GUI thread is running),
+ * and the child gets only a copy of the forking thread.  Anything another
+ * thread had locked at that moment stays locked in the child, so the child
+ * must not touch state that the other threads use.  glibc's fork resets the
+ * malloc and stdio locks; beyond that, the child does only async-signal-safe
+ * system calls until it has pointed cin/cout/cerr away from the console
+ * window (whose buffers the GUI thread shares) and turned off
+ * GThread::runOnQtGuiThread, so that a test that tries to use graphics fails
+ * with an error rather than waiting forever for a thread that is not there.
+ */
+static void runTestInWorkerChild(const std::string& testName, int outputFd, int resultFd,
+                                 int cpuLimitSeconds, int memoryLimitMB) {
+    // stdin/stdout/stderr become /dev/null and the output pipe, at the fd level,
+    // so output from printf and from any child processes is captured too
+    int devNull = open("/dev/null", O_RDONLY);
+    if (devNull >= 0) {
+        dup2(devNull, STDIN_FILENO);
+        close(devNull);
+    }
+    dup2(outputFd, STDOUT_FILENO);
+    dup2(outputFd, STDERR_FILENO);
+    close(outputFd);
+
+    if (cpuLimitSeconds > 0) {
+        setResourceLimit(RLIMIT_CPU, (rlim_t) cpuLimitSeconds);
+    }
+    if (memoryLimitMB > 0) {
+        setResourceLimit(RLIMIT_AS, (rlim_t) memoryLimitMB * 1024 * 1024);
+    }
+
+    FdOutputStreambuf outBuf(STDOUT_FILENO);
+    FdOutputStreambuf errBuf(STDERR_FILENO);
+    std::istringstream emptyInput;
+    std::cout.rdbuf(&outBuf);
+    std::cerr.rdbuf(&errBuf);
+    std::cin.rdbuf(emptyInput.rdbuf());
+    GThread::_autograder_setQtGuiThreadAvailable(false);
+
+    STATIC_VARIABLE(TEST_WORKER_RESULT_FD) = resultFd;
+    ::testing::UnitTest::GetInstance()->listeners().Append(new TestWorkerRecorder());
+    ::testing::GTEST_FLAG(filter) = testName;
+    ::testing::GTEST_FLAG(repeat) = 1;
+    int result = RUN_ALL_TESTS();
+
+    std::cout.flush();
+    std::cerr.flush();
+    fflush(stdout);
+    fflush(stderr);
+    autograder::TestResultEvent event;
+    event.kind = autograder::TestResultEvent::END;
+    writeTestWorkerRecord(event);
+
+    // skip atexit handlers and static destructors; they belong to the parent
+    _exit(result);
+}
+
+/*
+ * Forks a worker process to run the given test.
+ * Returns false if the pipes or process could not be created.
+ */
+static bool startTestWorker(const std::string& testName, Vector<TestWorker>& workers,
+                            int cpuLimitSeconds, int memoryLimitMB) {
+    int outputPipe[2];
+    int resultPipe[2];
+    if (pipe(outputPipe) != 0) {
+        return false;
+    }
+    if (pipe(resultPipe) != 0) {
+        close(outputPipe[0]);
+        close(outputPipe[1]);
+        return false;
+    }
+
+    // flush so buffered parent output is not duplicated by the child
+    std::cout.flush();
+    fflush(stdout);
+    fflush(stderr);
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(outputPipe[0]);
+        close(outputPipe[1]);
+        close(resultPipe[0]);
+        close(resultPipe[1]);
+        return false;
+    } else if (pid == 0) {
+        // child; its own process group, so that on a timeout the parent can
+        // kill any processes the test started along with it
+        setpgid(0, 0);
+
+        // drop the read ends belonging to the parent and other workers
+        close(outputPipe[0]);
+        close(resultPipe[0]);
+        for (const TestWorker& worker : workers) {
+            if (worker.outputFd >= 0) {
+                close(worker.outputFd);
+            }
+            if (worker.resultFd >= 0) {
+                close(worker.resultFd);
+            }
+        }
+        runTestInWorkerChild(testName, outputPipe[1], resultPipe[1],
+                             cpuLimitSeconds, memoryLimitMB);
+    }
+
+    setpgid(pid, pid);   // also here, in case the parent kills it before it gets to run
+    close(outputPipe[1]);
+    close(resultPipe[1]);
+    TestWorker worker;
+    worker.pid = pid;
+    worker.outputFd = outputPipe[0];
+    worker.resultFd = resultPipe[0];
+    worker.testName = testName;
+    worker.startMS = Timer::currentTimeMS();
+    // generous until the test reports its own timeout; covers fixture setup
+    worker.deadlineMS = worker.startMS + 2 * autograder::AutograderTest::TIMEOUT_MS_DEFAULT;
+    worker.resultPos = 0;
+    worker.finished = false;
+    worker.timedOut = false;
+    worker.outputExceeded = false;
+    worker.cpuMS = 0;
+    workers.add(worker);
+    return true;
+}
+
+/*
+ * Adds a synthetic failure to a worker's result, for deaths that the
+ * child could not report itself (timeouts, crashes, resource limits).
+ */
+static void addWorkerFailure(TestWorkerResult& result, const std::string& message) {
+    autograder::TestResultEvent details;
+    details.kind = autograder::TestResultEvent::DETAILS;
+    details.details = autograder::UnitTestDetails(autograder::UnitTestType::TEST_FAIL, message);
+    result.events.add(details);
+
+    autograder::TestResultEvent part;
+    part.kind = autograder::TestResultEvent::PART;
+    part.partType = (int) ::testing::TestPartResult::kFatalFailure;
+    part.message = message;
+    result.events.add(part);
+}
+
+/*
+ * Reads whatever is available on one of a worker's pipes.
+ * Closes the descriptor and sets it to -1 on end of file.
+ */
+static void readFromWorker(int& fd, std::string& buffer) {
+    char chunk[65536];
+    ssize_t count = read(fd, chunk, sizeof(chunk));
+    if (count > 0) {
+        buffer.append(chunk, (size_t) count);
+    } else if (count == 0 || errno != EINTR) {
+        close(fd);
+        fd = -1;
+    }
+}
+
+/*
+ * Decodes any complete records the worker has sent so far.
+ */
+static void processWorkerRecords(TestWorker& worker);
+
+/*
+ * Kills a worker that ran out of time or printed too much, along with any
+ * processes it started, and closes its pipes.  Whatever is already in the
+ * pipes is read first, without waiting for more; a process the test forked
+ * might still hold the pipes open, so they may never reach end of file.
+ */
+static void killTestWorker(TestWorker& worker) {
+    if (kill(-worker.pid, SIGKILL) != 0) {
+        kill(worker.pid, SIGKILL);
+    }
+    if (worker.resultFd >= 0) {
+        fcntl(worker.resultFd, F_SETFL, O_NONBLOCK);
+        readFromWorker(worker.resultFd, worker.resultBuffer);
+        processWorkerRecords(worker);
+    }
+    if (worker.outputFd >= 0 && !worker.outputExceeded) {
+        fcntl(worker.outputFd, F_SETFL, O_NONBLOCK);
+        readFromWorker(worker.outputFd, worker.result.output);
+    }
+    if (worker.outputFd >= 0) {
+        close(worker.outputFd);
+        worker.outputFd = -1;
+    }
+    if (worker.resultFd >= 0) {
+        close(worker.resultFd);
+        worker.resultFd = -1;
+    }
+}
+
+/*
+ * Decodes any complete records the worker has sent so far.
+ */
+static void processWorkerRecords(TestWorker& worker) {
+    autograder::TestResultEvent event;
+    while (autograder::decodeTestResultEvent(worker.resultBuffer, worker.resultPos, event)) {
+        if (event.kind == autograder::TestResultEvent::END) {
+            worker.finished = true;
+        } else if (event.kind == autograder::TestResultEvent::TIMEOUT) {
+            // child enforces the test's timeout itself; allow a grace period past it
+            worker.deadlineMS = Timer::currentTimeMS() + event.timeoutMS + 1000;
+        } else {
+            worker.result.events.add(event);
+        }
+    }
+}
+
+/*
+ * Reaps a worker whose pipes have both closed, or that was killed,
+ * and records its result.
+ */
+static void finishTestWorker(TestWorker& worker, int outputLimitBytes) {
+    int status = 0;
+    struct rusage usage;
+    std::memset(&usage, 0, sizeof(usage));
+    while (wait4(worker.pid, &status, 0, &usage) < 0 && errno == EINTR) {
+        // retry
+    }
+    worker.cpuMS = (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000L
+            + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000;
+    processWorkerRecords(worker);
+    worker.result.elapsedMS = Timer::currentTimeMS() - worker.startMS;
+
+    worker.result.cacheable = worker.finished && !worker.timedOut && !worker.outputExceeded
+            && !WIFSIGNALED(status);
+    if (worker.timedOut) {
+        addWorkerFailure(worker.result, STATIC_VARIABLE(TIMEOUT_ERROR_MESSAGE));
+    } else if (worker.outputExceeded) {
+        addWorkerFailure(worker.result, "test printed too much output (over "
+                         + integerToString(outputLimitBytes)
+                         + " bytes); halted");
+    } else if (WIFSIGNALED(status)) {
+        int sig = WTERMSIG(status);
+        if (sig == SIGXCPU) {
+            addWorkerFailure(worker.result, "test exceeded its CPU time limit; possible infinite loop");
+        } else {
+            addWorkerFailure(worker.result, "test crashed with signal "
+                             + integerToString(sig) + " (" + strsignal(sig) + ")");
+        }
+    } else if (!worker.finished) {
+        addWorkerFailure(worker.result, "test exited before finishing (exit status "
+                         + integerToString(WIFEXITED(status) ? WEXITSTATUS(status) : -1) + ")");
+    }
+    STATIC_VARIABLE(TEST_WORKER_RESULTS)[worker.testName] = worker.result;
+}
+
+/*
+ * Returns true if the given name matches the given gtest filter pattern,
+ * in which '*' matches any run of characters and '?' matches any one.
+ * The pattern ends at the end of the string or at a ':'.
+ */
+static bool gtestPatternMatches(const char* pattern, const char* name) {
+    switch (*pattern) {
+    case '\0':
+    case ':':
+        return *name == '\0';
+    case '?':
+        return *name != '\0' && gtestPatternMatches(pattern + 1, name + 1);
+    case '*':
+        return (*name != '\0' && gtestPatternMatches(pattern, name + 1))
+                || gtestPatternMatches(pattern + 1, name);
+    default:
+        return *pattern == *name && gtestPatternMatches(pattern + 1, name + 1);
+    }
+}
+
+/*
+ * Returns true if the given name matches any of the ':'-separated patterns.
+ */
+static bool gtestPatternsMatch(const std::string& patterns, const std::string& name) {
+    const char* pattern = patterns.c_str();
+    while (true) {
+        if (gtestPatternMatches(pattern, name.c_str())) {
+            return true;
+        }
+        pattern = strchr(pattern, ':');
+        if (!pattern) {
+            return false;
+        }
+        pattern++;
+    }
+}
+
+/*
+ * Returns true if the test with the given full name ("Category.TestName")
+ * passes the user's --gtest_filter, read the same way gtest reads it:
+ * positive patterns, then optionally '-' and negative patterns.
+ */
+static bool gtestFilterMatches(const std::string& fullName) {
+    const std::string& filter = ::testing::GTEST_FLAG(filter);
+    size_t dash = filter.find('-');
+    std::string positive = filter.substr(0, dash);
+    std::string negative = dash == std::string::npos ? "" : filter.substr(dash + 1);
+    if (positive.empty()) {
+        positive = "*";
+    }
+    return gtestPatternsMatch(positive, fullName)
+            && !(dash != std::string::npos && gtestPatternsMatch(negative, fullName));
+}
+
+bool runTestsInWorkerProcesses(int workerCount, int cpuLimitSeconds,
+                               int memoryLimitMB, int outputLimitBytes) {
+    clearTestWorkerResults();
+    STATIC_VARIABLE(TEST_WORKER_REPORT) = "";
+    if (workerCount <= 1 || isTestWorkerProcess()) {
+        return false;
+    }
+
+    // make sure shared singletons exist before forking, so that
+    // children never construct them (and touch the GUI) on their own
+    stanfordcpplib::autograder::AutograderUnitTestGui::instance();
+
+    // each child runs its one test with the filter set to just that test's
+    // name, so pick only the tests that the user's own filter would run;
+    // tests in the result cache are left for RUN_ALL_TESTS to replay, and
+    // it saves the results of the others to the cache as it reports them
+    Vector<std::string> testNames;
+    int cachedCount = 0;
+    ::testing::UnitTest* unitTest = ::testing::UnitTest::GetInstance();
+    for (int i = 0; i < unitTest->total_test_case_count(); i++) {
+        const ::testing::TestCase* testCase = unitTest->GetTestCase(i);
+        std::string caseName = testCase->name();
+        for (int j = 0; j < testCase->total_test_count(); j++) {
+            std::string name = testCase->GetTestInfo(j)->name();
+            bool disabled = startsWith(caseName, "DISABLED_") || startsWith(name, "DISABLED_");
+            if ((disabled && !::testing::GTEST_FLAG(also_run_disabled_tests))
+                    || !gtestFilterMatches(caseName + "." + name)) {
+                continue;
+            } else if (autograder::hasCachedTestResult(caseName, name)) {
+                cachedCount++;
+            } else {
+                testNames.add(caseName + "." + name);
+            }
+        }
+    }
+
+    long startMS = Timer::currentTimeMS();
+    long totalTestMS = 0;
+    long totalCpuMS = 0;
+    int next = 0;
+    Vector<TestWorker> workers;
+    while (next < testNames.size() || !workers.isEmpty()) {
+        while (next < testNames.size() && workers.size() < workerCount) {
+            if (!startTestWorker(testNames[next], workers, cpuLimitSeconds, memoryLimitMB)) {
+                if (workers.isEmpty()) {
+                    // can't fork at all; remaining tests will run serially
+                    return !STATIC_VARIABLE(TEST_WORKER_RESULTS).isEmpty();
+                }
+                break;
+            }
+            next++;
+        }
+
+        // wait for output from any worker
+        std::vector<struct pollfd> fds;
+        std::vector<std::pair<int, bool> > owners;   // (worker index, is result pipe)
+        for (int i = 0; i < workers.size(); i++) {
+            if (workers[i].outputFd >= 0) {
+                fds.push_back({workers[i].outputFd, POLLIN, 0});
+                owners.push_back(std::make_pair(i, false));
+            }
+            if (workers[i].resultFd >= 0) {
+                fds.push_back({workers[i].resultFd, POLLIN, 0});
+                owners.push_back(std::make_pair(i, true));
+            }
+        }
+        if (!fds.empty()) {
+            poll(fds.data(), (nfds_t) fds.size(), 50);
+        }
+        for (size_t k = 0; k < fds.size(); k++) {
+            if (fds[k].revents == 0) {
+                continue;
+            }
+            TestWorker& worker = workers[owners[k].first];
+            if (owners[k].second) {
+                readFromWorker(worker.resultFd, worker.resultBuffer);
+                processWorkerRecords(worker);
+            } else {
+                readFromWorker(worker.outputFd, worker.result.output);
+            }
+        }
+
+        // enforce limits and reap finished workers
+        long now = Timer::currentTimeMS();
+        for (int i = workers.size() - 1; i >= 0; i--) {
+            TestWorker& worker = workers[i];
+            bool running = !worker.timedOut && !worker.outputExceeded;
+            if (running && outputLimitBytes > 0
+                    && (int) worker.result.output.length() > outputLimitBytes) {
+                worker.outputExceeded = true;
+                worker.result.output.resize((size_t) outputLimitBytes);
+                killTestWorker(worker);
+            } else if (running && now > worker.deadlineMS) {
+                worker.timedOut = true;
+                killTestWorker(worker);
+            }
+            if (worker.outputFd < 0 && worker.resultFd < 0) {
+                finishTestWorker(worker, outputLimitBytes);
+                totalTestMS += worker.result.elapsedMS;
+                totalCpuMS += worker.cpuMS;
+                workers.remove(i);
+            }
+        }
+    }
+
+    long wallMS = std::max(1L, Timer::currentTimeMS() - startMS);
+    std::ostringstream out;
+    out << "Ran " << testNames.size() << " tests in " << workerCount << " worker processes: "
+        << wallMS << "ms wall-clock; per-test times add up to " << totalTestMS
+        << "ms, of which " << totalCpuMS << "ms was CPU time";
+    if (cachedCount > 0) {
+        out << " (" << cachedCount << " more had cached results)";
+    }
+    STATIC_VARIABLE(TEST_WORKER_REPORT) = out.str();
+    return true;
+}
+
 #endif // _WIN32
@@ -5,6 +5,10 @@
  * with a timeout, possibly in a separate thread depending on the platform.
  *
  * @author Marty Stepp
+ * @version 2018/10/19
+ * - runTestsInWorkerProcesses skips tests with cached results
+ * @version 2018/10/05
+ * - added process-based parallel test runner (runTestsInWorkerProcesses)
  * @version 2014/11/24
  * @since 2014/11/24
  */
@@ -17,8 +21,13 @@
 #include "map.h"
 #include "set.h"
 #include "timer.h"
+#include "unittestdetails.h"
 #include "vector.h"
 
+namespace autograder {
+class AutograderTest;
+}
+
 /*
  * Runs the given unit test but halts it with an error if its runtime
  * exceeds the amount of ms given by getTestTimeout on the given test.
@@ -28,4 +37,66 @@
  */
 void runTestWithTimeout(autograder::AutograderTest* test);
 
+/*
+ * Runs every registered test case that --gtest_filter selects in a pool of
+ * forked worker processes,
+ * at most workerCount at a time, and remembers each test's outcome so that
+ * the following RUN_ALL_TESTS() pass can replay it through the usual
+ * test result printer instead of running the test again.
+ * Tests with an entry in the test result cache (see setTestResultCache) are
+ * not run at all; RUN_ALL_TESTS() replays the cached result instead, and
+ * saves the results from the workers to the cache as it replays them.
+ *
+ * The parent process acts as a fork server: each test is run in a fresh
+ * child forked from the already-initialized library, so a test that crashes,
+ * hangs, or corrupts memory cannot affect the others.
+ * Each child has its stdout/stderr redirected into a pipe and is subject to
+ * the given per-test limits on CPU seconds, memory in MB, and bytes of
+ * output; a limit <= 0 means no limit.
+ * Children are forked while the Qt GUI thread is running, and so cannot use
+ * it: a test that creates or updates graphical objects fails with an error.
+ *
+ * Only supported for the text UI on Linux/Mac; elsewhere this does nothing
+ * and the tests run serially as before.
+ * Returns true if the tests were run in worker processes.
+ */
+bool runTestsInWorkerProcesses(int workerCount, int cpuLimitSeconds = 0,
+                               int memoryLimitMB = 0, int outputLimitBytes = 0);
+
+/*
+ * Returns a one-line summary of the most recent worker-process run: its
+ * wall-clock time, the sum of the per-test wall-clock times, and the CPU
+ * time that the workers used.  When there are more workers than cores,
+ * per-test times include time spent waiting for a core, so their sum
+ * overstates what the serial runner would have taken; compare to a run
+ * with no workers to measure the speedup.
+ */
+std::string getTestWorkerReport();
+
+/*
+ * Forgets all outcomes recorded by runTestsInWorkerProcesses,
+ * so that subsequent test runs execute the tests again.
+ */
+void clearTestWorkerResults();
+
+/*
+ * Returns true if the current process is a worker child forked by
+ * runTestsInWorkerProcesses.
+ */
+bool isTestWorkerProcess();
+
+/*
+ * Called internally by setFailDetails; sends the given details back to the
+ * parent process if this is a worker process, and otherwise does nothing.
+ */
+void recordTestWorkerFailDetails(const autograder::UnitTestDetails& deets);
+
+/*
+ * Called internally by the TIMED_TEST macros.
+ * If the given test was already run by a worker process, reports its
+ * recorded output and failures to the current test and returns true;
+ * otherwise returns false and the test should be run normally.
+ */
+bool replayTestWorkerResult(autograder::AutograderTest* test);
+
 #endif // _threading_h
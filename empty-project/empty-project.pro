@@ -15,6 +15,11 @@
 #
 # @author Marty Stepp
 #     (past authors/support by Reid Watson, Rasmus Rygaard, Jess Fisher, etc.)
+# @version 2018/10/19
+# - Qt multimedia module is optional; without it (no SPL_QT_MULTIMEDIA),
+#   Note and Sound are silent but can still be rendered to a WAV file
+# @version 2018/10/15
+# - added Qt multimedia module for Note and Sound audio output
 # @version 2018/09/06
 # - removed references to old Java back-end spl.jar
 # @version 2018/07/01
@@ -96,6 +101,10 @@ TEMPLATE = app
 PROJECT_FILTER =
 QT       += core gui network
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+qtHaveModule(multimedia) {
+    QT += multimedia
+    DEFINES += SPL_QT_MULTIMEDIA
+}
 
 ###############################################################################
 # BEGIN SECTION FOR SPECIFYING SOURCE/LIBRARY/RESOURCE FILES OF PROJECT       #